@@ -0,0 +1,658 @@
+#include "animation.h"
+#include "gltf_parser.h"
+#include "logger.h"
+#include "profiler.h"
+#include "simd_math.h"
+
+#include <fmt/format.h>
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/component_wise.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+template<typename T>
+inline T make_key_value(const float* data, float pad);
+
+template<>
+inline glm::vec4 make_key_value<glm::vec4>(const float* data, float pad)
+{
+    return glm::vec4(glm::make_vec3(data), pad);
+}
+
+template<>
+inline glm::quat make_key_value<glm::quat>(const float* data, float)
+{
+    // gltf stores quaternions as xyzw, same as engine
+    return glm::make_quat(data);
+}
+
+// pad is stored in w component of vec3 channels, scales are padded with 1.0f so division in add_pose() is well defined
+template<typename T>
+inline void append_track(engine::AnimationClip::channel_t<T>& channel, const engine::AnimationChannelInfo& channel_info, std::uint32_t target, float pad = 0.0f)
+{
+    constexpr std::size_t components_count = std::is_same_v<T, glm::quat> ? 4 : 3;
+    assert(channel_info.data.size() == channel_info.timestamps.size() * components_count);
+
+    engine::AnimationClip::track_t track{};
+    track.target = target;
+    track.first_key = static_cast<std::uint32_t>(channel.times.size());
+    track.keys_count = static_cast<std::uint32_t>(channel_info.timestamps.size());
+    channel.tracks.push_back(track);
+
+    channel.times.insert(channel.times.end(), channel_info.timestamps.begin(), channel_info.timestamps.end());
+    channel.values.reserve(channel.values.size() + track.keys_count);
+    for (std::uint32_t i = 0; i < track.keys_count; i++)
+    {
+        channel.values.push_back(make_key_value<T>(channel_info.data.data() + i * components_count, pad));
+    }
+}
+
+// playback advances only few keys per frame, bigger jumps (seek, loop, speed change) are handled with binary search
+constexpr std::uint32_t K_MAX_CURSOR_STEPS = 4;
+
+// returns key index, such that: times[idx] <= time < times[idx + 1]
+// time has to be in range (times[0], times[count - 1])
+inline std::uint32_t find_key(const float* times, std::uint32_t count, float time, std::uint32_t cursor)
+{
+    cursor = std::min(cursor, count - 2);
+    for (std::uint32_t step = 0; step < K_MAX_CURSOR_STEPS; step++)
+    {
+        if (time < times[cursor])
+        {
+            cursor--;
+        }
+        else if (time >= times[cursor + 1])
+        {
+            cursor++;
+        }
+        else
+        {
+            return cursor;
+        }
+    }
+    const auto it = std::upper_bound(times, times + count, time);
+    return static_cast<std::uint32_t>(std::distance(times, it)) - 1;
+}
+
+// interpolation between two keys surrounding the time, values are clamped outside of the track range
+template<typename T, typename Decode, typename Interpolate>
+inline engine::simd::float4 sample_track(const engine::AnimationClip::channel_t<T>& channel, const engine::AnimationClip::track_t& track, float time, std::uint32_t& cursor, Decode decode, Interpolate interpolate)
+{
+    const auto* times = channel.times.data() + track.first_key;
+    const auto* values = channel.values.data() + track.first_key;
+    const auto last = track.keys_count - 1;
+
+    if (time <= times[0])
+    {
+        cursor = 0;
+        return decode(values[0]);
+    }
+    if (time >= times[last])
+    {
+        cursor = last;
+        return decode(values[last]);
+    }
+    cursor = find_key(times, track.keys_count, time, cursor);
+    const auto t = (time - times[cursor]) / (times[cursor + 1] - times[cursor]);
+    return interpolate(decode(values[cursor]), decode(values[cursor + 1]), t);
+}
+
+// samples all tracks of the channel into out_values (indexed by bone), cursor is advanced by tracks count of the channel
+template<typename T, typename Decode, typename Interpolate, typename Out>
+inline void sample_channel(const engine::AnimationClip::channel_t<T>& channel, float time, std::span<const std::uint32_t> bones, std::span<const std::uint8_t> bones_mask,
+    std::span<std::uint32_t>::iterator& cursor, Decode decode, Interpolate interpolate, std::vector<Out>& out_values)
+{
+    for (const auto& track : channel.tracks)
+    {
+        auto& track_cursor = *cursor++;
+        const auto bone = bones[track.target];
+        if (bone != engine::AnimationClip::K_INVALID_BONE && (bones_mask.empty() || bones_mask[bone]))
+        {
+            engine::simd::store4(glm::value_ptr(out_values[bone]), sample_track(channel, track, time, track_cursor, decode, interpolate));
+        }
+    }
+}
+
+template<typename T>
+inline engine::simd::float4 load_key(const T& value)
+{
+    return engine::simd::load4(glm::value_ptr(value));
+}
+
+inline engine::simd::float4 load_quantized_rotation(const engine::quantized_rotation_t& value)
+{
+    float ret[4];
+    engine::dequantize_rotation(value, ret);
+    return engine::simd::load4(ret);
+}
+
+inline engine::simd::float4 lerp_keys(engine::simd::float4 a, engine::simd::float4 b, float t)
+{
+    return engine::simd::lerp(a, b, engine::simd::splat(t));
+}
+
+// returns false when not looping playback reached its end
+inline bool advance_time(float& time, float dt, float speed, bool loop, float duration)
+{
+    time += dt * speed;
+    if (loop)
+    {
+        time = duration > 0.0f ? std::fmod(time, duration) : 0.0f;
+        if (time < 0.0f)
+        {
+            time += duration;
+        }
+        return true;
+    }
+    if ((speed >= 0.0f && time >= duration) || (speed < 0.0f && time <= 0.0f))
+    {
+        time = std::clamp(time, 0.0f, duration);
+        return false;
+    }
+    return true;
+}
+
+inline void append_rest_pose(engine::Pose& pose, const engine_tranform_component_t* transform)
+{
+    if (transform)
+    {
+        pose.translations.emplace_back(glm::make_vec3(transform->position), 0.0f);
+        pose.rotations.push_back(glm::make_quat(transform->rotation));
+        pose.scales.emplace_back(glm::make_vec3(transform->scale), 1.0f);
+    }
+    else
+    {
+        pose.translations.emplace_back(0.0f);
+        pose.rotations.push_back(glm::identity<glm::quat>());
+        pose.scales.emplace_back(1.0f);
+    }
+}
+
+constexpr std::uint32_t K_LOD_OFFSCREEN = ENGINE_ANIMATION_LOD_COUNT;
+
+// distances in world units, phase offsets spread every 2nd/4th/8th frame updates evenly
+constexpr engine_animation_lod_settings_t K_DEFAULT_LOD_SETTINGS
+{
+    { 10.0f, 25.0f, 50.0f },
+    { 1, 2, 4, 8 },
+    { 0, 0, 8, 5 },
+    16,
+    5
+};
+
+struct lod_camera_t
+{
+    bool valid = false;
+    bool perspective = false;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 front = glm::vec3(0.0f);
+    float cos_view_angle = -1.0f;
+};
+
+inline lod_camera_t find_lod_camera(engine::registry_t& registry)
+{
+    lod_camera_t ret{};
+    auto view = registry.view<const engine_camera_component_t, const engine_tranform_component_t>();
+    for (const auto entity : view)
+    {
+        const auto& camera = view.get<const engine_camera_component_t>(entity);
+        if (!camera.enabled)
+        {
+            continue;
+        }
+        // same eye and target as view matrix of the scene
+        const auto& transform = view.get<const engine_tranform_component_t>(entity);
+        ret.valid = true;
+        ret.position = glm::make_vec3(transform.position);
+        const auto to_target = glm::make_vec3(camera.target) - ret.position;
+        ret.perspective = camera.type == ENGINE_CAMERA_PROJECTION_TYPE_PERSPECTIVE && glm::dot(to_target, to_target) > 0.0f;
+        if (ret.perspective)
+        {
+            ret.front = glm::normalize(to_target);
+            // fov is vertical, using it as half angle of the view cone covers wide aspect ratios and size of the objects
+            ret.cos_view_angle = std::cos(glm::radians(std::min(camera.type_union.perspective_fov, 89.0f)));
+        }
+        break;
+    }
+    return ret;
+}
+
+inline std::uint32_t select_lod(const engine_animation_lod_settings_t& settings, const lod_camera_t& camera, const engine_tranform_component_t* transform)
+{
+    if (!camera.valid || !transform)
+    {
+        return 0;
+    }
+    const auto to_object = glm::vec3(transform->local_to_world[12], transform->local_to_world[13], transform->local_to_world[14]) - camera.position;
+    const auto distance = glm::length(to_object);
+    // objects close to the camera can be partially visible even with origin out of the view
+    if (camera.perspective && distance > settings.distances[0] && glm::dot(to_object, camera.front) < distance * camera.cos_view_angle)
+    {
+        return K_LOD_OFFSCREEN;
+    }
+    std::uint32_t lod = 0;
+    while (lod < ENGINE_ANIMATION_LOD_COUNT - 1 && distance >= settings.distances[lod])
+    {
+        lod++;
+    }
+    return lod;
+}
+}  // namespace anonymous
+
+void engine::blend_poses(const Pose& a, const Pose& b, float weight, Pose& out)
+{
+    assert(a.size() == b.size());
+    const auto count = a.size();
+    out.translations.resize(count);
+    out.rotations.resize(count);
+    out.scales.resize(count);
+
+    const auto w = simd::splat(weight);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto t = simd::lerp(simd::load4(glm::value_ptr(a.translations[i])), simd::load4(glm::value_ptr(b.translations[i])), w);
+        const auto r = simd::quat_nlerp(simd::load4(glm::value_ptr(a.rotations[i])), simd::load4(glm::value_ptr(b.rotations[i])), weight);
+        const auto s = simd::lerp(simd::load4(glm::value_ptr(a.scales[i])), simd::load4(glm::value_ptr(b.scales[i])), w);
+        simd::store4(glm::value_ptr(out.translations[i]), t);
+        simd::store4(glm::value_ptr(out.rotations[i]), r);
+        simd::store4(glm::value_ptr(out.scales[i]), s);
+    }
+}
+
+void engine::add_pose(Pose& base, const Pose& additive, const Pose& reference, float weight)
+{
+    assert(base.size() == additive.size() && base.size() == reference.size());
+    const auto w = simd::splat(weight);
+    const auto one = simd::splat(1.0f);
+    const auto identity = simd::set4(0.0f, 0.0f, 0.0f, 1.0f);
+    for (std::size_t i = 0; i < base.size(); i++)
+    {
+        // translation: base + (additive - reference) * w
+        const auto t = simd::madd(simd::sub(simd::load4(glm::value_ptr(additive.translations[i])), simd::load4(glm::value_ptr(reference.translations[i]))), w,
+            simd::load4(glm::value_ptr(base.translations[i])));
+        // rotation: base * nlerp(identity, inverse(reference) * additive, w)
+        const auto delta = simd::quat_mul(simd::quat_conjugate(simd::load4(glm::value_ptr(reference.rotations[i]))), simd::load4(glm::value_ptr(additive.rotations[i])));
+        const auto r = simd::normalize4(simd::quat_mul(simd::load4(glm::value_ptr(base.rotations[i])), simd::quat_nlerp(identity, delta, weight)));
+        // scale: base * lerp(1, additive / reference, w)
+        const auto scale_delta = simd::div(simd::load4(glm::value_ptr(additive.scales[i])), simd::load4(glm::value_ptr(reference.scales[i])));
+        const auto s = simd::mul(simd::load4(glm::value_ptr(base.scales[i])), simd::lerp(one, scale_delta, w));
+        simd::store4(glm::value_ptr(base.translations[i]), t);
+        simd::store4(glm::value_ptr(base.rotations[i]), r);
+        simd::store4(glm::value_ptr(base.scales[i]), s);
+    }
+}
+
+engine::AnimationClip::AnimationClip(const AnimationClipInfo& clip_info, const ModelInfo& model)
+{
+    // clip only knows model node indices, which are translated to names (scene objects are bound by name component)
+    std::vector<std::int32_t> targets_nodes;
+    for (const auto& channel_info : clip_info.channels)
+    {
+        if (channel_info.timestamps.empty() || channel_info.type == AnimationChannelType::eUnknown)
+        {
+            continue;
+        }
+        const auto node_it = std::find_if(model.nodes.begin(), model.nodes.end(), [&channel_info](const auto& node) { return node->index == channel_info.target_node_idx; });
+        if (node_it == model.nodes.end())
+        {
+            log::log(log::LogLevel::eError, fmt::format("Animation clip: {} targets node: {} which is not part of the model. Skipping channel.\n", clip_info.name, channel_info.target_node_idx));
+            continue;
+        }
+
+        auto target_it = std::find(targets_nodes.begin(), targets_nodes.end(), channel_info.target_node_idx);
+        if (target_it == targets_nodes.end())
+        {
+            targets_nodes.push_back(channel_info.target_node_idx);
+            targets_names_.push_back((*node_it)->name);
+            target_it = targets_nodes.end() - 1;
+        }
+        const auto target = static_cast<std::uint32_t>(std::distance(targets_nodes.begin(), target_it));
+
+        switch (channel_info.type)
+        {
+        case AnimationChannelType::eTranslation:
+            append_track(translations_, channel_info, target);
+            break;
+        case AnimationChannelType::eRotation:
+            append_track(rotations_, channel_info, target);
+            break;
+        case AnimationChannelType::eScale:
+            append_track(scales_, channel_info, target, 1.0f);
+            break;
+        default:
+            assert(false && "Unknown animation channel type!");
+        }
+        duration_ = std::max(duration_, channel_info.timestamps.back());
+    }
+
+    if (clip_info.quantize)
+    {
+        quantize();
+    }
+}
+
+void engine::AnimationClip::sample(float time, std::span<const std::uint32_t> bones, std::span<std::uint32_t> cursors, Pose& pose, std::span<const std::uint8_t> bones_mask) const
+{
+    assert(bones.size() == targets_names_.size());
+    assert(cursors.size() == get_tracks_count());
+    const auto& bounds = translation_bounds_;
+    const auto load_quantized_translation = [&bounds](const quantized_translation_t& value)
+    {
+        float ret[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        dequantize_translation(value, bounds, ret);
+        return simd::load4(ret);
+    };
+
+    // order of the channels has to match cursors layout (see get_tracks_count())
+    auto cursor = cursors.begin();
+    sample_channel(translations_, time, bones, bones_mask, cursor, load_key<glm::vec4>, lerp_keys, pose.translations);
+    sample_channel(quantized_translations_, time, bones, bones_mask, cursor, load_quantized_translation, lerp_keys, pose.translations);
+    sample_channel(rotations_, time, bones, bones_mask, cursor, load_key<glm::quat>, simd::quat_slerp, pose.rotations);
+    sample_channel(quantized_rotations_, time, bones, bones_mask, cursor, load_quantized_rotation, simd::quat_slerp, pose.rotations);
+    sample_channel(scales_, time, bones, bones_mask, cursor, load_key<glm::vec4>, lerp_keys, pose.scales);
+}
+
+std::size_t engine::AnimationClip::get_memory_size() const
+{
+    const auto channel_size = [](const auto& channel)
+    {
+        return channel.tracks.size() * sizeof(track_t) + channel.times.size() * sizeof(float) + channel.values.size() * sizeof(channel.values[0]);
+    };
+    return channel_size(translations_) + channel_size(quantized_translations_) + channel_size(rotations_) + channel_size(quantized_rotations_) + channel_size(scales_);
+}
+
+void engine::AnimationClip::quantize()
+{
+    const auto size_before = get_memory_size();
+
+    glm::vec3 bounds_min(std::numeric_limits<float>::max());
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+    for (const auto& value : translations_.values)
+    {
+        bounds_min = glm::min(bounds_min, glm::vec3(value));
+        bounds_max = glm::max(bounds_max, glm::vec3(value));
+    }
+    if (!translations_.values.empty())
+    {
+        std::memcpy(translation_bounds_.min, glm::value_ptr(bounds_min), sizeof(translation_bounds_.min));
+        std::memcpy(translation_bounds_.extent, glm::value_ptr(bounds_max - bounds_min), sizeof(translation_bounds_.extent));
+    }
+
+    // max error is reported to help with choosing compression tolerance
+    float translation_error = 0.0f;
+    quantized_translations_.tracks = std::move(translations_.tracks);
+    quantized_translations_.times = std::move(translations_.times);
+    quantized_translations_.values.reserve(translations_.values.size());
+    for (const auto& value : translations_.values)
+    {
+        quantized_translations_.values.push_back(quantize_translation(glm::value_ptr(value), translation_bounds_));
+        glm::vec3 decoded;
+        dequantize_translation(quantized_translations_.values.back(), translation_bounds_, glm::value_ptr(decoded));
+        translation_error = std::max(translation_error, glm::compMax(glm::abs(decoded - glm::vec3(value))));
+    }
+    translations_ = {};
+
+    float rotation_error = 0.0f;
+    quantized_rotations_.tracks = std::move(rotations_.tracks);
+    quantized_rotations_.times = std::move(rotations_.times);
+    quantized_rotations_.values.reserve(rotations_.values.size());
+    for (const auto& value : rotations_.values)
+    {
+        quantized_rotations_.values.push_back(quantize_rotation(glm::value_ptr(value)));
+        glm::vec4 decoded;
+        dequantize_rotation(quantized_rotations_.values.back(), glm::value_ptr(decoded));
+        const auto original = glm::vec4(value.x, value.y, value.z, value.w) * (glm::dot(glm::vec4(value.x, value.y, value.z, value.w), decoded) < 0.0f ? -1.0f : 1.0f);
+        rotation_error = std::max(rotation_error, glm::compMax(glm::abs(decoded - original)));
+    }
+    rotations_ = {};
+
+    log::log(log::LogLevel::eTrace, fmt::format("Animation clip quantized, memory: {} -> {} bytes, max error: translation {}, rotation {}.\n",
+        size_before, get_memory_size(), translation_error, rotation_error));
+}
+
+engine::AnimationSystem::AnimationSystem()
+    : lod_settings_(K_DEFAULT_LOD_SETTINGS)
+{
+}
+
+void engine::AnimationSystem::update(registry_t& registry, float dt, const Atlas<AnimationClip>& clips)
+{
+    ENGINE_PROFILE_SECTION_N("animations_update");
+    lod_stats_ = {};
+    frame_index_++;
+    const auto camera = find_lod_camera(registry);
+
+    auto view = registry.view<engine_animation_component_t>();
+    for (const auto entity : view)
+    {
+        auto& anim = view.get<engine_animation_component_t>(entity);
+        auto& internal = registry.get_or_emplace<animation_internal_component_t>(entity);
+
+        const auto lod = select_lod(lod_settings_, camera, registry.try_get<engine_tranform_component_t>(entity));
+        std::uint32_t update_interval = 1;
+        std::uint32_t max_bone_depth = 0;
+        if (lod == K_LOD_OFFSCREEN)
+        {
+            lod_stats_.offscreen_objects++;
+            update_interval = lod_settings_.offscreen_update_interval;
+            max_bone_depth = lod_settings_.offscreen_max_bone_depth;
+        }
+        else
+        {
+            lod_stats_.objects_per_lod[lod]++;
+            update_interval = lod_settings_.update_intervals[lod];
+            max_bone_depth = lod_settings_.max_bone_depths[lod];
+        }
+
+        // throttled objects catch up with accumulated time, phase from entity id spreads them evenly between frames
+        internal.pending_dt += dt;
+        if (update_interval > 1 && (frame_index_ + static_cast<std::uint32_t>(entity)) % update_interval != 0)
+        {
+            lod_stats_.throttled_objects++;
+            continue;
+        }
+        const auto frame_dt = std::exchange(internal.pending_dt, 0.0f);
+
+        // main clip, when it changes previous one starts fading out
+        const auto* clip = clips.get_object(anim.clip);
+        if (internal.main.clip != anim.clip)
+        {
+            if (clips.get_object(internal.main.clip) && anim.crossfade_duration > 0.0f)
+            {
+                std::swap(internal.fade_out, internal.main);
+                internal.fade_elapsed = 0.0f;
+                internal.fade_duration = anim.crossfade_duration;
+            }
+            internal.main.clip = anim.clip;
+            if (clip)
+            {
+                bind_clip(registry, entity, internal, *clip, internal.main);
+            }
+        }
+        const auto main_active = clip && anim.playing;
+        if (main_active)
+        {
+            anim.playing = advance_time(anim.time, frame_dt, anim.speed, anim.loop, clip->get_duration());
+        }
+        internal.main.time = anim.time;
+        internal.main.speed = anim.speed;
+        internal.main.loop = anim.loop;
+        internal.main.playing = anim.playing;
+
+        const auto* fade_clip = clips.get_object(internal.fade_out.clip);
+        const auto fade_active = fade_clip != nullptr;
+        if (fade_clip)
+        {
+            internal.fade_elapsed += frame_dt;
+            if (internal.fade_elapsed >= internal.fade_duration)
+            {
+                internal.fade_out.clip = ENGINE_INVALID_OBJECT_HANDLE;
+                fade_clip = nullptr;
+            }
+            else if (internal.fade_out.playing)
+            {
+                internal.fade_out.playing = advance_time(internal.fade_out.time, frame_dt, internal.fade_out.speed, internal.fade_out.loop, fade_clip->get_duration());
+            }
+        }
+
+        bool layers_active = false;
+        for (std::size_t i = 0; i < internal.layers.size(); i++)
+        {
+            auto& layer = anim.additive_layers[i];
+            auto& internal_layer = internal.layers[i];
+            const auto* layer_clip = clips.get_object(layer.clip);
+            if (internal_layer.playback.clip != layer.clip)
+            {
+                internal_layer.playback.clip = layer.clip;
+                internal_layer.reference = {};
+                if (layer_clip)
+                {
+                    bind_clip(registry, entity, internal, *layer_clip, internal_layer.playback);
+                }
+            }
+            if (!layer_clip || layer.weight <= 0.0f)
+            {
+                continue;
+            }
+            if (layer.playing)
+            {
+                layer.playing = advance_time(layer.time, frame_dt, layer.speed, layer.loop, layer_clip->get_duration());
+            }
+            layers_active = true;
+        }
+
+        // nothing is moving, pose from the last update is still valid
+        if (!main_active && !fade_active && !layers_active)
+        {
+            continue;
+        }
+        lod_stats_.updated_objects++;
+
+        // bones below max depth are not sampled nor written, they keep pose from the last full update
+        bones_mask_.clear();
+        if (max_bone_depth > 0)
+        {
+            bones_mask_.resize(internal.bones.size());
+            for (std::size_t i = 0; i < internal.bones.size(); i++)
+            {
+                bones_mask_[i] = internal.bones_depths[i] <= max_bone_depth ? 1 : 0;
+            }
+        }
+
+        pose_ = internal.rest_pose;
+        if (clip)
+        {
+            clip->sample(anim.time, internal.main.bones, internal.main.cursors, pose_, bones_mask_);
+        }
+        if (fade_clip)
+        {
+            layer_pose_ = internal.rest_pose;
+            fade_clip->sample(internal.fade_out.time, internal.fade_out.bones, internal.fade_out.cursors, layer_pose_, bones_mask_);
+            blend_poses(layer_pose_, pose_, internal.fade_elapsed / internal.fade_duration, pose_);
+        }
+        for (std::size_t i = 0; i < internal.layers.size() && layers_active; i++)
+        {
+            const auto& layer = anim.additive_layers[i];
+            auto& internal_layer = internal.layers[i];
+            const auto* layer_clip = clips.get_object(layer.clip);
+            if (!layer_clip || layer.weight <= 0.0f)
+            {
+                continue;
+            }
+            // skeleton could grow since reference was computed
+            if (internal_layer.reference.size() != internal.rest_pose.size())
+            {
+                internal_layer.reference = internal.rest_pose;
+                reference_cursors_.assign(layer_clip->get_tracks_count(), 0);
+                layer_clip->sample(0.0f, internal_layer.playback.bones, reference_cursors_, internal_layer.reference);
+            }
+            layer_pose_ = internal.rest_pose;
+            layer_clip->sample(layer.time, internal_layer.playback.bones, internal_layer.playback.cursors, layer_pose_, bones_mask_);
+            add_pose(pose_, layer_pose_, internal_layer.reference, std::min(layer.weight, 1.0f));
+        }
+
+        // transforms are written in place, local to world matrices are recomputed by the scene later in the frame anyway
+        for (std::size_t i = 0; i < internal.bones.size(); i++)
+        {
+            if (!bones_mask_.empty() && !bones_mask_[i])
+            {
+                continue;
+            }
+            const auto bone = internal.bones[i];
+            auto* transform = registry.valid(bone) ? registry.try_get<engine_tranform_component_t>(bone) : nullptr;
+            if (!transform)
+            {
+                continue;
+            }
+            std::memcpy(transform->position, glm::value_ptr(pose_.translations[i]), sizeof(transform->position));
+            std::memcpy(transform->rotation, glm::value_ptr(pose_.rotations[i]), sizeof(transform->rotation));
+            std::memcpy(transform->scale, glm::value_ptr(pose_.scales[i]), sizeof(transform->scale));
+        }
+    }
+}
+
+void engine::AnimationSystem::bind_clip(registry_t& registry, entt::entity root, animation_internal_component_t& internal, const AnimationClip& clip, playback_t& out_playback)
+{
+    const auto targets_names = clip.get_targets_names();
+    out_playback.bones.assign(targets_names.size(), AnimationClip::K_INVALID_BONE);
+    out_playback.cursors.assign(clip.get_tracks_count(), 0);
+
+    std::size_t bound_count = 0;
+    hierarchy_scratch_.clear();
+    hierarchy_scratch_.push_back({ root, 0 });
+    while (!hierarchy_scratch_.empty())
+    {
+        const auto [entity, depth] = hierarchy_scratch_.back();
+        hierarchy_scratch_.pop_back();
+
+        if (const auto* name = registry.try_get<engine_name_component_t>(entity))
+        {
+            const std::string_view entity_name(name->name, strnlen(name->name, ENGINE_ENTITY_NAME_MAX_LENGTH));
+            for (std::size_t i = 0; i < targets_names.size(); i++)
+            {
+                if (out_playback.bones[i] != AnimationClip::K_INVALID_BONE || targets_names[i] != entity_name)
+                {
+                    continue;
+                }
+                // skeleton is shared by all clips of the component, new bones remember their current transform as rest pose
+                auto bone_it = std::find(internal.bones.begin(), internal.bones.end(), entity);
+                if (bone_it == internal.bones.end())
+                {
+                    internal.bones.push_back(entity);
+                    internal.bones_depths.push_back(depth);
+                    append_rest_pose(internal.rest_pose, registry.try_get<engine_tranform_component_t>(entity));
+                    bone_it = internal.bones.end() - 1;
+                }
+                out_playback.bones[i] = static_cast<std::uint32_t>(std::distance(internal.bones.begin(), bone_it));
+                bound_count++;
+                break;
+            }
+        }
+
+        if (const auto* children = registry.try_get<engine_children_component_t>(entity))
+        {
+            for (const auto child : children->child)
+            {
+                if (child != ENGINE_INVALID_GAME_OBJECT_ID)
+                {
+                    hierarchy_scratch_.push_back({ static_cast<entt::entity>(child), depth + 1 });
+                }
+            }
+        }
+    }
+
+    if (bound_count != targets_names.size())
+    {
+        log::log(log::LogLevel::eTrace, fmt::format("Animation clip bound only {} of {} targets for game object: {}.\n", bound_count, targets_names.size(), static_cast<std::uint32_t>(root)));
+    }
+}
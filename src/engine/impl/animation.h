@@ -0,0 +1,180 @@
+#pragma once
+#include "engine.h"
+#include "named_atlas.h"
+#include "animation_compression.h"
+#include "memory_tracker.h"
+#include "entity_registry.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <entt/entt.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace engine
+{
+struct AnimationClipInfo;
+struct ModelInfo;
+
+// Local transforms of all bones of the skeleton, each channel in separate contiguous array.
+// Translations and scales are padded to vec4, so each bone is processed with single SIMD operation.
+struct Pose
+{
+    std::vector<glm::vec4> translations;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec4> scales;
+
+    std::size_t size() const { return rotations.size(); }
+};
+
+// out = lerp(a, b, weight) for translations and scales, shortest path nlerp for rotations
+// out can be the same object as a or b
+void blend_poses(const Pose& a, const Pose& b, float weight, Pose& out);
+// adds difference between additive and reference pose on top of the base pose, scaled by weight
+void add_pose(Pose& base, const Pose& additive, const Pose& reference, float weight);
+
+// Keyframes stored in struct of arrays layout.
+// Times and values of every channel type live in separate contiguous arrays (for all tracks of the clip),
+// track only points to the range of its keys. Only linear interpolation is supported.
+// Clips imported with compression store translations and rotations quantized, keys are decoded while sampling.
+class AnimationClip
+{
+public:
+    struct track_t
+    {
+        std::uint32_t target = 0; // index to get_targets_names()
+        std::uint32_t first_key = 0;
+        std::uint32_t keys_count = 0;
+    };
+
+    template<typename T>
+    struct channel_t
+    {
+        memory::tracked_vector<track_t, ENGINE_MEMORY_TAG_ASSETS> tracks;
+        memory::tracked_vector<float, ENGINE_MEMORY_TAG_ASSETS> times;
+        memory::tracked_vector<T, ENGINE_MEMORY_TAG_ASSETS> values;
+    };
+
+    // target which is not part of the skeleton
+    static constexpr std::uint32_t K_INVALID_BONE = ~0u;
+
+public:
+    AnimationClip() = default;
+    AnimationClip(const AnimationClipInfo& clip_info, const ModelInfo& model);
+    AnimationClip(const AnimationClip& rhs) = delete;
+    AnimationClip(AnimationClip&& rhs) noexcept = default;
+    AnimationClip& operator=(const AnimationClip& rhs) = delete;
+    AnimationClip& operator=(AnimationClip&& rhs) noexcept = default;
+    ~AnimationClip() = default;
+
+    bool is_valid() const { return !targets_names_.empty(); }
+    float get_duration() const { return duration_; }
+    std::span<const std::string> get_targets_names() const { return targets_names_; }
+    std::size_t get_tracks_count() const
+    {
+        return translations_.tracks.size() + quantized_translations_.tracks.size() + rotations_.tracks.size() + quantized_rotations_.tracks.size() + scales_.tracks.size();
+    }
+    // size of keys data in bytes
+    std::size_t get_memory_size() const;
+
+    // bones map targets (indexed the same way as get_targets_names()) to the pose, K_INVALID_BONE targets are skipped
+    // only animated channels of the bones are written, rest of the pose is left untouched
+    // cursors (one per track, see get_tracks_count()) keep last used key of each track between calls,
+    // so regular playback finds next key in O(1), seeks and loops fall back to binary search
+    // bones_mask (optional, indexed by pose bone) disables sampling of masked out bones
+    void sample(float time, std::span<const std::uint32_t> bones, std::span<std::uint32_t> cursors, Pose& pose, std::span<const std::uint8_t> bones_mask = {}) const;
+
+private:
+    void quantize();
+
+private:
+    std::vector<std::string> targets_names_;
+    channel_t<glm::vec4> translations_;
+    channel_t<glm::quat> rotations_;
+    channel_t<glm::vec4> scales_;
+    // replace translations_ and rotations_ after quantize()
+    channel_t<quantized_translation_t> quantized_translations_;
+    channel_t<quantized_rotation_t> quantized_rotations_;
+    translation_bounds_t translation_bounds_;
+    float duration_ = 0.0f;
+};
+
+// Per frame pass over all engine_animation_component_t: advances time and writes sampled pose into transform components.
+// Main clip can crossfade from the previous one and additive layers are applied on top of it.
+// Level of detail (distance to the enabled camera) throttles update rate and limits depth of updated bones.
+class AnimationSystem
+{
+public:
+    // clip bound to the skeleton
+    struct playback_t
+    {
+        engine_animation_clip_t clip = ENGINE_INVALID_OBJECT_HANDLE;
+        std::vector<std::uint32_t> bones; // clip target -> skeleton bone
+        std::vector<std::uint32_t> cursors;
+        float time = 0.0f;
+        float speed = 1.0f;
+        bool loop = false;
+        bool playing = false;
+    };
+
+    struct additive_layer_t
+    {
+        playback_t playback;
+        Pose reference; // first frame of the clip
+    };
+
+    // internal component, skeleton built from game objects bound to clips of the component
+    struct animation_internal_component_t
+    {
+        std::vector<entt::entity> bones;
+        std::vector<std::uint32_t> bones_depths; // distance from the owner of the component in the hierarchy
+        Pose rest_pose; // local transforms of the bones when they were bound
+
+        playback_t main;
+        // previous clip, fading out after main clip was changed
+        playback_t fade_out;
+        float fade_elapsed = 0.0f;
+        float fade_duration = 0.0f;
+
+        std::array<additive_layer_t, ENGINE_ANIMATION_MAX_ADDITIVE_LAYERS> layers;
+
+        // time not applied yet, because of lod update interval
+        float pending_dt = 0.0f;
+    };
+
+public:
+    AnimationSystem();
+    AnimationSystem(const AnimationSystem& rhs) = delete;
+    AnimationSystem(AnimationSystem&& rhs) noexcept = default;
+    AnimationSystem& operator=(const AnimationSystem& rhs) = delete;
+    AnimationSystem& operator=(AnimationSystem&& rhs) noexcept = default;
+    ~AnimationSystem() = default;
+
+    void update(registry_t& registry, float dt, const Atlas<AnimationClip>& clips);
+
+    void set_lod_settings(const engine_animation_lod_settings_t& settings) { lod_settings_ = settings; }
+    const engine_animation_lod_settings_t& get_lod_settings() const { return lod_settings_; }
+    const engine_animation_lod_stats_t& get_lod_stats() const { return lod_stats_; }
+
+private:
+    void bind_clip(registry_t& registry, entt::entity root, animation_internal_component_t& internal, const AnimationClip& clip, playback_t& out_playback);
+
+private:
+    // reused between frames to avoid allocations
+    std::vector<std::pair<entt::entity, std::uint32_t>> hierarchy_scratch_;
+    Pose pose_;
+    Pose layer_pose_;
+    std::vector<std::uint32_t> reference_cursors_;
+    std::vector<std::uint8_t> bones_mask_;
+
+    engine_animation_lod_settings_t lod_settings_{};
+    engine_animation_lod_stats_t lod_stats_{};
+    std::uint32_t frame_index_ = 0;
+};
+}  // namespace engine
@@ -0,0 +1,166 @@
+#include "animation_compression.h"
+
+#include <cassert>
+
+namespace
+{
+inline float dot(const float* a, const float* b, std::uint32_t count)
+{
+    float ret = 0.0f;
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        ret += a[i] * b[i];
+    }
+    return ret;
+}
+
+// same interpolation as used by engine::AnimationClip::sample()
+inline void interpolate_key(const float* a, const float* b, float t, std::uint32_t count, bool is_rotation, float* out)
+{
+    if (!is_rotation)
+    {
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            out[i] = a[i] + (b[i] - a[i]) * t;
+        }
+        return;
+    }
+
+    auto cos_theta = dot(a, b, 4);
+    const auto sign = cos_theta < 0.0f ? -1.0f : 1.0f;
+    cos_theta = std::abs(cos_theta);
+    auto wa = 1.0f - t;
+    auto wb = t;
+    if (cos_theta <= 0.9995f)
+    {
+        const auto theta = std::acos(cos_theta);
+        const auto inv_sin_theta = 1.0f / std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) * inv_sin_theta;
+        wb = std::sin(t * theta) * inv_sin_theta;
+    }
+    for (std::uint32_t i = 0; i < 4; i++)
+    {
+        out[i] = a[i] * wa + b[i] * sign * wb;
+    }
+    if (cos_theta > 0.9995f)
+    {
+        const auto inv_length = 1.0f / std::sqrt(dot(out, out, 4));
+        for (std::uint32_t i = 0; i < 4; i++)
+        {
+            out[i] *= inv_length;
+        }
+    }
+}
+
+inline float key_error(const float* a, const float* b, std::uint32_t count, bool is_rotation)
+{
+    // q and -q are the same rotation
+    const auto sign = is_rotation && dot(a, b, 4) < 0.0f ? -1.0f : 1.0f;
+    float ret = 0.0f;
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        ret = std::max(ret, std::abs(a[i] - b[i] * sign));
+    }
+    return ret;
+}
+}  // namespace anonymous
+
+engine::quantized_rotation_t engine::quantize_rotation(const float q[4])
+{
+    std::uint32_t largest = 0;
+    for (std::uint32_t i = 1; i < 4; i++)
+    {
+        if (std::abs(q[i]) > std::abs(q[largest]))
+        {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation, so dropped component is always restored as positive
+    const auto length = std::sqrt(dot(q, q, 4));
+    const auto scale = (q[largest] < 0.0f ? -1.0f : 1.0f) / (length > 0.0f ? length : 1.0f);
+
+    quantized_rotation_t ret{};
+    for (std::uint32_t i = 0, dst = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        const auto v = std::clamp(q[i] * scale, -K_SMALLEST_THREE_RANGE, K_SMALLEST_THREE_RANGE);
+        ret.data[dst++] = static_cast<std::uint16_t>(std::lround((v + K_SMALLEST_THREE_RANGE) / (2.0f * K_SMALLEST_THREE_RANGE) * K_SMALLEST_THREE_MAX));
+    }
+    ret.data[0] |= static_cast<std::uint16_t>((largest >> 1) << 15);
+    ret.data[1] |= static_cast<std::uint16_t>((largest & 1) << 15);
+    return ret;
+}
+
+engine::quantized_translation_t engine::quantize_translation(const float v[3], const translation_bounds_t& bounds)
+{
+    quantized_translation_t ret{};
+    for (std::uint32_t i = 0; i < 3; i++)
+    {
+        if (bounds.extent[i] > 0.0f)
+        {
+            const auto normalized = std::clamp((v[i] - bounds.min[i]) / bounds.extent[i], 0.0f, 1.0f);
+            ret.data[i] = static_cast<std::uint16_t>(std::lround(normalized * K_TRANSLATION_MAX));
+        }
+    }
+    return ret;
+}
+
+float engine::reduce_animation_keys(std::vector<float>& timestamps, std::vector<float>& data, std::uint32_t components_count, bool is_rotation, float tolerance)
+{
+    assert(components_count <= 4);
+    assert(data.size() == timestamps.size() * components_count);
+    const auto count = timestamps.size();
+    if (count <= 2)
+    {
+        return 0.0f;
+    }
+
+    // error of keys between anchor and to, when they are replaced with interpolation of anchor and to
+    float interpolated[4];
+    const auto segment_error = [&](std::size_t anchor, std::size_t to)
+    {
+        float ret = 0.0f;
+        const auto duration = timestamps[to] - timestamps[anchor];
+        for (auto i = anchor + 1; i < to && ret <= tolerance; i++)
+        {
+            const auto t = duration > 0.0f ? (timestamps[i] - timestamps[anchor]) / duration : 0.0f;
+            interpolate_key(data.data() + anchor * components_count, data.data() + to * components_count, t, components_count, is_rotation, interpolated);
+            ret = std::max(ret, key_error(interpolated, data.data() + i * components_count, components_count, is_rotation));
+        }
+        return ret;
+    };
+
+    // greedy: segment from the last kept key is extended as long as skipped keys stay within tolerance
+    std::vector<std::size_t> kept;
+    kept.push_back(0);
+    std::size_t anchor = 0;
+    float anchor_segment_error = 0.0f;
+    float max_error = 0.0f;
+    for (std::size_t i = 1; i + 1 < count; i++)
+    {
+        const auto error = segment_error(anchor, i + 1);
+        if (error <= tolerance)
+        {
+            anchor_segment_error = error;
+            continue;
+        }
+        kept.push_back(i);
+        max_error = std::max(max_error, anchor_segment_error);
+        anchor_segment_error = 0.0f;
+        anchor = i;
+    }
+    kept.push_back(count - 1);
+    max_error = std::max(max_error, anchor_segment_error);
+
+    for (std::size_t i = 0; i < kept.size(); i++)
+    {
+        timestamps[i] = timestamps[kept[i]];
+        std::copy_n(data.begin() + kept[i] * components_count, components_count, data.begin() + i * components_count);
+    }
+    timestamps.resize(kept.size());
+    data.resize(kept.size() * components_count);
+    return max_error;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+// Rotation quantized with smallest three encoding: largest component is dropped (restored from unit length),
+// remaining three are in range [-1/sqrt(2), 1/sqrt(2)] and stored with 15 bits each.
+// Index of the dropped component is stored in the top bits of the first two values.
+struct quantized_rotation_t
+{
+    std::uint16_t data[3];
+};
+
+// Translation quantized to 16 bits per component, relative to bounds of all translation keys of the clip.
+struct quantized_translation_t
+{
+    std::uint16_t data[3];
+};
+
+struct translation_bounds_t
+{
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float extent[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+inline constexpr float K_SMALLEST_THREE_RANGE = 0.70710678f;
+inline constexpr float K_SMALLEST_THREE_MAX = 32767.0f;
+inline constexpr float K_TRANSLATION_MAX = 65535.0f;
+
+// q is xyzw
+quantized_rotation_t quantize_rotation(const float q[4]);
+quantized_translation_t quantize_translation(const float v[3], const translation_bounds_t& bounds);
+
+// out is xyzw
+inline void dequantize_rotation(const quantized_rotation_t& q, float out[4])
+{
+    constexpr float scale = 2.0f * K_SMALLEST_THREE_RANGE / K_SMALLEST_THREE_MAX;
+    const std::uint32_t largest = ((q.data[0] >> 15) << 1) | (q.data[1] >> 15);
+    float sum = 0.0f;
+    for (std::uint32_t i = 0, src = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        const auto v = static_cast<float>(q.data[src++] & 0x7fff) * scale - K_SMALLEST_THREE_RANGE;
+        out[i] = v;
+        sum += v * v;
+    }
+    out[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+}
+
+inline void dequantize_translation(const quantized_translation_t& v, const translation_bounds_t& bounds, float out[3])
+{
+    for (std::uint32_t i = 0; i < 3; i++)
+    {
+        out[i] = bounds.min[i] + static_cast<float>(v.data[i]) * (bounds.extent[i] / K_TRANSLATION_MAX);
+    }
+}
+
+// Removes keys, which are reproduced by interpolation of the remaining neighbours (lerp, slerp for rotations) within tolerance.
+// First and last keys are always kept. data holds components_count floats per key.
+// Returns max error (absolute difference of components) of the removed keys.
+float reduce_animation_keys(std::vector<float>& timestamps, std::vector<float>& data, std::uint32_t components_count, bool is_rotation, float tolerance);
+}  // namespace engine
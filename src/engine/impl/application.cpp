@@ -3,9 +3,11 @@
 #include "asset_store.h"
 #include "scene.h"
 #include "logger.h"
+#include "memory_tracker.h"
 #include "gltf_parser.h"
 #include "ui_document.h"
 #include "scene.h"
+#include "background_worker.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -17,6 +19,8 @@
 #include <map>
 #include <span>
 #include <iostream>
+#include <memory>
+#include <algorithm>
 
 #include "profiler.h"
 
@@ -24,6 +28,7 @@ namespace
 {
 struct vertex_attribute_simple_t
 {
+    std::uint32_t index; // shader input location
 	std::uint32_t size;
 	engine::Geometry::vertex_attribute_t::Type type;
 
@@ -52,10 +57,15 @@ inline std::vector<engine::Geometry::vertex_attribute_t> create_tightly_packed_v
         break;
     case Geometry::vertex_attribute_t::Type::eUint16:
     case Geometry::vertex_attribute_t::Type::eInt16:
+    case Geometry::vertex_attribute_t::Type::eFloat16:
+    case Geometry::vertex_attribute_t::Type::eUnorm16:
+    case Geometry::vertex_attribute_t::Type::eSnorm16:
         bytes_size = sizeof(std::uint16_t) * attrib.size;
         break;
     case Geometry::vertex_attribute_t::Type::eUint8:
     case Geometry::vertex_attribute_t::Type::eInt8:
+    case Geometry::vertex_attribute_t::Type::eUnorm8:
+    case Geometry::vertex_attribute_t::Type::eSnorm8:
         bytes_size = sizeof(std::uint8_t) * attrib.size;
         break;
     default:
@@ -71,7 +81,7 @@ inline std::vector<engine::Geometry::vertex_attribute_t> create_tightly_packed_v
 	vertex_layout.resize(simple_attribs.size());
 	for (std::uint32_t idx = 0; auto & attrib : vertex_layout)
 	{
-		attrib.index = idx;
+		attrib.index = simple_attribs[idx].index;
 		attrib.stride = stride;
 		attrib.size = simple_attribs[idx].size;
 		attrib.type = simple_attribs[idx].type;
@@ -98,6 +108,13 @@ inline std::vector<engine::Geometry::vertex_attribute_t> create_engine_api_layou
 
         case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8: return engine::Geometry::vertex_attribute_t::Type::eUint8;
         case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT8: return engine::Geometry::vertex_attribute_t::Type::eInt8;
+
+        case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT16: return engine::Geometry::vertex_attribute_t::Type::eFloat16;
+
+        case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM16: return engine::Geometry::vertex_attribute_t::Type::eUnorm16;
+        case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16: return engine::Geometry::vertex_attribute_t::Type::eSnorm16;
+        case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8: return engine::Geometry::vertex_attribute_t::Type::eUnorm8;
+        case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM8: return engine::Geometry::vertex_attribute_t::Type::eSnorm8;
         default:
             return engine::Geometry::vertex_attribute_t::Type::eCount;
         }
@@ -121,18 +138,34 @@ inline std::vector<engine::Geometry::vertex_attribute_t> create_engine_api_layou
         {
             continue;
         }
-        vertex_layout_simple.push_back({ attr.elements_count, to_vert_attr_dt(attr.elements_data_type), to_range_vector(attr.range_min, attr.elements_count), to_range_vector(attr.range_max, attr.elements_count)});
+        vertex_layout_simple.push_back({ static_cast<std::uint32_t>(attr.type), attr.elements_count, to_vert_attr_dt(attr.elements_data_type), to_range_vector(attr.range_min, attr.elements_count), to_range_vector(attr.range_max, attr.elements_count)});
     }
     return create_tightly_packed_vertex_layout(vertex_layout_simple);
 }
 
+// hot reload reads the edited loose file, even if the same file is in a mounted asset pack
+inline engine::RawDataFileContext read_hot_reloaded_file(const std::filesystem::path& full_path)
+{
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(full_path, ec))
+    {
+        return engine::RawDataFileContext(full_path);
+    }
+    return engine::AssetStore::get_instance().get_file_data(full_path);
+}
+
 }  // namespace annoymous
 
 engine::Application::Application(const engine_application_create_desc_t& desc, engine_result_code_t& out_code)
     : rdx_(std::move(RenderContext(desc.name, { 0, 0, desc.width, desc.height }, desc.fullscreen)))
+    , creation_time_(std::chrono::steady_clock::now())
     , ui_manager_(rdx_)
+    , optimize_meshes_(desc.optimize_meshes)
+    , compress_animations_(desc.compress_animations)
     , default_texture_idx_(ENGINE_INVALID_OBJECT_HANDLE)
 {
+    // before any scene (physics world) is created
+    memory::install_physics_allocator();
 	{
 		//constexpr const std::array<std::uint8_t, 3> default_texture_color = { 160, 50, 168 };
 		constexpr const std::array<std::uint8_t, 3> default_texture_color = { 255, 255, 255 };
@@ -146,6 +179,14 @@ engine::Application::Application(const engine_application_create_desc_t& desc, e
 
     rdx_.set_clear_color(0.05f, 0.0f, 0.2f, 1.0f);
 
+    if (desc.enable_assets_hot_reload)
+    {
+        if (AssetStore::get_instance().start_watching_files())
+        {
+            hot_reload_worker_ = std::make_unique<BackgroundWorker>();
+        }
+    }
+
 	timer_.tick();
 
 	out_code = ENGINE_RESULT_CODE_OK;
@@ -157,6 +198,11 @@ engine::Application::~Application()
     {
         destroy_texture(default_texture_idx_);
     }
+    if (hot_reload_worker_)
+    {
+        hot_reload_worker_.reset();
+        AssetStore::get_instance().stop_watching_files();
+    }
 }
 
 engine::Scene* engine::Application::allocate_scene(const engine_scene_create_desc_t& desc)
@@ -185,11 +231,9 @@ void engine::Application::release_scene(Scene* scene)
 
 engine_result_code_t engine::Application::update_scene(Scene* scene, float delta_time)
 {
+    frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_SCENE_UPDATE);
     on_scene_update_pre(scene, delta_time);
-	const auto ret_code = scene->update(delta_time,
-		textures_atlas_.get_objects_view(),
-		geometries_atlas_.get_objects_view(),
-        shader_atlas_.get_objects_view());
+	const auto ret_code = scene->update(delta_time, textures_atlas_, geometries_atlas_, shader_atlas_, animation_clips_atlas_);
     on_scene_update_post(scene, delta_time);
 
     return ret_code;
@@ -198,10 +242,18 @@ engine_result_code_t engine::Application::update_scene(Scene* scene, float delta
 engine_application_frame_begine_info_t engine::Application::begine_frame()
 {
 	timer_.tick();
-
     engine_application_frame_begine_info_t ret{};
     ret.delta_time = static_cast<float>(timer_.delta_time().count()) / 1000.0f;
     ret.events = ENGINE_EVENT_NONE;
+    frame_stats_.begin_frame(ret.delta_time);
+    frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_EVENTS);
+
+    if (hot_reload_worker_)
+    {
+        update_hot_reload();
+    }
+    // before scenes updates, so scripts see results in the same frame
+    path_queries_.update(nav_mesh_atlas_);
 
 	for(auto& f : finger_info_buffer)
 	{
@@ -299,16 +351,37 @@ engine_application_frame_begine_info_t engine::Application::begine_frame()
 
 engine_application_frame_end_info_t engine::Application::end_frame()
 {
-    on_frame_end();
-    ui_manager_.update_state_and_render();
-    rdx_.end_frame();
+    {
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_UI);
+        on_frame_end();
+        ui_manager_.update_state_and_render();
+    }
+    {
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_PRESENT);
+        rdx_.end_frame();
+    }
+    memory::end_frame();
+    frame_stats_.end_frame();
     ENGINE_PROFILE_FRAME;
+    if (!cold_start_reported_)
+    {
+        cold_start_reported_ = true;
+        const auto cold_start_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - creation_time_);
+        const auto stats = AssetStore::get_instance().get_load_stats();
+        log::log(log::LogLevel::eTrace, fmt::format("Cold start took: {} ms. Assets: {} files from packs, {} loose files, {} KiB, {} ms spent in loading and decoding.\n",
+            cold_start_time.count(), stats.files_from_packs, stats.loose_files, stats.bytes_loaded / 1024, stats.load_time.count() / 1000));
+    }
 	engine_application_frame_end_info_t ret{};
 	//ret.success = !glfwWindowShouldClose(rdx_.get_glfw_window());;
     ret.success = true;
 	return ret;
 }
 
+std::uint32_t engine::Application::get_frame_stats(std::span<engine_frame_stats_t> out) const
+{
+    return frame_stats_.get(out);
+}
+
 std::uint32_t engine::Application::add_texture(const engine_texture_2d_create_desc_t& desc, std::string_view texture_name)
 {
     const auto data_layout = [](const auto engine_api_layout)
@@ -330,7 +403,12 @@ std::uint32_t engine::Application::add_texture(const engine_texture_2d_create_de
 
 std::uint32_t engine::Application::add_texture_from_file(std::string_view file_name, std::string_view texture_name, engine_texture_color_space_t /*color_space*/)
 {
-	return textures_atlas_.add_object(texture_name, Texture2D(file_name, true));
+	const auto ret = textures_atlas_.add_object(texture_name, Texture2D(file_name, true));
+    if (hot_reload_worker_ && ret != ENGINE_INVALID_OBJECT_HANDLE)
+    {
+        textures_sources_[ret] = std::string(file_name);
+    }
+    return ret;
 }
 
 std::uint32_t engine::Application::get_texture(std::string_view name) const
@@ -342,10 +420,13 @@ std::uint32_t engine::Application::get_texture(std::string_view name) const
 void engine::Application::destroy_texture(std::uint32_t idx)
 {
     textures_atlas_.remove_object(idx);
+    textures_sources_.erase(idx);
 }
 
 std::uint32_t engine::Application::add_nav_mesh(std::string_view name)
 {
+    // atlas can grow and move nav meshes read by path query workers
+    path_queries_.wait_for_searches();
     return nav_mesh_atlas_.add_object(name, NavMesh());
 }
 
@@ -359,9 +440,104 @@ const engine::NavMesh* engine::Application::get_nav_mesh(std::uint32_t idx) cons
     return nav_mesh_atlas_.get_object(idx);
 }
 
+engine::NavMesh* engine::Application::get_nav_mesh(std::uint32_t idx)
+{
+    // mutable access: nav mesh can't be modified while path query workers read it
+    path_queries_.wait_for_searches();
+    return nav_mesh_atlas_.get_object(idx);
+}
+
 void engine::Application::destroy_nav_mesh(std::uint32_t idx)
 {
+    path_queries_.wait_for_searches();
     nav_mesh_atlas_.remove_object(idx);
+    nav_mesh_builders_.erase(idx);
+}
+
+engine_result_code_t engine::Application::build_nav_mesh(std::uint32_t idx, const Scene* scene, const engine_nav_mesh_build_config_t& config)
+{
+    path_queries_.wait_for_searches();
+    auto* nav_mesh = nav_mesh_atlas_.get_object(idx);
+    if (!nav_mesh || !scene)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    std::vector<glm::vec3> triangles;
+    scene->get_static_collision_geometry(triangles);
+    auto& builder = nav_mesh_builders_[idx];
+    builder.build(config, triangles);
+    if (!builder.is_built())
+    {
+        nav_mesh_builders_.erase(idx);
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *nav_mesh = builder.create_nav_mesh();
+    const auto& stats = builder.get_stats();
+    log::log(log::LogLevel::eTrace, fmt::format("Nav mesh: {} built in {:.2f} ms, tiles: {}, nodes: {}, edges: {}\n", nav_mesh_atlas_.get_name(idx), stats.total_ms, stats.tiles_count, stats.nodes_count, stats.edges_count));
+    return ENGINE_RESULT_CODE_OK;
+}
+
+engine_result_code_t engine::Application::rebuild_nav_mesh_area(std::uint32_t idx, const Scene* scene, const glm::vec3& bounds_min, const glm::vec3& bounds_max)
+{
+    path_queries_.wait_for_searches();
+    auto* nav_mesh = nav_mesh_atlas_.get_object(idx);
+    const auto builder = nav_mesh_builders_.find(idx);
+    if (!nav_mesh || !scene || builder == nav_mesh_builders_.end())
+    {
+        log::log(log::LogLevel::eError, fmt::format("Nav mesh area can be rebuilt only for valid nav mesh built from scene, nav mesh: {}\n", idx));
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    std::vector<glm::vec3> triangles;
+    scene->get_static_collision_geometry(triangles);
+    builder->second.rebuild_area(triangles, bounds_min, bounds_max);
+    *nav_mesh = builder->second.create_nav_mesh();
+    return ENGINE_RESULT_CODE_OK;
+}
+
+const engine_nav_mesh_build_stats_t* engine::Application::get_nav_mesh_build_stats(std::uint32_t idx) const
+{
+    const auto builder = nav_mesh_builders_.find(idx);
+    return builder != nav_mesh_builders_.end() ? &builder->second.get_stats() : nullptr;
+}
+
+std::uint32_t engine::Application::add_nav_mesh_flow_field(std::string_view name)
+{
+    return nav_mesh_flow_field_atlas_.add_object(name, NavMeshFlowField());
+}
+
+engine::NavMeshFlowField* engine::Application::get_nav_mesh_flow_field(std::uint32_t idx)
+{
+    return nav_mesh_flow_field_atlas_.get_object(idx);
+}
+
+void engine::Application::destroy_nav_mesh_flow_field(std::uint32_t idx)
+{
+    nav_mesh_flow_field_atlas_.remove_object(idx);
+}
+
+engine_path_query_ticket_t engine::Application::submit_path_query(std::uint32_t nav_mesh, NavMeshNodeIdx start, NavMeshNodeIdx end)
+{
+    return path_queries_.submit(nav_mesh, start, end);
+}
+
+engine::PathQueryService::result_t engine::Application::get_path_query_result(engine_path_query_ticket_t ticket) const
+{
+    return path_queries_.get_result(ticket);
+}
+
+void engine::Application::release_path_query(engine_path_query_ticket_t ticket)
+{
+    path_queries_.release(ticket);
+}
+
+void engine::Application::set_path_queries_time_budget(std::chrono::microseconds budget)
+{
+    path_queries_.set_time_budget(budget);
+}
+
+bool engine::Application::mount_asset_pack(std::string_view file_name)
+{
+    return AssetStore::get_instance().mount_pack(file_name);
 }
 
 bool engine::Application::add_font_from_file(std::string_view file_name, std::string_view handle_name)
@@ -370,10 +546,22 @@ bool engine::Application::add_font_from_file(std::string_view file_name, std::st
     return res;
 }
 
-std::uint32_t engine::Application::add_geometry(const engine_vertex_attributes_layout_t& api_verts_layout, std::int32_t vertex_count, std::span<const std::byte> verts_data, std::span<const uint32_t> inds, std::string_view name)
+std::uint32_t engine::Application::add_geometry(const engine_vertex_attributes_layout_t& api_verts_layout, std::int32_t vertex_count, std::span<const std::byte> verts_data, std::span<const std::byte> inds, engine_index_data_type_t inds_type, std::string_view name)
 {
 	const auto vertex_layout = create_engine_api_layout(api_verts_layout);
-	return geometries_atlas_.add_object(name, std::move(Geometry(vertex_layout, verts_data, vertex_count, inds)));
+    const auto index_type = inds_type == ENGINE_INDEX_DATA_TYPE_UINT16 ? Geometry::IndexType::eUint16 : Geometry::IndexType::eUint32;
+	const auto ret = geometries_atlas_.add_object(name, std::move(Geometry(vertex_layout, verts_data, vertex_count, inds, index_type)));
+    if (hot_reload_worker_ && ret != ENGINE_INVALID_OBJECT_HANDLE)
+    {
+        // geometry created from model desc loaded with load_model_desc_from_file()?
+        std::scoped_lock lock(model_desc_geometries_sources_mutex_);
+        const auto it = model_desc_geometries_sources_.find(verts_data.data());
+        if (it != model_desc_geometries_sources_.end())
+        {
+            geometries_sources_[ret] = it->second;
+        }
+    }
+    return ret;
 }
 
 std::uint32_t engine::Application::get_geometry(std::string_view name) const
@@ -389,11 +577,17 @@ const engine::Geometry* engine::Application::get_geometry(std::uint32_t idx) con
 void engine::Application::destroy_geometry(std::uint32_t idx)
 {
     geometries_atlas_.remove_object(idx);
+    geometries_sources_.erase(idx);
 }
 
 std::uint32_t engine::Application::add_shader(const std::vector<std::string>& vertex_shader_name, const std::vector<std::string>& fragment_shader_name, std::string_view name)
 {
-    return shader_atlas_.add_object(name, Shader(vertex_shader_name, fragment_shader_name));
+    const auto ret = shader_atlas_.add_object(name, Shader(vertex_shader_name, fragment_shader_name));
+    if (hot_reload_worker_ && ret != ENGINE_INVALID_OBJECT_HANDLE)
+    {
+        shaders_sources_[ret] = shader_source_t{ vertex_shader_name, fragment_shader_name };
+    }
+    return ret;
 }
 
 std::uint32_t engine::Application::get_shader(std::string_view name) const
@@ -404,6 +598,36 @@ std::uint32_t engine::Application::get_shader(std::string_view name) const
 void engine::Application::destroy_shader(std::uint32_t idx)
 {
     shader_atlas_.remove_object(idx);
+    shaders_sources_.erase(idx);
+}
+
+std::uint32_t engine::Application::add_animation_clip(const engine_model_desc_t& model_desc, std::uint32_t animation_index, std::string_view name)
+{
+    const auto model_info = reinterpret_cast<const engine::ModelInfo*>(model_desc.internal_handle);
+    assert(model_info);
+    assert(animation_index < model_info->animations.size());
+    AnimationClip clip(model_info->animations[animation_index], *model_info);
+    if (!clip.is_valid())
+    {
+        log::log(log::LogLevel::eError, fmt::format("Animation: {} has no valid channels. Cant create animation clip: {}\n", model_info->animations[animation_index].name, name));
+        return ENGINE_INVALID_OBJECT_HANDLE;
+    }
+    return animation_clips_atlas_.add_object(name, std::move(clip));
+}
+
+std::uint32_t engine::Application::get_animation_clip(std::string_view name) const
+{
+    return animation_clips_atlas_.get_object(name);
+}
+
+const engine::AnimationClip* engine::Application::get_animation_clip(std::uint32_t idx) const
+{
+    return animation_clips_atlas_.get_object(idx);
+}
+
+void engine::Application::destroy_animation_clip(std::uint32_t idx)
+{
+    animation_clips_atlas_.remove_object(idx);
 }
 
 engine_model_desc_t engine::Application::load_model_desc_from_file(engine_model_specification_t spec, std::string_view name, std::string_view base_dir)
@@ -417,7 +641,10 @@ engine_model_desc_t engine::Application::load_model_desc_from_file(engine_model_
     }
 
     const auto assets_dir = engine::AssetStore::get_instance().get_textures_base_path()/base_dir;
-    const auto model_info = new engine::ModelInfo(parse_gltf_data_from_memory({ file_data.get_data_ptr(), file_data.get_size() }, assets_dir.string()));
+    ModelImportOptions import_options{};
+    import_options.optimize_meshes = optimize_meshes_;
+    import_options.compress_animations = compress_animations_;
+    const auto model_info = new engine::ModelInfo(parse_gltf_data_from_memory({ file_data.get_data_ptr(), file_data.get_size() }, assets_dir.string(), import_options));
 
     engine_model_desc_t ret{};
     ret.internal_handle = reinterpret_cast<const void*>(model_info);
@@ -475,13 +702,20 @@ engine_model_desc_t engine::Application::load_model_desc_from_file(engine_model_
             const auto& int_g = model_info->geometries[i];
             auto& ret_g = ret.geometries_array[i];
 
-            ret_g.inds_count = int_g.indicies.size();
-            ret_g.inds = int_g.indicies.data();
+            ret_g.inds_count = int_g.index_count;
+            ret_g.inds = int_g.index_data.data();
+            ret_g.inds_data_type = int_g.index_data_type;
 
             ret_g.verts_data_size = int_g.vertex_data.size();
             ret_g.verts_data = int_g.vertex_data.data();
             ret_g.verts_layout = int_g.vertex_laytout;
             ret_g.verts_count = int_g.vertex_count;
+
+            if (hot_reload_worker_)
+            {
+                std::scoped_lock lock(model_desc_geometries_sources_mutex_);
+                model_desc_geometries_sources_[ret_g.verts_data] = geometry_source_t{ std::string(name), std::string(base_dir), static_cast<std::uint32_t>(i) };
+            }
         }
 
     }
@@ -608,6 +842,11 @@ void engine::Application::release_model_desc(engine_model_desc_t* info)
         delete model_info;
         if (info->geometries_array)
         {
+            std::scoped_lock lock(model_desc_geometries_sources_mutex_);
+            for (std::uint32_t i = 0; i < info->geometries_count; i++)
+            {
+                model_desc_geometries_sources_.erase(info->geometries_array[i].verts_data);
+            }
             delete[] info->geometries_array;
         }
         if (info->textures_array)
@@ -641,6 +880,166 @@ void engine::Application::release_model_desc(engine_model_desc_t* info)
     }
 }
 
+void engine::Application::update_hot_reload()
+{
+    ENGINE_PROFILE_SECTION_N("hot_reload");
+    auto& asset_store = AssetStore::get_instance();
+    const auto changed_files = asset_store.poll_changed_files();
+    for (const auto& changed_file : changed_files)
+    {
+        log::log(log::LogLevel::eTrace, fmt::format("[Hot reload] File changed: {}\n", changed_file.string()));
+        const auto is_same_file = [&changed_file](const std::filesystem::path& p)
+        {
+            return p.lexically_normal() == changed_file.lexically_normal();
+        };
+
+        for (const auto& [handle, file_name] : textures_sources_)
+        {
+            if (is_same_file(asset_store.get_textures_base_path() / file_name))
+            {
+                reload_texture(handle, file_name);
+            }
+        }
+
+        for (const auto& [handle, src] : shaders_sources_)
+        {
+            const auto uses_file = [&](const std::vector<std::string>& names)
+            {
+                return std::any_of(names.begin(), names.end(), [&](const auto& n) { return is_same_file(asset_store.get_shaders_base_path() / n); });
+            };
+            if (uses_file(src.vertex_shader_name) || uses_file(src.fragment_shader_name))
+            {
+                reload_shader(handle, src.vertex_shader_name, src.fragment_shader_name);
+            }
+        }
+
+        // model file is parsed once, all geometries created from it are updated together
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> geometries_to_reload;
+        const geometry_source_t* model_source = nullptr;
+        for (const auto& [handle, src] : geometries_sources_)
+        {
+            if (is_same_file(asset_store.get_models_base_path() / src.file_name))
+            {
+                geometries_to_reload.push_back({ handle, src.geometry_index });
+                model_source = &src;
+            }
+        }
+        if (model_source)
+        {
+            reload_model_geometries(model_source->file_name, model_source->base_dir, std::move(geometries_to_reload));
+        }
+
+        // RmlUi isn't thread safe, documents are parsed here on the main thread
+        if (ui_manager_.is_document_loaded(changed_file))
+        {
+            const auto file_data = read_hot_reloaded_file(changed_file);
+            ui_manager_.reload_documents(changed_file, std::string_view(reinterpret_cast<const char*>(file_data.get_data_ptr()), file_data.get_size()));
+        }
+    }
+
+    // swap of the reloaded objects happens here, on the main thread, between frames
+    hot_reload_worker_->execute_completed();
+}
+
+void engine::Application::reload_texture(std::uint32_t handle, const std::string& file_name)
+{
+    hot_reload_worker_->submit([this, handle, file_name]() -> BackgroundWorker::MainThreadCallback
+    {
+        // decode in background, std::function requires copyable callable
+        const auto file_data = read_hot_reloaded_file(AssetStore::get_instance().get_textures_base_path() / file_name);
+        auto texture_data = std::make_shared<TextureAssetContext>(std::span<const std::uint8_t>(file_data.get_data_ptr(), file_data.get_size()));
+        return [this, handle, file_name, texture_data]()
+        {
+            auto* texture = textures_atlas_.get_object(handle);
+            if (!texture)
+            {
+                // destroyed while reloading
+                return;
+            }
+            if (texture_data->get_data_ptr() == nullptr)
+            {
+                log::log(log::LogLevel::eError, fmt::format("[Hot reload] Failed to decode texture: {}\n", file_name));
+                return;
+            }
+            *texture = Texture2D(*texture_data, true);
+            log::log(log::LogLevel::eTrace, fmt::format("[Hot reload] Reloaded texture: {}\n", file_name));
+        };
+    });
+}
+
+void engine::Application::reload_shader(std::uint32_t handle, const std::vector<std::string>& vertex_shader_name, const std::vector<std::string>& fragment_shader_name)
+{
+    hot_reload_worker_->submit([this, handle, vertex_shader_name, fragment_shader_name]() -> BackgroundWorker::MainThreadCallback
+    {
+        auto load_sources = [](const std::vector<std::string>& names)
+        {
+            std::vector<std::string> sources;
+            sources.reserve(names.size());
+            std::for_each(names.begin(), names.end(), [&sources](const auto& s)
+                {
+                    const auto file_data = read_hot_reloaded_file(AssetStore::get_instance().get_shaders_base_path() / s);
+                    sources.emplace_back(reinterpret_cast<const char*>(file_data.get_data_ptr()), file_data.get_size());
+                });
+            return sources;
+        };
+        return [this, handle, vs_sources = load_sources(vertex_shader_name), fs_sources = load_sources(fragment_shader_name)]()
+        {
+            auto* shader = shader_atlas_.get_object(handle);
+            if (!shader)
+            {
+                return;
+            }
+            auto new_shader = Shader::create_from_sources(vs_sources, fs_sources);
+            if (!new_shader.is_valid())
+            {
+                // keep old program, so the app keeps running until shader is fixed
+                log::log(log::LogLevel::eError, fmt::format("[Hot reload] Failed to reload shader: {}\n", shader_atlas_.get_name(handle)));
+                return;
+            }
+            *shader = std::move(new_shader);
+            log::log(log::LogLevel::eTrace, fmt::format("[Hot reload] Reloaded shader: {}\n", shader_atlas_.get_name(handle)));
+        };
+    });
+}
+
+void engine::Application::reload_model_geometries(const std::string& file_name, const std::string& base_dir, std::vector<std::pair<std::uint32_t, std::uint32_t>> handles_with_indices)
+{
+    ModelImportOptions import_options{};
+    import_options.optimize_meshes = optimize_meshes_;
+    import_options.compress_animations = compress_animations_;
+    hot_reload_worker_->submit([this, file_name, base_dir, import_options, handles_with_indices = std::move(handles_with_indices)]() -> BackgroundWorker::MainThreadCallback
+    {
+        const auto& asset_store = AssetStore::get_instance();
+        const auto file_data = read_hot_reloaded_file(asset_store.get_models_base_path() / file_name);
+        auto model_info = std::make_shared<ModelInfo>();
+        if (file_data.get_size() != 0)
+        {
+            const auto assets_dir = asset_store.get_textures_base_path() / base_dir;
+            *model_info = parse_gltf_data_from_memory({ file_data.get_data_ptr(), file_data.get_size() }, assets_dir.string(), import_options);
+        }
+        return [this, file_name, model_info, handles_with_indices]()
+        {
+            for (const auto& [handle, geometry_index] : handles_with_indices)
+            {
+                auto* geometry = geometries_atlas_.get_object(handle);
+                if (!geometry)
+                {
+                    continue;
+                }
+                if (geometry_index >= model_info->geometries.size())
+                {
+                    log::log(log::LogLevel::eError, fmt::format("[Hot reload] Model: {} doesnt have geometry: {} anymore.\n", file_name, geometry_index));
+                    continue;
+                }
+                const auto& g = model_info->geometries[geometry_index];
+                const auto index_type = g.index_data_type == ENGINE_INDEX_DATA_TYPE_UINT16 ? Geometry::IndexType::eUint16 : Geometry::IndexType::eUint32;
+                *geometry = Geometry(create_engine_api_layout(g.vertex_laytout), g.vertex_data, g.vertex_count, g.index_data, index_type);
+            }
+            log::log(log::LogLevel::eTrace, fmt::format("[Hot reload] Reloaded model: {}\n", file_name));
+        };
+    });
+}
+
 engine::UiDocument engine::Application::load_ui_document(std::string_view file_name)
 {
     return ui_manager_.load_document_from_file(file_name);
@@ -7,9 +7,21 @@
 #include "ui_document.h"
 #include "named_atlas.h"
 #include "nav_mesh.h"
+#include "nav_mesh_builder.h"
+#include "path_query_service.h"
+#include "animation.h"
+#include "background_worker.h"
+#include "frame_stats.h"
 
 #include <array>
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+#include <span>
 
 namespace engine
 {
@@ -29,6 +41,8 @@ public:
     virtual engine_result_code_t update_scene(class Scene* scene, float delta_time);
     virtual engine_application_frame_begine_info_t begine_frame();
     virtual engine_application_frame_end_info_t end_frame();
+    // newest first
+    std::uint32_t get_frame_stats(std::span<engine_frame_stats_t> out) const;
 
     virtual std::uint32_t add_texture(const engine_texture_2d_create_desc_t& desc, std::string_view texture_name);
     virtual std::uint32_t add_texture_from_file(std::string_view file_name, std::string_view texture_name, engine_texture_color_space_t color_space);
@@ -38,11 +52,26 @@ public:
     virtual std::uint32_t add_nav_mesh(std::string_view name);
     virtual std::uint32_t get_nav_mesh(std::string_view name) const;
     virtual const NavMesh* get_nav_mesh(std::uint32_t idx) const;
+    virtual NavMesh* get_nav_mesh(std::uint32_t idx);
     virtual void destroy_nav_mesh(std::uint32_t idx);
+    virtual engine_result_code_t build_nav_mesh(std::uint32_t idx, const class Scene* scene, const engine_nav_mesh_build_config_t& config);
+    virtual engine_result_code_t rebuild_nav_mesh_area(std::uint32_t idx, const class Scene* scene, const glm::vec3& bounds_min, const glm::vec3& bounds_max);
+    virtual const engine_nav_mesh_build_stats_t* get_nav_mesh_build_stats(std::uint32_t idx) const;
+
+    virtual std::uint32_t add_nav_mesh_flow_field(std::string_view name);
+    virtual NavMeshFlowField* get_nav_mesh_flow_field(std::uint32_t idx);
+    virtual void destroy_nav_mesh_flow_field(std::uint32_t idx);
+
+    virtual engine_path_query_ticket_t submit_path_query(std::uint32_t nav_mesh, NavMeshNodeIdx start, NavMeshNodeIdx end);
+    virtual PathQueryService::result_t get_path_query_result(engine_path_query_ticket_t ticket) const;
+    virtual void release_path_query(engine_path_query_ticket_t ticket);
+    virtual void set_path_queries_time_budget(std::chrono::microseconds budget);
+
+    virtual bool mount_asset_pack(std::string_view file_name);
 
     virtual bool add_font_from_file(std::string_view file_name, std::string_view handle_name);
 
-    virtual std::uint32_t add_geometry(const engine_vertex_attributes_layout_t& verts_layout, std::int32_t vertex_count, std::span<const std::byte> verts_data, std::span<const uint32_t> inds, std::string_view name);
+    virtual std::uint32_t add_geometry(const engine_vertex_attributes_layout_t& verts_layout, std::int32_t vertex_count, std::span<const std::byte> verts_data, std::span<const std::byte> inds, engine_index_data_type_t inds_type, std::string_view name);
     virtual std::uint32_t get_geometry(std::string_view name) const;
     virtual const Geometry* get_geometry(std::uint32_t idx) const;
     virtual void destroy_geometry(std::uint32_t idx);
@@ -51,6 +80,11 @@ public:
     virtual std::uint32_t get_shader(std::string_view name) const;
     virtual void destroy_shader(std::uint32_t idx);
 
+    virtual std::uint32_t add_animation_clip(const engine_model_desc_t& model_desc, std::uint32_t animation_index, std::string_view name);
+    virtual std::uint32_t get_animation_clip(std::string_view name) const;
+    virtual const AnimationClip* get_animation_clip(std::uint32_t idx) const;
+    virtual void destroy_animation_clip(std::uint32_t idx);
+
     virtual engine_model_desc_t load_model_desc_from_file(engine_model_specification_t spec, std::string_view name, std::string_view base_dir);
     virtual void release_model_desc(engine_model_desc_t* info);
 
@@ -76,19 +110,59 @@ protected:
     virtual void on_scene_update_pre(class Scene* scene, float delta_time) {}
     virtual void on_scene_update_post(class Scene* scene, float delta_time) {}
 
+private:
+    void update_hot_reload();
+    void reload_texture(std::uint32_t handle, const std::string& file_name);
+    void reload_shader(std::uint32_t handle, const std::vector<std::string>& vertex_shader_name, const std::vector<std::string>& fragment_shader_name);
+    void reload_model_geometries(const std::string& file_name, const std::string& base_dir, std::vector<std::pair<std::uint32_t, std::uint32_t>> handles_with_indices);
+
 protected:
     RenderContext rdx_;
     GameTimer timer_;
+    // cold start: from application creation to the end of the first frame
+    std::chrono::steady_clock::time_point creation_time_;
+    bool cold_start_reported_ = false;
+    FrameStatsHistory frame_stats_;
 
+    bool optimize_meshes_;
+    bool compress_animations_;
     engine_texture2d_t default_texture_idx_;
     engine_material_t default_material_;
     Atlas<Texture2D> textures_atlas_;
     Atlas<Geometry> geometries_atlas_;
     Atlas<NavMesh> nav_mesh_atlas_;
+    // tiles cache of nav meshes generated from scenes, for incremental rebuilds
+    std::unordered_map<std::uint32_t, NavMeshBuilder> nav_mesh_builders_;
+    Atlas<NavMeshFlowField> nav_mesh_flow_field_atlas_;
+    // declared after nav meshes, so workers are stopped before meshes are destroyed
+    PathQueryService path_queries_;
     Atlas<Shader> shader_atlas_;
+    Atlas<AnimationClip> animation_clips_atlas_;
 
     UiManager ui_manager_;
     std::array<engine_finger_info_t, 10> finger_info_buffer;
+
+    // hot reload: files used to create atlas objects, tracked only when hot reload is enabled
+    struct shader_source_t
+    {
+        std::vector<std::string> vertex_shader_name;
+        std::vector<std::string> fragment_shader_name;
+    };
+    struct geometry_source_t
+    {
+        std::string file_name;
+        std::string base_dir;
+        std::uint32_t geometry_index;
+    };
+    std::unordered_map<std::uint32_t, std::string> textures_sources_;
+    std::unordered_map<std::uint32_t, shader_source_t> shaders_sources_;
+    std::unordered_map<std::uint32_t, geometry_source_t> geometries_sources_;
+    // vertex data pointer of not yet released model desc -> geometry source, used to match add_geometry() with loaded model
+    // model descs can be loaded on background threads (i.e. scene streaming)
+    std::mutex model_desc_geometries_sources_mutex_;
+    std::unordered_map<const void*, geometry_source_t> model_desc_geometries_sources_;
+    // declared after atlases, so pending callbacks are destroyed before objects they refer to
+    std::unique_ptr<BackgroundWorker> hot_reload_worker_;
 };
 
 }  // namespace engine
\ No newline at end of file
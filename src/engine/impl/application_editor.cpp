@@ -11,11 +11,31 @@
 
 #include <string>
 #include <map>
-#include <numeric>
+#include <array>
 
 namespace
 {
 constexpr const char* g_editor_camera_name = "__engine__camera-editor__";
+// indexed with engine_frame_stage_t
+constexpr std::array<const char*, ENGINE_FRAME_STAGE_COUNT> g_frame_stage_names =
+{
+    "Events",
+    "Scene update",
+    "  Command buffer",
+    "  Animation",
+    "  Crowd",
+    "  Physics",
+    "  Transforms",
+    "  Hierarchy",
+    "  Lights",
+    "  Render geometry",
+    "  Render skinned geometry",
+    "  Render sprites",
+    "  Render debug",
+    "  Post process",
+    "UI",
+    "Present",
+};
 inline auto get_spherical_coordinates(const auto& cartesian)
 {
     const float r = std::sqrt(
@@ -627,7 +647,7 @@ engine::ApplicationEditor::~ApplicationEditor()
     ImGui::DestroyContext();
 }
 
-void engine::ApplicationEditor::on_frame_begine(const engine_application_frame_begine_info_t & frame_begin_info)
+void engine::ApplicationEditor::on_frame_begine(const engine_application_frame_begine_info_t&)
 {
     ImGui_ImplSDL3_NewFrame();
     ImGui_ImplOpenGL3_NewFrame();
@@ -638,13 +658,35 @@ void engine::ApplicationEditor::on_frame_begine(const engine_application_frame_b
     {
         editor_controlling_scene_ = !editor_controlling_scene_;
     }
-    assert(frame_begin_info.delta_time > 0.0f);
-    static float avg_fps = 0; 
-    static std::vector<float> fps_values(60);
-    static std::size_t fps_idx = 0;
-    fps_values[fps_idx % fps_values.size()] = 1000.0f / frame_begin_info.delta_time;
-    fps_idx++;
-    ImGui::Text("FPS: %d", static_cast<std::uint32_t>(std::accumulate(fps_values.begin(), fps_values.end(), 0) / (fps_idx < fps_values.size() ? fps_idx : fps_values.size())));
+    std::array<engine_frame_stats_t, ENGINE_FRAME_STATS_HISTORY_SIZE> frames{};
+    const auto frames_count = get_frame_stats(frames);
+    if (frames_count > 0)
+    {
+        float delta_time_sum = 0.0f;
+        float cpu_time_sum = 0.0f;
+        std::array<float, ENGINE_FRAME_STATS_HISTORY_SIZE> cpu_times{};
+        for (std::uint32_t i = 0; i < frames_count; i++)
+        {
+            delta_time_sum += frames[i].delta_time_ms;
+            cpu_time_sum += frames[i].cpu_time_ms;
+            // plotted from the oldest
+            cpu_times[frames_count - 1 - i] = frames[i].cpu_time_ms;
+        }
+        const auto& last = frames[0];
+        ImGui::Text("FPS: %.1f (%.2f ms)", delta_time_sum > 0.0f ? 1000.0f * frames_count / delta_time_sum : 0.0f, delta_time_sum / frames_count);
+        ImGui::Text("CPU: %.2f ms", cpu_time_sum / frames_count);
+        ImGui::PlotLines("##cpu_times", cpu_times.data(), static_cast<int>(frames_count));
+        ImGui::Text("Draw calls: %u, triangles: %llu", last.draw_calls, static_cast<unsigned long long>(last.triangles));
+        ImGui::Text("State changes: %u", last.state_changes);
+        ImGui::Text("Entities: %u (scenes: %u)", last.entities_count, last.scenes_updated);
+        if (ImGui::CollapsingHeader("Frame stages"))
+        {
+            for (std::uint32_t i = 0; i < ENGINE_FRAME_STAGE_COUNT; i++)
+            {
+                ImGui::Text("%s: %.3f ms", g_frame_stage_names[i], last.stages_ms[i]);
+            }
+        }
+    }
     ImGui::End();
 }
 
@@ -0,0 +1,316 @@
+#include "asset_pack.h"
+#include "logger.h"
+
+#include <fmt/format.h>
+#include <zstd.h>
+
+#include <SDL3/SDL_iostream.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ENGINE_ASSET_PACK_POSIX_MMAP 1
+#endif
+
+namespace
+{
+// overflow safe check, that range [offset, offset + size) is inside of the file
+inline bool is_in_file(std::uint64_t offset, std::uint64_t size, std::uint64_t file_size)
+{
+    return offset <= file_size && size <= file_size - offset;
+}
+}  // namespace anonymous
+
+engine::AssetPack::AssetPack(const std::filesystem::path& file_path)
+    : file_path_(file_path)
+{
+    if (!map_file())
+    {
+        io_ = SDL_IOFromFile(file_path_.string().c_str(), "rb");
+        if (!io_)
+        {
+            log::log(log::LogLevel::eError, fmt::format("Couldnt open asset pack: {}. Error msg: {}\n", file_path_.string(), SDL_GetError()));
+            return;
+        }
+        io_mutex_ = std::make_unique<std::mutex>();
+    }
+
+    if (!read_bytes(0, &header_, sizeof(header_)) || header_.magic != K_ASSET_PACK_MAGIC)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Asset pack: {} has invalid header.\n", file_path_.string()));
+        return;
+    }
+    if (header_.version != K_ASSET_PACK_VERSION)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Asset pack: {} has unsupported version: {}, expected: {}.\n", file_path_.string(), header_.version, K_ASSET_PACK_VERSION));
+        return;
+    }
+
+    // sizes from the header are validated before anything is allocated, so corrupted pack can't request huge allocations
+    const auto file_size = mapped_data_ ? static_cast<std::int64_t>(mapped_size_) : SDL_GetIOSize(io_);
+    if (file_size < 0 || header_.file_size > static_cast<std::uint64_t>(file_size)
+        || !is_in_file(header_.toc_offset, static_cast<std::uint64_t>(header_.entry_count) * sizeof(asset_pack_toc_entry_t), header_.file_size)
+        || !is_in_file(header_.names_offset, header_.names_size, header_.file_size))
+    {
+        log::log(log::LogLevel::eError, fmt::format("Asset pack: {} is truncated or corrupted.\n", file_path_.string()));
+        return;
+    }
+
+    toc_.resize(header_.entry_count);
+    names_.resize(header_.names_size);
+    if (!read_bytes(header_.toc_offset, toc_.data(), toc_.size() * sizeof(asset_pack_toc_entry_t))
+        || !read_bytes(header_.names_offset, names_.data(), names_.size()))
+    {
+        log::log(log::LogLevel::eError, fmt::format("Asset pack: {} is truncated.\n", file_path_.string()));
+        toc_.clear();
+        names_.clear();
+        return;
+    }
+    const auto is_entry_valid = [this](const asset_pack_toc_entry_t& e)
+    {
+        const auto name_fits = static_cast<std::uint64_t>(e.name_offset) + e.name_size <= names_.size();
+        const auto data_fits = is_in_file(e.data_offset, e.stored_size, header_.file_size);
+        // uncompressed entries are read directly into buffer of original size
+        const auto sizes_match = e.compression != AssetPackCompression::eNone || e.stored_size == e.original_size;
+        return name_fits && data_fits && sizes_match;
+    };
+    const auto is_sorted = std::is_sorted(toc_.begin(), toc_.end(), [](const auto& a, const auto& b) { return a.name_hash < b.name_hash; });
+    if (!is_sorted || !std::all_of(toc_.begin(), toc_.end(), is_entry_valid))
+    {
+        log::log(log::LogLevel::eError, fmt::format("Asset pack: {} has corrupted table of contents.\n", file_path_.string()));
+        toc_.clear();
+        names_.clear();
+        return;
+    }
+    valid_ = true;
+}
+
+engine::AssetPack::AssetPack(AssetPack&& rhs) noexcept
+{
+    std::swap(file_path_, rhs.file_path_);
+    std::swap(valid_, rhs.valid_);
+    std::swap(header_, rhs.header_);
+    std::swap(toc_, rhs.toc_);
+    std::swap(names_, rhs.names_);
+    std::swap(mapped_data_, rhs.mapped_data_);
+    std::swap(mapped_size_, rhs.mapped_size_);
+    std::swap(mapping_handle_, rhs.mapping_handle_);
+    std::swap(io_, rhs.io_);
+    std::swap(io_mutex_, rhs.io_mutex_);
+}
+
+engine::AssetPack& engine::AssetPack::operator=(AssetPack&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        std::swap(file_path_, rhs.file_path_);
+        std::swap(valid_, rhs.valid_);
+        std::swap(header_, rhs.header_);
+        std::swap(toc_, rhs.toc_);
+        std::swap(names_, rhs.names_);
+        std::swap(mapped_data_, rhs.mapped_data_);
+        std::swap(mapped_size_, rhs.mapped_size_);
+        std::swap(mapping_handle_, rhs.mapping_handle_);
+        std::swap(io_, rhs.io_);
+        std::swap(io_mutex_, rhs.io_mutex_);
+    }
+    return *this;
+}
+
+engine::AssetPack::~AssetPack()
+{
+    unmap_file();
+    if (io_)
+    {
+        SDL_CloseIO(io_);
+        io_ = nullptr;
+    }
+}
+
+const engine::asset_pack_toc_entry_t* engine::AssetPack::find_entry(std::string_view name) const
+{
+    const auto hash = asset_pack_hash_name(name);
+    auto it = std::lower_bound(toc_.begin(), toc_.end(), hash, [](const auto& entry, std::uint64_t h) { return entry.name_hash < h; });
+    // hash collisions are resolved by comparing names
+    for (; it != toc_.end() && it->name_hash == hash; ++it)
+    {
+        if (get_entry_name(*it) == name)
+        {
+            return &(*it);
+        }
+    }
+    return nullptr;
+}
+
+bool engine::AssetPack::read_entry(const asset_pack_toc_entry_t& entry, std::vector<std::uint8_t>& out) const
+{
+    if (entry.compression == AssetPackCompression::eNone)
+    {
+        out.resize(entry.original_size);
+        return read_bytes(entry.data_offset, out.data(), entry.stored_size);
+    }
+
+    if (entry.compression != AssetPackCompression::eZstd)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Unknown compression of entry: {} in asset pack: {}\n", get_entry_name(entry), file_path_.string()));
+        return false;
+    }
+
+    std::vector<std::uint8_t> staging;
+    const void* src = nullptr;
+    if (mapped_data_)
+    {
+        src = mapped_data_ + entry.data_offset;
+    }
+    else
+    {
+        staging.resize(entry.stored_size);
+        if (!read_bytes(entry.data_offset, staging.data(), staging.size()))
+        {
+            return false;
+        }
+        src = staging.data();
+    }
+    // original size isn't trusted before it's confirmed by the zstd frame header
+    if (ZSTD_getFrameContentSize(src, entry.stored_size) != entry.original_size)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Entry: {} in asset pack: {} is corrupted.\n", get_entry_name(entry), file_path_.string()));
+        out.clear();
+        return false;
+    }
+    out.resize(entry.original_size);
+    const auto result = ZSTD_decompress(out.data(), out.size(), src, entry.stored_size);
+    if (ZSTD_isError(result) || result != entry.original_size)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Failed to decompress entry: {} in asset pack: {}. Error msg: {}\n",
+            get_entry_name(entry), file_path_.string(), ZSTD_isError(result) ? ZSTD_getErrorName(result) : "size mismatch"));
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+std::span<const std::uint8_t> engine::AssetPack::get_mapped_entry(const asset_pack_toc_entry_t& entry) const
+{
+    if (!mapped_data_ || entry.compression != AssetPackCompression::eNone)
+    {
+        return {};
+    }
+    return { mapped_data_ + entry.data_offset, entry.stored_size };
+}
+
+bool engine::AssetPack::map_file()
+{
+#if defined(_WIN32)
+    const auto file = CreateFileW(file_path_.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // mapping keeps reference to the file
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return false;
+    }
+    const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_handle_ = mapping;
+    mapped_data_ = static_cast<const std::uint8_t*>(view);
+    mapped_size_ = static_cast<std::uint64_t>(size.QuadPart);
+    return true;
+#elif ENGINE_ASSET_PACK_POSIX_MMAP
+    const auto fd = open(file_path_.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+    auto* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping keeps reference to the file
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+    mapped_data_ = static_cast<const std::uint8_t*>(view);
+    mapped_size_ = static_cast<std::uint64_t>(st.st_size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void engine::AssetPack::unmap_file()
+{
+    if (!mapped_data_)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(mapped_data_);
+    CloseHandle(mapping_handle_);
+#elif ENGINE_ASSET_PACK_POSIX_MMAP
+    munmap(const_cast<std::uint8_t*>(mapped_data_), static_cast<std::size_t>(mapped_size_));
+#endif
+    mapped_data_ = nullptr;
+    mapped_size_ = 0;
+    mapping_handle_ = nullptr;
+}
+
+bool engine::AssetPack::read_bytes(std::uint64_t offset, void* dst, std::uint64_t size) const
+{
+    if (size == 0)
+    {
+        return true;
+    }
+    if (mapped_data_)
+    {
+        if (offset + size > mapped_size_)
+        {
+            return false;
+        }
+        std::memcpy(dst, mapped_data_ + offset, size);
+        return true;
+    }
+    if (!io_)
+    {
+        return false;
+    }
+    std::scoped_lock lock(*io_mutex_);
+    if (SDL_SeekIO(io_, static_cast<Sint64>(offset), SDL_IO_SEEK_SET) < 0)
+    {
+        return false;
+    }
+    return SDL_ReadIO(io_, dst, size) == size;
+}
+
+std::string_view engine::AssetPack::get_entry_name(const asset_pack_toc_entry_t& entry) const
+{
+    if (static_cast<std::uint64_t>(entry.name_offset) + entry.name_size > names_.size())
+    {
+        return {};
+    }
+    return { names_.data() + entry.name_offset, entry.name_size };
+}
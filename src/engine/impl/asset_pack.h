@@ -0,0 +1,64 @@
+#pragma once
+#include "asset_pack_format.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+struct SDL_IOStream;
+
+namespace engine
+{
+// Read only view of the asset pack (see asset_pack_format.h).
+// File is memory mapped when platform allows it, otherwise entries are read with SDL IO (i.e. from android APK).
+// Safe to read from multiple threads.
+class AssetPack
+{
+public:
+    AssetPack() = default;
+    AssetPack(const std::filesystem::path& file_path);
+    AssetPack(const AssetPack& rhs) = delete;
+    AssetPack(AssetPack&& rhs) noexcept;
+    AssetPack& operator=(const AssetPack& rhs) = delete;
+    AssetPack& operator=(AssetPack&& rhs) noexcept;
+    ~AssetPack();
+
+    bool is_valid() const { return valid_; }
+    std::uint32_t get_entry_count() const { return header_.entry_count; }
+    const std::filesystem::path& get_file_path() const { return file_path_; }
+
+    // O(log n) lookup, nullptr if pack doesnt contain the file
+    const asset_pack_toc_entry_t* find_entry(std::string_view name) const;
+    // decompresses (or copies) entry data
+    bool read_entry(const asset_pack_toc_entry_t& entry, std::vector<std::uint8_t>& out) const;
+    // zero copy access, valid only for uncompressed entries of memory mapped packs, empty span otherwise
+    // memory stays valid as long as the pack is alive
+    std::span<const std::uint8_t> get_mapped_entry(const asset_pack_toc_entry_t& entry) const;
+
+private:
+    bool map_file();
+    void unmap_file();
+    bool read_bytes(std::uint64_t offset, void* dst, std::uint64_t size) const;
+    std::string_view get_entry_name(const asset_pack_toc_entry_t& entry) const;
+
+private:
+    std::filesystem::path file_path_;
+    bool valid_ = false;
+    asset_pack_header_t header_{};
+    std::vector<asset_pack_toc_entry_t> toc_;
+    std::vector<char> names_;
+
+    // memory mapped file
+    const std::uint8_t* mapped_data_ = nullptr;
+    std::uint64_t mapped_size_ = 0;
+    void* mapping_handle_ = nullptr; // windows only
+
+    // fallback when mapping is not possible
+    SDL_IOStream* io_ = nullptr;
+    std::unique_ptr<std::mutex> io_mutex_;
+};
+}  // namespace engine
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// On disk layout of the asset pack (*.epak). Shared by engine (reader) and asset_packer tool (writer).
+// Header only and without engine dependencies on purpose.
+//
+// [header][toc entries sorted by name hash][names blob][data of entries]
+// Uncompressed entries start at K_ASSET_PACK_PAGE_ALIGNMENT, so they can be used directly from memory mapped file.
+// All values are little endian.
+namespace engine
+{
+constexpr inline std::array<char, 4> K_ASSET_PACK_MAGIC = { 'E', 'P', 'A', 'K' };
+constexpr inline std::uint32_t K_ASSET_PACK_VERSION = 1;
+constexpr inline std::uint64_t K_ASSET_PACK_PAGE_ALIGNMENT = 4096;
+constexpr inline std::uint64_t K_ASSET_PACK_COMPRESSED_ALIGNMENT = 16;
+constexpr inline std::string_view K_ASSET_PACK_EXTENSION = ".epak";
+
+enum class AssetPackCompression : std::uint32_t
+{
+    eNone = 0,
+    eZstd = 1,
+};
+
+struct asset_pack_header_t
+{
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint32_t reserved;
+    std::uint64_t toc_offset;
+    std::uint64_t names_offset;
+    std::uint64_t names_size;
+    std::uint64_t file_size;
+};
+static_assert(sizeof(asset_pack_header_t) == 48);
+
+struct asset_pack_toc_entry_t
+{
+    std::uint64_t name_hash;
+    std::uint64_t data_offset;
+    std::uint64_t stored_size;   // size in the pack
+    std::uint64_t original_size; // size after decompression
+    std::uint32_t name_offset;   // offset in names blob, names are not null terminated
+    std::uint32_t name_size;
+    AssetPackCompression compression;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(asset_pack_toc_entry_t) == 48);
+
+// FNV-1a, entry names are relative to assets base path with '/' as separator (i.e. "textures/grass.png")
+constexpr inline std::uint64_t asset_pack_hash_name(std::string_view name)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const auto c : name)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+constexpr inline std::uint64_t asset_pack_align(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+}  // namespace engine
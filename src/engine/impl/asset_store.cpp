@@ -16,6 +16,14 @@
 
 #include <SDL3/SDL_iostream.h>
 
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#define ENGINE_ASSET_STORE_FILE_WATCHER 1
+#else
+#define ENGINE_ASSET_STORE_FILE_WATCHER 0
+#endif
+
 namespace
 {
 template<typename T>
@@ -65,6 +73,17 @@ engine::TextureAssetContext::TextureAssetContext(const std::filesystem::path& fi
 	//stbi_set_flip_vertically_on_load(false);
 }
 
+engine::TextureAssetContext::TextureAssetContext(std::span<const std::uint8_t> encoded_data)
+	: width_(0)
+	, height_(0)
+	, channels_(0)
+	, data_(nullptr)
+	, type_(TextureAssetDataType::eCount)
+{
+	data_ = stbi_load_from_memory(encoded_data.data(), static_cast<int>(encoded_data.size()), &width_, &height_, &channels_, 0);
+	type_ = TextureAssetDataType::eUchar8;
+}
+
 engine::TextureAssetContext::TextureAssetContext(TextureAssetContext&& rhs)
 	: width_(rhs.width_)
 	, height_(rhs.height_)
@@ -127,7 +146,12 @@ std::filesystem::path engine::AssetStore::get_textures_base_path() const
 engine::TextureAssetContext engine::AssetStore::get_texture_data(std::string_view name) const
 {
 	const auto full_path = get_textures_base_path() / name.data();
-	return TextureAssetContext(full_path);
+    // read through get_file_data() and decode from memory, so packs and android APK assets work the same way as loose files
+    const auto file_data = get_file_data(full_path);
+    const auto start_time = std::chrono::steady_clock::now();
+    auto ret = TextureAssetContext(std::span<const std::uint8_t>(file_data.get_data_ptr(), file_data.get_size()));
+    record_decode_time(start_time);
+	return ret;
 }
 
 
@@ -138,6 +162,18 @@ engine::RawDataFileContext::RawDataFileContext(const std::filesystem::path &file
 	{
 		log::log(log::LogLevel::eCritical, fmt::format("Couldnt load file {}\n", file_path.string().c_str()));
 	}
+	view_ = data_;
+}
+
+engine::RawDataFileContext::RawDataFileContext(std::vector<std::uint8_t>&& data)
+	: data_(std::move(data))
+	, view_(data_)
+{
+}
+
+engine::RawDataFileContext::RawDataFileContext(std::span<const std::uint8_t> data_view)
+	: view_(data_view)
+{
 }
 
 void engine::AssetStore::save_texture(std::string_view name, const void* data, std::uint32_t width, std::uint32_t height, std::uint32_t channels)
@@ -148,19 +184,124 @@ void engine::AssetStore::save_texture(std::string_view name, const void* data, s
     stbi_write_png(full_path.string().data(), width, height, channels, data, 0);
 }
 
+std::filesystem::path engine::AssetStore::get_shaders_base_path() const
+{
+    const std::filesystem::path shaders_folder = "shaders";
+    const auto shaders_assets_path = base_path_ / shaders_folder;
+    return shaders_assets_path;
+}
+
 std::string engine::AssetStore::get_shader_source(std::string_view name)
 {
-	const std::filesystem::path shaders_folder = "shaders";
-	const auto shaders_assets_path = base_path_ / shaders_folder;
-    const auto file_path = shaders_assets_path / name.data();
-    std::string ret = load_data_from_file<std::string>(file_path.string().c_str());
+    // packs are searched once, loose file is read as fallback
+    const auto file_data = get_file_data(get_shaders_base_path() / name.data());
+    return std::string(reinterpret_cast<const char*>(file_data.get_data_ptr()), file_data.get_size());
+}
+
+engine::RawDataFileContext engine::AssetStore::get_file_data(const std::filesystem::path& full_path) const
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto packed_file = find_in_packs(full_path);
+    if (packed_file.entry)
+    {
+        const auto mapped = packed_file.pack->get_mapped_entry(*packed_file.entry);
+        if (!mapped.empty())
+        {
+            record_file_load(true, mapped.size(), start_time);
+            return RawDataFileContext(mapped);
+        }
+        std::vector<std::uint8_t> data;
+        if (packed_file.pack->read_entry(*packed_file.entry, data))
+        {
+            record_file_load(true, data.size(), start_time);
+            return RawDataFileContext(std::move(data));
+        }
+        log::log(log::LogLevel::eError, fmt::format("Couldnt read {} from asset pack {}, trying loose file.\n", full_path.string(), packed_file.pack->get_file_path().string()));
+    }
+    auto ret = RawDataFileContext(full_path);
+    record_file_load(false, ret.get_size(), start_time);
     return ret;
 }
 
+bool engine::AssetStore::mount_pack(std::string_view file_name)
+{
+    const auto full_path = base_path_ / file_name;
+#if !defined(__ANDROID__)
+    // on android assets are inside of APK and can be opened only with SDL IO
+    std::error_code ec;
+    if (!std::filesystem::exists(full_path, ec))
+    {
+        // not an error, assets may be deployed as loose files
+        log::log(log::LogLevel::eTrace, fmt::format("Asset pack {} not found, using loose files.\n", full_path.string()));
+        return false;
+    }
+#endif
+    auto pack = AssetPack(full_path);
+    if (!pack.is_valid())
+    {
+        return false;
+    }
+    log::log(log::LogLevel::eTrace, fmt::format("Mounted asset pack {} with {} files.\n", full_path.string(), pack.get_entry_count()));
+    packs_.push_back(std::move(pack));
+    return true;
+}
+
+void engine::AssetStore::unmount_packs()
+{
+    packs_.clear();
+}
+
+engine::asset_load_stats_t engine::AssetStore::get_load_stats() const
+{
+    asset_load_stats_t ret{};
+    ret.files_from_packs = stats_files_from_packs_.load(std::memory_order_relaxed);
+    ret.loose_files = stats_loose_files_.load(std::memory_order_relaxed);
+    ret.bytes_loaded = stats_bytes_loaded_.load(std::memory_order_relaxed);
+    ret.load_time = std::chrono::microseconds(stats_load_time_us_.load(std::memory_order_relaxed));
+    return ret;
+}
+
+engine::AssetStore::packed_file_t engine::AssetStore::find_in_packs(const std::filesystem::path& full_path) const
+{
+    if (packs_.empty())
+    {
+        return {};
+    }
+    const auto relative_path = full_path.lexically_normal().lexically_relative(base_path_.lexically_normal());
+    if (relative_path.empty() || *relative_path.begin() == "..")
+    {
+        // outside of assets folder
+        return {};
+    }
+    const auto name = relative_path.generic_string();
+    for (auto it = packs_.rbegin(); it != packs_.rend(); ++it)
+    {
+        if (const auto* entry = it->find_entry(name))
+        {
+            return { &(*it), entry };
+        }
+    }
+    return {};
+}
+
+void engine::AssetStore::record_file_load(bool from_pack, std::size_t bytes, std::chrono::steady_clock::time_point start_time) const
+{
+    auto& counter = from_pack ? stats_files_from_packs_ : stats_loose_files_;
+    counter.fetch_add(1, std::memory_order_relaxed);
+    stats_bytes_loaded_.fetch_add(bytes, std::memory_order_relaxed);
+    record_decode_time(start_time);
+}
+
+void engine::AssetStore::record_decode_time(std::chrono::steady_clock::time_point start_time) const
+{
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    stats_load_time_us_.fetch_add(duration.count(), std::memory_order_relaxed);
+}
+
 engine::RawDataFileContext engine::AssetStore::get_font_data(std::string_view name) const
 {
 	const auto full_path = get_font_base_path() / name.data();
-	return RawDataFileContext(full_path);
+	return get_file_data(full_path);
 }
 
 std::filesystem::path engine::AssetStore::get_font_base_path() const
@@ -177,12 +318,133 @@ std::filesystem::path engine::AssetStore::get_ui_docs_base_path() const
     return ui_docs_ssets_path;
 }
 
+std::filesystem::path engine::AssetStore::get_models_base_path() const
+{
+    const std::filesystem::path models_folder = "models";
+    const auto models_assets_path = base_path_ / models_folder;
+    return models_assets_path;
+}
+
 engine::RawDataFileContext engine::AssetStore::get_model_data(std::string_view name) const
 {
-	const std::filesystem::path models_folder = "models";
-	const auto models_assets_path = base_path_ / models_folder;
-	const auto full_path = models_assets_path / name.data();
+	const auto full_path = get_models_base_path() / name.data();
+
+	return get_file_data(full_path);
+}
 
-	return RawDataFileContext(full_path);
+engine::AssetStore::~AssetStore()
+{
+    stop_watching_files();
+    unmount_packs();
+}
+
+bool engine::AssetStore::start_watching_files()
+{
+#if ENGINE_ASSET_STORE_FILE_WATCHER
+    if (watcher_fd_ >= 0)
+    {
+        return true;
+    }
+    watcher_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher_fd_ < 0)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Couldnt initialize file watcher. Errno: {}\n", errno));
+        return false;
+    }
+
+    auto add_watch = [this](const std::filesystem::path& dir)
+    {
+        const auto wd = inotify_add_watch(watcher_fd_, dir.string().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0)
+        {
+            log::log(log::LogLevel::eError, fmt::format("Couldnt watch directory: {}. Errno: {}\n", dir.string(), errno));
+            return;
+        }
+        watched_directories_[wd] = dir;
+    };
+
+    const std::array<std::filesystem::path, 4> folders = { get_shaders_base_path(), get_textures_base_path(), get_models_base_path(), get_ui_docs_base_path() };
+    for (const auto& folder : folders)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(folder, ec))
+        {
+            continue;
+        }
+        add_watch(folder);
+        // inotify is not recursive
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(folder, ec))
+        {
+            if (entry.is_directory())
+            {
+                add_watch(entry.path());
+            }
+        }
+    }
+    log::log(log::LogLevel::eTrace, fmt::format("Watching {} asset directories for changes.\n", watched_directories_.size()));
+    return true;
+#else
+    log::log(log::LogLevel::eError, "File watching is not supported on this platform.\n");
+    return false;
+#endif
+}
+
+void engine::AssetStore::stop_watching_files()
+{
+#if ENGINE_ASSET_STORE_FILE_WATCHER
+    if (watcher_fd_ >= 0)
+    {
+        close(watcher_fd_);
+    }
+#endif
+    watcher_fd_ = -1;
+    watched_directories_.clear();
+}
+
+bool engine::AssetStore::is_watching_files() const
+{
+    return watcher_fd_ >= 0;
+}
+
+std::vector<std::filesystem::path> engine::AssetStore::poll_changed_files()
+{
+    std::vector<std::filesystem::path> ret;
+#if ENGINE_ASSET_STORE_FILE_WATCHER
+    if (watcher_fd_ < 0)
+    {
+        return ret;
+    }
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    while (true)
+    {
+        const auto bytes_read = read(watcher_fd_, buffer.data(), buffer.size());
+        if (bytes_read <= 0)
+        {
+            // EAGAIN: no more events
+            break;
+        }
+        for (ssize_t offset = 0; offset < bytes_read;)
+        {
+            const auto* ev = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + ev->len;
+            if (ev->len == 0 || (ev->mask & IN_ISDIR))
+            {
+                continue;
+            }
+            const auto dir = watched_directories_.find(ev->wd);
+            if (dir == watched_directories_.end())
+            {
+                continue;
+            }
+            // editors tend to write the same file multiple times in a row
+            auto path = dir->second / ev->name;
+            if (std::find(ret.begin(), ret.end(), path) == ret.end())
+            {
+                ret.push_back(std::move(path));
+            }
+        }
+    }
+#endif
+    return ret;
 }
 
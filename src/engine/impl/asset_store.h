@@ -3,6 +3,12 @@
 #include <string>
 #include <filesystem>
 #include <vector>
+#include <unordered_map>
+#include <span>
+#include <atomic>
+#include <chrono>
+
+#include "asset_pack.h"
 
 namespace engine
 {
@@ -16,6 +22,7 @@ public:
     };
 public:
 	TextureAssetContext(const std::filesystem::path& file_path);
+	TextureAssetContext(std::span<const std::uint8_t> encoded_data);
 
 	TextureAssetContext(const TextureAssetContext&) = delete;
 	TextureAssetContext(TextureAssetContext&& rhs);
@@ -42,6 +49,9 @@ class RawDataFileContext
 {
 public:
 	RawDataFileContext(const std::filesystem::path& file_path);
+	RawDataFileContext(std::vector<std::uint8_t>&& data);
+	// doesnt own the data, used for memory mapped asset packs
+	RawDataFileContext(std::span<const std::uint8_t> data_view);
 
 	RawDataFileContext(const RawDataFileContext&) = delete;
 	RawDataFileContext(RawDataFileContext&& rhs) = default;
@@ -50,12 +60,20 @@ public:
 
 	~RawDataFileContext() = default;
 
-	std::size_t get_size() const { return data_.size(); }
-	const std::uint8_t* get_data_ptr() const { return data_.data(); }
-    const std::vector<std::uint8_t>& get_vector() const {return data_;}
+	std::size_t get_size() const { return view_.size(); }
+	const std::uint8_t* get_data_ptr() const { return view_.data(); }
 
 private:
 	std::vector<std::uint8_t> data_;
+	std::span<const std::uint8_t> view_; // points to data_ or to memory mapped asset pack
+};
+
+struct asset_load_stats_t
+{
+    std::uint32_t files_from_packs = 0;
+    std::uint32_t loose_files = 0;
+    std::uint64_t bytes_loaded = 0;
+    std::chrono::microseconds load_time{ 0 }; // reading + decompression + image decoding
 };
 
 class AssetStore
@@ -78,17 +96,53 @@ public:
     std::filesystem::path get_font_base_path() const;
     std::filesystem::path get_ui_docs_base_path() const;
     std::filesystem::path get_textures_base_path() const;
+    std::filesystem::path get_shaders_base_path() const;
+    std::filesystem::path get_models_base_path() const;
 	TextureAssetContext get_texture_data(std::string_view name) const;
 	RawDataFileContext get_model_data(std::string_view name) const;
     void save_texture(std::string_view name, const void* data, std::uint32_t width, std::uint32_t height, std::uint32_t channels);
 	std::string get_shader_source(std::string_view name);
+	// any file in assets folder (used by UI), path has to be prefixed with base path to be found in packs
+	RawDataFileContext get_file_data(const std::filesystem::path& full_path) const;
+
+    // Asset packs (see asset_pack_format.h) are searched before loose files.
+    // Pack mounted last has the highest priority. File name is relative to base path.
+    bool mount_pack(std::string_view file_name);
+    void unmount_packs();
+    asset_load_stats_t get_load_stats() const;
+
+    // Watching of asset folders for modified files (inotify). Supported only on linux and android.
+    bool start_watching_files();
+    void stop_watching_files();
+    bool is_watching_files() const;
+    // non-blocking, returns full paths of files written (or moved into asset folders) since last call
+    std::vector<std::filesystem::path> poll_changed_files();
 
 protected:
 	AssetStore() = default;
-	~AssetStore() = default;
+	~AssetStore();
+
+private:
+    struct packed_file_t
+    {
+        const AssetPack* pack = nullptr;
+        const asset_pack_toc_entry_t* entry = nullptr;
+    };
+    packed_file_t find_in_packs(const std::filesystem::path& full_path) const;
+    void record_file_load(bool from_pack, std::size_t bytes, std::chrono::steady_clock::time_point start_time) const;
+    void record_decode_time(std::chrono::steady_clock::time_point start_time) const;
 
 private:
 	std::filesystem::path base_path_;
+    std::vector<AssetPack> packs_;
+
+    mutable std::atomic_uint32_t stats_files_from_packs_ = 0;
+    mutable std::atomic_uint32_t stats_loose_files_ = 0;
+    mutable std::atomic_uint64_t stats_bytes_loaded_ = 0;
+    mutable std::atomic_int64_t stats_load_time_us_ = 0;
+
+    std::int32_t watcher_fd_ = -1;
+    std::unordered_map<std::int32_t, std::filesystem::path> watched_directories_;
 };
 
 }  // namespace engine
\ No newline at end of file
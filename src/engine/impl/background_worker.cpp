@@ -0,0 +1,83 @@
+#include "background_worker.h"
+
+#include <algorithm>
+#include <iterator>
+
+engine::BackgroundWorker::BackgroundWorker()
+    : thread_([this]() { worker_loop(); })
+{
+}
+
+engine::BackgroundWorker::~BackgroundWorker()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        stop_ = true;
+        jobs_.clear();
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+void engine::BackgroundWorker::submit(Job&& job)
+{
+    {
+        std::scoped_lock lock(mutex_);
+        jobs_.push_back(std::move(job));
+        in_flight_++;
+    }
+    cv_.notify_one();
+}
+
+std::size_t engine::BackgroundWorker::execute_completed(std::size_t max_count)
+{
+    std::deque<MainThreadCallback> callbacks;
+    {
+        std::scoped_lock lock(mutex_);
+        const auto count = std::min(max_count, completed_.size());
+        callbacks.insert(callbacks.end(), std::make_move_iterator(completed_.begin()), std::make_move_iterator(completed_.begin() + count));
+        completed_.erase(completed_.begin(), completed_.begin() + count);
+        in_flight_ -= count;
+    }
+    // execute without lock, callbacks can submit new jobs
+    for (auto& callback : callbacks)
+    {
+        if (callback)
+        {
+            callback();
+        }
+    }
+    return callbacks.size();
+}
+
+std::size_t engine::BackgroundWorker::get_pending_count() const
+{
+    std::scoped_lock lock(mutex_);
+    return in_flight_;
+}
+
+void engine::BackgroundWorker::worker_loop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+            if (stop_)
+            {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        auto callback = job();
+        {
+            std::scoped_lock lock(mutex_);
+            completed_.push_back(std::move(callback));
+        }
+    }
+}
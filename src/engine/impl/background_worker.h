@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace engine
+{
+// Single background thread executing jobs in submission order.
+// Every job returns callback which is executed later on the main thread by execute_completed().
+// This is the place for work which requires main thread (i.e. OpenGL calls) after heavy work was done in background.
+class BackgroundWorker
+{
+public:
+    using MainThreadCallback = std::function<void()>;
+    using Job = std::function<MainThreadCallback()>;
+
+public:
+    BackgroundWorker();
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker(BackgroundWorker&&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(BackgroundWorker&&) = delete;
+    ~BackgroundWorker();
+
+    void submit(Job&& job);
+
+    // main thread only, returns number of executed callbacks
+    std::size_t execute_completed(std::size_t max_count = std::numeric_limits<std::size_t>::max());
+
+    // number of jobs submitted, but not yet completed
+    std::size_t get_pending_count() const;
+
+private:
+    void worker_loop();
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    std::deque<MainThreadCallback> completed_;
+    std::size_t in_flight_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+};
+}  // namespace engine
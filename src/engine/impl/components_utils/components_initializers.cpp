@@ -4,7 +4,7 @@
 namespace
 {
 template<typename T>
-T& get_zero_init_component(entt::registry& registry, entt::entity entity)
+T& get_zero_init_component(engine::registry_t& registry, entt::entity entity)
 {
     auto& comp = registry.get<T>(entity);
     std::memset(&comp, 0, sizeof(T));
@@ -12,7 +12,7 @@ T& get_zero_init_component(entt::registry& registry, entt::entity entity)
 }
 } // namespace anonymous
 
-void engine::initialize_transform_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_transform_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_tranform_component_t>(registry, entity);
     comp.scale[0] = 1.0f;
@@ -21,13 +21,13 @@ void engine::initialize_transform_component(entt::registry& registry, entt::enti
     comp.rotation[3] = 1.0f;
 }
 
-void engine::initialize_mesh_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_mesh_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_mesh_component_t>(registry, entity);
     comp.geometry = ENGINE_INVALID_OBJECT_HANDLE;
 }
 
-void engine::initialize_light_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_light_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_light_component_t>(registry, entity);
     comp.type = ENGINE_LIGHT_TYPE_POINT;
@@ -48,13 +48,29 @@ void engine::initialize_light_component(entt::registry& registry, entt::entity e
 
 }
 
-void engine::initialize_sprite_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_sprite_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_sprite_component_t>(registry, entity);
 }
 
+void engine::initialize_animation_component(registry_t& registry, entt::entity entity)
+{
+    auto& comp = get_zero_init_component<engine_animation_component_t>(registry, entity);
+    comp.clip = ENGINE_INVALID_OBJECT_HANDLE;
+    comp.speed = 1.0f;
+    comp.loop = true;
+    comp.playing = true;
+    for (auto& layer : comp.additive_layers)
+    {
+        layer.clip = ENGINE_INVALID_OBJECT_HANDLE;
+        layer.speed = 1.0f;
+        layer.weight = 1.0f;
+        layer.playing = true;
+    }
+}
 
-void engine::initialize_material_component(entt::registry& registry, entt::entity entity)
+
+void engine::initialize_material_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_material_component_t>(registry, entity);
     comp.type = ENGINE_MATERIAL_TYPE_PONG;
@@ -66,18 +82,18 @@ void engine::initialize_material_component(entt::registry& registry, entt::entit
     comp.data.pong.specular_texture = ENGINE_INVALID_OBJECT_HANDLE;
 }
 
-void engine::initialize_parent_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_parent_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_parent_component_t>(registry, entity);
     comp.parent = ENGINE_INVALID_GAME_OBJECT_ID;
 }
 
-void engine::initialize_name_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_name_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_name_component_t>(registry, entity);
 }
 
-void engine::initialize_camera_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_camera_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_camera_component_t>(registry, entity);
     // disabled by default?
@@ -99,17 +115,17 @@ void engine::initialize_camera_component(entt::registry& registry, entt::entity
     comp.direction.up[2] = 0.0f;
 }
 
-void engine::initialize_rigidbody_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_rigidbody_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_rigid_body_component_t>(registry, entity);
 }
 
-void engine::initialize_collider_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_collider_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_collider_component_t>(registry, entity);
 }
 
-void engine::initialize_skin_component(entt::registry& registry, entt::entity entity)
+void engine::initialize_skin_component(registry_t& registry, entt::entity entity)
 {
     auto& comp = get_zero_init_component<engine_skin_component_t>(registry, entity);
     static_assert(ENGINE_INVALID_GAME_OBJECT_ID == 0, "Invalid game object id should be 0. If it's not 0 than update this function to initalize skeleton array.");
@@ -118,3 +134,10 @@ void engine::initialize_skin_component(entt::registry& registry, entt::entity en
         bone = ENGINE_INVALID_GAME_OBJECT_ID;
     }
 }
+
+void engine::initialize_nav_agent_component(registry_t& registry, entt::entity entity)
+{
+    auto& comp = get_zero_init_component<engine_nav_agent_component_t>(registry, entity);
+    comp.radius = 0.5f;
+    comp.max_speed = 2.0f;
+}
@@ -1,18 +1,20 @@
 #pragma once
-#include "entt/entt.hpp"
+#include "../entity_registry.h"
 
 
 namespace engine
 {
-void initialize_transform_component(entt::registry& registry, entt::entity entity);
-void initialize_mesh_component(entt::registry& registry, entt::entity entity);
-void initialize_material_component(entt::registry& registry, entt::entity entity);
-void initialize_parent_component(entt::registry& registry, entt::entity entity);
-void initialize_name_component(entt::registry& registry, entt::entity entity);
-void initialize_camera_component(entt::registry& registry, entt::entity entity);
-void initialize_rigidbody_component(entt::registry& registry, entt::entity entity);
-void initialize_collider_component(entt::registry& registry, entt::entity entity);
-void initialize_skin_component(entt::registry& registry, entt::entity entity);
-void initialize_light_component(entt::registry& registry, entt::entity entity);
-void initialize_sprite_component(entt::registry& registry, entt::entity entity);
+void initialize_transform_component(registry_t& registry, entt::entity entity);
+void initialize_mesh_component(registry_t& registry, entt::entity entity);
+void initialize_material_component(registry_t& registry, entt::entity entity);
+void initialize_parent_component(registry_t& registry, entt::entity entity);
+void initialize_name_component(registry_t& registry, entt::entity entity);
+void initialize_camera_component(registry_t& registry, entt::entity entity);
+void initialize_rigidbody_component(registry_t& registry, entt::entity entity);
+void initialize_collider_component(registry_t& registry, entt::entity entity);
+void initialize_skin_component(registry_t& registry, entt::entity entity);
+void initialize_light_component(registry_t& registry, entt::entity entity);
+void initialize_sprite_component(registry_t& registry, entt::entity entity);
+void initialize_animation_component(registry_t& registry, entt::entity entity);
+void initialize_nav_agent_component(registry_t& registry, entt::entity entity);
 } // namespace engine
\ No newline at end of file
@@ -0,0 +1,448 @@
+#include "crowd.h"
+#include "profiler.h"
+#include "components/transform_component.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <span>
+
+namespace
+{
+constexpr float K_EPSILON = 0.00001f;
+
+inline float det(float ax, float az, float bx, float bz)
+{
+    return ax * bz - az * bx;
+}
+
+inline std::int32_t get_cell(float position, float cell_size)
+{
+    return static_cast<std::int32_t>(std::floor(position / cell_size));
+}
+
+inline std::uint32_t hash_cell(std::int32_t x, std::int32_t z, std::uint32_t mask)
+{
+    return ((static_cast<std::uint32_t>(x) * 73856093u) ^ (static_cast<std::uint32_t>(z) * 19349663u)) & mask;
+}
+
+struct velocity_t
+{
+    float x = 0.0f;
+    float z = 0.0f;
+};
+
+template<typename Line>
+bool linear_program_1(std::span<const Line> lines, std::size_t line_idx, float radius, velocity_t optimal, bool direction_optimal, velocity_t& result)
+{
+    // velocities of the line within the circle of max speed
+    const auto& line = lines[line_idx];
+    const auto dot = line.point_x * line.direction_x + line.point_z * line.direction_z;
+    const auto discriminant = dot * dot + radius * radius - (line.point_x * line.point_x + line.point_z * line.point_z);
+    if (discriminant < 0.0f)
+    {
+        return false;
+    }
+    const auto discriminant_sqrt = std::sqrt(discriminant);
+    auto t_left = -dot - discriminant_sqrt;
+    auto t_right = -dot + discriminant_sqrt;
+
+    // cut the segment with previous lines
+    for (std::size_t i = 0; i < line_idx; i++)
+    {
+        const auto denominator = det(line.direction_x, line.direction_z, lines[i].direction_x, lines[i].direction_z);
+        const auto numerator = det(lines[i].direction_x, lines[i].direction_z, line.point_x - lines[i].point_x, line.point_z - lines[i].point_z);
+        if (std::abs(denominator) <= K_EPSILON)
+        {
+            // parallel lines
+            if (numerator < 0.0f)
+            {
+                return false;
+            }
+            continue;
+        }
+        const auto t = numerator / denominator;
+        if (denominator >= 0.0f)
+        {
+            t_right = std::min(t_right, t);
+        }
+        else
+        {
+            t_left = std::max(t_left, t);
+        }
+        if (t_left > t_right)
+        {
+            return false;
+        }
+    }
+
+    float t = 0.0f;
+    if (direction_optimal)
+    {
+        t = optimal.x * line.direction_x + optimal.z * line.direction_z > 0.0f ? t_right : t_left;
+    }
+    else
+    {
+        t = std::clamp(line.direction_x * (optimal.x - line.point_x) + line.direction_z * (optimal.z - line.point_z), t_left, t_right);
+    }
+    result = velocity_t{ line.point_x + t * line.direction_x, line.point_z + t * line.direction_z };
+    return true;
+}
+
+// returns index of the first line, which couldn't be satisfied (lines.size() on success)
+template<typename Line>
+std::size_t linear_program_2(std::span<const Line> lines, float radius, velocity_t optimal, bool direction_optimal, velocity_t& result)
+{
+    const auto optimal_length_squared = optimal.x * optimal.x + optimal.z * optimal.z;
+    if (direction_optimal)
+    {
+        // optimal is unit direction
+        result = velocity_t{ optimal.x * radius, optimal.z * radius };
+    }
+    else if (optimal_length_squared > radius * radius)
+    {
+        const auto scale = radius / std::sqrt(optimal_length_squared);
+        result = velocity_t{ optimal.x * scale, optimal.z * scale };
+    }
+    else
+    {
+        result = optimal;
+    }
+
+    for (std::size_t i = 0; i < lines.size(); i++)
+    {
+        if (det(lines[i].direction_x, lines[i].direction_z, lines[i].point_x - result.x, lines[i].point_z - result.z) > 0.0f)
+        {
+            // result doesn't satisfy line i, optimal velocity on this line
+            const auto previous = result;
+            if (!linear_program_1(lines, i, radius, optimal, direction_optimal, result))
+            {
+                result = previous;
+                return i;
+            }
+        }
+    }
+    return lines.size();
+}
+
+// infeasible program (dense crowd): velocity which minimizes max penetration of the lines
+template<typename Line>
+void linear_program_3(std::span<const Line> lines, std::size_t first_line, float radius, std::vector<Line>& projected_lines, velocity_t& result)
+{
+    float distance = 0.0f;
+    for (auto i = first_line; i < lines.size(); i++)
+    {
+        const auto& line = lines[i];
+        if (det(line.direction_x, line.direction_z, line.point_x - result.x, line.point_z - result.z) <= distance)
+        {
+            // result satisfies this line within current max penetration
+            continue;
+        }
+        projected_lines.clear();
+        for (std::size_t j = 0; j < i; j++)
+        {
+            Line projected{};
+            const auto determinant = det(line.direction_x, line.direction_z, lines[j].direction_x, lines[j].direction_z);
+            if (std::abs(determinant) <= K_EPSILON)
+            {
+                if (line.direction_x * lines[j].direction_x + line.direction_z * lines[j].direction_z > 0.0f)
+                {
+                    // same direction
+                    continue;
+                }
+                projected.point_x = 0.5f * (line.point_x + lines[j].point_x);
+                projected.point_z = 0.5f * (line.point_z + lines[j].point_z);
+            }
+            else
+            {
+                const auto t = det(lines[j].direction_x, lines[j].direction_z, line.point_x - lines[j].point_x, line.point_z - lines[j].point_z) / determinant;
+                projected.point_x = line.point_x + t * line.direction_x;
+                projected.point_z = line.point_z + t * line.direction_z;
+            }
+            const auto dx = lines[j].direction_x - line.direction_x;
+            const auto dz = lines[j].direction_z - line.direction_z;
+            const auto length = std::sqrt(dx * dx + dz * dz);
+            projected.direction_x = dx / length;
+            projected.direction_z = dz / length;
+            projected_lines.push_back(projected);
+        }
+
+        const auto previous = result;
+        if (linear_program_2(std::span<const Line>(projected_lines), radius, velocity_t{ -line.direction_z, line.direction_x }, true, result) < projected_lines.size())
+        {
+            // should not happen, result is already in the feasible region of this program
+            result = previous;
+        }
+        distance = det(line.direction_x, line.direction_z, line.point_x - result.x, line.point_z - result.z);
+    }
+}
+}  // namespace anonymous
+
+void engine::Crowd::agents_t::clear()
+{
+    position_x.clear();
+    position_z.clear();
+    velocity_x.clear();
+    velocity_z.clear();
+    preferred_velocity_x.clear();
+    preferred_velocity_z.clear();
+    radius.clear();
+    max_speed.clear();
+}
+
+void engine::Crowd::agents_t::push_back(float px, float pz, float vx, float vz, float pvx, float pvz, float r, float speed)
+{
+    position_x.push_back(px);
+    position_z.push_back(pz);
+    velocity_x.push_back(vx);
+    velocity_z.push_back(vz);
+    preferred_velocity_x.push_back(pvx);
+    preferred_velocity_z.push_back(pvz);
+    radius.push_back(r);
+    max_speed.push_back(speed);
+}
+
+void engine::Crowd::build_spatial_hash(const agents_t& agents, float cell_size)
+{
+    // counting sort of agents by hash bucket, twice more buckets than agents keeps collisions low
+    std::uint32_t buckets_count = 1;
+    while (buckets_count < agents.size() * 2)
+    {
+        buckets_count <<= 1;
+    }
+    hash_mask_ = buckets_count - 1;
+    cell_size_ = cell_size;
+    hash_offsets_.assign(buckets_count + 1, 0);
+    hash_agents_.resize(agents.size());
+    const auto get_bucket = [&](std::size_t i)
+    {
+        return hash_cell(get_cell(agents.position_x[i], cell_size_), get_cell(agents.position_z[i], cell_size_), hash_mask_);
+    };
+    for (std::size_t i = 0; i < agents.size(); i++)
+    {
+        hash_offsets_[get_bucket(i) + 1]++;
+    }
+    for (std::size_t i = 1; i < hash_offsets_.size(); i++)
+    {
+        hash_offsets_[i] += hash_offsets_[i - 1];
+    }
+    // offsets are used as insert positions and shifted back afterwards
+    for (std::size_t i = 0; i < agents.size(); i++)
+    {
+        hash_agents_[hash_offsets_[get_bucket(i)]++] = static_cast<std::uint32_t>(i);
+    }
+    for (auto i = hash_offsets_.size() - 1; i > 0; i--)
+    {
+        hash_offsets_[i] = hash_offsets_[i - 1];
+    }
+    hash_offsets_[0] = 0;
+}
+
+void engine::Crowd::find_neighbours(const agents_t& agents, std::uint32_t agent, const engine_crowd_settings_t& settings)
+{
+    neighbours_.clear();
+    const auto px = agents.position_x[agent];
+    const auto pz = agents.position_z[agent];
+    const auto cell_x = get_cell(px, cell_size_);
+    const auto cell_z = get_cell(pz, cell_size_);
+    const auto max_distance_squared = settings.neighbour_distance * settings.neighbour_distance;
+    std::uint32_t visited_buckets[9];
+    std::uint32_t visited_count = 0;
+    for (auto z = cell_z - 1; z <= cell_z + 1; z++)
+    {
+        for (auto x = cell_x - 1; x <= cell_x + 1; x++)
+        {
+            // different cells can share the bucket
+            const auto bucket = hash_cell(x, z, hash_mask_);
+            if (std::find(visited_buckets, visited_buckets + visited_count, bucket) != visited_buckets + visited_count)
+            {
+                continue;
+            }
+            visited_buckets[visited_count++] = bucket;
+            for (auto i = hash_offsets_[bucket]; i < hash_offsets_[bucket + 1]; i++)
+            {
+                const auto other = hash_agents_[i];
+                const auto dx = agents.position_x[other] - px;
+                const auto dz = agents.position_z[other] - pz;
+                const auto distance_squared = dx * dx + dz * dz;
+                if (other != agent && distance_squared < max_distance_squared)
+                {
+                    neighbours_.emplace_back(distance_squared, other);
+                }
+            }
+        }
+    }
+    // agent index breaks ties, so result doesn't depend on order in buckets
+    if (neighbours_.size() > settings.max_neighbours)
+    {
+        std::nth_element(neighbours_.begin(), neighbours_.begin() + settings.max_neighbours, neighbours_.end());
+        neighbours_.resize(settings.max_neighbours);
+    }
+    std::sort(neighbours_.begin(), neighbours_.end());
+}
+
+void engine::Crowd::compute_velocities(agents_t& agents, const engine_crowd_settings_t& settings, float dt)
+{
+    ENGINE_PROFILE_SECTION_N("crowd_compute_velocities");
+    const auto count = agents.size();
+    neighbours_count_ = 0;
+    if (count == 0 || dt <= 0.0f)
+    {
+        return;
+    }
+    build_spatial_hash(agents, std::max(settings.neighbour_distance, K_EPSILON));
+    new_velocity_x_.resize(count);
+    new_velocity_z_.resize(count);
+
+    const auto inv_time_horizon = 1.0f / std::max(settings.time_horizon, K_EPSILON);
+    const auto inv_dt = 1.0f / dt;
+    for (std::uint32_t agent = 0; agent < count; agent++)
+    {
+        find_neighbours(agents, agent, settings);
+        neighbours_count_ += static_cast<std::uint32_t>(neighbours_.size());
+
+        const auto px = agents.position_x[agent];
+        const auto pz = agents.position_z[agent];
+        const auto vx = agents.velocity_x[agent];
+        const auto vz = agents.velocity_z[agent];
+        lines_.clear();
+        for (const auto& [distance_squared, other] : neighbours_)
+        {
+            const auto rel_px = agents.position_x[other] - px;
+            const auto rel_pz = agents.position_z[other] - pz;
+            const auto rel_vx = vx - agents.velocity_x[other];
+            const auto rel_vz = vz - agents.velocity_z[other];
+            const auto combined_radius = agents.radius[agent] + agents.radius[other];
+            const auto combined_radius_squared = combined_radius * combined_radius;
+
+            // u: smallest change of relative velocity, which resolves the collision
+            line_t line{};
+            float ux = 0.0f;
+            float uz = 0.0f;
+            if (distance_squared > combined_radius_squared)
+            {
+                // w: vector from cutoff circle center to relative velocity
+                const auto wx = rel_vx - inv_time_horizon * rel_px;
+                const auto wz = rel_vz - inv_time_horizon * rel_pz;
+                const auto w_length_squared = wx * wx + wz * wz;
+                const auto dot = wx * rel_px + wz * rel_pz;
+                if (dot < 0.0f && dot * dot > combined_radius_squared * w_length_squared)
+                {
+                    // project on cutoff circle
+                    const auto w_length = std::sqrt(w_length_squared);
+                    const auto unit_wx = wx / w_length;
+                    const auto unit_wz = wz / w_length;
+                    line.direction_x = unit_wz;
+                    line.direction_z = -unit_wx;
+                    ux = (combined_radius * inv_time_horizon - w_length) * unit_wx;
+                    uz = (combined_radius * inv_time_horizon - w_length) * unit_wz;
+                }
+                else
+                {
+                    // project on legs of the velocity obstacle
+                    const auto leg = std::sqrt(distance_squared - combined_radius_squared);
+                    if (det(rel_px, rel_pz, wx, wz) > 0.0f)
+                    {
+                        line.direction_x = (rel_px * leg - rel_pz * combined_radius) / distance_squared;
+                        line.direction_z = (rel_px * combined_radius + rel_pz * leg) / distance_squared;
+                    }
+                    else
+                    {
+                        line.direction_x = -(rel_px * leg + rel_pz * combined_radius) / distance_squared;
+                        line.direction_z = -(-rel_px * combined_radius + rel_pz * leg) / distance_squared;
+                    }
+                    const auto dot_leg = rel_vx * line.direction_x + rel_vz * line.direction_z;
+                    ux = dot_leg * line.direction_x - rel_vx;
+                    uz = dot_leg * line.direction_z - rel_vz;
+                }
+            }
+            else
+            {
+                // already overlapping, resolve within one step
+                const auto wx = rel_vx - inv_dt * rel_px;
+                const auto wz = rel_vz - inv_dt * rel_pz;
+                const auto w_length = std::sqrt(wx * wx + wz * wz);
+                if (w_length <= K_EPSILON)
+                {
+                    // the same position and velocity, agents are pushed apart by their index
+                    continue;
+                }
+                const auto unit_wx = wx / w_length;
+                const auto unit_wz = wz / w_length;
+                line.direction_x = unit_wz;
+                line.direction_z = -unit_wx;
+                ux = (combined_radius * inv_dt - w_length) * unit_wx;
+                uz = (combined_radius * inv_dt - w_length) * unit_wz;
+            }
+            // both agents take half of the responsibility
+            line.point_x = vx + 0.5f * ux;
+            line.point_z = vz + 0.5f * uz;
+            lines_.push_back(line);
+        }
+
+        const auto max_speed = agents.max_speed[agent];
+        velocity_t result{};
+        const auto lines = std::span<const line_t>(lines_);
+        const auto failed_line = linear_program_2(lines, max_speed, velocity_t{ agents.preferred_velocity_x[agent], agents.preferred_velocity_z[agent] }, false, result);
+        if (failed_line < lines.size())
+        {
+            linear_program_3(lines, failed_line, max_speed, projected_lines_, result);
+        }
+        new_velocity_x_[agent] = result.x;
+        new_velocity_z_[agent] = result.z;
+    }
+    std::copy(new_velocity_x_.begin(), new_velocity_x_.end(), agents.velocity_x.begin());
+    std::copy(new_velocity_z_.begin(), new_velocity_z_.end(), agents.velocity_z.begin());
+}
+
+engine::CrowdSystem::CrowdSystem()
+{
+    settings_.neighbour_distance = 5.0f;
+    settings_.time_horizon = 2.0f;
+    settings_.max_neighbours = 10;
+}
+
+void engine::CrowdSystem::update(registry_t& registry, float dt)
+{
+    ENGINE_PROFILE_SECTION_N("crowd_update");
+    const auto start = std::chrono::steady_clock::now();
+    stats_ = {};
+
+    auto view = registry.view<engine_nav_agent_component_t, engine_tranform_component_t>();
+    agents_.clear();
+    entities_.clear();
+    for (auto entity : view)
+    {
+        const auto& agent = view.get<engine_nav_agent_component_t>(entity);
+        const auto& transform = view.get<engine_tranform_component_t>(entity);
+        agents_.push_back(transform.position[0], transform.position[2], agent.velocity[0], agent.velocity[2],
+            agent.preferred_velocity[0], agent.preferred_velocity[2], agent.radius, agent.max_speed);
+        entities_.push_back(entity);
+    }
+    if (entities_.empty())
+    {
+        return;
+    }
+
+    const auto dt_seconds = dt / 1000.0f;
+    crowd_.compute_velocities(agents_, settings_, dt_seconds);
+
+    for (std::size_t i = 0; i < entities_.size(); i++)
+    {
+        auto& agent = view.get<engine_nav_agent_component_t>(entities_[i]);
+        agent.velocity[0] = agents_.velocity_x[i];
+        agent.velocity[1] = 0.0f;
+        agent.velocity[2] = agents_.velocity_z[i];
+        // patch, so model matrix and colliders are updated by the scene observers
+        registry.patch<engine_tranform_component_t>(entities_[i], [&](auto& transform)
+            {
+                transform.position[0] += agents_.velocity_x[i] * dt_seconds;
+                transform.position[2] += agents_.velocity_z[i] * dt_seconds;
+            });
+    }
+
+    stats_.agents_count = static_cast<std::uint32_t>(entities_.size());
+    stats_.neighbours_count = crowd_.get_neighbours_count();
+    stats_.update_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
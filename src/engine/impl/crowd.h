@@ -0,0 +1,105 @@
+#pragma once
+#include "components/nav_component.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "entity_registry.h"
+
+namespace engine
+{
+// Local avoidance of crowd agents on xz plane (ORCA - optimal reciprocal collision avoidance).
+// Agents are stored as structure of arrays and all agents are processed in one pass:
+// 1. agents are sorted into spatial hash with cell size of neighbour distance, so neighbours are in 3x3 cells
+// 2. every agent gets the closest max_neighbours agents within neighbour distance
+// 3. every neighbour adds half-plane of velocities, which are collision free within time horizon (each agent takes half of the responsibility)
+// 4. new velocity is the closest velocity to the preferred one, which satisfies all half-planes (2D linear program)
+// New velocities are computed only from the current velocities, so result doesn't depend on order of agents.
+class Crowd
+{
+public:
+    struct agents_t
+    {
+        std::vector<float> position_x;
+        std::vector<float> position_z;
+        std::vector<float> velocity_x; // current velocity, replaced with new velocity by compute_velocities()
+        std::vector<float> velocity_z;
+        std::vector<float> preferred_velocity_x;
+        std::vector<float> preferred_velocity_z;
+        std::vector<float> radius;
+        std::vector<float> max_speed;
+
+        std::size_t size() const { return position_x.size(); }
+        void clear();
+        void push_back(float px, float pz, float vx, float vz, float pvx, float pvz, float r, float speed);
+    };
+
+public:
+    Crowd() = default;
+    Crowd(const Crowd& rhs) = delete;
+    Crowd(Crowd&& rhs) noexcept = default;
+    Crowd& operator=(const Crowd& rhs) = delete;
+    Crowd& operator=(Crowd&& rhs) noexcept = default;
+    ~Crowd() = default;
+
+    // dt in seconds, used to resolve already overlapping agents within one step
+    void compute_velocities(agents_t& agents, const engine_crowd_settings_t& settings, float dt);
+    // sum of neighbours of all agents in the last compute_velocities()
+    std::uint32_t get_neighbours_count() const { return neighbours_count_; }
+
+private:
+    struct line_t
+    {
+        float point_x = 0.0f;
+        float point_z = 0.0f;
+        float direction_x = 0.0f;
+        float direction_z = 0.0f;
+    };
+
+    void build_spatial_hash(const agents_t& agents, float cell_size);
+    void find_neighbours(const agents_t& agents, std::uint32_t agent, const engine_crowd_settings_t& settings);
+
+    // spatial hash: agents of bucket i are hash_agents_[hash_offsets_[i], hash_offsets_[i + 1])
+    std::vector<std::uint32_t> hash_offsets_;
+    std::vector<std::uint32_t> hash_agents_;
+    std::uint32_t hash_mask_ = 0;
+    float cell_size_ = 1.0f;
+
+    // scratch of a single agent, reused between agents and frames
+    std::vector<std::pair<float, std::uint32_t>> neighbours_; // distance squared, agent
+    std::vector<line_t> lines_;
+    std::vector<line_t> projected_lines_;
+    std::vector<float> new_velocity_x_;
+    std::vector<float> new_velocity_z_;
+    std::uint32_t neighbours_count_ = 0;
+};
+
+// Moves entities with nav agent and transform components, updated by the scene before physics,
+// so physics sees already separated agents.
+class CrowdSystem
+{
+public:
+    CrowdSystem();
+    CrowdSystem(const CrowdSystem& rhs) = delete;
+    CrowdSystem(CrowdSystem&& rhs) noexcept = default;
+    CrowdSystem& operator=(const CrowdSystem& rhs) = delete;
+    CrowdSystem& operator=(CrowdSystem&& rhs) noexcept = default;
+    ~CrowdSystem() = default;
+
+    // dt in milliseconds
+    void update(registry_t& registry, float dt);
+
+    void set_settings(const engine_crowd_settings_t& settings) { settings_ = settings; }
+    const engine_crowd_settings_t& get_settings() const { return settings_; }
+    const engine_crowd_stats_t& get_stats() const { return stats_; }
+
+private:
+    Crowd crowd_;
+    // reused between frames to avoid allocations
+    Crowd::agents_t agents_;
+    std::vector<entt::entity> entities_;
+
+    engine_crowd_settings_t settings_{};
+    engine_crowd_stats_t stats_{};
+};
+}  // namespace engine
@@ -7,8 +7,11 @@
 #include "ui_document.h"
 
 #include "logger.h"
+#include "memory_tracker.h"
 
+#include <limits>
 #include <utility>
+#include <glm/gtc/type_ptr.hpp>
 
 #include <fmt/format.h>
 
@@ -29,6 +32,11 @@ inline engine::UiDataHandle* ui_data_handle_cast(engine_ui_data_handle_t handle)
     return reinterpret_cast<engine::UiDataHandle*>(handle);
 }
 
+inline engine::PrefabTemplate* prefab_cast(engine_prefab_t prefab)
+{
+    return reinterpret_cast<engine::PrefabTemplate*>(prefab);
+}
+
 inline engine::Scene* scene_cast(engine_scene_t engine_scene_t)
 {
     return reinterpret_cast<engine::Scene*>(engine_scene_t);
@@ -39,14 +47,14 @@ inline entt::entity entity_cast(engine_game_object_t go)
     return static_cast<entt::entity>(go);
 }
 
-inline entt::runtime_view* runtime_view_cast(engine_component_view_t comp_view)
+inline engine::runtime_view_t* runtime_view_cast(engine_component_view_t comp_view)
 {
-    return reinterpret_cast<entt::runtime_view*>(comp_view);
+    return reinterpret_cast<engine::runtime_view_t*>(comp_view);
 }
 
 inline auto component_iterator_cast(engine_component_iterator_t it)
 {
-    return reinterpret_cast<decltype(std::declval<entt::runtime_view>().begin())*>(it);
+    return reinterpret_cast<decltype(std::declval<engine::runtime_view_t>().begin())*>(it);
 }
 
 template<typename T>
@@ -98,6 +106,39 @@ void engineLog(const char* str)
     engine::log::log(engine::log::LogLevel::eTrace, str);
 }
 
+void engineLogFlush()
+{
+    engine::log::flush();
+}
+
+uint64_t engineLogGetDroppedCount()
+{
+    return engine::log::get_dropped_count();
+}
+
+engine_memory_stats_t engineMemoryGetStats(engine_memory_tag_t tag)
+{
+    if (tag >= ENGINE_MEMORY_TAG_COUNT)
+    {
+        return engine_memory_stats_t{};
+    }
+    return engine::memory::get_stats(tag);
+}
+
+void engineMemorySetBudget(engine_memory_tag_t tag, uint64_t budget_bytes)
+{
+    if (tag >= ENGINE_MEMORY_TAG_COUNT)
+    {
+        return;
+    }
+    engine::memory::set_budget(tag, budget_bytes);
+}
+
+void engineMemorySetBudgetExceededCallback(void* user_data, void (*callback)(engine_memory_tag_t tag, uint64_t live_bytes, uint64_t budget_bytes, void* user_data))
+{
+    engine::memory::set_budget_exceeded_callback(user_data, callback);
+}
+
 engine_result_code_t engineApplicationCreate(engine_application_t* handle, engine_application_create_desc_t create_desc)
 {
     if (create_desc.asset_store_path)
@@ -128,6 +169,7 @@ void engineApplicationDestroy(engine_application_t handle)
 {
 	auto* app = application_cast(handle);
 	delete app;
+	engine::log::flush();
 }
 
 bool engineApplicationIsKeyboardButtonDown(engine_application_t handle, engine_keyboard_keys_t key)
@@ -210,6 +252,16 @@ engine_application_frame_end_info_t engineApplicationFrameEnd(engine_application
 	return app->end_frame();
 }
 
+uint32_t engineApplicationGetFrameStats(engine_application_t handle, engine_frame_stats_t* out, uint32_t max_count)
+{
+    if (!handle || !out)
+    {
+        return 0;
+    }
+    auto* app = application_cast(handle);
+    return app->get_frame_stats({ out, max_count });
+}
+
 engine_result_code_t engineApplicationCreateShader(engine_application_t handle, const engine_shader_create_desc_t* desc, const char* name, engine_shader_t* out)
 {
     if (!handle || !desc || !name || !out)
@@ -254,6 +306,13 @@ void engineApplicationDestroyShader(engine_application_t handle, engine_shader_t
     }
 }
 
+engine_result_code_t engineApplicationMountAssetPack(engine_application_t handle, const char* file_name)
+{
+    auto* app = application_cast(handle);
+    const auto result = app->mount_asset_pack(file_name);
+    return result ? ENGINE_RESULT_CODE_OK : ENGINE_RESULT_CODE_FAIL;
+}
+
 engine_result_code_t engineApplicationCreateFontFromFile(engine_application_t handle, const char* file_name, const char* handle_name)
 {
     auto* app = application_cast(handle);
@@ -264,7 +323,9 @@ engine_result_code_t engineApplicationCreateFontFromFile(engine_application_t ha
 engine_result_code_t engineApplicationCreateGeometryFromDesc(engine_application_t handle, const engine_geometry_create_desc_t* desc, const char* name, engine_geometry_t* out)
 {
     auto* app = application_cast(handle);
-    const auto ret = app->add_geometry(desc->verts_layout, desc->verts_count, { reinterpret_cast<const std::byte*>(desc->verts_data), desc->verts_data_size }, { desc->inds, desc->inds_count}, name);
+    const auto index_size = desc->inds_data_type == ENGINE_INDEX_DATA_TYPE_UINT16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+    const auto ret = app->add_geometry(desc->verts_layout, desc->verts_count, { reinterpret_cast<const std::byte*>(desc->verts_data), desc->verts_data_size },
+        { reinterpret_cast<const std::byte*>(desc->inds), desc->inds_count * index_size }, desc->inds_data_type, name);
     if (ret == ENGINE_INVALID_OBJECT_HANDLE || !out)
     {
         return ENGINE_RESULT_CODE_FAIL;
@@ -345,6 +406,269 @@ void engineApplicationDestroyTexture2D(engine_application_t handle, engine_textu
     application_cast(handle)->destroy_texture(tex2d);
 }
 
+engine_result_code_t engineApplicationCreateAnimationClipFromModelDesc(engine_application_t handle, const engine_model_desc_t* model_desc, uint32_t animation_index, const char* name, engine_animation_clip_t* out)
+{
+    if (!model_desc || !model_desc->internal_handle || animation_index >= model_desc->animations_counts)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    auto* app = application_cast(handle);
+    const auto ret = app->add_animation_clip(*model_desc, animation_index, name);
+    if (ret == ENGINE_INVALID_OBJECT_HANDLE || !out)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *out = ret;
+    engineLog(fmt::format("Created animation clip: {}, with id: {}\n", name, ret).c_str());
+    return ENGINE_RESULT_CODE_OK;
+}
+
+engine_animation_clip_t engineApplicationGetAnimationClipByName(engine_application_t handle, const char* name)
+{
+    const auto* app = application_cast(handle);
+    return app->get_animation_clip(name);
+}
+
+float engineApplicationGetAnimationClipDuration(engine_application_t handle, engine_animation_clip_t clip)
+{
+    const auto* app = application_cast(handle);
+    const auto* clip_obj = app->get_animation_clip(clip);
+    return clip_obj ? clip_obj->get_duration() : 0.0f;
+}
+
+void engineApplicationDestroyAnimationClip(engine_application_t handle, engine_animation_clip_t clip)
+{
+    assert(handle);
+    application_cast(handle)->destroy_animation_clip(clip);
+}
+
+engine_result_code_t engineApplicationCreatePrefabFromModelDesc(engine_application_t handle, const engine_prefab_create_desc_t* desc, engine_prefab_t* out)
+{
+    if (!handle || !desc || !desc->model_desc || !out)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    const auto& model_desc = *desc->model_desc;
+    const auto* app = application_cast(handle);
+    const auto geometries_count = desc->geometries ? model_desc.geometries_count : 0;
+    for (std::uint32_t i = 0; i < geometries_count; i++)
+    {
+        if (!app->get_geometry(desc->geometries[i]))
+        {
+            engineLog(fmt::format("Can't create prefab, geometry: {} with id: {} doesn't exist.\n", i, desc->geometries[i]).c_str());
+            return ENGINE_RESULT_CODE_FAIL;
+        }
+    }
+    const auto materials_count = desc->materials ? model_desc.materials_count : 0;
+    auto* ret = new engine::PrefabTemplate(model_desc, { desc->geometries, geometries_count }, { desc->materials, materials_count }, desc->add_animation_component);
+    if (!ret->is_valid())
+    {
+        delete ret;
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *out = reinterpret_cast<engine_prefab_t>(ret);
+    return ENGINE_RESULT_CODE_OK;
+}
+
+uint32_t enginePrefabGetNodesCount(engine_prefab_t prefab)
+{
+    return prefab ? prefab_cast(prefab)->get_nodes_count() : 0;
+}
+
+void enginePrefabDestroy(engine_prefab_t prefab)
+{
+    if (prefab)
+    {
+        delete prefab_cast(prefab);
+    }
+}
+
+engine_result_code_t engineApplicationCreateNavMesh(engine_application_t handle, const char* name, engine_nav_mesh_t* out)
+{
+    auto* app = application_cast(handle);
+    const auto ret = app->add_nav_mesh(name);
+    if (ret == ENGINE_INVALID_OBJECT_HANDLE || !out)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *out = ret;
+    engineLog(fmt::format("Created nav mesh: {}, with id: {}\n", name, ret).c_str());
+    return ENGINE_RESULT_CODE_OK;
+}
+
+engine_nav_mesh_node_t engineApplicationNavMeshAddNode(engine_application_t handle, engine_nav_mesh_t nav_mesh, const float center[3], const float half_size[3])
+{
+    auto* mesh = application_cast(handle)->get_nav_mesh(nav_mesh);
+    if (!mesh)
+    {
+        return ENGINE_INVALID_OBJECT_HANDLE;
+    }
+    return static_cast<engine_nav_mesh_node_t>(mesh->add_node(glm::make_vec3(center), glm::make_vec3(half_size)));
+}
+
+void engineApplicationNavMeshAddEdge(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t from, engine_nav_mesh_node_t to, uint32_t cost)
+{
+    auto* mesh = application_cast(handle)->get_nav_mesh(nav_mesh);
+    if (mesh)
+    {
+        mesh->add_edge(static_cast<engine::NavMeshNodeIdx>(from), static_cast<engine::NavMeshNodeIdx>(to), cost);
+    }
+}
+
+void engineApplicationNavMeshBuild(engine_application_t handle, engine_nav_mesh_t nav_mesh)
+{
+    auto* mesh = application_cast(handle)->get_nav_mesh(nav_mesh);
+    if (mesh)
+    {
+        mesh->build();
+    }
+}
+
+engine_nav_mesh_node_t engineApplicationNavMeshGetNearestNode(engine_application_t handle, engine_nav_mesh_t nav_mesh, const float position[3])
+{
+    const auto* app = application_cast(handle);
+    const auto* mesh = app->get_nav_mesh(nav_mesh);
+    if (!mesh || !mesh->is_built())
+    {
+        return ENGINE_INVALID_OBJECT_HANDLE;
+    }
+    return static_cast<engine_nav_mesh_node_t>(mesh->get_nearest_node_idx(glm::make_vec3(position)));
+}
+
+void engineApplicationNavMeshGetNodeCenter(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t node, float out_center[3])
+{
+    const auto* app = application_cast(handle);
+    const auto* mesh = app->get_nav_mesh(nav_mesh);
+    if (!mesh || node >= mesh->get_nodes_count() || !out_center)
+    {
+        return;
+    }
+    const auto center = mesh->get_node(static_cast<engine::NavMeshNodeIdx>(node)).get_center();
+    std::memcpy(out_center, glm::value_ptr(center), sizeof(center));
+}
+
+void engineApplicationDestroyNavMesh(engine_application_t handle, engine_nav_mesh_t nav_mesh)
+{
+    assert(handle);
+    application_cast(handle)->destroy_nav_mesh(nav_mesh);
+}
+
+engine_result_code_t engineApplicationNavMeshBuildFromScene(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_scene_t scene, const engine_nav_mesh_build_config_t* config)
+{
+    if (!config)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    auto* app = application_cast(handle);
+    return app->build_nav_mesh(nav_mesh, scene_cast(scene), *config);
+}
+
+engine_result_code_t engineApplicationNavMeshRebuildArea(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_scene_t scene, const float bounds_min[3], const float bounds_max[3])
+{
+    auto* app = application_cast(handle);
+    return app->rebuild_nav_mesh_area(nav_mesh, scene_cast(scene), glm::make_vec3(bounds_min), glm::make_vec3(bounds_max));
+}
+
+engine_result_code_t engineApplicationNavMeshGetBuildStats(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_build_stats_t* out)
+{
+    const auto* app = application_cast(handle);
+    const auto* stats = app->get_nav_mesh_build_stats(nav_mesh);
+    if (!stats || !out)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *out = *stats;
+    return ENGINE_RESULT_CODE_OK;
+}
+
+engine_result_code_t engineApplicationCreateNavMeshFlowField(engine_application_t handle, const char* name, engine_nav_mesh_flow_field_t* out)
+{
+    auto* app = application_cast(handle);
+    const auto ret = app->add_nav_mesh_flow_field(name);
+    if (ret == ENGINE_INVALID_OBJECT_HANDLE || !out)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    *out = ret;
+    engineLog(fmt::format("Created nav mesh flow field: {}, with id: {}\n", name, ret).c_str());
+    return ENGINE_RESULT_CODE_OK;
+}
+
+bool engineApplicationNavMeshFlowFieldUpdate(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_flow_field_t field, const float goal_position[3], uint32_t max_nodes)
+{
+    auto* app = application_cast(handle);
+    const auto* mesh = std::as_const(*app).get_nav_mesh(nav_mesh);
+    auto* flow_field = app->get_nav_mesh_flow_field(field);
+    if (!mesh || !flow_field || !mesh->is_built())
+    {
+        return false;
+    }
+    flow_field->set_goal(*mesh, glm::make_vec3(goal_position));
+    return flow_field->update(*mesh, max_nodes == 0 ? std::numeric_limits<std::uint32_t>::max() : max_nodes);
+}
+
+bool engineApplicationNavMeshFlowFieldSample(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_flow_field_t field, const float position[3], float out_direction[3])
+{
+    auto* app = application_cast(handle);
+    const auto* mesh = std::as_const(*app).get_nav_mesh(nav_mesh);
+    const auto* flow_field = app->get_nav_mesh_flow_field(field);
+    if (!mesh || !flow_field || !out_direction)
+    {
+        return false;
+    }
+    glm::vec3 direction;
+    const auto ret = flow_field->sample(*mesh, glm::make_vec3(position), direction);
+    std::memcpy(out_direction, glm::value_ptr(direction), sizeof(direction));
+    return ret;
+}
+
+void engineApplicationNavMeshFlowFieldReset(engine_application_t handle, engine_nav_mesh_flow_field_t field)
+{
+    auto* flow_field = application_cast(handle)->get_nav_mesh_flow_field(field);
+    if (flow_field)
+    {
+        flow_field->reset();
+    }
+}
+
+void engineApplicationDestroyNavMeshFlowField(engine_application_t handle, engine_nav_mesh_flow_field_t field)
+{
+    assert(handle);
+    application_cast(handle)->destroy_nav_mesh_flow_field(field);
+}
+
+engine_path_query_ticket_t engineApplicationSubmitPathQuery(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t start, engine_nav_mesh_node_t end)
+{
+    auto* app = application_cast(handle);
+    return app->submit_path_query(nav_mesh, static_cast<engine::NavMeshNodeIdx>(start), static_cast<engine::NavMeshNodeIdx>(end));
+}
+
+engine_path_query_status_t engineApplicationGetPathQueryResult(engine_application_t handle, engine_path_query_ticket_t ticket, const engine_nav_mesh_node_t** nodes, uint32_t* nodes_count)
+{
+    const auto* app = application_cast(handle);
+    const auto result = app->get_path_query_result(ticket);
+    if (nodes)
+    {
+        *nodes = result.nodes.data();
+    }
+    if (nodes_count)
+    {
+        *nodes_count = static_cast<std::uint32_t>(result.nodes.size());
+    }
+    return result.status;
+}
+
+void engineApplicationReleasePathQuery(engine_application_t handle, engine_path_query_ticket_t ticket)
+{
+    application_cast(handle)->release_path_query(ticket);
+}
+
+void engineApplicationSetPathQueriesTimeBudget(engine_application_t handle, float budget_ms)
+{
+    const auto budget = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<float, std::milli>(budget_ms));
+    application_cast(handle)->set_path_queries_time_budget(budget);
+}
+
 engine_result_code_t engineApplicationAllocateModelDescAndLoadDataFromFile(engine_application_t handle, engine_model_specification_t spec, const char *file_name, const char* base_dir, engine_model_desc_t* out)
 {
     if (!out)
@@ -408,6 +732,46 @@ void engineSceneDestroyGameObject(engine_scene_t scene, engine_game_object_t gam
     sc->destroy_entity(entity_cast(game_object));
 }
 
+engine_game_object_t engineSceneCommandBufferCreateGameObject(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return static_cast<engine_game_object_t>(sc->command_buffer_create_entity());
+}
+
+void engineSceneCommandBufferDestroyGameObject(engine_scene_t scene, engine_game_object_t game_object)
+{
+    auto sc = scene_cast(scene);
+    sc->get_command_buffer().destroy(entity_cast(game_object));
+}
+
+void engineSceneCommandBufferAddComponent(engine_scene_t scene, engine_game_object_t game_object, engine_component_type_t type)
+{
+    auto sc = scene_cast(scene);
+    sc->get_command_buffer().add_component(entity_cast(game_object), type);
+}
+
+void engineSceneCommandBufferSetComponent(engine_scene_t scene, engine_game_object_t game_object, engine_component_type_t type, const void* component)
+{
+    auto sc = scene_cast(scene);
+    sc->get_command_buffer().set_component(entity_cast(game_object), type, component);
+}
+
+engine_result_code_t engineScenePrefabInstantiate(engine_scene_t scene, engine_prefab_t prefab, uint32_t count, const engine_tranform_component_t* root_transforms, engine_game_object_t* out_roots)
+{
+    if (!scene || !prefab)
+    {
+        return ENGINE_RESULT_CODE_FAIL;
+    }
+    scene_cast(scene)->instantiate_prefab(*prefab_cast(prefab), count, root_transforms, out_roots);
+    return ENGINE_RESULT_CODE_OK;
+}
+
+engine_frame_arena_stats_t engineSceneGetFrameArenaStats(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return sc->get_frame_arena_stats();
+}
+
 void engineScenePhysicsSetGravityVector(engine_scene_t scene, const float gravity[3])
 {
     auto sc = scene_cast(scene);
@@ -567,7 +931,7 @@ engine_result_code_t engineCreateComponentView(engine_component_view_t* out)
 {
     if (out)
     {
-        *out = reinterpret_cast<engine_component_view_t>(new entt::runtime_view());
+        *out = reinterpret_cast<engine_component_view_t>(new engine::runtime_view_t());
         return ENGINE_RESULT_CODE_OK;
     }
 
@@ -780,6 +1144,94 @@ bool engineSceneHasBoneComponent(engine_scene_t scene, engine_game_object_t game
 }
 // -- 
 
+engine_animation_component_t engineSceneAddAnimationComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return add_component<engine_animation_component_t>(scene, game_object);
+}
+
+engine_animation_component_t engineSceneGetAnimationComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return get_component<engine_animation_component_t>(scene, game_object);
+}
+
+void engineSceneUpdateAnimationComponent(engine_scene_t scene, engine_game_object_t game_object, const engine_animation_component_t* comp)
+{
+    update_component(scene, game_object, comp);
+}
+
+void engineSceneRemoveAnimationComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    remove_component<engine_animation_component_t>(scene, game_object);
+}
+
+bool engineSceneHasAnimationComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return has_component<engine_animation_component_t>(scene, game_object);
+}
+
+void engineSceneSetAnimationLodSettings(engine_scene_t scene, const engine_animation_lod_settings_t* settings)
+{
+    auto sc = scene_cast(scene);
+    sc->set_animation_lod_settings(*settings);
+}
+
+engine_animation_lod_settings_t engineSceneGetAnimationLodSettings(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return sc->get_animation_lod_settings();
+}
+
+engine_animation_lod_stats_t engineSceneGetAnimationLodStats(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return sc->get_animation_lod_stats();
+}
+// -- 
+
+engine_nav_agent_component_t engineSceneAddNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return add_component<engine_nav_agent_component_t>(scene, game_object);
+}
+
+engine_nav_agent_component_t engineSceneGetNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return get_component<engine_nav_agent_component_t>(scene, game_object);
+}
+
+void engineSceneUpdateNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object, const engine_nav_agent_component_t* comp)
+{
+    update_component(scene, game_object, comp);
+}
+
+void engineSceneRemoveNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    remove_component<engine_nav_agent_component_t>(scene, game_object);
+}
+
+bool engineSceneHasNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object)
+{
+    return has_component<engine_nav_agent_component_t>(scene, game_object);
+}
+
+void engineSceneSetCrowdSettings(engine_scene_t scene, const engine_crowd_settings_t* settings)
+{
+    auto sc = scene_cast(scene);
+    sc->set_crowd_settings(*settings);
+}
+
+engine_crowd_settings_t engineSceneGetCrowdSettings(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return sc->get_crowd_settings();
+}
+
+engine_crowd_stats_t engineSceneGetCrowdStats(engine_scene_t scene)
+{
+    auto sc = scene_cast(scene);
+    return sc->get_crowd_stats();
+}
+// -- 
+
 engine_material_component_t engineSceneAddMaterialComponent(engine_scene_t scene, engine_game_object_t game_object)
 {
     return add_component<engine_material_component_t>(scene, game_object);
@@ -0,0 +1,211 @@
+#include "entity_command_buffer.h"
+#include "logger.h"
+#include "profiler.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+struct component_ops_t
+{
+    std::size_t size = 0;
+    void(*add)(registry_t& registry, entt::entity entity) = nullptr;
+    void(*set)(registry_t& registry, entt::entity entity, const std::byte* data) = nullptr;
+};
+
+template<typename T>
+constexpr component_ops_t make_component_ops()
+{
+    component_ops_t ops{};
+    ops.size = sizeof(T);
+    ops.add = [](registry_t& registry, entt::entity entity)
+    {
+        if (!registry.any_of<T>(entity))
+        {
+            registry.emplace<T>(entity);
+        }
+    };
+    ops.set = [](registry_t& registry, entt::entity entity, const std::byte* data)
+    {
+        // components are initialized on construction, so value is always applied with replace
+        if (!registry.any_of<T>(entity))
+        {
+            registry.emplace<T>(entity);
+        }
+        T component{};
+        std::memcpy(&component, data, sizeof(T));
+        registry.replace<T>(entity, component);
+    };
+    return ops;
+}
+
+// indexed with engine_component_type_t
+constexpr std::array<component_ops_t, ENGINE_COMPONENT_TYPE_COUNT> K_COMPONENTS_OPS =
+{
+    make_component_ops<engine_tranform_component_t>(),
+    make_component_ops<engine_name_component_t>(),
+    make_component_ops<engine_parent_component_t>(),
+    make_component_ops<engine_mesh_component_t>(),
+    make_component_ops<engine_material_component_t>(),
+    make_component_ops<engine_camera_component_t>(),
+    make_component_ops<engine_light_component_t>(),
+    make_component_ops<engine_rigid_body_component_t>(),
+    make_component_ops<engine_collider_component_t>(),
+    make_component_ops<engine_skin_component_t>(),
+    make_component_ops<engine_bone_component_t>(),
+    make_component_ops<engine_sprite_component_t>(),
+    make_component_ops<engine_animation_component_t>(),
+    make_component_ops<engine_nav_agent_component_t>(),
+};
+
+inline bool is_valid_component_type(engine_component_type_t type)
+{
+    if (type < 0 || type >= ENGINE_COMPONENT_TYPE_COUNT)
+    {
+        engine::log::log(engine::log::LogLevel::eError, fmt::format("Command buffer: unknown component type: {}\n", static_cast<std::int32_t>(type)));
+        assert(false && "Unknown component type");
+        return false;
+    }
+    return true;
+}
+}  // namespace anonymous
+
+entt::entity engine::EntityCommandBuffer::create(registry_t& registry)
+{
+    std::scoped_lock lock(mutex_);
+    return registry.create();
+}
+
+void engine::EntityCommandBuffer::destroy(entt::entity entity)
+{
+    std::scoped_lock lock(mutex_);
+    command_t cmd{};
+    cmd.type = CommandType::eDestroy;
+    cmd.entity = entity;
+    cmd.sequence = static_cast<std::uint32_t>(commands_.size());
+    commands_.push_back(cmd);
+}
+
+void engine::EntityCommandBuffer::add_component(entt::entity entity, engine_component_type_t type)
+{
+    if (!is_valid_component_type(type))
+    {
+        return;
+    }
+    std::scoped_lock lock(mutex_);
+    command_t cmd{};
+    cmd.type = CommandType::eAddComponent;
+    cmd.component = type;
+    cmd.entity = entity;
+    cmd.sequence = static_cast<std::uint32_t>(commands_.size());
+    commands_.push_back(cmd);
+}
+
+void engine::EntityCommandBuffer::set_component(entt::entity entity, engine_component_type_t type, const void* component)
+{
+    if (!is_valid_component_type(type) || !component)
+    {
+        return;
+    }
+    const auto size = K_COMPONENTS_OPS[type].size;
+    std::scoped_lock lock(mutex_);
+    command_t cmd{};
+    cmd.type = CommandType::eSetComponent;
+    cmd.component = type;
+    cmd.entity = entity;
+    cmd.sequence = static_cast<std::uint32_t>(commands_.size());
+    cmd.data_offset = static_cast<std::uint32_t>(data_.size());
+    data_.resize(data_.size() + size);
+    std::memcpy(data_.data() + cmd.data_offset, component, size);
+    commands_.push_back(cmd);
+}
+
+bool engine::EntityCommandBuffer::is_empty() const
+{
+    std::scoped_lock lock(mutex_);
+    return commands_.empty();
+}
+
+void engine::EntityCommandBuffer::apply(registry_t& registry)
+{
+    ENGINE_PROFILE_SECTION_N("entity_command_buffer_apply");
+    {
+        // commands recorded while applying the batch (i.e. from on_construct callbacks) go to the next batch
+        std::scoped_lock lock(mutex_);
+        batch_.swap(commands_);
+        batch_data_.swap(data_);
+        commands_.clear();
+        data_.clear();
+    }
+    if (batch_.empty())
+    {
+        return;
+    }
+
+    std::sort(batch_.begin(), batch_.end(), [](const command_t& lhs, const command_t& rhs)
+        {
+            const auto lhs_destroy = lhs.type == CommandType::eDestroy;
+            const auto rhs_destroy = rhs.type == CommandType::eDestroy;
+            if (lhs_destroy != rhs_destroy)
+            {
+                return rhs_destroy;
+            }
+            // destroys keep order of recording, i.e. children destroyed before their parent
+            if (lhs_destroy)
+            {
+                return lhs.sequence < rhs.sequence;
+            }
+            if (lhs.component != rhs.component)
+            {
+                return lhs.component < rhs.component;
+            }
+            if (lhs.entity != rhs.entity)
+            {
+                return lhs.entity < rhs.entity;
+            }
+            return lhs.sequence < rhs.sequence;
+        }
+    );
+
+    for (std::size_t i = 0; i < batch_.size(); i++)
+    {
+        const auto& cmd = batch_[i];
+        if (!registry.valid(cmd.entity))
+        {
+            continue;
+        }
+        switch (cmd.type)
+        {
+        case CommandType::eAddComponent:
+        {
+            K_COMPONENTS_OPS[cmd.component].add(registry, cmd.entity);
+            break;
+        }
+        case CommandType::eSetComponent:
+        {
+            // only the last value matters, the next command is set of the same component of the same entity
+            const auto is_overwritten = i + 1 < batch_.size() && batch_[i + 1].type == CommandType::eSetComponent
+                && batch_[i + 1].component == cmd.component && batch_[i + 1].entity == cmd.entity;
+            if (!is_overwritten)
+            {
+                K_COMPONENTS_OPS[cmd.component].set(registry, cmd.entity, batch_data_.data() + cmd.data_offset);
+            }
+            break;
+        }
+        case CommandType::eDestroy:
+        {
+            registry.destroy(cmd.entity);
+            break;
+        }
+        default:
+            assert(false && "Unknown command type");
+        }
+    }
+    batch_.clear();
+    batch_data_.clear();
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "engine.h"
+#include "memory_tracker.h"
+#include "entity_registry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace engine
+{
+// Records structural changes of the registry (create/destroy entities, add/set components)
+// and applies them later in one batch, when nothing iterates the registry.
+// Batch is applied sorted by: component operations grouped by component type, then entity, then order of recording,
+// and destroys at the very end, in order of recording. Consecutive sets of the same component of the same entity are collapsed into the last one,
+// so observers see single update per component per batch.
+// Recording is thread safe, apply() has to be called from the thread owning the registry.
+class EntityCommandBuffer
+{
+public:
+    EntityCommandBuffer() = default;
+    EntityCommandBuffer(const EntityCommandBuffer& rhs) = delete;
+    EntityCommandBuffer(EntityCommandBuffer&& rhs) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer& rhs) = delete;
+    EntityCommandBuffer& operator=(EntityCommandBuffer&& rhs) = delete;
+    ~EntityCommandBuffer() = default;
+
+    // entt can't reserve ids, so entity is created immediately - without components it's invisible for views and observers
+    entt::entity create(registry_t& registry);
+    void destroy(entt::entity entity);
+    void add_component(entt::entity entity, engine_component_type_t type);
+    void set_component(entt::entity entity, engine_component_type_t type, const void* component);
+
+    void apply(registry_t& registry);
+    bool is_empty() const;
+
+private:
+    enum class CommandType : std::uint8_t
+    {
+        eAddComponent = 0,
+        eSetComponent,
+        eDestroy  // last, so destroyed entities get all their commands applied (and removed) in the same batch
+    };
+
+    struct command_t
+    {
+        CommandType type = CommandType::eAddComponent;
+        engine_component_type_t component = ENGINE_COMPONENT_TYPE_COUNT;
+        entt::entity entity = entt::null;
+        std::uint32_t sequence = 0;
+        std::uint32_t data_offset = 0;  // in data_, for set
+    };
+
+private:
+    mutable std::mutex mutex_;
+    memory::tracked_vector<command_t, ENGINE_MEMORY_TAG_ECS> commands_;
+    memory::tracked_vector<std::byte, ENGINE_MEMORY_TAG_ECS> data_;
+    // reused between batches
+    memory::tracked_vector<command_t, ENGINE_MEMORY_TAG_ECS> batch_;
+    memory::tracked_vector<std::byte, ENGINE_MEMORY_TAG_ECS> batch_data_;
+};
+}  // namespace engine
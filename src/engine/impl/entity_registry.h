@@ -0,0 +1,14 @@
+#pragma once
+#include "engine.h"
+#include "memory_tracker.h"
+
+#include <entt/entt.hpp>
+
+namespace engine
+{
+// entities and components storage of the scene is tracked under ENGINE_MEMORY_TAG_ECS
+using registry_t = entt::basic_registry<entt::entity, memory::TrackingAllocator<entt::entity, ENGINE_MEMORY_TAG_ECS>>;
+using observer_t = entt::basic_observer<registry_t>;
+// views over storages of the registry, which base type differs from the default entt::sparse_set because of the allocator
+using runtime_view_t = entt::basic_runtime_view<registry_t::common_type>;
+}  // namespace engine
@@ -0,0 +1,108 @@
+#include "frame_arena.h"
+#include "memory_tracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace
+{
+inline std::size_t align_up(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+}  // namespace anonymous
+
+engine::FrameArena::FrameArena(std::size_t capacity)
+    : memory_resource_(this)
+{
+    for (auto& buffer : buffers_)
+    {
+        buffer.data = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        buffer.capacity = capacity;
+        memory::on_allocate(ENGINE_MEMORY_TAG_ECS, capacity);
+    }
+    stats_.capacity = capacity;
+}
+
+engine::FrameArena::~FrameArena()
+{
+    for (auto& buffer : buffers_)
+    {
+        release_overflow_blocks(buffer);
+        memory::on_free(ENGINE_MEMORY_TAG_ECS, buffer.capacity);
+    }
+}
+
+void* engine::FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    assert((alignment & (alignment - 1)) == 0 && "Alignment has to be power of 2.");
+    auto& buffer = buffers_[current_];
+    const auto base = reinterpret_cast<std::uintptr_t>(buffer.data.get());
+    const auto aligned_offset = align_up(base + buffer.offset, alignment) - base;
+    if (aligned_offset + size <= buffer.capacity)
+    {
+        buffer.required += aligned_offset + size - buffer.offset;
+        buffer.offset = aligned_offset + size;
+        return buffer.data.get() + aligned_offset;
+    }
+    buffer.required += size + alignment;
+    return allocate_overflow(buffer, size, alignment);
+}
+
+void engine::FrameArena::end_frame()
+{
+    const auto& finished = buffers_[current_];
+    stats_.used = finished.required;
+    stats_.peak_used = std::max(stats_.peak_used, finished.required);
+    stats_.overflow_count = finished.overflow_count;
+
+    current_ = (current_ + 1) % 2;
+    reset(buffers_[current_]);
+    stats_.capacity = std::max(buffers_[0].capacity, buffers_[1].capacity);
+}
+
+void* engine::FrameArena::allocate_overflow(buffer_t& buffer, std::size_t size, std::size_t alignment)
+{
+    alignment = std::max(alignment, alignof(overflow_block_t));
+    const auto header_size = align_up(sizeof(overflow_block_t), alignment);
+    const auto total_size = header_size + size;
+    auto* data = static_cast<std::byte*>(::operator new(total_size, std::align_val_t(alignment)));
+    auto* block = new (data) overflow_block_t{ buffer.overflow_blocks, total_size, alignment };
+    buffer.overflow_blocks = block;
+    buffer.overflow_count++;
+    memory::on_allocate(ENGINE_MEMORY_TAG_ECS, total_size);
+    return data + header_size;
+}
+
+void engine::FrameArena::release_overflow_blocks(buffer_t& buffer)
+{
+    while (buffer.overflow_blocks)
+    {
+        auto* block = buffer.overflow_blocks;
+        buffer.overflow_blocks = block->next;
+        memory::on_free(ENGINE_MEMORY_TAG_ECS, block->size);
+        ::operator delete(block, block->size, std::align_val_t(block->alignment));
+    }
+}
+
+void engine::FrameArena::reset(buffer_t& buffer)
+{
+    release_overflow_blocks(buffer);
+    if (buffer.required > buffer.capacity)
+    {
+        // the last frame didn't fit, so the next one (most likely) won't fit either
+        auto new_capacity = std::max<std::size_t>(buffer.capacity, 1024);
+        while (new_capacity < buffer.required)
+        {
+            new_capacity *= 2;
+        }
+        buffer.data = std::make_unique_for_overwrite<std::byte[]>(new_capacity);
+        memory::on_free(ENGINE_MEMORY_TAG_ECS, buffer.capacity);
+        memory::on_allocate(ENGINE_MEMORY_TAG_ECS, new_capacity);
+        buffer.capacity = new_capacity;
+    }
+    buffer.offset = 0;
+    buffer.required = 0;
+    buffer.overflow_count = 0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace engine
+{
+// Linear allocator for transient data of a frame. Two buffers are used in turns, so data allocated in the frame
+// stays valid until the end of the next frame (i.e. pointers returned to the user). Deallocation is a no-op,
+// memory is released at once when the buffer is reused. Not thread safe - used only from the thread updating the scene.
+// Allocations, which don't fit the buffer, fall back to the heap and the buffer grows when it's reused,
+// so after a few frames of warm up, frames don't allocate from the heap.
+class FrameArena
+{
+public:
+    struct stats_t
+    {
+        std::size_t capacity = 0;          // bytes of each of the buffers
+        std::size_t used = 0;              // bytes used by the last finished frame
+        std::size_t peak_used = 0;         // max of used, since creation
+        std::uint32_t overflow_count = 0;  // heap allocations of the last finished frame
+    };
+
+public:
+    FrameArena(std::size_t capacity);
+    FrameArena(const FrameArena& rhs) = delete;
+    FrameArena(FrameArena&& rhs) = delete;
+    FrameArena& operator=(const FrameArena& rhs) = delete;
+    FrameArena& operator=(FrameArena&& rhs) = delete;
+    ~FrameArena();
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    // std::pmr containers use it, i.e: std::pmr::vector<T> v(arena.get_memory_resource());
+    std::pmr::memory_resource* get_memory_resource() { return &memory_resource_; }
+
+    // switches to the other buffer: allocations of the frame before the last one are released
+    void end_frame();
+
+    stats_t get_stats() const { return stats_; }
+
+private:
+    class MemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        MemoryResource(FrameArena* arena) : arena_(arena) {}
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override { return arena_->allocate(bytes, alignment); }
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+        FrameArena* arena_;
+    };
+
+    // header placed in front of the heap allocation
+    struct overflow_block_t
+    {
+        overflow_block_t* next;
+        std::size_t size;  // with header
+        std::size_t alignment;
+    };
+
+    struct buffer_t
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t capacity = 0;
+        std::size_t offset = 0;
+        std::size_t required = 0;  // bytes requested in the frame, including overflows
+        std::uint32_t overflow_count = 0;
+        overflow_block_t* overflow_blocks = nullptr;  // intrusive list, so tracking them doesn't allocate
+    };
+
+private:
+    void* allocate_overflow(buffer_t& buffer, std::size_t size, std::size_t alignment);
+    void release_overflow_blocks(buffer_t& buffer);
+    void reset(buffer_t& buffer);
+
+private:
+    buffer_t buffers_[2];
+    std::uint32_t current_ = 0;
+    stats_t stats_;
+    MemoryResource memory_resource_;
+};
+}  // namespace engine
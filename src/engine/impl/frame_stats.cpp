@@ -0,0 +1,112 @@
+#include "frame_stats.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+struct frame_counters_t
+{
+    std::array<std::chrono::steady_clock::duration, ENGINE_FRAME_STAGE_COUNT> stages{};
+    std::uint32_t draw_calls = 0;
+    std::uint32_t state_changes = 0;
+    std::uint64_t triangles = 0;
+    std::uint32_t entities_count = 0;
+    std::uint32_t scenes_updated = 0;
+};
+
+// frame in progress, reset at the frame begin
+frame_counters_t g_counters;
+
+// profiler plots need names with static storage
+constexpr std::array<const char*, ENGINE_FRAME_STAGE_COUNT> K_STAGE_PLOT_NAMES =
+{
+    "frame_events_ms",
+    "frame_scene_update_ms",
+    "frame_command_buffer_ms",
+    "frame_animation_ms",
+    "frame_crowd_ms",
+    "frame_physics_ms",
+    "frame_transforms_ms",
+    "frame_hierarchy_ms",
+    "frame_lights_ms",
+    "frame_render_geometry_ms",
+    "frame_render_skinned_geometry_ms",
+    "frame_render_sprites_ms",
+    "frame_render_debug_ms",
+    "frame_post_process_ms",
+    "frame_ui_ms",
+    "frame_present_ms",
+};
+
+inline float to_ms(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+}  // namespace anonymous
+
+void engine::frame_stats::add_stage_time(engine_frame_stage_t stage, std::chrono::steady_clock::duration duration)
+{
+    assert(stage < ENGINE_FRAME_STAGE_COUNT);
+    g_counters.stages[stage] += duration;
+}
+
+void engine::frame_stats::add_draw_call(std::uint64_t triangles)
+{
+    g_counters.draw_calls++;
+    g_counters.triangles += triangles;
+}
+
+void engine::frame_stats::add_state_change()
+{
+    g_counters.state_changes++;
+}
+
+void engine::frame_stats::add_scene(std::uint32_t entities_count)
+{
+    g_counters.scenes_updated++;
+    g_counters.entities_count += entities_count;
+}
+
+void engine::FrameStatsHistory::begin_frame(float delta_time_ms)
+{
+    g_counters = frame_counters_t{};
+    frame_begin_ = std::chrono::steady_clock::now();
+    delta_time_ms_ = delta_time_ms;
+}
+
+void engine::FrameStatsHistory::end_frame()
+{
+    auto& frame = history_[frames_count_ % history_.size()];
+    frame.frame_index = frames_count_;
+    frame.delta_time_ms = delta_time_ms_;
+    frame.cpu_time_ms = to_ms(std::chrono::steady_clock::now() - frame_begin_);
+    for (std::uint32_t i = 0; i < ENGINE_FRAME_STAGE_COUNT; i++)
+    {
+        frame.stages_ms[i] = to_ms(g_counters.stages[i]);
+        ENGINE_PROFILE_VALUE(K_STAGE_PLOT_NAMES[i], frame.stages_ms[i]);
+    }
+    frame.draw_calls = g_counters.draw_calls;
+    frame.state_changes = g_counters.state_changes;
+    frame.triangles = g_counters.triangles;
+    frame.entities_count = g_counters.entities_count;
+    frame.scenes_updated = g_counters.scenes_updated;
+    frames_count_++;
+
+    ENGINE_PROFILE_VALUE("frame_cpu_ms", frame.cpu_time_ms);
+    ENGINE_PROFILE_VALUE("frame_draw_calls", static_cast<std::int64_t>(frame.draw_calls));
+    ENGINE_PROFILE_VALUE("frame_state_changes", static_cast<std::int64_t>(frame.state_changes));
+    ENGINE_PROFILE_VALUE("frame_triangles", static_cast<std::int64_t>(frame.triangles));
+    ENGINE_PROFILE_VALUE("frame_entities", static_cast<std::int64_t>(frame.entities_count));
+}
+
+std::uint32_t engine::FrameStatsHistory::get(std::span<engine_frame_stats_t> out) const
+{
+    const auto count = static_cast<std::uint32_t>(std::min<std::uint64_t>({ out.size(), frames_count_, history_.size() }));
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        out[i] = history_[(frames_count_ - 1 - i) % history_.size()];
+    }
+    return count;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "engine.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+namespace engine
+{
+namespace frame_stats
+{
+// Counters of the frame in progress. Not thread safe - updated only from the main (render) thread.
+void add_stage_time(engine_frame_stage_t stage, std::chrono::steady_clock::duration duration);
+void add_draw_call(std::uint64_t triangles);
+void add_state_change();
+void add_scene(std::uint32_t entities_count);
+
+// adds time from construction to destruction to the stage, used next to ENGINE_PROFILE_SECTION_N
+class ScopedStage
+{
+public:
+    ScopedStage(engine_frame_stage_t stage)
+        : stage_(stage)
+        , start_(std::chrono::steady_clock::now())
+    {
+    }
+    ScopedStage(const ScopedStage& rhs) = delete;
+    ScopedStage(ScopedStage&& rhs) = delete;
+    ScopedStage& operator=(const ScopedStage& rhs) = delete;
+    ScopedStage& operator=(ScopedStage&& rhs) = delete;
+    ~ScopedStage()
+    {
+        add_stage_time(stage_, std::chrono::steady_clock::now() - start_);
+    }
+
+private:
+    engine_frame_stage_t stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+}  // namespace frame_stats
+
+// Rolling history of finished frames. Counters are collected between begin_frame() and end_frame().
+class FrameStatsHistory
+{
+public:
+    void begin_frame(float delta_time_ms);
+    // pushes the frame to the history and plots its counters to the profiler
+    void end_frame();
+
+    // newest first, returns number of frames written
+    std::uint32_t get(std::span<engine_frame_stats_t> out) const;
+
+private:
+    std::array<engine_frame_stats_t, ENGINE_FRAME_STATS_HISTORY_SIZE> history_{};
+    std::uint64_t frames_count_ = 0;
+    std::chrono::steady_clock::time_point frame_begin_;
+    float delta_time_ms_ = 0.0f;
+};
+}  // namespace engine
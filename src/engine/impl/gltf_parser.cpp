@@ -2,6 +2,8 @@
 #include "math_helpers.h"
 #include "logger.h"
 #include "asset_store.h"
+#include "mesh_optimizer.h"
+#include "animation_compression.h"
 
 #define TINYGLTF_IMPLEMENTATION
 #include <tiny_gltf.h>
@@ -12,249 +14,445 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <limits>
 
 namespace
 {
-inline engine::GeometryInfo parse_mesh(const tinygltf::Mesh& mesh, const tinygltf::Model& model)
+inline std::uint32_t get_vertex_attribute_data_type_size(engine_vertex_attribute_data_type_t type)
 {
-    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#_mesh_primitive_mode
+    switch (type)
+    {
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT32:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT32:
+        return 4u;
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT16:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT16:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT16:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM16:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16:
+        return 2u;
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT8:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8:
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM8:
+        return 1u;
+    default:
+        assert(false && !"Unknown vertex attribute data type!");
+    }
+    return 0u;
+}
 
-    engine::GeometryInfo ret{};
-    ret.material_index = mesh.primitives.front().material;
-    //assert(mesh.primitives.size() == 1 && "Not enabled path for primitives count > 1");
+// reads single component of gltf accessor as float, takes care of normalized integers (KHR_mesh_quantization)
+inline float read_component(const unsigned char* ptr, std::int32_t component_type, bool normalized)
+{
+    auto read = [ptr]<typename T>(T) { T v; std::memcpy(&v, ptr, sizeof(T)); return v; };
+    switch (component_type)
+    {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:          return read(float{});
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   return static_cast<float>(read(std::uint32_t{}));
+    case TINYGLTF_COMPONENT_TYPE_INT:            return static_cast<float>(read(std::int32_t{}));
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: return normalized ? glm::unpackUnorm1x16(read(std::uint16_t{})) : static_cast<float>(read(std::uint16_t{}));
+    case TINYGLTF_COMPONENT_TYPE_SHORT:          return normalized ? glm::unpackSnorm1x16(read(std::uint16_t{})) : static_cast<float>(read(std::int16_t{}));
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  return normalized ? glm::unpackUnorm1x8(read(std::uint8_t{})) : static_cast<float>(read(std::uint8_t{}));
+    case TINYGLTF_COMPONENT_TYPE_BYTE:           return normalized ? glm::unpackSnorm1x8(read(std::uint8_t{})) : static_cast<float>(read(std::int8_t{}));
+    default:
+        assert(false && !"Unknown gltf component type!");
+    }
+    return 0.0f;
+}
 
-    for (std::size_t prim_idx = 0; prim_idx < mesh.primitives.size(); prim_idx++)
+// writes single component in engine data type, returns number of written bytes
+inline std::uint32_t write_component(std::byte* ptr, engine_vertex_attribute_data_type_t type, float value)
+{
+    auto write = [ptr]<typename T>(T v) { std::memcpy(ptr, &v, sizeof(T)); return static_cast<std::uint32_t>(sizeof(T)); };
+    switch (type)
     {
-        const auto& primitive = mesh.primitives[prim_idx];
-        assert(ret.material_index  == primitive.material && "Currently not supporting multi-material meshes!");
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32: return write(value);
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT32:  return write(static_cast<std::uint32_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT32:   return write(static_cast<std::int32_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT16:  return write(static_cast<std::uint16_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT16:   return write(static_cast<std::int16_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8:   return write(static_cast<std::uint8_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT8:    return write(static_cast<std::int8_t>(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT16: return write(glm::packHalf1x16(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM16: return write(glm::packUnorm1x16(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16: return write(glm::packSnorm1x16(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8:  return write(glm::packUnorm1x8(value));
+    case ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM8:  return write(glm::packSnorm1x8(value));
+    default:
+        assert(false && !"Unknown vertex attribute data type!");
+    }
+    return 0u;
+}
 
-        static const std::map<std::string, engine_vertex_attribute_type_t> expected_attrib_names = []()
-        {
-            std::map<std::string, engine_vertex_attribute_type_t> ret;
-            ret["POSITION"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION;
-            ret["NORMAL"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS;
-            ret["TEXCOORD_0"] = ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0;
-            ret["JOINTS_0"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0;
-            ret["WEIGHTS_0"]  = ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0;
-            return ret;
-        }();
+struct vertex_attrib_info_t
+{
+    const unsigned char* data = nullptr;
+    std::int32_t param_type = 0;
+    bool normalized = false;
+    std::size_t count = 0;
+    std::uint32_t num_components = 0;
+    std::uint32_t data_stride = 0;
 
-        static const std::map<engine_vertex_attribute_type_t, std::uint32_t> expected_num_components = []()
-        {
-            std::map<engine_vertex_attribute_type_t, std::uint32_t> ret;
-            ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION]  = 3u;
-            ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS]   = 3u;
-            ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0]      = 2u;
-            ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0]  = 4u;
-            ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0] = 4u;
-            return ret;
-        }();
+    std::vector<double> values_range_min;
+    std::vector<double> values_range_max;
 
-        struct attrib_info
-        {
-            const std::byte* data = nullptr;
-            std::uint32_t param_type = 0;
-            std::size_t count = 0;
-            std::uint32_t num_components = 0;
-            std::uint32_t data_stride = 0;
+    inline float get(std::size_t vertex_idx, std::uint32_t component) const
+    {
+        return read_component(data + vertex_idx * data_stride + component * tinygltf::GetComponentSizeInBytes(param_type), param_type, normalized);
+    }
+};
+using primitive_attribs_t = std::array<vertex_attrib_info_t, ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT>;
 
-            std::vector<double> values_range_min;
-            std::vector<double> values_range_max;
+// reads accessors of the primitive, returns false if primitive can't be loaded
+inline bool parse_primitive_attribs(const tinygltf::Primitive& primitive, const tinygltf::Mesh& mesh, const tinygltf::Model& model, primitive_attribs_t& attribs)
+{
+    static const std::map<std::string, engine_vertex_attribute_type_t> expected_attrib_names = []()
+    {
+        std::map<std::string, engine_vertex_attribute_type_t> ret;
+        ret["POSITION"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION;
+        ret["NORMAL"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS;
+        ret["TEXCOORD_0"] = ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0;
+        ret["JOINTS_0"]   = ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0;
+        ret["WEIGHTS_0"]  = ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0;
+        return ret;
+    }();
+
+    static const std::map<engine_vertex_attribute_type_t, std::uint32_t> expected_num_components = []()
+    {
+        std::map<engine_vertex_attribute_type_t, std::uint32_t> ret;
+        ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION]  = 3u;
+        ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS]   = 3u;
+        ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0]      = 2u;
+        ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0]  = 4u;
+        ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0] = 4u;
+        return ret;
+    }();
+
+    auto& position_data  = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION];
+    auto& normals_data   = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS];
+    auto& uv_0_data      = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0];
+    auto& joints_0_data  = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0];
+    auto& weights_0_data = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0];
+
+    for (const auto& attrib : primitive.attributes)
+    {
+        const auto& attrib_accesor = model.accessors[attrib.second];
+        const auto& buffer_view = model.bufferViews[attrib_accesor.bufferView];
+        const auto& buffer = model.buffers[buffer_view.buffer];
+
+        const auto attrib_num_components = tinygltf::GetNumComponentsInType(attrib_accesor.type);
+        const auto attrib_stride = attrib_accesor.ByteStride(model.bufferViews[attrib_accesor.bufferView]);
+
+        if (expected_attrib_names.find(attrib.first) != expected_attrib_names.end())
+        {
+            const auto attrib_type = expected_attrib_names.at(attrib.first);
+            attribs[attrib_type].data = buffer.data.data() + buffer_view.byteOffset + attrib_accesor.byteOffset;
+            attribs[attrib_type].count = attrib_accesor.count;
+            attribs[attrib_type].num_components = attrib_num_components;
+            attribs[attrib_type].param_type = attrib_accesor.componentType;
+            attribs[attrib_type].normalized = attrib_accesor.normalized;
+            attribs[attrib_type].data_stride = attrib_stride;
+            attribs[attrib_type].values_range_min = attrib_accesor.minValues;
+            attribs[attrib_type].values_range_max = attrib_accesor.maxValues;
+
+            assert(attribs[attrib_type].num_components == expected_num_components.at(attrib_type));
+        }
+        else
+        {
+            engine::log::log(engine::log::LogLevel::eError, fmt::format("Unexpected vertex attrivute: {} for mesh: {} \n", attrib.first, mesh.name));
+        }
+    }
 
-            inline std::size_t get_size() const
-            {
-                return count * num_components * tinygltf::GetComponentSizeInBytes(param_type);
-            }
-        };
-        std::array<attrib_info, ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT> attribs{};
-        
-        auto& position_data  = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION];
-        auto& normals_data   = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS];
-        auto& uv_0_data      = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0];
-        auto& joints_0_data  = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0];
-        auto& weights_0_data = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0];
+    // some validation
+    if (position_data.count == 0)
+    {
+        engine::log::log(engine::log::LogLevel::eCritical, 
+            fmt::format("Cant load mesh correctly. Count of positions: {}.\n", position_data.count));
+        return false;
+    }
 
-        for (const auto& attrib : primitive.attributes)
-        {
-            const auto& attrib_accesor = model.accessors[attrib.second];
-            const auto& buffer_view = model.bufferViews[attrib_accesor.bufferView];
-            const auto& buffer = model.buffers[buffer_view.buffer];
+    if (normals_data.count > 0 && normals_data.count != position_data.count)
+    {
+        engine::log::log(engine::log::LogLevel::eCritical,
+            fmt::format("Cant load mesh correctly. Count of positions: {}, count of uv: {}.\n",
+                position_data.count, uv_0_data.count));
+    }
 
-            const auto attrib_num_components = tinygltf::GetNumComponentsInType(attrib_accesor.type);
-            const auto attrib_stride = attrib_accesor.ByteStride(model.bufferViews[attrib_accesor.bufferView]);
+    if (joints_0_data.count != weights_0_data.count)
+    {
+        engine::log::log(engine::log::LogLevel::eError,
+            fmt::format("Cant load vertex joints and weights correctly. Will not load them.\n"));
+        joints_0_data = {};
+        weights_0_data = {};
+    }
 
-            //ToDo: this is not correct, bone indcies are 2 bytes (unsigned shorts)
+    if (joints_0_data.count > 0 && position_data.count != joints_0_data.count)
+    {
+        engine::log::log(engine::log::LogLevel::eCritical,
+            fmt::format("Cant load mesh correctly. Count of positions: {}, count of joints: {} .\n",
+                position_data.count, joints_0_data.count));
+    }
+    return true;
+}
 
-            if (expected_attrib_names.find(attrib.first) != expected_attrib_names.end())
+// Selects output format of each attribute, common for all primitives of the mesh (they share single vertex buffer).
+// Attribute missing in all primitives is not emitted at all - shader inputs are bound by attribute type (location),
+// so disabled vertex arrays will read default (constant) values. Attribute missing only in some primitives is zero filled.
+// Quantized formats:
+//  - normals:  snorm16 (or half float) with 4th component as padding to keep 4 bytes alignment,
+//  - uvs:      unorm16 if all values (of all primitives) are in [0, 1] range (no tiling), float otherwise,
+//  - joints:   uint8 if skin has less than 256 bones,
+//  - weights:  unorm8, renormalized so quantized weights sum up to 1.
+// Value ranges are union of ranges of all primitives.
+inline std::array<engine_vertex_attribute_desc_t, ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT> select_vertex_format(std::span<const primitive_attribs_t> primitives, const engine::ModelImportOptions& options)
+{
+    std::array<engine_vertex_attribute_desc_t, ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT> ret{};
+    std::array<bool, ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT> has_range{};
+    bool uvs_in_unit_range = true;
+    float max_joint = 0.0f;
+    for (const auto& attribs : primitives)
+    {
+        for (std::size_t i = 0; i < ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT; i++)
+        {
+            const auto& attrib = attribs[i];
+            if (!attrib.data)
             {
-                const auto attrib_type = expected_attrib_names.at(attrib.first);
-                attribs[attrib_type].data = reinterpret_cast<const std::byte*>(buffer.data.data() + buffer_view.byteOffset + attrib_accesor.byteOffset);
-                attribs[attrib_type].count = attrib_accesor.count;
-                attribs[attrib_type].num_components = attrib_num_components;
-                attribs[attrib_type].param_type = attrib_accesor.componentType;
-                attribs[attrib_type].data_stride = attrib_stride;
-                attribs[attrib_type].values_range_min = attrib_accesor.minValues;
-                attribs[attrib_type].values_range_max = attrib_accesor.maxValues;
-
-                assert(attribs[attrib_type].num_components == expected_num_components.at(attrib_type));
+                continue;
             }
-            else
+            ret[i].type = static_cast<engine_vertex_attribute_type_t>(i);
+            ret[i].elements_count = attrib.num_components;
+            for (std::size_t j = 0; j < std::min<std::size_t>({ attrib.values_range_min.size(), attrib.values_range_max.size(), 4 }); j++)
             {
-                engine::log::log(engine::log::LogLevel::eError, fmt::format("Unexpected vertex attrivute: {} for mesh: {} \n", attrib.first, mesh.name));
+                const auto range_min = static_cast<float>(attrib.values_range_min[j]);
+                const auto range_max = static_cast<float>(attrib.values_range_max[j]);
+                ret[i].range_min[j] = has_range[i] ? std::min(ret[i].range_min[j], range_min) : range_min;
+                ret[i].range_max[j] = has_range[i] ? std::max(ret[i].range_max[j], range_max) : range_max;
             }
+            has_range[i] = has_range[i] || !attrib.values_range_min.empty();
         }
-        // we can set number of vertices
-        ret.vertex_count = static_cast<std::int32_t>(position_data.count);
 
-        // some validation
-        if (position_data.count == 0)
+        const auto& uv_0_data = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0];
+        for (std::size_t i = 0; uv_0_data.data && uvs_in_unit_range && i < uv_0_data.count; i++)
         {
-            engine::log::log(engine::log::LogLevel::eCritical, 
-                fmt::format("Cant load mesh correctly. Count of positions: {}.\n", position_data.count));
+            for (std::uint32_t c = 0; c < uv_0_data.num_components; c++)
+            {
+                const auto v = uv_0_data.get(i, c);
+                uvs_in_unit_range &= v >= 0.0f && v <= 1.0f;
+            }
         }
 
-        if (normals_data.count > 0 && normals_data.count != position_data.count)
+        const auto& joints_0_data = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0];
+        for (std::size_t i = 0; joints_0_data.data && i < joints_0_data.count; i++)
         {
-            engine::log::log(engine::log::LogLevel::eCritical,
-                fmt::format("Cant load mesh correctly. Count of positions: {}, count of uv: {}.\n",
-                    position_data.count, uv_0_data.count));
+            for (std::uint32_t c = 0; c < joints_0_data.num_components; c++)
+            {
+                max_joint = std::max(max_joint, joints_0_data.get(i, c));
+            }
         }
+    }
 
-        if (joints_0_data.count != weights_0_data.count)
+    auto& position_format  = ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION];
+    auto& normals_format   = ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS];
+    auto& uv_0_format      = ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0];
+    auto& joints_0_format  = ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0];
+    auto& weights_0_format = ret[ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0];
+    position_format.elements_data_type = ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32;
+    position_format.elements_count = 3;
+    if (uv_0_format.elements_count > 0)
+    {
+        uv_0_format.elements_data_type = options.quantize_vertex_attributes && uvs_in_unit_range ? ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM16 : ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32;
+        uv_0_format.elements_count = 2;
+    }
+    if (normals_format.elements_count > 0)
+    {
+        if (options.quantize_vertex_attributes)
         {
-            engine::log::log(engine::log::LogLevel::eError,
-                fmt::format("Cant load vertex joints and weights correctly. Will not load them.\n"));
-            joints_0_data = {};
-            weights_0_data = {};
+            normals_format.elements_data_type = options.normals_as_half_float ? ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT16 : ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16;
+            normals_format.elements_count = 4;
         }
-
-        if (joints_0_data.count > 0 && position_data.count != joints_0_data.count)
+        else
         {
-            engine::log::log(engine::log::LogLevel::eCritical,
-                fmt::format("Cant load mesh correctly. Count of positions: {}, count of joints: {} .\n",
-                    position_data.count, joints_0_data.count));
+            normals_format.elements_data_type = ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32;
+            normals_format.elements_count = 3;
         }
+    }
+    if (joints_0_format.elements_count > 0)
+    {
+        joints_0_format.elements_data_type = options.quantize_vertex_attributes && max_joint <= 255.0f ? ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8 : ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT16;
+        joints_0_format.elements_count = 4;
+    }
+    if (weights_0_format.elements_count > 0)
+    {
+        weights_0_format.elements_data_type = options.quantize_vertex_attributes ? ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8 : ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32;
+        weights_0_format.elements_count = 4;
+    }
+    return ret;
+}
 
-        // Fill missing gaps  <- because we are using common shader
-        // ToDo: remove this and make shaders detect attributs components (should have better performance)
-        // This approach will have gaps in buffer -> waste of memory and performance
-        for (auto i = 0; i < attribs.size(); i++)
+// writes single vertex of the primitive in the selected format, returns number of written bytes
+inline std::uint32_t write_vertex(std::byte* dst, const primitive_attribs_t& attribs, std::span<const engine_vertex_attribute_desc_t> format, std::size_t vertex_idx)
+{
+    const auto* begin = dst;
+    for (std::size_t i = 0; i < format.size(); i++)
+    {
+        const auto& attrib = attribs[i];
+        const auto out_type = format[i].elements_data_type;
+        if (format[i].elements_count == 0)
         {
-            auto& attrib = attribs[i];
-            if (attrib.data)
-            {
-                continue;
-            }
-            attrib.num_components = expected_num_components.at(static_cast<engine_vertex_attribute_type_t>(i));
-            attrib.count = ret.vertex_count;
-            attrib.param_type = TINYGLTF_PARAMETER_TYPE_FLOAT;
+            continue;
         }
-
-        // create layout returned to user
+        if (out_type == ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8 && i == ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0 && attrib.data)
         {
-            auto to_engine_vertex_data_type = [](std::size_t tinygltf_param_type)
+            // quantize weights so they still sum up to 1: rounding error is moved to the biggest weight
+            std::array<std::int32_t, 4> qw{};
+            std::int32_t sum = 0;
+            std::size_t max_idx = 0;
+            for (std::uint32_t c = 0; c < 4; c++)
             {
-                switch (tinygltf_param_type)
-                {
-                case TINYGLTF_PARAMETER_TYPE_FLOAT:          return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32;
-                case TINYGLTF_PARAMETER_TYPE_INT:            return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT32;
-                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:   return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT32;
-                case TINYGLTF_PARAMETER_TYPE_SHORT:          return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT16;
-                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT16;
-                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:  return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8;
-                case TINYGLTF_PARAMETER_TYPE_BYTE:           return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT8;
-                default:
-                    assert(false && !"Unknown conversion of param type to engine vertex attribute data type!");
-                }
-                return ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNKNOWN;
-            };
-
-            std::size_t attrib_added_idx = 0;
-            for (std::size_t i = 0; i < ENGINE_VERTEX_ATTRIBUTE_TYPE_COUNT; i++)
+                qw[c] = static_cast<std::int32_t>(glm::packUnorm1x8(attrib.get(vertex_idx, c)));
+                sum += qw[c];
+                max_idx = qw[c] > qw[max_idx] ? c : max_idx;
+            }
+            if (sum > 0)
             {
-                if (attribs[i].num_components > 0)
-                {
-                    ret.vertex_laytout.attributes[attrib_added_idx].elements_data_type = to_engine_vertex_data_type(attribs[i].param_type);
-                    ret.vertex_laytout.attributes[attrib_added_idx].elements_count = attribs[i].num_components;
-                    ret.vertex_laytout.attributes[attrib_added_idx].type = static_cast<engine_vertex_attribute_type_t>(i);
-
-                    for (std::size_t j = 0; j < attribs[i].values_range_min.size(); j++)
-                    {
-                        ret.vertex_laytout.attributes[attrib_added_idx].range_min[j] = static_cast<float>(attribs[i].values_range_min[j]);
-                        ret.vertex_laytout.attributes[attrib_added_idx].range_max[j] = static_cast<float>(attribs[i].values_range_max[j]);
-                    }
-
-
-                    attrib_added_idx++;
-                }
+                qw[max_idx] = std::clamp(qw[max_idx] + (255 - sum), 0, 255);
             }
+            for (std::uint32_t c = 0; c < 4; c++)
+            {
+                dst[c] = static_cast<std::byte>(qw[c]);
+            }
+            dst += 4;
+            continue;
+        }
+        for (std::uint32_t c = 0; c < format[i].elements_count; c++)
+        {
+            const auto value = attrib.data && c < attrib.num_components ? attrib.get(vertex_idx, c) : 0.0f;
+            dst += write_component(dst, out_type, value);
         }
+    }
+    return static_cast<std::uint32_t>(dst - begin);
+}
+
+inline engine::GeometryInfo parse_mesh(const tinygltf::Mesh& mesh, const tinygltf::Model& model, const engine::ModelImportOptions& options)
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#_mesh_primitive_mode
+
+    engine::GeometryInfo ret{};
+    ret.material_index = mesh.primitives.front().material;
+    //assert(mesh.primitives.size() == 1 && "Not enabled path for primitives count > 1");
 
-        // verts buffer size
-        const auto total_verts_buffer_size = [&attribs]()
+    // first pass: accessors of all primitives, output format has to be known before any primitive is converted
+    std::vector<const tinygltf::Primitive*> primitives;
+    std::vector<primitive_attribs_t> primitives_attribs;
+    primitives.reserve(mesh.primitives.size());
+    primitives_attribs.reserve(mesh.primitives.size());
+    for (const auto& primitive : mesh.primitives)
+    {
+        assert(ret.material_index  == primitive.material && "Currently not supporting multi-material meshes!");
+        primitive_attribs_t attribs{};
+        if (parse_primitive_attribs(primitive, mesh, model, attribs))
         {
-            std::size_t ret = 0;
-            std::for_each(attribs.begin(), attribs.end(), [&ret](const auto& attrib) { ret += attrib.get_size(); });
-            return ret;
-        }();
-        const auto single_vertex_size = total_verts_buffer_size / position_data.count;
+            primitives.push_back(&primitive);
+            primitives_attribs.push_back(std::move(attribs));
+        }
+    }
+    if (primitives.empty())
+    {
+        return ret;
+    }
 
-        // copy data into buffer returned to user
-        ret.vertex_data.resize(total_verts_buffer_size, std::byte(0));    
-        auto* verts_ptr = ret.vertex_data.data();
-        for (auto i = 0; i < position_data.count; i++)
+    // create layout returned to user
+    const auto vertex_format = select_vertex_format(primitives_attribs, options);
+    std::uint32_t single_vertex_size = 0;
+    {
+        std::size_t attrib_added_idx = 0;
+        for (const auto& attrib_format : vertex_format)
         {
-            const std::size_t vertex_offset = i * single_vertex_size;
-            std::size_t attrib_offset = 0;
-            for (auto j = 0; j < attribs.size(); j++)
+            if (attrib_format.elements_count > 0)
             {
-                const auto& attrib = attribs[j];
-                const auto attrib_packed_stride = attrib.num_components * tinygltf::GetComponentSizeInBytes(attrib.param_type);
-                if (attrib.data)
-                {
-                    assert(attrib.data_stride != 0);
-                    std::memcpy(verts_ptr + vertex_offset + attrib_offset, attrib.data + i * attrib.data_stride, attrib_packed_stride);
-                }
-                assert(attrib.num_components != 0);
-                assert(attrib.param_type != 0);
-                attrib_offset += attrib_packed_stride;
+                ret.vertex_laytout.attributes[attrib_added_idx++] = attrib_format;
+                single_vertex_size += attrib_format.elements_count * get_vertex_attribute_data_type_size(attrib_format.elements_data_type);
             }
         }
+    }
+
+    // second pass: copy (and convert) data into buffers returned to user
+    // indices are kept as 32 bit until all primitives are parsed, than packed to smallest possible type
+    std::vector<std::uint32_t> indices;
+    for (std::size_t prim_idx = 0; prim_idx < primitives.size(); prim_idx++)
+    {
+        const auto& primitive = *primitives[prim_idx];
+        const auto& attribs = primitives_attribs[prim_idx];
+        const auto vertex_base = static_cast<std::uint32_t>(ret.vertex_count);
+        const auto primitive_vertex_count = attribs[ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION].count;
+
+        ret.vertex_data.resize(ret.vertex_data.size() + primitive_vertex_count * single_vertex_size, std::byte(0));
+        auto* verts_ptr = ret.vertex_data.data() + vertex_base * single_vertex_size;
+        for (std::size_t i = 0; i < primitive_vertex_count; i++)
+        {
+            [[maybe_unused]] const auto written = write_vertex(verts_ptr + i * single_vertex_size, attribs, vertex_format, i);
+            assert(written == single_vertex_size);
+        }
+        ret.vertex_count += static_cast<std::int32_t>(primitive_vertex_count);
 
         // inds
-        auto copy_inds_data = [](auto& out, const auto out_base_offset, const auto& typed_gltf_buffer)
+        if (primitive.indices < 0)
         {
-            for (auto i = 0; i < out.size() - out_base_offset; i++)
+            // non-indexed primitive, generate trivial indices
+            for (std::uint32_t i = 0; i < primitive_vertex_count; i++)
             {
-                out[i + out_base_offset] = typed_gltf_buffer[i];
+                indices.push_back(vertex_base + i);
             }
-        };
+            continue;
+        }
         const auto& index_accessor = model.accessors[primitive.indices];
-        const auto indicies_offset = ret.indicies.size();
-        ret.indicies.resize(indicies_offset + index_accessor.count);
-
         const auto& index_buffer_view = model.bufferViews[index_accessor.bufferView];
         const auto& index_buffer = model.buffers[index_buffer_view.buffer];
-        const auto index_buffer_data = index_buffer.data.data() + index_buffer_view.byteOffset;
-        //ToDo: Indicies are always typed casted to uint32_t, this is not optimal
-        // we can support u16 and u8 as well
-        if (index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+        const auto index_buffer_data = index_buffer.data.data() + index_buffer_view.byteOffset + index_accessor.byteOffset;
+        if (index_accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+            && index_accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT
+            && index_accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
         {
-            copy_inds_data(ret.indicies, indicies_offset, reinterpret_cast<const std::uint16_t*>(index_buffer_data));
-        }
-        else if (index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
-        {
-            copy_inds_data(ret.indicies, indicies_offset, reinterpret_cast<const std::uint32_t*>(index_buffer_data));
+            assert(false && "Unsupported indicies data type!");
+            continue;
         }
-        else if (index_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+        const auto index_size = tinygltf::GetComponentSizeInBytes(index_accessor.componentType);
+        indices.reserve(indices.size() + index_accessor.count);
+        for (std::size_t i = 0; i < index_accessor.count; i++)
         {
-            copy_inds_data(ret.indicies, indicies_offset, reinterpret_cast<const std::uint8_t*>(index_buffer_data));
+            indices.push_back(vertex_base + static_cast<std::uint32_t>(read_component(index_buffer_data + i * index_size, index_accessor.componentType, false)));
         }
-        else
+    }
+
+    if (options.optimize_meshes && !indices.empty())
+    {
+        engine::log::log(engine::log::LogLevel::eTrace, fmt::format("Optimizing mesh: {}\n", mesh.name));
+        engine::optimize_mesh(ret.vertex_data, single_vertex_size, 0 /* position is always first attribute */, indices, options.log_mesh_optimization_stats);
+        ret.vertex_count = static_cast<std::int32_t>(ret.vertex_data.size() / single_vertex_size);
+    }
+
+    // pack indices: 16 bit indices are enough if every vertex can be addressed
+    ret.index_count = static_cast<std::uint32_t>(indices.size());
+    if (ret.vertex_count <= std::numeric_limits<std::uint16_t>::max() + 1)
+    {
+        ret.index_data_type = ENGINE_INDEX_DATA_TYPE_UINT16;
+        ret.index_data.resize(indices.size() * sizeof(std::uint16_t));
+        auto* out = reinterpret_cast<std::uint16_t*>(ret.index_data.data());
+        for (std::size_t i = 0; i < indices.size(); i++)
         {
-            assert(false && "Unsupported indicies data type!");
+            out[i] = static_cast<std::uint16_t>(indices[i]);
         }
     }
+    else
+    {
+        ret.index_data_type = ENGINE_INDEX_DATA_TYPE_UINT32;
+        ret.index_data.resize(indices.size() * sizeof(std::uint32_t));
+        std::memcpy(ret.index_data.data(), indices.data(), ret.index_data.size());
+    }
 
     return ret;
 }
@@ -403,9 +601,30 @@ inline engine::AnimationClipInfo parse_animation(const tinygltf::Animation& anim
     return new_animation;
 }
 
+// key reduction is done here, so desc of the model references already reduced data, quantization is done when clip is created
+inline void compress_animation(engine::AnimationClipInfo& animation, float tolerance)
+{
+    std::size_t keys_before = 0;
+    std::size_t keys_after = 0;
+    float max_error = 0.0f;
+    for (auto& channel : animation.channels)
+    {
+        if (channel.timestamps.empty())
+        {
+            continue;
+        }
+        const auto components_count = static_cast<std::uint32_t>(channel.data.size() / channel.timestamps.size());
+        keys_before += channel.timestamps.size();
+        max_error = std::max(max_error, engine::reduce_animation_keys(channel.timestamps, channel.data, components_count, channel.type == engine::AnimationChannelType::eRotation, tolerance));
+        keys_after += channel.timestamps.size();
+    }
+    animation.quantize = true;
+    engine::log::log(engine::log::LogLevel::eTrace, fmt::format("Animation: {} keys reduced from {} to {}, max error: {}\n", animation.name, keys_before, keys_after, max_error));
+}
+
 }  // namespace anonymous
 
-engine::ModelInfo engine::parse_gltf_data_from_memory(std::span<const std::uint8_t> data, const std::string& base_dir)
+engine::ModelInfo engine::parse_gltf_data_from_memory(std::span<const std::uint8_t> data, const std::string& base_dir, const ModelImportOptions& options)
 {
     assert(!data.empty());
 
@@ -534,7 +753,7 @@ engine::ModelInfo engine::parse_gltf_data_from_memory(std::span<const std::uint8
     out.geometries.reserve(meshes_root_nodes_idx.size());
     std::for_each(model.meshes.begin(), model.meshes.end(), [&out, &model](const auto& mesh)
         {
-            out.geometries.push_back(parse_mesh(mesh, model));
+            out.geometries.push_back(parse_mesh(mesh, model, options));
         });
 
     // skins
@@ -546,9 +765,13 @@ engine::ModelInfo engine::parse_gltf_data_from_memory(std::span<const std::uint8
 
     // animations
     out.animations.reserve(model.animations.size());
-    std::for_each(model.animations.begin(), model.animations.end(), [&out, &model](const auto& animation)
+    std::for_each(model.animations.begin(), model.animations.end(), [&out, &model, &options](const auto& animation)
         {
             out.animations.push_back(parse_animation(animation, model));
+            if (options.compress_animations)
+            {
+                compress_animation(out.animations.back(), options.animation_compression_tolerance);
+            }
         });
 
     out.nodes = std::move(nodes);
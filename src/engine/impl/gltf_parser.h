@@ -20,7 +20,9 @@ struct GeometryInfo
     engine_vertex_attributes_layout_t vertex_laytout{};
     std::vector<std::byte> vertex_data;
     std::int32_t vertex_count = 0;
-    std::vector<std::uint32_t> indicies;
+    std::vector<std::byte> index_data;
+    engine_index_data_type_t index_data_type = ENGINE_INDEX_DATA_TYPE_UINT32;
+    std::uint32_t index_count = 0;
     std::int32_t material_index = INVALID_VALUE;
 };
 
@@ -60,6 +62,8 @@ struct AnimationClipInfo
 {
     std::string name;
     std::vector<AnimationChannelInfo> channels;
+    // translations and rotations are stored quantized by AnimationClip
+    bool quantize = false;
 };
 
 struct BoneInfo
@@ -102,6 +106,22 @@ struct ModelInfo
 };
 
 
+struct ModelImportOptions
+{
+    // store normals, uvs, joints and weights in compact (quantized) formats
+    bool quantize_vertex_attributes = true;
+    // used only with quantization, by default normals are stored as snorm16
+    bool normals_as_half_float = false;
+    // vertex deduplication, vertex cache, overdraw and vertex fetch optimization (see mesh_optimizer.h)
+    bool optimize_meshes = false;
+    // analyze meshes before and after every optimization step and log results (slow, for diagnostics only)
+    bool log_mesh_optimization_stats = false;
+    // remove animation keys reproduced by interpolation within tolerance, quantize rotations (smallest three) and translations (clip bounds)
+    bool compress_animations = false;
+    // max difference of translation, rotation and scale components of removed keys
+    float animation_compression_tolerance = 0.0001f;
+};
+
 // base dir to search for assets (i.e. images)
-ModelInfo parse_gltf_data_from_memory(std::span<const std::uint8_t> data, const std::string& base_dir);
+ModelInfo parse_gltf_data_from_memory(std::span<const std::uint8_t> data, const std::string& base_dir, const ModelImportOptions& options = {});
 } // namespace engine>
@@ -2,6 +2,8 @@
 #include "graphics.h"
 #include "asset_store.h"
 #include "logger.h"
+#include "memory_tracker.h"
+#include "frame_stats.h"
 
 #if __ANDROID__
 #define GLAD_GLES2_IMPLEMENTATION
@@ -24,12 +26,18 @@
 #include <cassert>
 #include <array>
 #include <iostream>
+#include <unordered_map>
 
 class SystemInterface_SDL;
 class RenderInterface_GL3;
 
 namespace
 {
+inline std::uint64_t triangles_count(engine::Geometry::Mode mode, std::uint32_t elements_count)
+{
+    return mode == engine::Geometry::Mode::eTriangles ? elements_count / 3 : 0;
+}
+
 inline std::uint32_t to_ogl_datatype(engine::DataLayout layout)
 {
     switch (layout)
@@ -100,6 +108,13 @@ inline std::uint8_t data_layout_bytes_width(engine::DataLayout layout)
     return GL_FALSE;
 }
 
+// mip chain adds 1/3 of the base level
+inline std::size_t texture_gpu_bytes(std::uint32_t width, std::uint32_t height, engine::DataLayout layout, bool generate_mipmaps)
+{
+    const auto base_level = static_cast<std::size_t>(width) * height * data_layout_bytes_width(layout);
+    return generate_mipmaps ? base_level + base_level / 3 : base_level;
+}
+
 inline std::uint32_t to_ogl_texture_border_clamp_mode(engine::TextureAddressClampMode mode)
 {
     switch (mode)
@@ -114,6 +129,74 @@ inline std::uint32_t to_ogl_texture_border_clamp_mode(engine::TextureAddressClam
     return GL_FALSE;
 }
 
+// UI renderer, which tracks memory of its geometries and textures (RmlUi handles don't know their size) and counts its draw calls
+class TrackedRenderInterfaceGL3 : public RenderInterface_GL3
+{
+public:
+    Rml::CompiledGeometryHandle CompileGeometry(Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices) override
+    {
+        const auto handle = RenderInterface_GL3::CompileGeometry(vertices, indices);
+        track(geometries_bytes_, handle, sizeof(Rml::Vertex) * vertices.size() + sizeof(int) * indices.size());
+        if (handle)
+        {
+            geometries_triangles_[handle] = static_cast<std::uint32_t>(indices.size() / 3);
+        }
+        return handle;
+    }
+
+    void RenderGeometry(Rml::CompiledGeometryHandle handle, Rml::Vector2f translation, Rml::TextureHandle texture) override
+    {
+        RenderInterface_GL3::RenderGeometry(handle, translation, texture);
+        const auto it = geometries_triangles_.find(handle);
+        engine::frame_stats::add_draw_call(it != geometries_triangles_.end() ? it->second : 0);
+    }
+
+    void ReleaseGeometry(Rml::CompiledGeometryHandle handle) override
+    {
+        untrack(geometries_bytes_, handle);
+        geometries_triangles_.erase(handle);
+        RenderInterface_GL3::ReleaseGeometry(handle);
+    }
+
+    Rml::TextureHandle GenerateTexture(Rml::Span<const Rml::byte> source_data, Rml::Vector2i source_dimensions) override
+    {
+        const auto handle = RenderInterface_GL3::GenerateTexture(source_data, source_dimensions);
+        track(textures_bytes_, handle, static_cast<std::size_t>(source_dimensions.x) * source_dimensions.y * 4);
+        return handle;
+    }
+
+    void ReleaseTexture(Rml::TextureHandle handle) override
+    {
+        untrack(textures_bytes_, handle);
+        RenderInterface_GL3::ReleaseTexture(handle);
+    }
+
+private:
+    static void track(std::unordered_map<std::uintptr_t, std::size_t>& sizes, std::uintptr_t handle, std::size_t bytes)
+    {
+        if (handle)
+        {
+            sizes[handle] = bytes;
+            engine::memory::on_allocate(ENGINE_MEMORY_TAG_UI, bytes);
+        }
+    }
+
+    static void untrack(std::unordered_map<std::uintptr_t, std::size_t>& sizes, std::uintptr_t handle)
+    {
+        const auto it = sizes.find(handle);
+        if (it != sizes.end())
+        {
+            engine::memory::on_free(ENGINE_MEMORY_TAG_UI, it->second);
+            sizes.erase(it);
+        }
+    }
+
+private:
+    std::unordered_map<std::uintptr_t, std::size_t> geometries_bytes_;
+    std::unordered_map<std::uintptr_t, std::uint32_t> geometries_triangles_;
+    std::unordered_map<std::uintptr_t, std::size_t> textures_bytes_;
+};
+
 }
 
 
@@ -123,29 +206,43 @@ engine::Shader::Shader(const std::vector<std::string>& vertex_shader_name, const
 , program_(glCreateProgram())
 {
     log::log(log::LogLevel::eTrace, fmt::format("[Trace][Program] Creating shaders: \t\n"));
-	// compile shaders and link to program
-	{
-        for (const auto& s : vertex_shader_name)
-        {
-            log::log(log::LogLevel::eTrace, fmt::format("\t[Trace][Program] Vertex shader: {}\n", s));
-        }
+    auto load_sources = [](const std::vector<std::string>& names, std::string_view type_name)
+    {
         std::vector<std::string> sources;
-        sources.reserve(vertex_shader_name.size());
-        std::for_each(vertex_shader_name.begin(), vertex_shader_name.end(), [&sources](const auto& s) { sources.push_back(AssetStore::get_instance().get_shader_source(s)); });
-		vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
-        compile_and_attach_to_program(vertex_shader_, sources);
-	}
-	{
-        for (const auto& s : fragment_shader_name)
+        sources.reserve(names.size());
+        for (const auto& s : names)
         {
-            log::log(log::LogLevel::eTrace, fmt::format("\t[Trace][Program] Fragment shader: {}\n", s));
+            log::log(log::LogLevel::eTrace, fmt::format("\t[Trace][Program] {} shader: {}\n", type_name, s));
+            sources.push_back(AssetStore::get_instance().get_shader_source(s));
         }
-        std::vector<std::string> sources;
-        sources.reserve(fragment_shader_name.size());
-        std::for_each(fragment_shader_name.begin(), fragment_shader_name.end(), [&sources](const auto& s) { sources.push_back(AssetStore::get_instance().get_shader_source(s)); });
-		fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
-        compile_and_attach_to_program(fragment_shader_, sources);
-	}
+        return sources;
+    };
+    if (!compile_and_link(load_sources(vertex_shader_name, "Vertex"), load_sources(fragment_shader_name, "Fragment")))
+    {
+        assert(false && "Failed shader compilation!");
+    }
+}
+
+engine::Shader engine::Shader::create_from_sources(const std::vector<std::string>& vertex_shader_sources, const std::vector<std::string>& fragment_shader_sources)
+{
+    Shader ret;
+    ret.program_ = glCreateProgram();
+    if (!ret.compile_and_link(vertex_shader_sources, fragment_shader_sources))
+    {
+        // ret destructor releases partially created gl objects
+        return Shader{};
+    }
+    return ret;
+}
+
+bool engine::Shader::compile_and_link(const std::vector<std::string>& vertex_shader_sources, const std::vector<std::string>& fragment_shader_sources)
+{
+	// compile shaders and link to program
+    vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
+    compile_and_attach_to_program(vertex_shader_, vertex_shader_sources);
+    fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
+    compile_and_attach_to_program(fragment_shader_, fragment_shader_sources);
+
 	// link attached shaders
 	glLinkProgram(program_);
 	int32_t success = 0;
@@ -155,8 +252,9 @@ engine::Shader::Shader(const std::vector<std::string>& vertex_shader_name, const
 		std::array<char, 512> info_log;
 		glGetProgramInfoLog(program_, 512, nullptr, info_log.data());
 		log::log(log::LogLevel::eCritical, fmt::format("[Error][Program] Failed program linking: \n\t {}", info_log.data()));
-        assert(false && "Failed shader compilation!");
+        return false;
 	}
+    return true;
 }
 
 engine::Shader::Shader(Shader&& rhs) noexcept
@@ -202,6 +300,7 @@ void engine::Shader::bind() const
 {
     assert(is_valid() && "[ERROR] Invalid shader program.");
 	glUseProgram(program_);
+	frame_stats::add_state_change();
 }
 
 void engine::Shader::set_uniform_f4(std::string_view name, std::span<const float> host_data)
@@ -352,14 +451,19 @@ inline auto generate_opengl_texture(std::uint32_t width, std::uint32_t height, e
 
 engine::Texture2D::Texture2D(std::uint32_t width, std::uint32_t height, bool generate_mipmaps, const void* data, DataLayout layout, TextureAddressClampMode clamp_mode)
 	: texture_(generate_opengl_texture(width, height, layout, generate_mipmaps, data, clamp_mode))
+	, gpu_bytes_(texture_gpu_bytes(width, height, layout, generate_mipmaps))
 {
-	
+	memory::on_allocate(ENGINE_MEMORY_TAG_GPU_TEXTURES, gpu_bytes_);
 }
 
 engine::Texture2D::Texture2D(std::string_view texture_name, bool generate_mipmaps)
+	: Texture2D(AssetStore::get_instance().get_texture_data(texture_name), generate_mipmaps)
+{
+}
+
+engine::Texture2D::Texture2D(const TextureAssetContext& texture_data, bool generate_mipmaps)
 	: texture_(0)
 {
-	const auto texture_data = AssetStore::get_instance().get_texture_data(texture_name);
 	assert(texture_data.get_width() != 0);
 	assert(texture_data.get_height() != 0);
 	assert(texture_data.get_channels() != 0);
@@ -389,6 +493,8 @@ engine::Texture2D::Texture2D(std::string_view texture_name, bool generate_mipmap
     }
 
 	texture_ = generate_opengl_texture(texture_data.get_width(), texture_data.get_height(), dt, generate_mipmaps, texture_data.get_data_ptr(), TextureAddressClampMode::eClampToEdge);
+	gpu_bytes_ = texture_gpu_bytes(texture_data.get_width(), texture_data.get_height(), dt, generate_mipmaps);
+	memory::on_allocate(ENGINE_MEMORY_TAG_GPU_TEXTURES, gpu_bytes_);
 }
 
 engine::Texture2D engine::Texture2D::create_and_attach_to_frame_buffer(std::uint32_t width, std::uint32_t height, DataLayout layout, std::size_t idx)
@@ -404,6 +510,7 @@ engine::Texture2D engine::Texture2D::create_and_attach_to_frame_buffer(std::uint
 engine::Texture2D::Texture2D(Texture2D&& rhs) noexcept
 {
 	std::swap(texture_, rhs.texture_);
+	std::swap(gpu_bytes_, rhs.gpu_bytes_);
 }
 
 engine::Texture2D& engine::Texture2D::operator=(Texture2D&& rhs) noexcept
@@ -411,6 +518,7 @@ engine::Texture2D& engine::Texture2D::operator=(Texture2D&& rhs) noexcept
 	if (this != &rhs)
 	{
 		std::swap(texture_, rhs.texture_);
+		std::swap(gpu_bytes_, rhs.gpu_bytes_);
 	}
 	return *this;
 }
@@ -420,6 +528,7 @@ engine::Texture2D::~Texture2D()
 	if (texture_)
 	{
 		glDeleteTextures(1, &texture_);
+		memory::on_free(ENGINE_MEMORY_TAG_GPU_TEXTURES, gpu_bytes_);
 	}
 }
 
@@ -441,14 +550,21 @@ void engine::Texture2D::bind(std::uint32_t slot) const
 	assert(texture_ != 0);
 	glActiveTexture(GL_TEXTURE0 + slot);
 	glBindTexture(GL_TEXTURE_2D, texture_);
+	frame_stats::add_state_change();
 }
 
 engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, std::span<const std::byte> vertex_data, std::int32_t vertex_count, std::span<const std::uint32_t> index_data)
+    : Geometry(vertex_layout, vertex_data, vertex_count, std::as_bytes(index_data), IndexType::eUint32)
+{
+}
+
+engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, std::span<const std::byte> vertex_data, std::int32_t vertex_count, std::span<const std::byte> index_data, IndexType index_type)
 	: vbo_(0)
 	, vao_(0)
 	, ibo_(0)
 	, vertex_count_(vertex_count)
 	, index_count_(0)
+    , index_type_(index_type)
 {
     if (vertex_layout.empty())
     {
@@ -468,11 +584,13 @@ engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, st
     glGenBuffers(1, &vbo_);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
 	glBufferData(GL_ARRAY_BUFFER, vertex_data.size_bytes(), vertex_data.data(), GL_STATIC_DRAW);
+	gpu_bytes_ = vertex_data.size_bytes();
 
 	// vertex layout 
     std::for_each(vertex_layout.begin(), vertex_layout.end(), [this](const vertex_attribute_t& vl)
         {
             bool use_float_attrib = false;  // we dont want to cast ints to floats with glVertexAttribPointer
+            bool normalized = false;
 			std::uint32_t gl_type = 0;
 			switch (vl.type)
 			{
@@ -497,6 +615,30 @@ engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, st
                 break;
             case vertex_attribute_t::Type::eInt8:
                 gl_type = GL_BYTE;
+                break;
+            case vertex_attribute_t::Type::eFloat16:
+                gl_type = GL_HALF_FLOAT;
+                use_float_attrib = true;
+                break;
+            case vertex_attribute_t::Type::eUnorm16:
+                gl_type = GL_UNSIGNED_SHORT;
+                use_float_attrib = true;
+                normalized = true;
+                break;
+            case vertex_attribute_t::Type::eSnorm16:
+                gl_type = GL_SHORT;
+                use_float_attrib = true;
+                normalized = true;
+                break;
+            case vertex_attribute_t::Type::eUnorm8:
+                gl_type = GL_UNSIGNED_BYTE;
+                use_float_attrib = true;
+                normalized = true;
+                break;
+            case vertex_attribute_t::Type::eSnorm8:
+                gl_type = GL_BYTE;
+                use_float_attrib = true;
+                normalized = true;
                 break;
 			default:
 				assert("Unknown vertex attirubute tpye!");
@@ -505,7 +647,8 @@ engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, st
             if (use_float_attrib)
             {
                 // if intiget is used with this function than it will be implictly casted to float
-                glVertexAttribPointer(vl.index, vl.size, gl_type, GL_FALSE, vl.stride, (void*)vl.offset);
+                // normalized integers are mapped to [0, 1] or [-1, 1] range
+                glVertexAttribPointer(vl.index, vl.size, gl_type, normalized ? GL_TRUE : GL_FALSE, vl.stride, (void*)vl.offset);
             }
             else
             {
@@ -524,11 +667,14 @@ engine::Geometry::Geometry(std::span<const vertex_attribute_t> vertex_layout, st
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_data.size_bytes(), index_data.data(), GL_STATIC_DRAW);
-		index_count_ = static_cast<std::uint32_t>(index_data.size());
+		gpu_bytes_ += index_data.size_bytes();
+        const auto index_size = index_type_ == IndexType::eUint16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		index_count_ = static_cast<std::uint32_t>(index_data.size_bytes() / index_size);
 	}
 
 	// unbind at the end so both vbo_ and ibo_ are part of VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	memory::on_allocate(ENGINE_MEMORY_TAG_GPU_BUFFERS, gpu_bytes_);
 }
 
 engine::Geometry::Geometry(std::uint32_t vertex_count)
@@ -544,7 +690,9 @@ engine::Geometry::Geometry(Geometry&& rhs) noexcept
 	std::swap(vao_, rhs.vao_);
 	std::swap(vertex_count_, rhs.vertex_count_);
 	std::swap(index_count_, rhs.index_count_);
+	std::swap(index_type_, rhs.index_type_);
 	std::swap(attribs_, rhs.attribs_);
+	std::swap(gpu_bytes_, rhs.gpu_bytes_);
 }
 
 engine::Geometry& engine::Geometry::operator=(Geometry&& rhs) noexcept
@@ -556,7 +704,9 @@ engine::Geometry& engine::Geometry::operator=(Geometry&& rhs) noexcept
 		std::swap(vao_, rhs.vao_);
 		std::swap(vertex_count_, rhs.vertex_count_);
 		std::swap(index_count_, rhs.index_count_);
+		std::swap(index_type_, rhs.index_type_);
 		std::swap(attribs_, rhs.attribs_);
+		std::swap(gpu_bytes_, rhs.gpu_bytes_);
 	}
 	return *this;
 }
@@ -575,11 +725,16 @@ engine::Geometry::~Geometry()
 	{
 		glDeleteBuffers(1, &vbo_);
 	}
+	if (gpu_bytes_)
+	{
+		memory::on_free(ENGINE_MEMORY_TAG_GPU_BUFFERS, gpu_bytes_);
+	}
 }
 
 void engine::Geometry::bind() const
 {
 	glBindVertexArray(vao_);
+	frame_stats::add_state_change();
 }
 
 void engine::Geometry::draw(Mode mode) const
@@ -600,12 +755,13 @@ void engine::Geometry::draw(Mode mode) const
 
 	if (ibo_)
 	{
-		glDrawElements(gl_mode, index_count_, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(gl_mode, index_count_, index_type_ == IndexType::eUint16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, nullptr);
 	}
 	else
 	{
 		glDrawArrays(gl_mode, 0, vertex_count_);
 	}
+	frame_stats::add_draw_call(triangles_count(mode, ibo_ ? index_count_ : vertex_count_));
 }
 
 void engine::Geometry::draw_instances(Mode mode, std::uint32_t instance_count) const
@@ -626,17 +782,23 @@ void engine::Geometry::draw_instances(Mode mode, std::uint32_t instance_count) c
 
     if (ibo_)
     {
-        glDrawElementsInstanced(gl_mode, index_count_, GL_UNSIGNED_INT, nullptr, instance_count);
+        glDrawElementsInstanced(gl_mode, index_count_, index_type_ == IndexType::eUint16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, nullptr, instance_count);
     }
     else
     {
         glDrawArraysInstanced(gl_mode, 0, vertex_count_, instance_count);
     }
+    frame_stats::add_draw_call(triangles_count(mode, ibo_ ? index_count_ : vertex_count_) * instance_count);
 }
 
 engine::Geometry::vertex_attribute_t engine::Geometry::get_vertex_attribute(std::size_t idx) const
 {
-    return attribs_.at(idx);
+    const auto it = std::find_if(attribs_.begin(), attribs_.end(), [idx](const vertex_attribute_t& a) { return a.index == idx; });
+    if (it == attribs_.end())
+    {
+        return {};
+    }
+    return *it;
 }
 #if defined(GLAD_GL_IMPLEMENTATION)
 inline void GLAPIENTRY
@@ -821,7 +983,7 @@ engine::RenderContext::RenderContext(std::string_view window_name, viewport_t in
     
     // UI stuff 
     ui_rml_sdl_interface_ = new SystemInterface_SDL;
-    ui_rml_gl3_renderer_ = new RenderInterface_GL3;
+    ui_rml_gl3_renderer_ = new TrackedRenderInterfaceGL3;
     ui_rml_sdl_interface_->SetWindow(window_);
     const auto window_size = get_window_size_in_pixels();
     set_viewport(viewport_t{0, 0, (uint32_t)window_size.width, (uint32_t)window_size.height});
@@ -1155,6 +1317,7 @@ engine::UniformBuffer::UniformBuffer(std::size_t size)
     // GL_STATIC_DRAW? 
     glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
     unbind();
+    memory::on_allocate(ENGINE_MEMORY_TAG_GPU_BUFFERS, size_);
 }
 
 engine::UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept
@@ -1178,6 +1341,7 @@ engine::UniformBuffer::~UniformBuffer()
     if (ubo_)
     {
         glDeleteBuffers(1, &ubo_);
+        memory::on_free(ENGINE_MEMORY_TAG_GPU_BUFFERS, size_);
     }
 }
 
@@ -1241,6 +1405,7 @@ engine::ShaderStorageBuffer::ShaderStorageBuffer(std::size_t size)
     // GL_STATIC_DRAW? 
     glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
     unbind();
+    memory::on_allocate(ENGINE_MEMORY_TAG_GPU_BUFFERS, size_);
 }
 
 engine::ShaderStorageBuffer::ShaderStorageBuffer(ShaderStorageBuffer&& rhs) noexcept
@@ -1264,6 +1429,7 @@ engine::ShaderStorageBuffer::~ShaderStorageBuffer()
     if (ssbo_)
     {
         glDeleteBuffers(1, &ssbo_);
+        memory::on_free(ENGINE_MEMORY_TAG_GPU_BUFFERS, size_);
     }
 }
 
@@ -59,6 +59,8 @@ public:
 public:
     Shader() = default;
 	Shader(const std::vector<std::string>& vertex_shader_name, const std::vector<std::string>& fragment_shader_name);
+    // doesnt assert on compilation errors, returns invalid shader instead (used by hot reload)
+    static Shader create_from_sources(const std::vector<std::string>& vertex_shader_sources, const std::vector<std::string>& fragment_shader_sources);
 	Shader(const Shader& rhs) = delete;
     Shader(Shader&& rhs) noexcept;
 	Shader& operator=(const Shader& rhs) = delete;
@@ -83,6 +85,7 @@ private:
     std::int32_t get_resource_location(std::string_view name, std::int32_t resource_interface);
     std::int32_t get_uniform_location(std::string_view name);
 	void compile_and_attach_to_program(std::uint32_t shader, std::span<const std::string> sources);
+    bool compile_and_link(const std::vector<std::string>& vertex_shader_sources, const std::vector<std::string>& fragment_shader_sources);
 
 private:
     std::uint32_t vertex_shader_{ 0 };
@@ -99,6 +102,7 @@ public:
 	Texture2D() = default;
 	Texture2D(std::uint32_t width, std::uint32_t height, bool generate_mipmaps, const void* data, DataLayout layout, TextureAddressClampMode clamp_mode);
 	Texture2D(std::string_view texture_name, bool generate_mipmaps);  
+	Texture2D(const class TextureAssetContext& texture_data, bool generate_mipmaps);
     static Texture2D create_and_attach_to_frame_buffer(std::uint32_t width, std::uint32_t height, DataLayout layout, std::size_t idx);
 
 	Texture2D(const Texture2D& rhs) = delete;
@@ -114,6 +118,7 @@ public:
 
 private:
 	std::uint32_t texture_ = 0;
+	std::size_t gpu_bytes_ = 0;  // tracked memory
 };
 
 class Framebuffer
@@ -170,6 +175,14 @@ public:
             eUint8,
             eInt8,
 
+            eFloat16,
+
+            // normalized integers (read as floats by shader)
+            eUnorm16,
+            eSnorm16,
+            eUnorm8,
+            eSnorm8,
+
 			eCount
 		};
 		std::uint32_t index = 0;
@@ -182,9 +195,16 @@ public:
         std::vector<float> range_min;
 	};
 
+    enum class IndexType
+    {
+        eUint32 = 0,
+        eUint16,
+    };
+
 public:
 	Geometry() = default;
 	Geometry(std::span<const vertex_attribute_t> vertex_layout, std::span<const std::byte> vertex_data, std::int32_t vertex_count, std::span<const std::uint32_t> index_data = {});
+	Geometry(std::span<const vertex_attribute_t> vertex_layout, std::span<const std::byte> vertex_data, std::int32_t vertex_count, std::span<const std::byte> index_data, IndexType index_type);
     Geometry(std::uint32_t vertex_count); // empty geometry, no data (used for full screen quad rendering when vertex data is already present in the shader)
 	Geometry(const Geometry& rhs) = delete;
 	Geometry(Geometry&& rhs) noexcept;
@@ -197,15 +217,18 @@ public:
 	void draw(Mode mode) const;
     void draw_instances(Mode mode, std::uint32_t instance_count) const;
 
+    // idx is shader input location of the attribute, returns empty attribute if geometry does not have it
     vertex_attribute_t get_vertex_attribute(std::size_t idx) const;
 
 private:
     std::vector<vertex_attribute_t> attribs_{};
+    IndexType index_type_{ IndexType::eUint32 };
 	std::uint32_t vbo_{0}; // vertex buffer
 	std::uint32_t ibo_{0}; // index buffer
 	std::uint32_t vao_{0};
 	std::uint32_t vertex_count_{0};
 	std::uint32_t index_count_{0};
+	std::size_t gpu_bytes_{0};  // tracked memory of vertex and index buffers
 };
 
 class UniformBuffer
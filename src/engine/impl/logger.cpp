@@ -1,7 +1,16 @@
 #include "logger.h"
 
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <unordered_map>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4127) // disable warning
@@ -17,41 +26,290 @@
 #include <android/log.h>
 #endif
 
+namespace
+{
 struct LogLevelTraits
 {
     const char* name;
     fmt::color color;
 };
 
-inline std::unordered_map<engine::log::LogLevel, LogLevelTraits> LOG_LEVEL_LUT =
+// indexed with LogLevel
+constexpr std::array<LogLevelTraits, 3> LOG_LEVEL_LUT =
+{ {
+    {"TRACE", fmt::color::white},
+    {"ERROR", fmt::color::medium_violet_red},
+    {"CRITICAL", fmt::color::red},
+} };
+
+constexpr std::size_t K_RECORD_SIZE = 256;
+constexpr std::size_t K_RECORDS_COUNT = 4096;  // power of 2
+static_assert((K_RECORDS_COUNT & (K_RECORDS_COUNT - 1)) == 0, "Records count has to be power of 2.");
+constexpr std::size_t K_SINK_BUFFER_SIZE = 64 * 1024;
+
+struct alignas(64) record_t
 {
-    { engine::log::LogLevel::eTrace,      {"TRACE", fmt::color::white} },
-    { engine::log::LogLevel::eError,      {"ERROR", fmt::color::medium_violet_red} },
-    { engine::log::LogLevel::eCritical,   {"CRITICAL", fmt::color::red} },
+    // ring buffer slot state: equal to the position - free for producer, position + 1 - ready for consumer
+    std::atomic<std::uint64_t> sequence{ 0 };
+    std::chrono::system_clock::time_point time;
+    engine::log::LogLevel level = engine::log::LogLevel::eTrace;
+    std::uint32_t size = 0;
+    char text[K_RECORD_SIZE - sizeof(std::atomic<std::uint64_t>) - sizeof(std::chrono::system_clock::time_point) - 2 * sizeof(std::uint32_t)];
 };
+static_assert(sizeof(record_t) == K_RECORD_SIZE);
 
-template<typename Stream, typename T>
-inline Stream& streamin(Stream& s, const T& t)
+inline void append_to_sink(fmt::memory_buffer& buffer, engine::log::LogLevel level, std::chrono::system_clock::time_point time, std::string_view msg)
 {
-    s << t;
-    return s;
+    const auto& log_level_trait = LOG_LEVEL_LUT[static_cast<std::size_t>(level)];
+#if __ANDROID__
+    fmt::format_to(std::back_inserter(buffer), "[{}][{}]: {}", time, log_level_trait.name, msg);
+    buffer.push_back('\0');
+    __android_log_print(ANDROID_LOG_ERROR, "", "%s", buffer.data());
+    buffer.clear();
+#else
+    fmt::format_to(std::back_inserter(buffer), fmt::fg(log_level_trait.color), "[{}][{}]: {}", time, log_level_trait.name, msg);
+#endif
 }
 
-template<typename Stream, typename T>
-inline Stream& streamin_with_braces(Stream& s, const T& t)
+inline void flush_sink(fmt::memory_buffer& buffer)
 {
-    s << "[" << t << "]";
-    return s;
+#if !__ANDROID__
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    std::fflush(stdout);
+#endif
+    buffer.clear();
 }
 
+// Bounded multi producer ring buffer (D. Vyukov's MPMC queue) with single consumer - the flush thread.
+// Producers only copy the message (no allocations, no locks), timestamp formatting and writing happens on the flush thread.
+class AsyncLogger
+{
+public:
+    AsyncLogger()
+        : records_(std::make_unique<record_t[]>(K_RECORDS_COUNT))
+    {
+        for (std::size_t i = 0; i < K_RECORDS_COUNT; i++)
+        {
+            records_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        thread_ = std::thread(&AsyncLogger::run, this);
+    }
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger(AsyncLogger&&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(AsyncLogger&&) = delete;
+    ~AsyncLogger() = default;
+
+    void log(engine::log::LogLevel level, std::string_view msg)
+    {
+        const auto time = std::chrono::system_clock::now();
+        if (!running_.load(std::memory_order_acquire))
+        {
+            write_direct(level, time, msg);
+            return;
+        }
+        if (msg.size() > sizeof(record_t::text) || level == engine::log::LogLevel::eCritical)
+        {
+            // keeps order with already queued messages of this thread
+            flush();
+            write_direct(level, time, msg);
+            return;
+        }
+
+        auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+        record_t* record = nullptr;
+        for (;;)
+        {
+            record = &records_[pos & (K_RECORDS_COUNT - 1)];
+            const auto sequence = record->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // full, flush thread is behind
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        record->time = time;
+        record->level = level;
+        record->size = static_cast<std::uint32_t>(msg.size());
+        std::memcpy(record->text, msg.data(), msg.size());
+        record->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    void flush()
+    {
+        if (!running_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        const auto target = enqueue_pos_.load(std::memory_order_acquire);
+        {
+            std::scoped_lock lock(wake_mutex_);
+            flush_requested_ = true;
+        }
+        wake_cv_.notify_one();
+        auto current = written_pos_.load(std::memory_order_acquire);
+        while (current < target && running_.load(std::memory_order_acquire))
+        {
+            written_pos_.wait(current, std::memory_order_acquire);
+            current = written_pos_.load(std::memory_order_acquire);
+        }
+    }
+
+    std::uint64_t get_dropped_count() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // at exit: writes remaining messages, the following ones are written synchronously
+    void stop()
+    {
+        {
+            std::scoped_lock lock(wake_mutex_);
+            running_.store(false, std::memory_order_release);
+        }
+        wake_cv_.notify_one();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+        written_pos_.notify_all();
+    }
+
+private:
+    void write_direct(engine::log::LogLevel level, std::chrono::system_clock::time_point time, std::string_view msg)
+    {
+        std::scoped_lock lock(sink_mutex_);
+        append_to_sink(direct_buffer_, level, time, msg);
+        flush_sink(direct_buffer_);
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            const auto written = write_queued();
+            report_dropped();
+            if (written > 0)
+            {
+                written_pos_.notify_all();
+            }
+
+            std::unique_lock lock(wake_mutex_);
+            if (!running_.load(std::memory_order_acquire))
+            {
+                lock.unlock();
+                write_queued();
+                report_dropped();
+                return;
+            }
+            if (written == 0)
+            {
+                // producers don't notify (no syscalls in log()), so queue is polled
+                wake_cv_.wait_for(lock, std::chrono::milliseconds(2), [this]() { return flush_requested_ || !running_.load(std::memory_order_acquire); });
+            }
+            flush_requested_ = false;
+        }
+    }
+
+    // formats all ready records into one buffer, written to the sink at once
+    std::size_t write_queued()
+    {
+        std::size_t written = 0;
+        std::scoped_lock lock(sink_mutex_);
+        for (;;)
+        {
+            auto& record = records_[dequeue_pos_ & (K_RECORDS_COUNT - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+            {
+                // empty, or producer hasn't finished copying yet
+                break;
+            }
+            append_to_sink(buffer_, record.level, record.time, std::string_view(record.text, record.size));
+            // slot is free as soon as message is formatted
+            record.sequence.store(dequeue_pos_ + K_RECORDS_COUNT, std::memory_order_release);
+            dequeue_pos_++;
+            written++;
+            if (buffer_.size() >= K_SINK_BUFFER_SIZE)
+            {
+                flush_sink(buffer_);
+                written_pos_.store(dequeue_pos_, std::memory_order_release);
+            }
+        }
+        if (buffer_.size() > 0)
+        {
+            flush_sink(buffer_);
+        }
+        written_pos_.store(dequeue_pos_, std::memory_order_release);
+        return written;
+    }
+
+    void report_dropped()
+    {
+        const auto dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped_)
+        {
+            write_direct(engine::log::LogLevel::eError, std::chrono::system_clock::now(),
+                fmt::format("[Logger] {} messages dropped, ring buffer is full.\n", dropped - reported_dropped_));
+            reported_dropped_ = dropped;
+        }
+    }
+
+private:
+    std::unique_ptr<record_t[]> records_;
+    alignas(64) std::atomic<std::uint64_t> enqueue_pos_{ 0 };
+    alignas(64) std::uint64_t dequeue_pos_ = 0;  // flush thread
+    std::atomic<std::uint64_t> written_pos_{ 0 };  // messages before this position are in the sink
+    alignas(64) std::atomic<std::uint64_t> dropped_{ 0 };
+    std::uint64_t reported_dropped_ = 0;  // flush thread only
+
+    std::atomic<bool> running_{ true };
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool flush_requested_ = false;
+    // sink is written by the flush thread, and by callers of critical and too long messages
+    std::mutex sink_mutex_;
+    fmt::memory_buffer buffer_;         // flush thread
+    fmt::memory_buffer direct_buffer_;  // guarded by sink mutex
+    std::thread thread_;
+};
+
+AsyncLogger& get_logger()
+{
+    // never destroyed, so it can be used during destruction of other statics, flush thread is stopped at exit
+    static AsyncLogger* logger = []()
+        {
+            auto* ret = new AsyncLogger();
+            std::atexit([]() { get_logger().stop(); });
+            return ret;
+        }();
+    return *logger;
+}
+}  // namespace anonymous
+
 void engine::log::log(LogLevel level, std::string_view msg)
 {
-    const auto log_level_trait = LOG_LEVEL_LUT[level];
-    const auto printable_str = fmt::format("[{}][{}]: {}", std::chrono::system_clock::now(), log_level_trait.name, msg);
+    get_logger().log(level, msg);
+}
 
-#if __ANDROID__
-    __android_log_print(ANDROID_LOG_ERROR, "", "%s", printable_str.data());
-#else
-    fmt::print(fmt::fg(log_level_trait.color), printable_str);
-#endif
+void engine::log::flush()
+{
+    get_logger().flush();
+}
+
+std::uint64_t engine::log::get_dropped_count()
+{
+    return get_logger().get_dropped_count();
 }
@@ -1,6 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <string_view>
 
+// messages below this level are compiled out, when logged with ENGINE_LOG_* macros (0 - trace, 1 - error, 2 - critical)
+#ifndef ENGINE_LOG_MIN_LEVEL
+#define ENGINE_LOG_MIN_LEVEL 0
+#endif
+
 namespace engine
 {
 namespace log
@@ -12,7 +18,27 @@ enum class LogLevel
     eCritical
 };
 
+// Thread safe and asynchronous: message is copied into lock-free ring buffer and written to the sink by background thread.
+// Messages, which don't fit the ring buffer record, and critical messages are written after the queue is flushed,
+// so they are visible before i.e. assert. When ring buffer is full, message is dropped and counted.
 void log(LogLevel level, std::string_view msg);
+// blocks until all queued messages are written
+void flush();
+std::uint64_t get_dropped_count();
 
 } // namespace log
-} // namespace engine
\ No newline at end of file
+} // namespace engine
+
+// message expression (i.e. fmt::format) is not evaluated, when level is filtered out
+#define ENGINE_LOG(level, msg)                                                          \
+    do                                                                                  \
+    {                                                                                   \
+        if constexpr (static_cast<int>(level) >= ENGINE_LOG_MIN_LEVEL)                  \
+        {                                                                               \
+            ::engine::log::log(level, msg);                                             \
+        }                                                                               \
+    } while (false)
+
+#define ENGINE_LOG_TRACE(msg) ENGINE_LOG(::engine::log::LogLevel::eTrace, msg)
+#define ENGINE_LOG_ERROR(msg) ENGINE_LOG(::engine::log::LogLevel::eError, msg)
+#define ENGINE_LOG_CRITICAL(msg) ENGINE_LOG(::engine::log::LogLevel::eCritical, msg)
@@ -1,6 +1,8 @@
 #include "material.h"
 #include "math_helpers.h"
 
+#include <cassert>
+
 engine::MaterialStaticGeometryLit::MaterialStaticGeometryLit()
     : shader_(Shader({ "simple_vertex_definitions.h", "simple.vs" }, { "lit_helpers.h", "lit.fs" }))
 {
@@ -28,7 +30,10 @@ void engine::MaterialStaticGeometryLit::draw(const Geometry& geometry, const Dra
 engine::MaterialSkinnedGeometryLit::MaterialSkinnedGeometryLit()
     : shader_(Shader({ "simple_vertex_definitions.h", "vertex_skinning.vs" }, { "lit_helpers.h", "lit.fs" }))
 {
-
+    for (std::size_t i = 0; i < bone_uniform_names_.size(); i++)
+    {
+        bone_uniform_names_[i] = "global_bone_transform[" + std::to_string(i) + "]";
+    }
 }
 
 void engine::MaterialSkinnedGeometryLit::draw(const Geometry& geometry, const DrawContext& ctx)
@@ -46,11 +51,11 @@ void engine::MaterialSkinnedGeometryLit::draw(const Geometry& geometry, const Dr
     shader_.set_texture("texture_diffuse", &ctx.texture_diffuse);
     shader_.set_texture("texture_specular", &ctx.texture_specular);
 
-    for (auto i = 0; i < ctx.bone_transforms.size(); i++)
+    assert(ctx.bone_transforms.size() <= bone_uniform_names_.size());
+    for (std::size_t i = 0; i < ctx.bone_transforms.size(); i++)
     {
-        const auto& per_bone_final_transform = ctx.bone_transforms.at(i);
-        const auto uniform_name = "global_bone_transform[" + std::to_string(i) + "]";
-        shader_.set_uniform_mat_f4(uniform_name, { glm::value_ptr(per_bone_final_transform), sizeof(per_bone_final_transform) / sizeof(float) });
+        const auto& per_bone_final_transform = ctx.bone_transforms[i];
+        shader_.set_uniform_mat_f4(bone_uniform_names_[i], { glm::value_ptr(per_bone_final_transform), sizeof(per_bone_final_transform) / sizeof(float) });
     }
 
     geometry.bind();
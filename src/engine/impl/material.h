@@ -5,7 +5,9 @@
 
 #include "glm/glm.hpp"
 
+#include <array>
 #include <span>
+#include <string>
 
 namespace engine
 {
@@ -57,7 +59,7 @@ public:
         const UniformBuffer& camera;
         const UniformBuffer& scene;
         const float* model_matrix;
-        std::vector<glm::mat4> bone_transforms;
+        std::span<const glm::mat4> bone_transforms;
 
         const float* color_diffuse;
         float shininess;
@@ -71,6 +73,8 @@ public:
 
 private:
     Shader shader_;
+    // built once, so drawing doesn't allocate strings
+    std::array<std::string, ENGINE_SKINNED_MESH_COMPONENT_MAX_SKELETON_BONES> bone_uniform_names_;
 };
 
 
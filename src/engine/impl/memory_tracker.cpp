@@ -0,0 +1,211 @@
+#include "memory_tracker.h"
+#include "logger.h"
+#include "profiler.h"
+
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace
+{
+struct alignas(64) counters_t
+{
+    std::atomic<std::uint64_t> live_bytes{ 0 };
+    std::atomic<std::uint64_t> peak_bytes{ 0 };
+    std::atomic<std::uint64_t> live_allocations{ 0 };
+    std::atomic<std::uint64_t> frame_allocations{ 0 };
+    std::atomic<std::uint64_t> frame_allocated_bytes{ 0 };
+    // published at the frame end
+    std::atomic<std::uint64_t> last_frame_allocations{ 0 };
+    std::atomic<std::uint64_t> last_frame_allocated_bytes{ 0 };
+    std::atomic<std::uint64_t> budget_bytes{ 0 };
+    bool over_budget = false;  // main thread
+};
+
+// indexed with engine_memory_tag_t
+std::array<counters_t, ENGINE_MEMORY_TAG_COUNT> g_counters;
+
+constexpr std::array<const char*, ENGINE_MEMORY_TAG_COUNT> K_TAG_NAMES =
+{
+    "ecs",
+    "physics",
+    "assets",
+    "ui",
+    "gpu_buffers",
+    "gpu_textures",
+};
+
+// profiler plots need names with static storage
+constexpr std::array<const char*, ENGINE_MEMORY_TAG_COUNT> K_PLOT_NAMES =
+{
+    "memory_ecs",
+    "memory_physics",
+    "memory_assets",
+    "memory_ui",
+    "memory_gpu_buffers",
+    "memory_gpu_textures",
+};
+
+void* g_budget_exceeded_user_data = nullptr;
+engine::memory::budget_exceeded_callback_t g_budget_exceeded_callback = nullptr;
+
+inline counters_t& get_counters(engine_memory_tag_t tag)
+{
+    assert(tag < ENGINE_MEMORY_TAG_COUNT);
+    return g_counters[tag];
+}
+
+// Bullet frees without size, so it's stored in front of the allocation (header keeps malloc alignment)
+constexpr std::size_t K_PHYSICS_HEADER_SIZE = alignof(std::max_align_t);
+
+void* physics_alloc(std::size_t size)
+{
+    auto* memory = static_cast<std::byte*>(std::malloc(size + K_PHYSICS_HEADER_SIZE));
+    if (!memory)
+    {
+        return nullptr;
+    }
+    *reinterpret_cast<std::size_t*>(memory) = size;
+    engine::memory::on_allocate(ENGINE_MEMORY_TAG_PHYSICS, size);
+    return memory + K_PHYSICS_HEADER_SIZE;
+}
+
+void physics_free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    auto* memory = static_cast<std::byte*>(ptr) - K_PHYSICS_HEADER_SIZE;
+    engine::memory::on_free(ENGINE_MEMORY_TAG_PHYSICS, *reinterpret_cast<std::size_t*>(memory));
+    std::free(memory);
+}
+
+// placed right in front of the aligned allocation
+struct physics_aligned_header_t
+{
+    void* memory;
+    std::size_t size;
+};
+
+// Bullet uses its own aligned allocator (i.e. _aligned_malloc with BT_HAS_ALIGNED_ALLOCATOR on MSVC),
+// which doesn't go through physics_alloc(), so it's replaced too
+void* physics_aligned_alloc(std::size_t size, int alignment)
+{
+    const auto align = std::max(static_cast<std::size_t>(alignment), alignof(physics_aligned_header_t));
+    auto* memory = static_cast<std::byte*>(std::malloc(size + sizeof(physics_aligned_header_t) + align - 1));
+    if (!memory)
+    {
+        return nullptr;
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(memory + sizeof(physics_aligned_header_t));
+    auto* ret = reinterpret_cast<std::byte*>((address + align - 1) & ~(align - 1));
+    new (ret - sizeof(physics_aligned_header_t)) physics_aligned_header_t{ memory, size };
+    engine::memory::on_allocate(ENGINE_MEMORY_TAG_PHYSICS, size);
+    return ret;
+}
+
+void physics_aligned_free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    const auto* header = reinterpret_cast<physics_aligned_header_t*>(static_cast<std::byte*>(ptr) - sizeof(physics_aligned_header_t));
+    engine::memory::on_free(ENGINE_MEMORY_TAG_PHYSICS, header->size);
+    std::free(header->memory);
+}
+}  // namespace anonymous
+
+void engine::memory::on_allocate(engine_memory_tag_t tag, std::size_t bytes)
+{
+    auto& counters = get_counters(tag);
+    const auto live = counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.live_allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frame_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    auto peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+void engine::memory::on_free(engine_memory_tag_t tag, std::size_t bytes)
+{
+    auto& counters = get_counters(tag);
+    counters.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+engine_memory_stats_t engine::memory::get_stats(engine_memory_tag_t tag)
+{
+    const auto& counters = get_counters(tag);
+    engine_memory_stats_t ret{};
+    ret.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    ret.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    ret.live_allocations = counters.live_allocations.load(std::memory_order_relaxed);
+    ret.frame_allocations = counters.last_frame_allocations.load(std::memory_order_relaxed);
+    ret.frame_allocated_bytes = counters.last_frame_allocated_bytes.load(std::memory_order_relaxed);
+    ret.budget_bytes = counters.budget_bytes.load(std::memory_order_relaxed);
+    return ret;
+}
+
+void engine::memory::set_budget(engine_memory_tag_t tag, std::uint64_t budget_bytes)
+{
+    get_counters(tag).budget_bytes.store(budget_bytes, std::memory_order_relaxed);
+}
+
+void engine::memory::set_budget_exceeded_callback(void* user_data, budget_exceeded_callback_t callback)
+{
+    g_budget_exceeded_user_data = user_data;
+    g_budget_exceeded_callback = callback;
+}
+
+void engine::memory::end_frame()
+{
+    for (std::uint32_t i = 0; i < ENGINE_MEMORY_TAG_COUNT; i++)
+    {
+        const auto tag = static_cast<engine_memory_tag_t>(i);
+        auto& counters = g_counters[i];
+        counters.last_frame_allocations.store(counters.frame_allocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        counters.last_frame_allocated_bytes.store(counters.frame_allocated_bytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+        const auto live = counters.live_bytes.load(std::memory_order_relaxed);
+        ENGINE_PROFILE_VALUE(K_PLOT_NAMES[i], static_cast<std::int64_t>(live));
+
+        const auto budget = counters.budget_bytes.load(std::memory_order_relaxed);
+        const auto over_budget = budget != 0 && live > budget;
+        if (over_budget && !counters.over_budget)
+        {
+            if (g_budget_exceeded_callback)
+            {
+                g_budget_exceeded_callback(tag, live, budget, g_budget_exceeded_user_data);
+            }
+            else
+            {
+                log::log(log::LogLevel::eError, fmt::format("Memory budget of: {} exceeded. Live: {} KiB, budget: {} KiB.\n", K_TAG_NAMES[i], live / 1024, budget / 1024));
+            }
+        }
+        counters.over_budget = over_budget;
+    }
+}
+
+void engine::memory::install_physics_allocator()
+{
+    static std::once_flag installed;
+    std::call_once(installed, []()
+        {
+            btAlignedAllocSetCustom(&physics_alloc, &physics_free);
+            btAlignedAllocSetCustomAligned(&physics_aligned_alloc, &physics_aligned_free);
+        }
+    );
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace engine
+{
+namespace memory
+{
+// Counters are lock-free and can be updated from any thread, budgets and callback are used from the main thread.
+void on_allocate(engine_memory_tag_t tag, std::size_t bytes);
+void on_free(engine_memory_tag_t tag, std::size_t bytes);
+
+engine_memory_stats_t get_stats(engine_memory_tag_t tag);
+void set_budget(engine_memory_tag_t tag, std::uint64_t budget_bytes);
+using budget_exceeded_callback_t = void (*)(engine_memory_tag_t tag, std::uint64_t live_bytes, std::uint64_t budget_bytes, void* user_data);
+void set_budget_exceeded_callback(void* user_data, budget_exceeded_callback_t callback);
+
+// publishes frame counters, checks budgets and plots live bytes to the profiler
+void end_frame();
+
+// all Bullet allocations are tracked, has to be installed before Bullet allocates anything (i.e. before the first scene)
+void install_physics_allocator();
+
+// std allocator, which tracks memory of engine containers, i.e: tracked_vector<float, ENGINE_MEMORY_TAG_ASSETS>
+template<typename T, engine_memory_tag_t Tag>
+class TrackingAllocator
+{
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = TrackingAllocator<U, Tag>;
+    };
+
+    TrackingAllocator() noexcept = default;
+    template<typename U>
+    TrackingAllocator(const TrackingAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        auto* ret = std::allocator<T>().allocate(n);
+        on_allocate(Tag, n * sizeof(T));
+        return ret;
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        on_free(Tag, n * sizeof(T));
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template<typename U>
+    bool operator==(const TrackingAllocator<U, Tag>&) const noexcept { return true; }
+};
+
+template<typename T, engine_memory_tag_t Tag>
+using tracked_vector = std::vector<T, TrackingAllocator<T, Tag>>;
+
+}  // namespace memory
+}  // namespace engine
@@ -0,0 +1,495 @@
+#include "mesh_optimizer.h"
+#include "logger.h"
+
+#include <glm/glm.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+inline glm::vec3 get_position(std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset, std::uint32_t idx)
+{
+    glm::vec3 ret{};
+    std::memcpy(&ret, vertex_data.data() + static_cast<std::size_t>(idx) * vertex_size + position_offset, sizeof(ret));
+    return ret;
+}
+
+// compressed sparse row: triangles using given vertex
+struct VertexTriangleAdjacency
+{
+    std::vector<std::uint32_t> offsets;   // vertex_count + 1
+    std::vector<std::uint32_t> triangles;
+
+    VertexTriangleAdjacency(std::span<const std::uint32_t> indices, std::uint32_t vertex_count)
+        : offsets(vertex_count + 1, 0)
+        , triangles(indices.size())
+    {
+        for (const auto idx : indices)
+        {
+            offsets[idx + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::uint32_t i = 0; i < indices.size(); i++)
+        {
+            triangles[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    inline std::span<const std::uint32_t> get(std::uint32_t vertex) const
+    {
+        return { triangles.data() + offsets[vertex], offsets[vertex + 1] - offsets[vertex] };
+    }
+};
+
+inline void remap_vertices(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::span<const std::uint32_t> remap, std::uint32_t new_vertex_count)
+{
+    std::vector<std::byte> out(static_cast<std::size_t>(new_vertex_count) * vertex_size);
+    const auto old_vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    for (std::uint32_t i = 0; i < old_vertex_count; i++)
+    {
+        if (remap[i] == std::numeric_limits<std::uint32_t>::max())
+        {
+            continue;
+        }
+        std::memcpy(out.data() + static_cast<std::size_t>(remap[i]) * vertex_size, vertex_data.data() + static_cast<std::size_t>(i) * vertex_size, vertex_size);
+    }
+    vertex_data = std::move(out);
+}
+
+inline engine::MeshStats compute_stats(std::span<const std::uint32_t> indices, std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset)
+{
+    const auto vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    auto ret = engine::analyze_vertex_cache(indices, vertex_count);
+    ret.overdraw = engine::analyze_overdraw(indices, vertex_data, vertex_size, position_offset);
+    return ret;
+}
+}  // namespace anonymous
+
+engine::MeshStats engine::analyze_vertex_cache(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, std::uint32_t cache_size)
+{
+    MeshStats ret{};
+    ret.vertex_count = vertex_count;
+    if (indices.empty() || vertex_count == 0)
+    {
+        return ret;
+    }
+    // timestamp based FIFO: vertex is in cache if it was inserted less than cache_size insertions ago
+    std::vector<std::uint32_t> timestamps(vertex_count, 0);
+    std::uint32_t time = cache_size + 1;
+    std::uint32_t misses = 0;
+    for (const auto idx : indices)
+    {
+        if (time - timestamps[idx] > cache_size)
+        {
+            timestamps[idx] = time++;
+            misses++;
+        }
+    }
+    ret.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    ret.atvr = static_cast<float>(misses) / static_cast<float>(vertex_count);
+    return ret;
+}
+
+float engine::analyze_overdraw(std::span<const std::uint32_t> indices, std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset)
+{
+    constexpr std::int32_t K_VIEWPORT = 256;
+    if (indices.size() < 3)
+    {
+        return 0.0f;
+    }
+
+    const auto vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    glm::vec3 bounds_min(std::numeric_limits<float>::max());
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+    for (std::uint32_t i = 0; i < vertex_count; i++)
+    {
+        const auto p = get_position(vertex_data, vertex_size, position_offset, i);
+        bounds_min = glm::min(bounds_min, p);
+        bounds_max = glm::max(bounds_max, p);
+    }
+    const auto extent = std::max({ bounds_max.x - bounds_min.x, bounds_max.y - bounds_min.y, bounds_max.z - bounds_min.z, std::numeric_limits<float>::epsilon() });
+    const auto scale = static_cast<float>(K_VIEWPORT - 1) / extent;
+
+    std::uint64_t pixels_covered = 0;
+    std::uint64_t pixels_shaded = 0;
+    std::vector<float> depth_buffer(K_VIEWPORT * K_VIEWPORT);
+
+    // 3 axes, each seen from both sides
+    for (std::int32_t axis = 0; axis < 3; axis++)
+    {
+        for (const float side : { 1.0f, -1.0f })
+        {
+            std::fill(depth_buffer.begin(), depth_buffer.end(), std::numeric_limits<float>::lowest());
+            const auto axis_u = (axis + 1) % 3;
+            const auto axis_v = (axis + 2) % 3;
+            for (std::size_t t = 0; t + 2 < indices.size(); t += 3)
+            {
+                std::array<glm::vec3, 3> tri{};
+                for (std::size_t k = 0; k < 3; k++)
+                {
+                    const auto p = (get_position(vertex_data, vertex_size, position_offset, indices[t + k]) - bounds_min) * scale;
+                    tri[k] = glm::vec3(p[axis_u], p[axis_v], p[axis] * side);
+                }
+                // mirrored view flips winding
+                const auto area = ((tri[1].x - tri[0].x) * (tri[2].y - tri[0].y) - (tri[2].x - tri[0].x) * (tri[1].y - tri[0].y)) * side;
+                if (area <= 0.0f)
+                {
+                    continue; // backface or degenerate
+                }
+                if (side < 0.0f)
+                {
+                    std::swap(tri[1], tri[2]);
+                }
+                const auto min_x = std::max(0, static_cast<std::int32_t>(std::floor(std::min({ tri[0].x, tri[1].x, tri[2].x }))));
+                const auto max_x = std::min(K_VIEWPORT - 1, static_cast<std::int32_t>(std::ceil(std::max({ tri[0].x, tri[1].x, tri[2].x }))));
+                const auto min_y = std::max(0, static_cast<std::int32_t>(std::floor(std::min({ tri[0].y, tri[1].y, tri[2].y }))));
+                const auto max_y = std::min(K_VIEWPORT - 1, static_cast<std::int32_t>(std::ceil(std::max({ tri[0].y, tri[1].y, tri[2].y }))));
+
+                auto edge = [](const glm::vec3& a, const glm::vec3& b, float x, float y)
+                {
+                    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+                };
+                for (std::int32_t y = min_y; y <= max_y; y++)
+                {
+                    for (std::int32_t x = min_x; x <= max_x; x++)
+                    {
+                        const auto px = static_cast<float>(x) + 0.5f;
+                        const auto py = static_cast<float>(y) + 0.5f;
+                        const auto w0 = edge(tri[1], tri[2], px, py);
+                        const auto w1 = edge(tri[2], tri[0], px, py);
+                        const auto w2 = edge(tri[0], tri[1], px, py);
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                        {
+                            continue;
+                        }
+                        const auto depth = (w0 * tri[0].z + w1 * tri[1].z + w2 * tri[2].z) / area;
+                        auto& stored_depth = depth_buffer[y * K_VIEWPORT + x];
+                        if (stored_depth == std::numeric_limits<float>::lowest())
+                        {
+                            pixels_covered++;
+                        }
+                        // closer to viewer means bigger depth value
+                        if (depth > stored_depth)
+                        {
+                            stored_depth = depth;
+                            pixels_shaded++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return pixels_covered == 0 ? 0.0f : static_cast<float>(pixels_shaded) / static_cast<float>(pixels_covered);
+}
+
+std::uint32_t engine::deduplicate_vertices(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::vector<std::uint32_t>& indices)
+{
+    const auto vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    std::vector<std::uint32_t> remap(vertex_count, std::numeric_limits<std::uint32_t>::max());
+    std::unordered_map<std::string_view, std::uint32_t> unique_vertices;
+    unique_vertices.reserve(vertex_count);
+
+    std::uint32_t new_vertex_count = 0;
+    for (std::uint32_t i = 0; i < vertex_count; i++)
+    {
+        const auto key = std::string_view(reinterpret_cast<const char*>(vertex_data.data()) + static_cast<std::size_t>(i) * vertex_size, vertex_size);
+        const auto [it, inserted] = unique_vertices.try_emplace(key, new_vertex_count);
+        if (inserted)
+        {
+            new_vertex_count++;
+        }
+        remap[i] = it->second;
+    }
+    if (new_vertex_count == vertex_count)
+    {
+        return vertex_count;
+    }
+
+    // keep first occurrence of every vertex
+    std::vector<std::uint32_t> first_occurrence_remap(vertex_count, std::numeric_limits<std::uint32_t>::max());
+    std::vector<bool> written(new_vertex_count, false);
+    for (std::uint32_t i = 0; i < vertex_count; i++)
+    {
+        if (!written[remap[i]])
+        {
+            written[remap[i]] = true;
+            first_occurrence_remap[i] = remap[i];
+        }
+    }
+    // keys point into vertex data, clear map before vertex buffer is replaced
+    unique_vertices.clear();
+    remap_vertices(vertex_data, vertex_size, first_occurrence_remap, new_vertex_count);
+    for (auto& idx : indices)
+    {
+        idx = remap[idx];
+    }
+    return new_vertex_count;
+}
+
+void engine::optimize_vertex_cache(std::vector<std::uint32_t>& indices, std::uint32_t vertex_count, std::uint32_t cache_size)
+{
+    // tipsify
+    const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+    if (triangle_count == 0 || vertex_count == 0)
+    {
+        return;
+    }
+    const VertexTriangleAdjacency adjacency(indices, vertex_count);
+
+    std::vector<std::uint32_t> live_triangles(vertex_count);
+    for (std::uint32_t v = 0; v < vertex_count; v++)
+    {
+        live_triangles[v] = static_cast<std::uint32_t>(adjacency.get(v).size());
+    }
+    std::vector<std::uint32_t> cache_timestamps(vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<std::uint32_t> dead_end_stack;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> out;
+    out.reserve(indices.size());
+
+    constexpr auto K_INVALID = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t time = cache_size + 1;
+    std::uint32_t cursor = 0;
+    std::uint32_t fanning_vertex = 0;
+
+    while (fanning_vertex != K_INVALID)
+    {
+        candidates.clear();
+        for (const auto t : adjacency.get(fanning_vertex))
+        {
+            if (emitted[t])
+            {
+                continue;
+            }
+            for (std::uint32_t k = 0; k < 3; k++)
+            {
+                const auto v = indices[t * 3 + k];
+                out.push_back(v);
+                dead_end_stack.push_back(v);
+                candidates.push_back(v);
+                live_triangles[v]--;
+                if (time - cache_timestamps[v] > cache_size)
+                {
+                    cache_timestamps[v] = time++;
+                }
+            }
+            emitted[t] = true;
+        }
+
+        // next fanning vertex: the oldest vertex still in cache after fanning it
+        std::uint32_t best_vertex = K_INVALID;
+        std::int32_t best_priority = -1;
+        for (const auto v : candidates)
+        {
+            if (live_triangles[v] == 0)
+            {
+                continue;
+            }
+            std::int32_t priority = 0;
+            if (time - cache_timestamps[v] + 2 * live_triangles[v] <= cache_size)
+            {
+                priority = static_cast<std::int32_t>(time - cache_timestamps[v]);
+            }
+            if (priority > best_priority)
+            {
+                best_priority = priority;
+                best_vertex = v;
+            }
+        }
+
+        if (best_vertex == K_INVALID)
+        {
+            // dead end: recently used vertices first, than any vertex with live triangles
+            while (!dead_end_stack.empty())
+            {
+                const auto v = dead_end_stack.back();
+                dead_end_stack.pop_back();
+                if (live_triangles[v] > 0)
+                {
+                    best_vertex = v;
+                    break;
+                }
+            }
+            while (best_vertex == K_INVALID && cursor < vertex_count)
+            {
+                if (live_triangles[cursor] > 0)
+                {
+                    best_vertex = cursor;
+                }
+                cursor++;
+            }
+        }
+        fanning_vertex = best_vertex;
+    }
+    assert(out.size() == triangle_count * 3);
+    indices = std::move(out);
+}
+
+void engine::optimize_overdraw(std::vector<std::uint32_t>& indices, std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset, float threshold)
+{
+    const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+    const auto vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    if (triangle_count == 0)
+    {
+        return;
+    }
+
+    // clusters start where cache simulation shows that all 3 vertices of triangle missed (tipsify restarted fanning)
+    std::vector<std::uint32_t> cluster_starts;
+    {
+        std::vector<std::uint32_t> timestamps(vertex_count, 0);
+        std::uint32_t time = K_MESH_OPTIMIZER_CACHE_SIZE + 1;
+        for (std::uint32_t t = 0; t < triangle_count; t++)
+        {
+            std::uint32_t misses = 0;
+            for (std::uint32_t k = 0; k < 3; k++)
+            {
+                const auto v = indices[t * 3 + k];
+                if (time - timestamps[v] > K_MESH_OPTIMIZER_CACHE_SIZE)
+                {
+                    timestamps[v] = time++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3)
+            {
+                cluster_starts.push_back(t);
+            }
+        }
+    }
+    if (cluster_starts.size() < 2)
+    {
+        return;
+    }
+
+    glm::vec3 mesh_centroid(0.0f);
+    for (std::uint32_t i = 0; i < vertex_count; i++)
+    {
+        mesh_centroid += get_position(vertex_data, vertex_size, position_offset, i);
+    }
+    mesh_centroid /= static_cast<float>(std::max(vertex_count, 1u));
+
+    // sort key: how much cluster faces outward from the mesh center
+    struct cluster_t
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+        float sort_key;
+    };
+    std::vector<cluster_t> clusters(cluster_starts.size());
+    for (std::size_t c = 0; c < cluster_starts.size(); c++)
+    {
+        auto& cluster = clusters[c];
+        cluster.begin = cluster_starts[c];
+        cluster.end = c + 1 < cluster_starts.size() ? cluster_starts[c + 1] : triangle_count;
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area_sum = 0.0f;
+        for (auto t = cluster.begin; t < cluster.end; t++)
+        {
+            const auto p0 = get_position(vertex_data, vertex_size, position_offset, indices[t * 3 + 0]);
+            const auto p1 = get_position(vertex_data, vertex_size, position_offset, indices[t * 3 + 1]);
+            const auto p2 = get_position(vertex_data, vertex_size, position_offset, indices[t * 3 + 2]);
+            const auto n = glm::cross(p1 - p0, p2 - p0);
+            const auto area = glm::length(n);
+            centroid += (p0 + p1 + p2) * (area / 3.0f);
+            normal += n;
+            area_sum += area;
+        }
+        centroid = area_sum > 0.0f ? centroid / area_sum : centroid;
+        const auto normal_length = glm::length(normal);
+        normal = normal_length > 0.0f ? normal / normal_length : normal;
+        cluster.sort_key = glm::dot(centroid - mesh_centroid, normal);
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const cluster_t& lhs, const cluster_t& rhs) { return lhs.sort_key > rhs.sort_key; });
+
+    std::vector<std::uint32_t> out;
+    out.reserve(indices.size());
+    for (const auto& cluster : clusters)
+    {
+        out.insert(out.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+
+    // dont trade too much of vertex cache efficiency
+    const auto acmr_before = analyze_vertex_cache(indices, vertex_count).acmr;
+    const auto acmr_after = analyze_vertex_cache(out, vertex_count).acmr;
+    if (acmr_after <= acmr_before * threshold)
+    {
+        indices = std::move(out);
+    }
+}
+
+std::uint32_t engine::optimize_vertex_fetch(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::vector<std::uint32_t>& indices)
+{
+    const auto vertex_count = static_cast<std::uint32_t>(vertex_data.size() / vertex_size);
+    std::vector<std::uint32_t> remap(vertex_count, std::numeric_limits<std::uint32_t>::max());
+    std::uint32_t new_vertex_count = 0;
+    for (auto& idx : indices)
+    {
+        if (remap[idx] == std::numeric_limits<std::uint32_t>::max())
+        {
+            remap[idx] = new_vertex_count++;
+        }
+        idx = remap[idx];
+    }
+    remap_vertices(vertex_data, vertex_size, remap, new_vertex_count);
+    return new_vertex_count;
+}
+
+engine::MeshOptimizationStats engine::optimize_mesh(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset, std::vector<std::uint32_t>& indices,
+    bool collect_stats)
+{
+    MeshOptimizationStats ret{};
+    if (vertex_size == 0 || indices.size() < 3 || indices.size() % 3 != 0)
+    {
+        log::log(log::LogLevel::eError, "Mesh optimization supports only indexed triangle lists. Skipping.\n");
+        return ret;
+    }
+    auto stats = [&]()
+    {
+        return collect_stats ? compute_stats(indices, vertex_data, vertex_size, position_offset) : MeshStats{};
+    };
+    ret.input = stats();
+
+    const auto vertex_count = deduplicate_vertices(vertex_data, vertex_size, indices);
+    ret.after_deduplication = stats();
+
+    optimize_vertex_cache(indices, vertex_count);
+    ret.after_vertex_cache = stats();
+
+    optimize_overdraw(indices, vertex_data, vertex_size, position_offset);
+    ret.after_overdraw = stats();
+
+    optimize_vertex_fetch(vertex_data, vertex_size, indices);
+    ret.after_vertex_fetch = stats();
+
+    if (!collect_stats)
+    {
+        return ret;
+    }
+
+    auto log_step = [](std::string_view name, const MeshStats& s)
+    {
+        log::log(log::LogLevel::eTrace, fmt::format("    {:<20} verts: {:>7}, acmr: {:.3f}, atvr: {:.3f}, overdraw: {:.3f}\n", name, s.vertex_count, s.acmr, s.atvr, s.overdraw));
+    };
+    log::log(log::LogLevel::eTrace, fmt::format("Mesh optimization, triangles: {}\n", indices.size() / 3));
+    log_step("input", ret.input);
+    log_step("deduplication", ret.after_deduplication);
+    log_step("vertex cache", ret.after_vertex_cache);
+    log_step("overdraw", ret.after_overdraw);
+    log_step("vertex fetch", ret.after_vertex_fetch);
+    return ret;
+}
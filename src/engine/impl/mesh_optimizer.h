@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace engine
+{
+// Triangle list optimization run at import time.
+// Vertices are interleaved blobs of vertex_size bytes, positions are expected as 3 floats at position_offset.
+// Based on: "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (Sander, Nehab, Barczak 2007)
+struct MeshStats
+{
+    std::uint32_t vertex_count = 0;
+    float acmr = 0.0f;      // average cache miss ratio: transformed vertices per triangle (0.5 - 3.0)
+    float atvr = 0.0f;      // average transformed vertex ratio: transformed vertices per vertex (1.0 is optimal)
+    float overdraw = 0.0f;  // shaded fragments per covered pixel (1.0 is optimal)
+};
+
+struct MeshOptimizationStats
+{
+    MeshStats input;
+    MeshStats after_deduplication;
+    MeshStats after_vertex_cache;
+    MeshStats after_overdraw;
+    MeshStats after_vertex_fetch;
+};
+
+constexpr inline std::uint32_t K_MESH_OPTIMIZER_CACHE_SIZE = 16;
+
+// simulates FIFO post transform cache, fills acmr and atvr
+MeshStats analyze_vertex_cache(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, std::uint32_t cache_size = K_MESH_OPTIMIZER_CACHE_SIZE);
+// software rasterization of the mesh from 6 axis aligned views, fills overdraw
+float analyze_overdraw(std::span<const std::uint32_t> indices, std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset);
+
+// merges binary identical vertices, returns new vertex count
+std::uint32_t deduplicate_vertices(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::vector<std::uint32_t>& indices);
+// reorders triangles for post transform cache (tipsify)
+void optimize_vertex_cache(std::vector<std::uint32_t>& indices, std::uint32_t vertex_count, std::uint32_t cache_size = K_MESH_OPTIMIZER_CACHE_SIZE);
+// reorders clusters of triangles so outward facing ones are drawn first, vertex cache efficiency can drop at most by threshold
+void optimize_overdraw(std::vector<std::uint32_t>& indices, std::span<const std::byte> vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset, float threshold = 1.05f);
+// reorders vertices in order of first use in index buffer, unused vertices are removed, returns new vertex count
+std::uint32_t optimize_vertex_fetch(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::vector<std::uint32_t>& indices);
+
+// runs all of above steps in order: deduplication, vertex cache, overdraw, vertex fetch
+// collect_stats: analyze (and log) the mesh before and after every step - expensive (overdraw is rasterized), for diagnostics only
+MeshOptimizationStats optimize_mesh(std::vector<std::byte>& vertex_data, std::uint32_t vertex_size, std::uint32_t position_offset, std::vector<std::uint32_t>& indices,
+    bool collect_stats = false);
+}  // namespace engine
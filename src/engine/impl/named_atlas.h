@@ -1,116 +1,274 @@
 #pragma once
-#include "engine.h" 
+#include "engine.h"
 #include "logger.h"
 
-#include <array>
+#include <cassert>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <deque>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <utility>
 
 #include <fmt/format.h>
 
 namespace engine
 {
-template<typename T, std::size_t SIZE = 1024>
+// Slot map of named objects.
+// Handles are 32 bit: lower bits are slot index, upper bits are generation of the slot.
+// Generation is bumped every time slot is released, so stale handles are detected instead of aliasing new objects.
+// Objects live in std::deque, so pointers returned by get_object() stay valid while atlas grows.
+// Names dont have to be unique, lookup by name returns first added (still alive) object with given name.
+// With REF_COUNTED enabled every acquire() has to be balanced with remove_object() before object is destroyed.
+template<typename T, bool REF_COUNTED = false>
 class Atlas
 {
 public:
-    Atlas()
-    {
-        free_indices_.resize(SIZE);
-        std::generate(free_indices_.begin(), free_indices_.end(), [n = 0]() mutable { return n++; });
-    }
+    using Handle = std::uint32_t;
+    static constexpr std::uint32_t K_INDEX_BITS = 20;
+    static constexpr std::uint32_t K_INDEX_MASK = (1u << K_INDEX_BITS) - 1u;
+    static constexpr std::uint32_t K_GENERATION_MASK = (1u << (32u - K_INDEX_BITS)) - 1u;
+    // last slot is never used, so handle can't be equal to ENGINE_INVALID_OBJECT_HANDLE
+    static constexpr std::uint32_t K_MAX_OBJECTS = K_INDEX_MASK;
+
+public:
+    Atlas() = default;
     Atlas(const Atlas& rhs) = delete;
     Atlas(Atlas&& rhs) = delete;
     Atlas& operator=(const Atlas& rhs) = delete;
     Atlas& operator=(Atlas&& rhs) = delete;
     ~Atlas()
     {
-        if (free_indices_.size() != SIZE)
+        if (alive_count_ != 0)
         {
             // print not removed objects
-            for (std::size_t i = 0; i < SIZE; i++)
+            for (const auto& slot : slots_)
             {
-                if (!names_[i].empty())
+                if (slot.alive)
                 {
-                    log::log(log::LogLevel::eCritical, fmt::format("Not released object: {}\n", names_[i]));
+                    log::log(log::LogLevel::eCritical, fmt::format("Not released object: {}\n", slot.name));
                 }
             }
             assert(false && "Not all objects were removed from atlas");
         }
     }
 
-    std::uint32_t add_object(std::string_view name, T&& t)
+    Handle add_object(std::string_view name, T&& t)
     {
-        if (free_indices_.empty())
+        std::uint32_t idx = 0;
+        if (!free_slots_.empty())
         {
-            assert(false && "Atlas is full");
-            return ENGINE_INVALID_OBJECT_HANDLE;
+            idx = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        else
+        {
+            if (slots_.size() >= K_MAX_OBJECTS)
+            {
+                assert(false && "Atlas is full");
+                return ENGINE_INVALID_OBJECT_HANDLE;
+            }
+            idx = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
         }
-        const auto current_idx_ = free_indices_.front();
-        objects_[current_idx_] = std::move(t);
-        names_[current_idx_] = name.data();
-        free_indices_.pop_front();
-        return current_idx_;
+        auto& slot = slots_[idx];
+        slot.object = std::move(t);
+        slot.name = name;
+        slot.ref_count = 1;
+        slot.alive = true;
+        alive_count_++;
+
+        const auto handle = make_handle(idx, slot.generation);
+        // keep first object with given name, same as linear search would find
+        auto it = names_index_.try_emplace(slot.name, name_entry_t{ handle, 0 }).first;
+        it->second.count++;
+        return handle;
     }
 
-    void remove_object(std::uint32_t idx)
+    // increments reference count, only for REF_COUNTED atlases
+    void acquire(Handle handle) requires REF_COUNTED
     {
-        assert(names_[idx].empty() == false && "Object not found");
-        assert(idx < SIZE && "Index out of bounds");
-        objects_[idx] = T{};
-        names_[idx] = "";
-        free_indices_.push_front(idx);
+        auto* slot = get_slot(handle);
+        assert(slot && "Object not found");
+        if (slot)
+        {
+            slot->ref_count++;
+        }
+    }
+
+    void remove_object(Handle handle)
+    {
+        auto* slot = get_slot(handle);
+        if (!slot)
+        {
+            assert(false && "Object not found");
+            return;
+        }
+        if constexpr (REF_COUNTED)
+        {
+            assert(slot->ref_count > 0);
+            if (--slot->ref_count > 0)
+            {
+                return;
+            }
+        }
+        slot->alive = false;
+        const auto names_it = names_index_.find(slot->name);
+        assert(names_it != names_index_.end());
+        if (--names_it->second.count == 0)
+        {
+            names_index_.erase(names_it);
+        }
+        else if (names_it->second.handle == handle)
+        {
+            // removed object owned the name entry, pass it to the next object with the same name
+            names_it->second.handle = find_by_name_slow(slot->name);
+        }
+        slot->object = T{};
+        slot->name.clear();
+        slot->ref_count = 0;
+        slot->generation = (slot->generation + 1) & K_GENERATION_MASK;
+        alive_count_--;
+        free_slots_.push_back(get_index(handle));
     }
 
     void remove_object(std::string_view name)
     {
-        for (std::uint32_t i = 0; const auto & n : names_)
+        const auto handle = get_object(name);
+        if (handle == ENGINE_INVALID_OBJECT_HANDLE)
+        {
+            assert(false && "Object not found");
+            return;
+        }
+        remove_object(handle);
+    }
+
+    const T* get_object(Handle handle) const
+    {
+        // it's valid not found object - user may want to check if object exists by trying to get it
+        const auto* slot = get_slot(handle);
+        return slot ? &slot->object : nullptr;
+    }
+
+    T* get_object(Handle handle)
+    {
+        auto* slot = get_slot(handle);
+        return slot ? &slot->object : nullptr;
+    }
+
+    Handle get_object(std::string_view name) const
+    {
+        const auto it = names_index_.find(name);
+        if (it == names_index_.end())
+        {
+            // it's valid not found object - user may want to check if object exists by trying to get it
+            return ENGINE_INVALID_OBJECT_HANDLE;
+        }
+        return it->second.handle;
+    }
+
+    std::string_view get_name(Handle handle) const
+    {
+        const auto* slot = get_slot(handle);
+        return slot ? std::string_view(slot->name) : std::string_view{};
+    }
+
+    std::uint32_t get_ref_count(Handle handle) const
+    {
+        const auto* slot = get_slot(handle);
+        return slot ? slot->ref_count : 0u;
+    }
+
+    std::size_t size() const { return alive_count_; }
+
+    template<typename Func>
+    void for_each(Func&& func)
+    {
+        for (std::uint32_t i = 0; auto& slot : slots_)
         {
-            if (n.compare(name) == 0)
+            if (slot.alive)
             {
-                remove_object(i);
-                break;
+                func(make_handle(i, slot.generation), slot.object);
             }
             i++;
         }
-        assert(false && "Object not found");
     }
 
-    const T* get_object(std::uint32_t idx) const
+private:
+    struct slot_t
     {
-        if (idx >= SIZE)
+        T object{};
+        std::string name;
+        std::uint32_t generation = 0;
+        std::uint32_t ref_count = 0;
+        bool alive = false;
+    };
+
+    struct name_entry_t
+    {
+        Handle handle;
+        std::uint32_t count; // number of alive objects with this name
+    };
+
+    struct string_hash
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    static inline Handle make_handle(std::uint32_t idx, std::uint32_t generation)
+    {
+        return (generation << K_INDEX_BITS) | idx;
+    }
+
+    static inline std::uint32_t get_index(Handle handle) { return handle & K_INDEX_MASK; }
+    static inline std::uint32_t get_generation(Handle handle) { return handle >> K_INDEX_BITS; }
+
+    const slot_t* get_slot(Handle handle) const
+    {
+        if (handle == ENGINE_INVALID_OBJECT_HANDLE)
+        {
+            return nullptr;
+        }
+        const auto idx = get_index(handle);
+        if (idx >= slots_.size())
         {
             assert(false && "Index out of bounds");
             return nullptr;
         }
-        if (names_[idx].empty())
+        const auto& slot = slots_[idx];
+        if (!slot.alive || slot.generation != get_generation(handle))
         {
-            // it's valid not found object - user may want to check if object exists by trying to get it
             return nullptr;
         }
-        return &objects_[idx];
+        return &slot;
     }
 
-    std::uint32_t get_object(std::string_view name) const
+    slot_t* get_slot(Handle handle)
     {
-        for (std::uint32_t i = 0; const auto & n : names_)
+        return const_cast<slot_t*>(std::as_const(*this).get_slot(handle));
+    }
+
+    // linear search, used only when object with duplicated name is removed
+    Handle find_by_name_slow(std::string_view name) const
+    {
+        for (std::uint32_t i = 0; const auto& slot : slots_)
         {
-            if (n.compare(name) == 0)
+            if (slot.alive && slot.name == name)
             {
-                return i;
+                return make_handle(i, slot.generation);
             }
             i++;
         }
-        // it's valid not found object - user may want to check if object exists by trying to get it
         return ENGINE_INVALID_OBJECT_HANDLE;
     }
 
-    const std::array<T, SIZE>& get_objects_view() const { return objects_; }
-    std::array<T, SIZE>& get_objects_view() { return objects_; }
 private:
-    std::array<T, SIZE> objects_;
-    std::array<std::string, SIZE> names_;
-    std::deque<std::uint32_t> free_indices_;
+    std::deque<slot_t> slots_;
+    std::vector<std::uint32_t> free_slots_;
+    std::unordered_map<std::string, name_entry_t, string_hash, std::equal_to<>> names_index_;
+    std::size_t alive_count_ = 0;
 };
-}
\ No newline at end of file
+}
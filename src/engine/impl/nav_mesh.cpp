@@ -1,7 +1,33 @@
 #include "nav_mesh.h"
 
-#include <queue>
-#include <unordered_set>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// limits memory of the lookup grid for sparse meshes
+constexpr float K_MAX_GRID_CELLS_PER_NODE = 4.0f;
+
+inline bool contains_xz(const engine::NavMeshNode& node, const engine::NavMeshPosition3D& pos)
+{
+    const auto center = node.get_center();
+    const auto size = node.get_size();
+    return pos.x >= center.x - size.x && pos.x <= center.x + size.x &&
+        //pos.y >= center.y - size.y && pos.y <= center.y + size.y &&
+        pos.z >= center.z - size.z && pos.z <= center.z + size.z;
+}
+
+// squared distance from pos to the bounding box of the node (xz plane)
+inline float distance_xz_squared(const engine::NavMeshNode& node, const engine::NavMeshPosition3D& pos)
+{
+    const auto center = glm::vec2(node.get_center().x, node.get_center().z);
+    const auto size = glm::vec2(node.get_size().x, node.get_size().z);
+    const auto d = glm::max(glm::abs(glm::vec2(pos.x, pos.z) - center) - size, glm::vec2(0.0f));
+    return glm::dot(d, d);
+}
+}  // namespace anonymous
 
 engine::NavMeshNodeIdx engine::NavMesh::add_node(NavMeshNodeCenterOfMass&& center, NavMeshNodeHalfSize&& size)
 {
@@ -29,7 +55,156 @@ void engine::NavMesh::add_edge(NavMeshNodeIdx node_idx_1, NavMeshNodeIdx node_id
         return;
     }
 
-    nodes_[node_idx_1].add_edge(node_idx_2, cost);
+    pending_edges_.push_back({ node_idx_1, NavMeshEdge{ node_idx_2, cost } });
+}
+
+void engine::NavMesh::build()
+{
+    // counting sort of existing and pending edges by source node
+    std::vector<std::uint32_t> offsets(nodes_.size() + 1, 0);
+    for (std::size_t i = 0; i + 1 < edges_offsets_.size(); i++)
+    {
+        offsets[i + 1] += edges_offsets_[i + 1] - edges_offsets_[i];
+    }
+    for (const auto& pending : pending_edges_)
+    {
+        offsets[pending.source + 1]++;
+    }
+    for (std::size_t i = 1; i < offsets.size(); i++)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    std::vector<NavMeshEdge> edges(offsets.back());
+    std::vector<std::uint32_t> insert_pos(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i + 1 < edges_offsets_.size(); i++)
+    {
+        for (auto e = edges_offsets_[i]; e < edges_offsets_[i + 1]; e++)
+        {
+            edges[insert_pos[i]++] = edges_[e];
+        }
+    }
+    for (const auto& pending : pending_edges_)
+    {
+        edges[insert_pos[pending.source]++] = pending.edge;
+    }
+    edges_offsets_ = std::move(offsets);
+    edges_ = std::move(edges);
+    pending_edges_.clear();
+
+    // same counting sort by target node
+    incoming_edges_offsets_.assign(nodes_.size() + 1, 0);
+    for (const auto& edge : edges_)
+    {
+        incoming_edges_offsets_[edge.target + 1]++;
+    }
+    for (std::size_t i = 1; i < incoming_edges_offsets_.size(); i++)
+    {
+        incoming_edges_offsets_[i] += incoming_edges_offsets_[i - 1];
+    }
+    incoming_edges_.resize(edges_.size());
+    insert_pos.assign(incoming_edges_offsets_.begin(), incoming_edges_offsets_.end() - 1);
+    for (std::size_t i = 0; i < nodes_.size(); i++)
+    {
+        for (auto e = edges_offsets_[i]; e < edges_offsets_[i + 1]; e++)
+        {
+            incoming_edges_[insert_pos[edges_[e].target]++] = NavMeshEdge{ static_cast<NavMeshNodeIdx>(i), edges_[e].cost };
+        }
+    }
+    build_grid();
+
+    // heuristic has to be a lower bound of the real cost to keep A* paths optimal
+    cost_per_distance_ = std::numeric_limits<float>::max();
+    for (std::size_t i = 0; i < nodes_.size(); i++)
+    {
+        const auto edges_span = get_edges(static_cast<NavMeshNodeIdx>(i));
+        for (auto it = edges_span.begin(); it != edges_span.end(); it++)
+        {
+            assert(std::none_of(edges_span.begin(), it, [&it](const auto& e) { return e.target == it->target; }) && "Edge already exists");
+            const auto distance = glm::distance(nodes_[i].get_center(), nodes_[it->target].get_center());
+            cost_per_distance_ = distance > 0.0f ? std::min(cost_per_distance_, static_cast<float>(it->cost) / distance) : 0.0f;
+        }
+    }
+    if (edges_.empty())
+    {
+        cost_per_distance_ = 0.0f;
+    }
+}
+
+void engine::NavMesh::build_grid()
+{
+    grid_offsets_.clear();
+    grid_nodes_.clear();
+    grid_size_ = glm::ivec2(0);
+    grid_nodes_count_ = nodes_.size();
+    if (nodes_.empty())
+    {
+        return;
+    }
+
+    auto bounds_min = glm::vec2(std::numeric_limits<float>::max());
+    auto bounds_max = glm::vec2(std::numeric_limits<float>::lowest());
+    float nodes_extent = 0.0f;
+    for (const auto& node : nodes_)
+    {
+        const auto center = glm::vec2(node.get_center().x, node.get_center().z);
+        const auto size = glm::vec2(node.get_size().x, node.get_size().z);
+        bounds_min = glm::min(bounds_min, center - size);
+        bounds_max = glm::max(bounds_max, center + size);
+        nodes_extent += 2.0f * std::max(size.x, size.y);
+    }
+
+    // cell of average node size, so each node overlaps only few cells and each cell holds only few nodes
+    const auto extent = bounds_max - bounds_min;
+    const auto min_cell_size = std::sqrt(extent.x * extent.y / (K_MAX_GRID_CELLS_PER_NODE * nodes_.size()));
+    grid_cell_size_ = std::max(nodes_extent / nodes_.size(), min_cell_size);
+    if (grid_cell_size_ <= 0.0f)
+    {
+        grid_cell_size_ = std::max(std::max(extent.x, extent.y), 1.0f);
+    }
+    grid_origin_ = bounds_min;
+    grid_size_ = glm::ivec2(glm::floor(extent / grid_cell_size_)) + 1;
+
+    // counting sort of nodes by overlapped cells
+    const auto for_each_overlapped_cell = [this](const NavMeshNode& node, auto&& func)
+    {
+        const auto first = get_grid_cell(node.get_center() - node.get_size());
+        const auto last = get_grid_cell(node.get_center() + node.get_size());
+        for (auto z = first.y; z <= last.y; z++)
+        {
+            for (auto x = first.x; x <= last.x; x++)
+            {
+                func(static_cast<std::size_t>(z) * grid_size_.x + x);
+            }
+        }
+    };
+    grid_offsets_.assign(static_cast<std::size_t>(grid_size_.x) * grid_size_.y + 1, 0);
+    for (const auto& node : nodes_)
+    {
+        for_each_overlapped_cell(node, [this](std::size_t cell) { grid_offsets_[cell + 1]++; });
+    }
+    for (std::size_t i = 1; i < grid_offsets_.size(); i++)
+    {
+        grid_offsets_[i] += grid_offsets_[i - 1];
+    }
+    grid_nodes_.resize(grid_offsets_.back());
+    std::vector<std::uint32_t> insert_pos(grid_offsets_.begin(), grid_offsets_.end() - 1);
+    for (const auto& node : nodes_)
+    {
+        for_each_overlapped_cell(node, [this, &insert_pos, &node](std::size_t cell) { grid_nodes_[insert_pos[cell]++] = node.get_idx(); });
+    }
+}
+
+glm::ivec2 engine::NavMesh::get_grid_cell(const NavMeshPosition3D& pos) const
+{
+    const auto cell = glm::ivec2(glm::floor((glm::vec2(pos.x, pos.z) - grid_origin_) / grid_cell_size_));
+    return glm::clamp(cell, glm::ivec2(0), grid_size_ - 1);
+}
+
+std::span<const engine::NavMeshNodeIdx> engine::NavMesh::get_grid_cell_nodes(const glm::ivec2& cell) const
+{
+    const auto i = static_cast<std::size_t>(cell.y) * grid_size_.x + cell.x;
+    return std::span<const NavMeshNodeIdx>(grid_nodes_.data() + grid_offsets_[i], grid_nodes_.data() + grid_offsets_[i + 1]);
 }
 
 const engine::NavMeshNode& engine::NavMesh::get_node(NavMeshNodeIdx idx) const
@@ -38,23 +213,97 @@ const engine::NavMeshNode& engine::NavMesh::get_node(NavMeshNodeIdx idx) const
     return nodes_[idx];
 }
 
+std::span<const engine::NavMeshEdge> engine::NavMesh::get_edges(NavMeshNodeIdx idx) const
+{
+    assert(idx >= 0 && idx < nodes_.size() && "Invalid node index");
+    assert(is_built() && "Nav mesh has to be built before accessing edges");
+    return std::span<const NavMeshEdge>(edges_.data() + edges_offsets_[idx], edges_.data() + edges_offsets_[idx + 1]);
+}
+
+std::span<const engine::NavMeshEdge> engine::NavMesh::get_incoming_edges(NavMeshNodeIdx idx) const
+{
+    assert(idx >= 0 && idx < nodes_.size() && "Invalid node index");
+    assert(is_built() && "Nav mesh has to be built before accessing edges");
+    return std::span<const NavMeshEdge>(incoming_edges_.data() + incoming_edges_offsets_[idx], incoming_edges_.data() + incoming_edges_offsets_[idx + 1]);
+}
+
+float engine::NavMesh::get_cost_estimate(NavMeshNodeIdx from, NavMeshNodeIdx to) const
+{
+    return glm::distance(nodes_[from].get_center(), nodes_[to].get_center()) * cost_per_distance_;
+}
+
 engine::NavMeshNodeIdx engine::NavMesh::get_node_idx(const NavMeshPosition3D& pos) const
 {
-    // iterate over all nodes and check if "pos" is in bounding box of Node
-    for (const auto& node : nodes_)
+    assert(is_built() && "Nav mesh has to be built before node lookup");
+    if (nodes_.empty())
+    {
+        return invalid_node_idx;
+    }
+    // check only nodes overlapping the cell of "pos"
+    for (const auto idx : get_grid_cell_nodes(get_grid_cell(pos)))
     {
-        const auto center = node.get_center();
-        const auto size = node.get_size();
-        if (pos.x >= center.x - size.x && pos.x <= center.x + size.x &&
-            //pos.y >= center.y - size.y && pos.y <= center.y + size.y &&
-            pos.z >= center.z - size.z && pos.z <= center.z + size.z)
+        if (contains_xz(nodes_[idx], pos))
         {
-            return node.get_idx();
+            return idx;
         }
     }
     return invalid_node_idx;
 }
 
+engine::NavMeshNodeIdx engine::NavMesh::get_nearest_node_idx(const NavMeshPosition3D& pos) const
+{
+    const auto contained = get_node_idx(pos);
+    if (contained != invalid_node_idx || nodes_.empty())
+    {
+        return contained;
+    }
+
+    // rings of cells around the cell of "pos", cells of ring r are at least (r - 1) * cell size away from "pos"
+    // (also for "pos" outside of the grid, because its projection on the grid is in the start cell)
+    const auto start = get_grid_cell(pos);
+    auto best = invalid_node_idx;
+    auto best_distance = std::numeric_limits<float>::max();
+    const auto visit_cell = [&](glm::ivec2 cell)
+    {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= grid_size_.x || cell.y >= grid_size_.y)
+        {
+            return;
+        }
+        for (const auto idx : get_grid_cell_nodes(cell))
+        {
+            const auto distance = distance_xz_squared(nodes_[idx], pos);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best = idx;
+            }
+        }
+    };
+    const auto max_ring = std::max(grid_size_.x, grid_size_.y);
+    for (std::int32_t ring = 0; ring <= max_ring; ring++)
+    {
+        const auto ring_distance = std::max(ring - 1, 0) * grid_cell_size_;
+        if (best != invalid_node_idx && best_distance <= ring_distance * ring_distance)
+        {
+            break;
+        }
+        for (auto x = -ring; x <= ring; x++)
+        {
+            visit_cell(start + glm::ivec2(x, -ring));
+            if (ring > 0)
+            {
+                visit_cell(start + glm::ivec2(x, ring));
+            }
+        }
+        for (auto z = -ring + 1; z <= ring - 1; z++)
+        {
+            visit_cell(start + glm::ivec2(-ring, z));
+            visit_cell(start + glm::ivec2(ring, z));
+        }
+    }
+    return best;
+}
+
 engine::NavMeshNode::NavMeshNode(NavMeshNodeIdx my_idx, NavMeshNodeCenterOfMass&& pos, NavMeshNodeHalfSize&& size)
     : idx_(my_idx)
     , center_(std::move(pos))
@@ -63,16 +312,6 @@ engine::NavMeshNode::NavMeshNode(NavMeshNodeIdx my_idx, NavMeshNodeCenterOfMass&
     assert(idx_ != invalid_node_idx);
 }
 
-void engine::NavMeshNode::add_edge(NavMeshNodeIdx node_idx, NavMeshEdgeCost cost)
-{
-    if (edges_.find(node_idx) != edges_.end())
-    {
-        assert(false && "Edge already exists");
-        return;
-    }
-    edges_.emplace(node_idx, cost);
-}
-
 engine::NavMesh::NavMesh()
 {
     nodes_.reserve(1024);
@@ -80,44 +319,235 @@ engine::NavMesh::NavMesh()
 
 engine::NavMeshPathFinder::PathFromStartToEnd engine::NavMeshPathFinder::find_path(const NavMesh& mesh, NavMeshNodeIdx start, NavMeshNodeIdx end)
 {
-    constexpr bool optimization_early_exit = true;
-
     PathFromStartToEnd ret{};
+    if (!mesh.is_built())
+    {
+        assert(false && "Nav mesh has to be built before path queries");
+        return ret;
+    }
+    if (start < 0 || start >= mesh.get_nodes_count() || end < 0 || end >= mesh.get_nodes_count() || start == end)
+    {
+        return ret;
+    }
 
-    std::queue<NavMeshNodeIdx> frontier;
-    frontier.push(start);
-    std::unordered_map<NavMeshNodeIdx, NavMeshNodeIdx> came_from;
-    came_from[start] = start;
+    // new generation invalidates states of all nodes without clearing the buffer
+    if (nodes_state_.size() < mesh.get_nodes_count())
+    {
+        nodes_state_.resize(mesh.get_nodes_count());
+    }
+    generation_++;
+    if (generation_ == 0)
+    {
+        std::fill(nodes_state_.begin(), nodes_state_.end(), node_state_t{});
+        generation_ = 1;
+    }
+    const auto heap_compare = [](const open_node_t& lhs, const open_node_t& rhs) { return lhs.estimated_cost > rhs.estimated_cost; };
 
-    while (!frontier.empty())
+    open_.clear();
+    nodes_state_[start] = node_state_t{ generation_, 0, invalid_node_idx, false };
+    open_.push_back({ mesh.get_cost_estimate(start, end), start });
+    bool found = false;
+    while (!open_.empty())
     {
-        const auto current = mesh.get_node(frontier.front());
-        if constexpr (optimization_early_exit)
+        std::pop_heap(open_.begin(), open_.end(), heap_compare);
+        const auto current = open_.back().idx;
+        open_.pop_back();
+
+        auto& current_state = nodes_state_[current];
+        if (current_state.closed)
         {
-            if (current.get_idx() == end)
-            {
-                break;
-            }
+            continue;
+        }
+        current_state.closed = true;
+        if (current == end)
+        {
+            found = true;
+            break;
         }
-        frontier.pop();
-        const auto edges = current.get_edges();
-        for (const auto next : edges)
+
+        for (const auto& edge : mesh.get_edges(current))
         {
-            if (came_from.find(next.first) == came_from.end())
+            auto& next_state = nodes_state_[edge.target];
+            const auto cost = current_state.cost + edge.cost;
+            if (next_state.generation != generation_)
+            {
+                next_state = node_state_t{ generation_, cost, current, false };
+            }
+            else if (next_state.closed || cost >= next_state.cost)
             {
-                frontier.push(next.first);
-                came_from[next.first] = current.get_idx();
+                continue;
             }
+            next_state.cost = cost;
+            next_state.came_from = current;
+            open_.push_back({ static_cast<float>(cost) + mesh.get_cost_estimate(edge.target, end), edge.target });
+            std::push_heap(open_.begin(), open_.end(), heap_compare);
         }
     }
 
-    while (end != start)
+    if (!found)
     {
-        ret.nodes.push_back(end);
-        end = came_from[end];
+        return ret;
     }
-    //ret.nodes.push_back(start);
-    // reverse so it's from start to begin
+    ret.cost = nodes_state_[end].cost;
+    for (auto node = end; node != start; node = nodes_state_[node].came_from)
+    {
+        ret.nodes.push_back(node);
+    }
+    // reverse so it's from start to end
     std::reverse(ret.nodes.begin(), ret.nodes.end());
     return ret;
 }
+
+bool engine::NavMeshFlowField::set_goal(const NavMesh& mesh, const NavMeshPosition3D& goal)
+{
+    if (!mesh.is_built())
+    {
+        assert(false && "Nav mesh has to be built before flow field update");
+        return false;
+    }
+    const auto goal_node = mesh.get_nearest_node_idx(goal);
+    if (goal_node == invalid_node_idx)
+    {
+        return false;
+    }
+
+    // goal moved inside of the same node - integration field stays the same
+    auto& current = searching_ ? search_ : field_;
+    if (goal_node == current.goal && current.costs.size() == mesh.get_nodes_count())
+    {
+        current.goal_position = goal;
+        if (field_.goal == goal_node)
+        {
+            field_.goal_position = goal;
+        }
+        return false;
+    }
+    start_search(mesh, goal_node, goal);
+    return true;
+}
+
+void engine::NavMeshFlowField::start_search(const NavMesh& mesh, NavMeshNodeIdx goal, const NavMeshPosition3D& goal_position)
+{
+    const auto nodes_count = mesh.get_nodes_count();
+    search_.goal = goal;
+    search_.goal_position = goal_position;
+    search_.costs.assign(nodes_count, K_UNREACHABLE);
+    search_.next_nodes.assign(nodes_count, invalid_node_idx);
+    search_.directions.assign(nodes_count, glm::vec3(0.0f));
+    search_.costs[goal] = 0;
+    open_.clear();
+    open_.push_back({ 0, goal });
+    searching_ = true;
+}
+
+bool engine::NavMeshFlowField::update(const NavMesh& mesh, std::uint32_t max_nodes)
+{
+    if (!searching_)
+    {
+        return true;
+    }
+    if (!mesh.is_built() || search_.goal >= mesh.get_nodes_count())
+    {
+        assert(false && "Nav mesh has to be built before flow field update");
+        return false;
+    }
+    if (search_.costs.size() != mesh.get_nodes_count())
+    {
+        // mesh was rebuilt while search was spread over frames
+        start_search(mesh, search_.goal, search_.goal_position);
+    }
+
+    const auto heap_compare = [](const open_node_t& lhs, const open_node_t& rhs) { return lhs.cost > rhs.cost; };
+    for (std::uint32_t settled = 0; settled < max_nodes && !open_.empty();)
+    {
+        std::pop_heap(open_.begin(), open_.end(), heap_compare);
+        const auto current = open_.back();
+        open_.pop_back();
+        if (current.cost != search_.costs[current.idx])
+        {
+            // stale entry, node was already settled with lower cost
+            continue;
+        }
+        settled++;
+
+        // next node is final when node is settled
+        const auto next = search_.next_nodes[current.idx];
+        if (next != invalid_node_idx)
+        {
+            auto direction = mesh.get_node(next).get_center() - mesh.get_node(current.idx).get_center();
+            direction.y = 0.0f;
+            const auto length = glm::length(direction);
+            search_.directions[current.idx] = length > 0.0f ? direction / length : glm::vec3(0.0f);
+        }
+
+        for (const auto& edge : mesh.get_incoming_edges(current.idx))
+        {
+            const auto cost = current.cost + edge.cost;
+            if (cost < search_.costs[edge.target])
+            {
+                search_.costs[edge.target] = cost;
+                search_.next_nodes[edge.target] = current.idx;
+                open_.push_back({ cost, edge.target });
+                std::push_heap(open_.begin(), open_.end(), heap_compare);
+            }
+        }
+    }
+
+    if (!open_.empty())
+    {
+        return false;
+    }
+    std::swap(field_, search_);
+    searching_ = false;
+    return true;
+}
+
+void engine::NavMeshFlowField::reset()
+{
+    field_.goal = invalid_node_idx;
+    search_.goal = invalid_node_idx;
+    searching_ = false;
+    open_.clear();
+}
+
+engine::NavMeshEdgeCost engine::NavMeshFlowField::get_cost(NavMeshNodeIdx idx) const
+{
+    if (idx < 0 || idx >= field_.costs.size())
+    {
+        return K_UNREACHABLE;
+    }
+    return field_.costs[idx];
+}
+
+engine::NavMeshNodeIdx engine::NavMeshFlowField::get_next_node(NavMeshNodeIdx idx) const
+{
+    if (idx < 0 || idx >= field_.next_nodes.size())
+    {
+        return invalid_node_idx;
+    }
+    return field_.next_nodes[idx];
+}
+
+bool engine::NavMeshFlowField::sample(const NavMesh& mesh, const NavMeshPosition3D& pos, glm::vec3& out_direction) const
+{
+    out_direction = glm::vec3(0.0f);
+    if (field_.goal == invalid_node_idx || field_.costs.size() != mesh.get_nodes_count())
+    {
+        return false;
+    }
+    const auto node = mesh.get_node_idx(pos);
+    if (node == invalid_node_idx || field_.costs[node] == K_UNREACHABLE)
+    {
+        return false;
+    }
+    if (node != field_.goal)
+    {
+        out_direction = field_.directions[node];
+        return true;
+    }
+    auto direction = field_.goal_position - pos;
+    direction.y = 0.0f;
+    const auto length = glm::length(direction);
+    out_direction = length > 0.0f ? direction / length : glm::vec3(0.0f);
+    return true;
+}
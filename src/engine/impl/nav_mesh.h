@@ -1,6 +1,9 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -13,6 +16,12 @@ using NavMeshPosition3D = glm::vec3;
 using NavMeshNodeCenterOfMass = glm::vec3;
 using NavMeshNodeHalfSize = glm::vec3;
 
+struct NavMeshEdge
+{
+    NavMeshNodeIdx target = invalid_node_idx;
+    NavMeshEdgeCost cost = 0;
+};
+
 class NavMeshNode
 {
 public:
@@ -27,15 +36,17 @@ public:
     inline NavMeshNodeCenterOfMass get_center() const { return center_; }
     inline NavMeshNodeHalfSize get_size() const { return size_; }
 
-    void add_edge(NavMeshNodeIdx node_idx, NavMeshEdgeCost cost);
-    inline const std::unordered_map<NavMeshNodeIdx, NavMeshEdgeCost>& get_edges() const { return edges_; }
 private:
     NavMeshNodeCenterOfMass center_;
     NavMeshNodeHalfSize size_;
     NavMeshNodeIdx idx_;
-    std::unordered_map<NavMeshNodeIdx, NavMeshEdgeCost> edges_;
 };
 
+// Graph of walkable nodes. Edges are stored as compressed sparse row adjacency:
+// outgoing edges of node i are edges_[edges_offsets_[i], edges_offsets_[i + 1]).
+// Added edges are pending until build() is called, path queries require built mesh.
+// Incoming edges are stored the same way (edge target is the source node), for searches from the goal.
+// build() also creates uniform grid over nodes bounds (xz plane), so point to node lookup checks only nodes of one cell.
 class NavMesh
 {
 public:
@@ -48,21 +59,61 @@ public:
 
     NavMeshNodeIdx add_node(NavMeshNodeCenterOfMass&& center, NavMeshNodeHalfSize&& size);
     void add_edge(NavMeshNodeIdx node_idx_1, NavMeshNodeIdx node_idx_2, NavMeshEdgeCost cost);
+    // merges pending edges into adjacency arrays and builds lookup grid
+    void build();
+    bool is_built() const { return pending_edges_.empty() && edges_offsets_.size() == nodes_.size() + 1 && grid_nodes_count_ == nodes_.size(); }
 
     const NavMeshNode& get_node(NavMeshNodeIdx idx) const;
+    // node which contains pos (height is ignored), invalid_node_idx if there is no such node
     NavMeshNodeIdx get_node_idx(const NavMeshPosition3D& pos) const;
+    // node which contains pos or the closest one, invalid_node_idx only for empty mesh
+    NavMeshNodeIdx get_nearest_node_idx(const NavMeshPosition3D& pos) const;
+    std::size_t get_nodes_count() const { return nodes_.size(); }
+    std::span<const NavMeshEdge> get_edges(NavMeshNodeIdx idx) const;
+    // edges ending in node idx, target of returned edge is the source node
+    std::span<const NavMeshEdge> get_incoming_edges(NavMeshNodeIdx idx) const;
+
+    // lower bound of the path cost between two nodes (straight line distance scaled by the cheapest cost per unit of distance of all edges)
+    float get_cost_estimate(NavMeshNodeIdx from, NavMeshNodeIdx to) const;
 
 private:
+    struct pending_edge_t
+    {
+        NavMeshNodeIdx source = invalid_node_idx;
+        NavMeshEdge edge;
+    };
+
     std::vector<NavMeshNode> nodes_;
+    std::vector<std::uint32_t> edges_offsets_;
+    std::vector<NavMeshEdge> edges_;
+    std::vector<std::uint32_t> incoming_edges_offsets_;
+    std::vector<NavMeshEdge> incoming_edges_;
+    std::vector<pending_edge_t> pending_edges_;
+    float cost_per_distance_ = 0.0f;
+
+    void build_grid();
+    glm::ivec2 get_grid_cell(const NavMeshPosition3D& pos) const;
+    std::span<const NavMeshNodeIdx> get_grid_cell_nodes(const glm::ivec2& cell) const;
+
+    // nodes overlapping cell (x, z) are grid_nodes_[grid_offsets_[i], grid_offsets_[i + 1]), where i = z * grid_size_.x + x
+    glm::vec2 grid_origin_ = glm::vec2(0.0f);
+    float grid_cell_size_ = 1.0f;
+    glm::ivec2 grid_size_ = glm::ivec2(0);
+    std::vector<std::uint32_t> grid_offsets_;
+    std::vector<NavMeshNodeIdx> grid_nodes_;
+    std::size_t grid_nodes_count_ = 0;
 };
 
+// A* search. Scratch buffers are kept between queries, so one path finder should be reused for many queries (not thread safe).
 class NavMeshPathFinder
 {
 public:
     struct Path
     {
         std::vector<NavMeshNodeIdx> nodes;
+        NavMeshEdgeCost cost = 0;
     };
+    // doesn't include start node, empty if end is not reachable
     struct PathFromStartToEnd : public Path
     {
     };
@@ -74,6 +125,85 @@ public:
     NavMeshPathFinder& operator=(NavMeshPathFinder&& rhs) noexcept = default;
     ~NavMeshPathFinder() = default;
 
-    static PathFromStartToEnd find_path(const NavMesh& mesh, NavMeshNodeIdx start, NavMeshNodeIdx end);
+    PathFromStartToEnd find_path(const NavMesh& mesh, NavMeshNodeIdx start, NavMeshNodeIdx end);
+
+private:
+    struct open_node_t
+    {
+        float estimated_cost = 0.0f; // cost from start + heuristic
+        NavMeshNodeIdx idx = invalid_node_idx;
+    };
+
+    struct node_state_t
+    {
+        std::uint32_t generation = 0; // state is valid only when equal to generation_ of the current query
+        NavMeshEdgeCost cost = 0;
+        NavMeshNodeIdx came_from = invalid_node_idx;
+        bool closed = false;
+    };
+
+    // binary heap (std::push_heap/std::pop_heap), nodes can be pushed multiple times, stale entries are skipped when popped
+    std::vector<open_node_t> open_;
+    std::vector<node_state_t> nodes_state_;
+    std::uint32_t generation_ = 0;
+};
+
+// Flow field towards one goal, shared by all agents chasing it instead of path search per agent.
+// Integration field is the cost from every node to the goal (Dijkstra from the goal over incoming edges),
+// direction field is the direction from node center to the next node of the cheapest path.
+// Goal change to a different node restarts the search in back buffers, update() can spread it over frames
+// and sampling uses the last completed field until the new one is ready.
+// Field has to be reset() when the nav mesh is rebuilt.
+class NavMeshFlowField
+{
+public:
+    static constexpr NavMeshEdgeCost K_UNREACHABLE = std::numeric_limits<NavMeshEdgeCost>::max();
+
+public:
+    NavMeshFlowField() = default;
+    NavMeshFlowField(const NavMeshFlowField& rhs) = delete;
+    NavMeshFlowField(NavMeshFlowField&& rhs) noexcept = default;
+    NavMeshFlowField& operator=(const NavMeshFlowField& rhs) = delete;
+    NavMeshFlowField& operator=(NavMeshFlowField&& rhs) noexcept = default;
+    ~NavMeshFlowField() = default;
+
+    // returns true if goal moved to a different node and field has to be recomputed with update()
+    bool set_goal(const NavMesh& mesh, const NavMeshPosition3D& goal);
+    // settles at most max_nodes nodes of the search, returns true when field of the current goal is complete
+    bool update(const NavMesh& mesh, std::uint32_t max_nodes = std::numeric_limits<std::uint32_t>::max());
+    bool is_complete() const { return !searching_; }
+    void reset();
+
+    // queries of the last completed field
+    NavMeshNodeIdx get_goal_node() const { return field_.goal; }
+    NavMeshEdgeCost get_cost(NavMeshNodeIdx idx) const;
+    NavMeshNodeIdx get_next_node(NavMeshNodeIdx idx) const;
+    // direction (xz plane) at pos, in the goal node it points to the goal position
+    // returns false if pos is outside of the mesh or goal is not reachable from it
+    bool sample(const NavMesh& mesh, const NavMeshPosition3D& pos, glm::vec3& out_direction) const;
+
+private:
+    struct field_t
+    {
+        NavMeshNodeIdx goal = invalid_node_idx;
+        NavMeshPosition3D goal_position = NavMeshPosition3D(0.0f);
+        std::vector<NavMeshEdgeCost> costs;
+        std::vector<NavMeshNodeIdx> next_nodes;
+        std::vector<glm::vec3> directions;
+    };
+
+    struct open_node_t
+    {
+        NavMeshEdgeCost cost = 0;
+        NavMeshNodeIdx idx = invalid_node_idx;
+    };
+
+    void start_search(const NavMesh& mesh, NavMeshNodeIdx goal, const NavMeshPosition3D& goal_position);
+
+    field_t field_;
+    // buffers of the search in progress, swapped with field_ when complete (so buffers are reused)
+    field_t search_;
+    bool searching_ = false;
+    std::vector<open_node_t> open_;
 };
-}  // namespace engine
\ No newline at end of file
+}  // namespace engine
@@ -0,0 +1,674 @@
+#include "nav_mesh_builder.h"
+#include "logger.h"
+#include "profiler.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr std::int32_t K_NO_SPAN = -1;
+constexpr std::int32_t K_NO_CEILING = std::numeric_limits<std::int32_t>::max();
+// edge cost per unit of distance between node centers
+constexpr float K_COST_PER_UNIT = 100.0f;
+// directions of span neighbours: -x, +z, +x, -z
+constexpr std::int32_t K_DIRECTION_X[4] = { -1, 0, 1, 0 };
+constexpr std::int32_t K_DIRECTION_Z[4] = { 0, 1, 0, -1 };
+// triangle clipped by 4 planes of the cell has at most 7 vertices
+constexpr std::uint32_t K_MAX_CLIPPED_VERTICES = 12;
+
+struct span_t
+{
+    std::int32_t min = 0;
+    std::int32_t max = 0;
+    std::int32_t next = K_NO_SPAN;
+    bool walkable = false;
+};
+
+// solid spans of the tile (with border), spans of the column are linked list sorted by height
+struct heightfield_t
+{
+    std::int32_t size = 0;
+    std::vector<std::int32_t> columns;
+    std::vector<span_t> spans;
+
+    void add_span(std::int32_t x, std::int32_t z, span_t span, std::int32_t walkable_climb)
+    {
+        auto& head = columns[static_cast<std::size_t>(z) * size + x];
+        auto prev = K_NO_SPAN;
+        auto current = head;
+        while (current != K_NO_SPAN)
+        {
+            const auto other = spans[current];
+            if (other.min > span.max)
+            {
+                break;
+            }
+            if (other.max < span.min)
+            {
+                prev = current;
+                current = other.next;
+                continue;
+            }
+            // overlapping spans are merged, top surface decides if merged span is walkable
+            span.min = std::min(span.min, other.min);
+            if (std::abs(span.max - other.max) <= walkable_climb)
+            {
+                span.walkable = span.walkable || other.walkable;
+            }
+            else if (other.max > span.max)
+            {
+                span.walkable = other.walkable;
+            }
+            span.max = std::max(span.max, other.max);
+            current = other.next;
+            if (prev == K_NO_SPAN)
+            {
+                head = current;
+            }
+            else
+            {
+                spans[prev].next = current;
+            }
+        }
+        span.next = current;
+        spans.push_back(span);
+        const auto idx = static_cast<std::int32_t>(spans.size() - 1);
+        if (prev == K_NO_SPAN)
+        {
+            head = idx;
+        }
+        else
+        {
+            spans[prev].next = idx;
+        }
+    }
+};
+
+struct compact_span_t
+{
+    std::int32_t floor = 0;
+    std::int32_t ceiling = K_NO_CEILING;
+    std::int32_t neighbours[4] = { K_NO_SPAN, K_NO_SPAN, K_NO_SPAN, K_NO_SPAN };
+    std::int32_t distance = 0; // to the border of walkable area, 2 per cell (3 per diagonal)
+    std::int32_t region = -1;
+    bool walkable = true;
+};
+
+// polygon part on the side of the plane (axis == value), where sign * (p[axis] - value) >= 0
+std::uint32_t clip_polygon(const glm::vec3* in, std::uint32_t count, glm::vec3* out, std::int32_t axis, float value, float sign)
+{
+    std::uint32_t ret = 0;
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        const auto& a = in[i];
+        const auto& b = in[(i + 1) % count];
+        const auto da = sign * (a[axis] - value);
+        const auto db = sign * (b[axis] - value);
+        if (da >= 0.0f)
+        {
+            out[ret++] = a;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f))
+        {
+            out[ret++] = a + (b - a) * (da / (da - db));
+        }
+    }
+    return ret;
+}
+
+void rasterize_triangle(heightfield_t& heightfield, const glm::vec3* triangle, bool walkable, const glm::vec3& origin, float cell_size, float cell_height, std::int32_t walkable_climb)
+{
+    const auto bounds_min = glm::min(glm::min(triangle[0], triangle[1]), triangle[2]);
+    const auto bounds_max = glm::max(glm::max(triangle[0], triangle[1]), triangle[2]);
+    const auto size = heightfield.size;
+    const auto first = glm::ivec2(glm::floor((glm::vec2(bounds_min.x, bounds_min.z) - glm::vec2(origin.x, origin.z)) / cell_size));
+    const auto last = glm::ivec2(glm::floor((glm::vec2(bounds_max.x, bounds_max.z) - glm::vec2(origin.x, origin.z)) / cell_size));
+    if (last.x < 0 || last.y < 0 || first.x >= size || first.y >= size)
+    {
+        return;
+    }
+
+    glm::vec3 row[K_MAX_CLIPPED_VERTICES];
+    glm::vec3 cell[K_MAX_CLIPPED_VERTICES];
+    glm::vec3 tmp[K_MAX_CLIPPED_VERTICES];
+    for (auto z = std::max(first.y, 0); z <= std::min(last.y, size - 1); z++)
+    {
+        const auto cell_z = origin.z + z * cell_size;
+        auto row_count = clip_polygon(triangle, 3, tmp, 2, cell_z, 1.0f);
+        row_count = clip_polygon(tmp, row_count, row, 2, cell_z + cell_size, -1.0f);
+        if (row_count < 3)
+        {
+            continue;
+        }
+        for (auto x = std::max(first.x, 0); x <= std::min(last.x, size - 1); x++)
+        {
+            const auto cell_x = origin.x + x * cell_size;
+            auto cell_count = clip_polygon(row, row_count, tmp, 0, cell_x, 1.0f);
+            cell_count = clip_polygon(tmp, cell_count, cell, 0, cell_x + cell_size, -1.0f);
+            if (cell_count < 3)
+            {
+                continue;
+            }
+            auto y_min = cell[0].y;
+            auto y_max = cell[0].y;
+            for (std::uint32_t i = 1; i < cell_count; i++)
+            {
+                y_min = std::min(y_min, cell[i].y);
+                y_max = std::max(y_max, cell[i].y);
+            }
+            const auto span_max = static_cast<std::int32_t>(std::ceil((y_max - origin.y) / cell_height));
+            if (span_max < 0)
+            {
+                continue;
+            }
+            const auto span_min = std::max(static_cast<std::int32_t>(std::floor((y_min - origin.y) / cell_height)), 0);
+            heightfield.add_span(x, z, span_t{ span_min, std::max(span_max, span_min + 1), K_NO_SPAN, walkable }, walkable_climb);
+        }
+    }
+}
+
+// portals of the same pair of regions are merged into one segment
+void merge_portals(std::vector<engine::NavMeshBuilder::portal_t>& portals)
+{
+    std::sort(portals.begin(), portals.end(), [](const auto& lhs, const auto& rhs)
+        {
+            return lhs.node_a != rhs.node_a ? lhs.node_a < rhs.node_a : lhs.node_b < rhs.node_b;
+        });
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < portals.size(); i++)
+    {
+        if (count > 0 && portals[count - 1].node_a == portals[i].node_a && portals[count - 1].node_b == portals[i].node_b)
+        {
+            // portals are axis aligned, so merged segment is bounding box of both
+            portals[count - 1].start = glm::min(portals[count - 1].start, portals[i].start);
+            portals[count - 1].end = glm::max(portals[count - 1].end, portals[i].end);
+            continue;
+        }
+        portals[count++] = portals[i];
+    }
+    portals.resize(count);
+}
+
+inline float elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace anonymous
+
+void engine::NavMeshBuilder::build(const engine_nav_mesh_build_config_t& config, std::span<const glm::vec3> triangles)
+{
+    ENGINE_PROFILE_SECTION_N("nav_mesh_build");
+    tiles_.clear();
+    portals_.clear();
+    stats_ = {};
+    if (config.cell_size <= 0.0f || config.cell_height <= 0.0f || config.tile_size == 0)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Invalid nav mesh build config: cell size: {}, cell height: {}, tile size: {}.\n", config.cell_size, config.cell_height, config.tile_size));
+        return;
+    }
+    if (triangles.size() < 3 || triangles.size() % 3 != 0)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Invalid nav mesh geometry, vertices count: {}.\n", triangles.size()));
+        return;
+    }
+
+    config_ = config;
+    walkable_height_ = std::max(static_cast<std::int32_t>(std::ceil(config.agent_height / config.cell_height)), 1);
+    walkable_climb_ = static_cast<std::int32_t>(std::floor(config.agent_max_climb / config.cell_height));
+    walkable_radius_ = static_cast<std::int32_t>(std::ceil(config.agent_radius / config.cell_size));
+    // border has to fit erosion by agent radius and neighbours of the tile edge cells
+    border_ = walkable_radius_ + 1;
+    min_walkable_normal_y_ = std::cos(glm::radians(config.agent_max_slope));
+
+    auto bounds_min = triangles[0];
+    auto bounds_max = triangles[0];
+    for (const auto& v : triangles)
+    {
+        bounds_min = glm::min(bounds_min, v);
+        bounds_max = glm::max(bounds_max, v);
+    }
+    origin_ = bounds_min;
+    const auto extent = glm::vec2(bounds_max.x - bounds_min.x, bounds_max.z - bounds_min.z);
+    cells_count_ = glm::max(glm::ivec2(glm::ceil(extent / config.cell_size)), glm::ivec2(1));
+    const auto tile_size = static_cast<std::int32_t>(config.tile_size);
+    tiles_count_ = (cells_count_ + tile_size - 1) / tile_size;
+    tiles_.resize(static_cast<std::size_t>(tiles_count_.x) * tiles_count_.y);
+
+    std::vector<std::uint32_t> tiles(tiles_.size());
+    for (std::uint32_t i = 0; i < tiles.size(); i++)
+    {
+        tiles[i] = i;
+    }
+    build_tiles(triangles, tiles);
+}
+
+void engine::NavMeshBuilder::rebuild_area(std::span<const glm::vec3> triangles, const glm::vec3& bounds_min, const glm::vec3& bounds_max)
+{
+    ENGINE_PROFILE_SECTION_N("nav_mesh_rebuild_area");
+    if (!is_built())
+    {
+        log::log(log::LogLevel::eError, fmt::format("Nav mesh area can't be rebuilt before nav mesh is built.\n"));
+        return;
+    }
+    if (triangles.size() % 3 != 0)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Invalid nav mesh geometry, vertices count: {}.\n", triangles.size()));
+        return;
+    }
+
+    // changed cell affects every tile, which has this cell in its border
+    const auto tile_size = static_cast<float>(config_.tile_size);
+    const auto first_cell = glm::floor((glm::vec2(bounds_min.x, bounds_min.z) - glm::vec2(origin_.x, origin_.z)) / config_.cell_size);
+    const auto last_cell = glm::floor((glm::vec2(bounds_max.x, bounds_max.z) - glm::vec2(origin_.x, origin_.z)) / config_.cell_size);
+    const auto first_tile = glm::max(glm::ivec2(glm::floor((first_cell - static_cast<float>(border_)) / tile_size)), glm::ivec2(0));
+    const auto last_tile = glm::min(glm::ivec2(glm::floor((last_cell + static_cast<float>(border_)) / tile_size)), tiles_count_ - 1);
+
+    std::vector<std::uint32_t> tiles;
+    for (auto z = first_tile.y; z <= last_tile.y; z++)
+    {
+        for (auto x = first_tile.x; x <= last_tile.x; x++)
+        {
+            tiles.push_back(z * tiles_count_.x + x);
+        }
+    }
+    stats_ = {};
+    build_tiles(triangles, tiles);
+}
+
+void engine::NavMeshBuilder::build_tiles(std::span<const glm::vec3> triangles, const std::vector<std::uint32_t>& tiles)
+{
+    stats_.tiles_count = static_cast<std::uint32_t>(tiles_.size());
+    stats_.tiles_built = static_cast<std::uint32_t>(tiles.size());
+    if (tiles.empty())
+    {
+        return;
+    }
+
+    const auto triangles_count = triangles.size() / 3;
+    std::vector<std::uint8_t> walkable_triangles(triangles_count);
+    for (std::size_t i = 0; i < triangles_count; i++)
+    {
+        const auto normal = glm::cross(triangles[i * 3 + 1] - triangles[i * 3], triangles[i * 3 + 2] - triangles[i * 3]);
+        const auto length = glm::length(normal);
+        walkable_triangles[i] = length > 0.0f && normal.y / length >= min_walkable_normal_y_;
+    }
+
+    // counting sort of triangles by overlapped tiles (with border)
+    std::vector<std::int32_t> tile_slots(tiles_.size(), -1);
+    for (std::uint32_t i = 0; i < tiles.size(); i++)
+    {
+        tile_slots[tiles[i]] = static_cast<std::int32_t>(i);
+    }
+    const auto tile_size = static_cast<float>(config_.tile_size);
+    const auto for_each_overlapped_tile = [&](std::size_t triangle, auto&& func)
+    {
+        const auto* v = triangles.data() + triangle * 3;
+        const auto bounds_min = glm::min(glm::min(v[0], v[1]), v[2]);
+        const auto bounds_max = glm::max(glm::max(v[0], v[1]), v[2]);
+        const auto first_cell = glm::floor((glm::vec2(bounds_min.x, bounds_min.z) - glm::vec2(origin_.x, origin_.z)) / config_.cell_size);
+        const auto last_cell = glm::floor((glm::vec2(bounds_max.x, bounds_max.z) - glm::vec2(origin_.x, origin_.z)) / config_.cell_size);
+        const auto first_tile = glm::max(glm::ivec2(glm::floor((first_cell - static_cast<float>(border_)) / tile_size)), glm::ivec2(0));
+        const auto last_tile = glm::min(glm::ivec2(glm::floor((last_cell + static_cast<float>(border_)) / tile_size)), tiles_count_ - 1);
+        for (auto z = first_tile.y; z <= last_tile.y; z++)
+        {
+            for (auto x = first_tile.x; x <= last_tile.x; x++)
+            {
+                const auto slot = tile_slots[z * tiles_count_.x + x];
+                if (slot >= 0)
+                {
+                    func(static_cast<std::size_t>(slot));
+                }
+            }
+        }
+    };
+    std::vector<std::uint32_t> offsets(tiles.size() + 1, 0);
+    for (std::size_t i = 0; i < triangles_count; i++)
+    {
+        for_each_overlapped_tile(i, [&offsets](std::size_t slot) { offsets[slot + 1]++; });
+    }
+    for (std::size_t i = 1; i < offsets.size(); i++)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<std::uint32_t> tiles_triangles(offsets.back());
+    std::vector<std::uint32_t> insert_pos(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < triangles_count; i++)
+    {
+        for_each_overlapped_tile(i, [&](std::size_t slot) { tiles_triangles[insert_pos[slot]++] = static_cast<std::uint32_t>(i); });
+    }
+
+    for (std::size_t i = 0; i < tiles.size(); i++)
+    {
+        const auto tile_triangles = std::span<const std::uint32_t>(tiles_triangles.data() + offsets[i], tiles_triangles.data() + offsets[i + 1]);
+        build_tile(tiles[i], triangles, tile_triangles, walkable_triangles);
+    }
+    stats_.total_ms = stats_.voxelization_ms + stats_.regions_ms;
+}
+
+void engine::NavMeshBuilder::build_tile(std::uint32_t tile_idx, std::span<const glm::vec3> triangles, std::span<const std::uint32_t> tile_triangles, const std::vector<std::uint8_t>& walkable_triangles)
+{
+    const auto voxelization_start = std::chrono::steady_clock::now();
+    const auto tile_size = static_cast<std::int32_t>(config_.tile_size);
+    const auto size = tile_size + 2 * border_;
+    const auto tile = glm::ivec2(tile_idx % tiles_count_.x, tile_idx / tiles_count_.x);
+    // first cell of the tile with border, in global cells
+    const auto first_cell = tile * tile_size - border_;
+    const auto heightfield_origin = get_cell_position(first_cell, 0);
+
+    heightfield_t heightfield;
+    heightfield.size = size;
+    heightfield.columns.assign(static_cast<std::size_t>(size) * size, K_NO_SPAN);
+    for (const auto triangle : tile_triangles)
+    {
+        rasterize_triangle(heightfield, triangles.data() + triangle * 3, walkable_triangles[triangle], heightfield_origin, config_.cell_size, config_.cell_height, walkable_climb_);
+    }
+
+    // walkable spans: top of solid span with enough free space above it
+    std::vector<std::uint32_t> columns(static_cast<std::size_t>(size) * size + 1, 0);
+    std::vector<compact_span_t> spans;
+    for (std::size_t i = 0; i + 1 < columns.size(); i++)
+    {
+        for (auto s = heightfield.columns[i]; s != K_NO_SPAN; s = heightfield.spans[s].next)
+        {
+            const auto& span = heightfield.spans[s];
+            const auto ceiling = span.next != K_NO_SPAN ? heightfield.spans[span.next].min : K_NO_CEILING;
+            if (span.walkable && ceiling - span.max >= walkable_height_)
+            {
+                compact_span_t compact{};
+                compact.floor = span.max;
+                compact.ceiling = ceiling;
+                spans.push_back(compact);
+            }
+        }
+        columns[i + 1] = static_cast<std::uint32_t>(spans.size());
+    }
+
+    // agent can step to the neighbour span, if it's within climb height and there is enough space to pass
+    for (std::int32_t z = 0; z < size; z++)
+    {
+        for (std::int32_t x = 0; x < size; x++)
+        {
+            const auto column = static_cast<std::size_t>(z) * size + x;
+            for (auto i = columns[column]; i < columns[column + 1]; i++)
+            {
+                auto& span = spans[i];
+                for (std::uint32_t dir = 0; dir < 4; dir++)
+                {
+                    const auto nx = x + K_DIRECTION_X[dir];
+                    const auto nz = z + K_DIRECTION_Z[dir];
+                    if (nx < 0 || nz < 0 || nx >= size || nz >= size)
+                    {
+                        continue;
+                    }
+                    const auto neighbour_column = static_cast<std::size_t>(nz) * size + nx;
+                    for (auto n = columns[neighbour_column]; n < columns[neighbour_column + 1]; n++)
+                    {
+                        const auto& neighbour = spans[n];
+                        if (std::abs(neighbour.floor - span.floor) <= walkable_climb_ &&
+                            std::min(neighbour.ceiling, span.ceiling) - std::max(neighbour.floor, span.floor) >= walkable_height_)
+                        {
+                            span.neighbours[dir] = static_cast<std::int32_t>(n);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // erosion by agent radius: two pass chamfer distance to spans without all neighbours
+    if (walkable_radius_ > 0)
+    {
+        for (auto& span : spans)
+        {
+            const auto inner = std::all_of(std::begin(span.neighbours), std::end(span.neighbours), [](std::int32_t n) { return n != K_NO_SPAN; });
+            span.distance = inner ? std::numeric_limits<std::int32_t>::max() / 2 : 0;
+        }
+        const auto relax = [&spans](compact_span_t& span, std::uint32_t dir, std::uint32_t diagonal_dir)
+        {
+            const auto n = span.neighbours[dir];
+            if (n == K_NO_SPAN)
+            {
+                return;
+            }
+            span.distance = std::min(span.distance, spans[n].distance + 2);
+            const auto diagonal = spans[n].neighbours[diagonal_dir];
+            if (diagonal != K_NO_SPAN)
+            {
+                span.distance = std::min(span.distance, spans[diagonal].distance + 3);
+            }
+        };
+        for (std::uint32_t i = 0; i < spans.size(); i++)
+        {
+            relax(spans[i], 0, 3);
+            relax(spans[i], 3, 2);
+        }
+        for (auto i = spans.size(); i-- > 0;)
+        {
+            relax(spans[i], 2, 1);
+            relax(spans[i], 1, 0);
+        }
+        for (auto& span : spans)
+        {
+            span.walkable = span.distance >= walkable_radius_ * 2;
+        }
+    }
+    stats_.voxelization_ms += elapsed_ms(voxelization_start);
+
+    // regions: walkable spans of the tile (without border) greedily merged into rectangles, first along x then along z
+    const auto regions_start = std::chrono::steady_clock::now();
+    auto& result = tiles_[tile_idx];
+    result = tile_t{};
+    const auto core_begin = glm::ivec2(border_);
+    const auto core_end = glm::min(glm::ivec2(border_ + tile_size), cells_count_ - first_cell);
+    std::vector<std::int32_t> row;
+    std::vector<std::int32_t> next_row;
+    for (auto z = core_begin.y; z < core_end.y; z++)
+    {
+        for (auto x = core_begin.x; x < core_end.x; x++)
+        {
+            const auto column = static_cast<std::size_t>(z) * size + x;
+            for (auto i = columns[column]; i < columns[column + 1]; i++)
+            {
+                if (!spans[i].walkable || spans[i].region != -1)
+                {
+                    continue;
+                }
+                const auto seed_floor = spans[i].floor;
+                const auto can_merge = [&spans, seed_floor, this](std::int32_t n)
+                {
+                    return n != K_NO_SPAN && spans[n].walkable && spans[n].region == -1 && std::abs(spans[n].floor - seed_floor) <= walkable_climb_;
+                };
+                region_t region{};
+                region.min_floor = seed_floor;
+                region.max_floor = seed_floor;
+                const auto region_idx = static_cast<std::int32_t>(result.regions.size());
+                const auto assign_row = [&]()
+                {
+                    for (const auto n : row)
+                    {
+                        spans[n].region = region_idx;
+                        region.min_floor = std::min(region.min_floor, spans[n].floor);
+                        region.max_floor = std::max(region.max_floor, spans[n].floor);
+                    }
+                };
+
+                row.assign(1, static_cast<std::int32_t>(i));
+                for (auto rx = x + 1; rx < core_end.x && can_merge(spans[row.back()].neighbours[2]); rx++)
+                {
+                    row.push_back(spans[row.back()].neighbours[2]);
+                }
+                assign_row();
+                auto last_z = z;
+                while (last_z + 1 < core_end.y)
+                {
+                    // next row has to be connected to this row and along x
+                    next_row.clear();
+                    for (const auto n : row)
+                    {
+                        const auto up = spans[n].neighbours[1];
+                        if (!can_merge(up) || (!next_row.empty() && spans[next_row.back()].neighbours[2] != up))
+                        {
+                            break;
+                        }
+                        next_row.push_back(up);
+                    }
+                    if (next_row.size() != row.size())
+                    {
+                        break;
+                    }
+                    std::swap(row, next_row);
+                    assign_row();
+                    last_z++;
+                }
+                region.min = first_cell + glm::ivec2(x, z);
+                region.max = first_cell + glm::ivec2(x + static_cast<std::int32_t>(row.size()) - 1, last_z);
+                result.regions.push_back(region);
+            }
+        }
+    }
+
+    // portals between regions of the tile and cache of the tile edges
+    result.columns.assign(static_cast<std::size_t>(tile_size) * tile_size + 1, 0);
+    for (auto z = core_begin.y; z < core_begin.y + tile_size; z++)
+    {
+        for (auto x = core_begin.x; x < core_begin.x + tile_size; x++)
+        {
+            const auto tile_column = static_cast<std::size_t>(z - core_begin.y) * tile_size + (x - core_begin.x);
+            if (x >= core_end.x || z >= core_end.y)
+            {
+                result.columns[tile_column + 1] = static_cast<std::uint32_t>(result.spans.size());
+                continue;
+            }
+            const auto column = static_cast<std::size_t>(z) * size + x;
+            for (auto i = columns[column]; i < columns[column + 1]; i++)
+            {
+                const auto& span = spans[i];
+                if (span.region < 0)
+                {
+                    continue;
+                }
+                result.spans.push_back(tile_span_t{ span.floor, span.ceiling, span.region });
+                for (const auto dir : { 1u, 2u })
+                {
+                    const auto n = span.neighbours[dir];
+                    if (n == K_NO_SPAN || spans[n].region < 0 || spans[n].region == span.region || x + K_DIRECTION_X[dir] >= core_end.x || z + K_DIRECTION_Z[dir] >= core_end.y)
+                    {
+                        continue;
+                    }
+                    const auto floor = std::max(span.floor, spans[n].floor);
+                    const auto cell = first_cell + glm::ivec2(x, z);
+                    portal_t portal{};
+                    portal.node_a = std::min(span.region, spans[n].region);
+                    portal.node_b = std::max(span.region, spans[n].region);
+                    portal.start = get_cell_position(dir == 2 ? cell + glm::ivec2(1, 0) : cell + glm::ivec2(0, 1), floor);
+                    portal.end = get_cell_position(cell + glm::ivec2(1, 1), floor);
+                    result.portals.push_back(portal);
+                }
+            }
+            result.columns[tile_column + 1] = static_cast<std::uint32_t>(result.spans.size());
+        }
+    }
+    merge_portals(result.portals);
+    stats_.regions_ms += elapsed_ms(regions_start);
+}
+
+void engine::NavMeshBuilder::link_tiles(std::uint32_t tile_a, std::uint32_t tile_b, std::uint32_t node_offset_a, std::uint32_t node_offset_b, bool along_x)
+{
+    // last column (or row) of tile a with first column (or row) of tile b
+    const auto tile_size = static_cast<std::int32_t>(config_.tile_size);
+    const auto& a = tiles_[tile_a];
+    const auto& b = tiles_[tile_b];
+    const auto first_cell_b = glm::ivec2(tile_b % tiles_count_.x, tile_b / tiles_count_.x) * tile_size;
+    for (std::int32_t i = 0; i < tile_size; i++)
+    {
+        const auto column_a = along_x ? i * tile_size + tile_size - 1 : (tile_size - 1) * tile_size + i;
+        const auto column_b = along_x ? i * tile_size : i;
+        for (auto sa = a.columns[column_a]; sa < a.columns[column_a + 1]; sa++)
+        {
+            for (auto sb = b.columns[column_b]; sb < b.columns[column_b + 1]; sb++)
+            {
+                const auto& span_a = a.spans[sa];
+                const auto& span_b = b.spans[sb];
+                if (std::abs(span_a.floor - span_b.floor) > walkable_climb_ ||
+                    std::min(span_a.ceiling, span_b.ceiling) - std::max(span_a.floor, span_b.floor) < walkable_height_)
+                {
+                    continue;
+                }
+                const auto floor = std::max(span_a.floor, span_b.floor);
+                const auto cell = first_cell_b + (along_x ? glm::ivec2(0, i) : glm::ivec2(i, 0));
+                portal_t portal{};
+                portal.node_a = static_cast<NavMeshNodeIdx>(node_offset_a + span_a.region);
+                portal.node_b = static_cast<NavMeshNodeIdx>(node_offset_b + span_b.region);
+                portal.start = get_cell_position(cell, floor);
+                portal.end = get_cell_position(cell + (along_x ? glm::ivec2(0, 1) : glm::ivec2(1, 0)), floor);
+                portals_.push_back(portal);
+            }
+        }
+    }
+}
+
+engine::NavMesh engine::NavMeshBuilder::create_nav_mesh()
+{
+    ENGINE_PROFILE_SECTION_N("nav_mesh_create");
+    const auto linking_start = std::chrono::steady_clock::now();
+    NavMesh ret;
+    portals_.clear();
+    std::vector<std::uint32_t> nodes_offsets(tiles_.size() + 1, 0);
+    for (std::size_t t = 0; t < tiles_.size(); t++)
+    {
+        for (const auto& region : tiles_[t].regions)
+        {
+            const auto min = get_cell_position(region.min, region.min_floor);
+            const auto max = get_cell_position(region.max + 1, region.max_floor);
+            ret.add_node((min + max) * 0.5f, glm::max((max - min) * 0.5f, glm::vec3(0.0f, config_.cell_height * 0.5f, 0.0f)));
+        }
+        for (const auto& portal : tiles_[t].portals)
+        {
+            portals_.push_back(portal_t{ static_cast<NavMeshNodeIdx>(nodes_offsets[t] + portal.node_a), static_cast<NavMeshNodeIdx>(nodes_offsets[t] + portal.node_b), portal.start, portal.end });
+        }
+        nodes_offsets[t + 1] = nodes_offsets[t] + static_cast<std::uint32_t>(tiles_[t].regions.size());
+    }
+    for (std::int32_t z = 0; z < tiles_count_.y; z++)
+    {
+        for (std::int32_t x = 0; x < tiles_count_.x; x++)
+        {
+            const auto t = static_cast<std::uint32_t>(z * tiles_count_.x + x);
+            if (x + 1 < tiles_count_.x)
+            {
+                link_tiles(t, t + 1, nodes_offsets[t], nodes_offsets[t + 1], true);
+            }
+            if (z + 1 < tiles_count_.y)
+            {
+                link_tiles(t, t + tiles_count_.x, nodes_offsets[t], nodes_offsets[t + tiles_count_.x], false);
+            }
+        }
+    }
+    merge_portals(portals_);
+
+    for (const auto& portal : portals_)
+    {
+        const auto distance = glm::distance(ret.get_node(portal.node_a).get_center(), ret.get_node(portal.node_b).get_center());
+        const auto cost = std::max(static_cast<NavMeshEdgeCost>(std::lround(distance * K_COST_PER_UNIT)), NavMeshEdgeCost(1));
+        ret.add_edge(portal.node_a, portal.node_b, cost);
+        ret.add_edge(portal.node_b, portal.node_a, cost);
+    }
+    ret.build();
+
+    stats_.linking_ms = elapsed_ms(linking_start);
+    stats_.total_ms = stats_.voxelization_ms + stats_.regions_ms + stats_.linking_ms;
+    stats_.nodes_count = static_cast<std::uint32_t>(ret.get_nodes_count());
+    stats_.edges_count = static_cast<std::uint32_t>(portals_.size() * 2);
+    return ret;
+}
+
+glm::vec3 engine::NavMeshBuilder::get_cell_position(const glm::ivec2& cell, std::int32_t floor) const
+{
+    return origin_ + glm::vec3(cell.x * config_.cell_size, floor * config_.cell_height, cell.y * config_.cell_size);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "components/nav_component.h"
+#include "nav_mesh.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace engine
+{
+// Builds NavMesh from triangles of the level:
+// 1. triangles are voxelized into heightfield of solid spans, per tile with border of agent radius around it
+// 2. walkable spans: top surface within max slope and with agent height of free space above, eroded by agent radius
+// 3. walkable spans are greedily merged into axis aligned rectangles (convex regions), which become nav mesh nodes
+// 4. regions sharing border (inside of tile and between neighbouring tiles) are connected with portals (nav mesh edges)
+// Tiles are cached, so rebuild_area() voxelizes only tiles overlapping changed area and nav mesh is assembled from the cache.
+// Build is single threaded and doesn't depend on order of tiles, so the same geometry always gives the same nav mesh.
+class NavMeshBuilder
+{
+public:
+    // segment shared by two nodes
+    struct portal_t
+    {
+        NavMeshNodeIdx node_a = invalid_node_idx;
+        NavMeshNodeIdx node_b = invalid_node_idx;
+        glm::vec3 start = glm::vec3(0.0f);
+        glm::vec3 end = glm::vec3(0.0f);
+    };
+
+public:
+    NavMeshBuilder() = default;
+    NavMeshBuilder(const NavMeshBuilder& rhs) = delete;
+    NavMeshBuilder(NavMeshBuilder&& rhs) noexcept = default;
+    NavMeshBuilder& operator=(const NavMeshBuilder& rhs) = delete;
+    NavMeshBuilder& operator=(NavMeshBuilder&& rhs) noexcept = default;
+    ~NavMeshBuilder() = default;
+
+    // triangles: 3 vertices per triangle, counter clockwise when looking from the outside, in world space
+    // bounds of the tiles grid are bounds of the geometry
+    void build(const engine_nav_mesh_build_config_t& config, std::span<const glm::vec3> triangles);
+    // triangles of the whole (changed) level, only tiles which may be affected by changes in bounds are built again
+    // geometry outside of bounds of the last build() is ignored
+    void rebuild_area(std::span<const glm::vec3> triangles, const glm::vec3& bounds_min, const glm::vec3& bounds_max);
+    bool is_built() const { return !tiles_.empty(); }
+
+    // graph of regions and portals of all tiles, nodes are ordered by tiles and by position inside of tile
+    NavMesh create_nav_mesh();
+    // portals of the last created nav mesh
+    std::span<const portal_t> get_portals() const { return portals_; }
+    const engine_nav_mesh_build_stats_t& get_stats() const { return stats_; }
+
+private:
+    // rectangle of cells (inclusive, global cell coordinates)
+    struct region_t
+    {
+        glm::ivec2 min = glm::ivec2(0);
+        glm::ivec2 max = glm::ivec2(0);
+        std::int32_t min_floor = 0;
+        std::int32_t max_floor = 0;
+    };
+
+    struct tile_span_t
+    {
+        std::int32_t floor = 0;
+        std::int32_t ceiling = 0;
+        std::int32_t region = -1;
+    };
+
+    struct tile_t
+    {
+        std::vector<region_t> regions;
+        std::vector<portal_t> portals; // between regions of the tile (region indices instead of nodes)
+        // walkable spans of the tile cells (without border), spans of cell (x, z) are spans[columns[i], columns[i + 1]), where i = z * tile_size + x
+        // used to connect regions of neighbouring tiles
+        std::vector<std::uint32_t> columns;
+        std::vector<tile_span_t> spans;
+    };
+
+    void build_tiles(std::span<const glm::vec3> triangles, const std::vector<std::uint32_t>& tiles);
+    void build_tile(std::uint32_t tile_idx, std::span<const glm::vec3> triangles, std::span<const std::uint32_t> tile_triangles, const std::vector<std::uint8_t>& walkable_triangles);
+    void link_tiles(std::uint32_t tile_a, std::uint32_t tile_b, std::uint32_t node_offset_a, std::uint32_t node_offset_b, bool along_x);
+    glm::vec3 get_cell_position(const glm::ivec2& cell, std::int32_t floor) const;
+
+    engine_nav_mesh_build_config_t config_{};
+    std::int32_t walkable_height_ = 0; // in cells
+    std::int32_t walkable_climb_ = 0;
+    std::int32_t walkable_radius_ = 0;
+    std::int32_t border_ = 0;
+    float min_walkable_normal_y_ = 0.0f;
+
+    glm::vec3 origin_ = glm::vec3(0.0f);
+    glm::ivec2 cells_count_ = glm::ivec2(0);
+    glm::ivec2 tiles_count_ = glm::ivec2(0);
+    std::vector<tile_t> tiles_;
+    std::vector<portal_t> portals_;
+    engine_nav_mesh_build_stats_t stats_{};
+};
+}  // namespace engine
@@ -0,0 +1,265 @@
+#include "path_query_service.h"
+#include "logger.h"
+#include "profiler.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+constexpr std::uint32_t K_MAX_WORKERS_COUNT = 3;
+}  // namespace anonymous
+
+engine::PathQueryService::~PathQueryService()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+engine_path_query_ticket_t engine::PathQueryService::submit(engine_nav_mesh_t mesh, NavMeshNodeIdx start, NavMeshNodeIdx end)
+{
+    const query_key_t key{ mesh, start, end };
+    std::uint32_t query_idx = 0;
+    if (const auto it = pending_lookup_.find(key); it != pending_lookup_.end())
+    {
+        query_idx = it->second;
+    }
+    else
+    {
+        if (free_queries_.empty())
+        {
+            query_idx = static_cast<std::uint32_t>(queries_.size());
+            queries_.emplace_back();
+        }
+        else
+        {
+            query_idx = free_queries_.back();
+            free_queries_.pop_back();
+        }
+        auto& query = queries_[query_idx];
+        query.key = key;
+        query.status = ENGINE_PATH_QUERY_STATUS_PENDING;
+        query.nodes.clear();
+        query.cost = 0;
+        query.tickets_count = 0;
+        pending_.push_back(query_idx);
+        pending_lookup_[key] = query_idx;
+    }
+    queries_[query_idx].tickets_count++;
+
+    if (++next_ticket_ == ENGINE_INVALID_OBJECT_HANDLE)
+    {
+        next_ticket_ = 0;
+    }
+    tickets_[next_ticket_] = query_idx;
+    return next_ticket_;
+}
+
+engine::PathQueryService::result_t engine::PathQueryService::get_result(engine_path_query_ticket_t ticket) const
+{
+    const auto it = tickets_.find(ticket);
+    if (it == tickets_.end())
+    {
+        return {};
+    }
+    const auto& query = queries_[it->second];
+    if (query.status != ENGINE_PATH_QUERY_STATUS_COMPLETED)
+    {
+        // nodes of the pending query can be written by worker
+        return result_t{ query.status, {}, 0 };
+    }
+    return result_t{ query.status, query.nodes, query.cost };
+}
+
+void engine::PathQueryService::release(engine_path_query_ticket_t ticket)
+{
+    const auto it = tickets_.find(ticket);
+    if (it == tickets_.end())
+    {
+        return;
+    }
+    const auto query_idx = it->second;
+    tickets_.erase(it);
+
+    auto& query = queries_[query_idx];
+    assert(query.tickets_count > 0);
+    if (--query.tickets_count > 0 || query.in_batch)
+    {
+        // query in batch is freed when the batch finishes, worker may still write its result
+        return;
+    }
+    // nobody waits for the result anymore
+    if (query.status == ENGINE_PATH_QUERY_STATUS_PENDING)
+    {
+        pending_.erase(std::find(pending_.begin(), pending_.end(), query_idx));
+    }
+    free_query(query_idx);
+}
+
+void engine::PathQueryService::update(const Atlas<NavMesh>& meshes)
+{
+    if (batch_in_flight_)
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            if (busy_workers_ > 0)
+            {
+                // searches continue in background, new batch starts when they finish
+                return;
+            }
+        }
+        finish_batch();
+    }
+    if (pending_.empty())
+    {
+        return;
+    }
+    ENGINE_PROFILE_SECTION_N("path_queries_update");
+
+    batch_.clear();
+    for (const auto query_idx : pending_)
+    {
+        auto& query = queries_[query_idx];
+        query.mesh = meshes.get_object(query.key.mesh);
+        const auto nodes_count = query.mesh ? static_cast<NavMeshNodeIdx>(query.mesh->get_nodes_count()) : 0;
+        if (!query.mesh || !query.mesh->is_built() || query.key.start < 0 || query.key.start >= nodes_count || query.key.end < 0 || query.key.end >= nodes_count)
+        {
+            log::log(log::LogLevel::eError, fmt::format("Path query with invalid nav mesh: {} or nodes: {} -> {}. Nav mesh has to be built before path queries.\n", query.key.mesh, query.key.start, query.key.end));
+            query.status = ENGINE_PATH_QUERY_STATUS_NOT_FOUND;
+            pending_lookup_.erase(query.key);
+            continue;
+        }
+        query.in_batch = true;
+        batch_.push_back({ query_idx, &query });
+    }
+    pending_.clear();
+    if (batch_.empty())
+    {
+        return;
+    }
+
+    if (workers_.empty())
+    {
+        // at least one worker, also on single core: main thread never runs searches, so it can't be blocked by a long one
+        const auto workers_count = std::clamp(std::thread::hardware_concurrency(), 2u, K_MAX_WORKERS_COUNT + 1) - 1;
+        for (std::uint32_t i = 0; i < workers_count; i++)
+        {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    {
+        std::scoped_lock lock(mutex_);
+        batch_next_ = 0;
+        batch_deadline_ = std::chrono::steady_clock::now() + time_budget_;
+        batch_generation_++;
+        busy_workers_ = workers_.size();
+    }
+    batch_in_flight_ = true;
+    work_cv_.notify_all();
+}
+
+void engine::PathQueryService::wait_for_searches()
+{
+    if (!batch_in_flight_)
+    {
+        return;
+    }
+    {
+        std::unique_lock lock(mutex_);
+        done_cv_.wait(lock, [this]() { return busy_workers_ == 0; });
+    }
+    finish_batch();
+}
+
+void engine::PathQueryService::finish_batch()
+{
+    batch_in_flight_ = false;
+    // searches not started before deadline go to the front of the queue, before queries submitted during the batch
+    const auto started_count = std::min(batch_next_.load(), batch_.size());
+    std::vector<std::uint32_t> requeued;
+    for (std::size_t i = 0; i < batch_.size(); i++)
+    {
+        const auto query_idx = batch_[i].query_idx;
+        auto& query = *batch_[i].query;
+        query.in_batch = false;
+        if (query.tickets_count == 0)
+        {
+            // all tickets released during the batch
+            free_query(query_idx);
+        }
+        else if (i < started_count)
+        {
+            query.status = query.search_status;
+            pending_lookup_.erase(query.key);
+        }
+        else
+        {
+            requeued.push_back(query_idx);
+        }
+    }
+    pending_.insert(pending_.begin(), requeued.begin(), requeued.end());
+    batch_.clear();
+}
+
+void engine::PathQueryService::free_query(std::uint32_t query_idx)
+{
+    auto& query = queries_[query_idx];
+    if (query.status == ENGINE_PATH_QUERY_STATUS_PENDING)
+    {
+        pending_lookup_.erase(query.key);
+    }
+    query.status = ENGINE_PATH_QUERY_STATUS_INVALID;
+    free_queries_.push_back(query_idx);
+}
+
+void engine::PathQueryService::run_batch(NavMeshPathFinder& finder)
+{
+    while (std::chrono::steady_clock::now() < batch_deadline_)
+    {
+        const auto i = batch_next_.fetch_add(1);
+        if (i >= batch_.size())
+        {
+            break;
+        }
+        auto& query = *batch_[i].query;
+        const auto path = finder.find_path(*query.mesh, query.key.start, query.key.end);
+        query.nodes.assign(path.nodes.begin(), path.nodes.end());
+        query.cost = path.cost;
+        query.search_status = path.nodes.empty() && query.key.start != query.key.end ? ENGINE_PATH_QUERY_STATUS_NOT_FOUND : ENGINE_PATH_QUERY_STATUS_COMPLETED;
+    }
+}
+
+void engine::PathQueryService::worker_loop()
+{
+    // scratch buffers of the path finder are reused by all searches of this worker
+    NavMeshPathFinder finder;
+    std::uint32_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex_);
+            work_cv_.wait(lock, [this, generation]() { return stop_ || batch_generation_ != generation; });
+            if (stop_)
+            {
+                return;
+            }
+            generation = batch_generation_;
+        }
+        run_batch(finder);
+        {
+            std::scoped_lock lock(mutex_);
+            busy_workers_--;
+        }
+        done_cv_.notify_one();
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "engine.h"
+#include "named_atlas.h"
+#include "nav_mesh.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace engine
+{
+// Batched path queries. submit() only queues request and returns ticket, result is polled with get_result() in later frames.
+// Requests with the same nav mesh, start and end node share one search while they wait in the queue.
+// update() is called once per frame on the main thread: it starts the queued searches on worker threads and returns,
+// workers start searches until the time budget is spent, rest of the queue waits for the next batch.
+// Main thread never waits for searches: results of the batch are published by the first update() after all workers finished.
+// Workers read nav meshes in background, so wait_for_searches() has to be called before nav mesh is modified or destroyed.
+class PathQueryService
+{
+public:
+    struct result_t
+    {
+        engine_path_query_status_t status = ENGINE_PATH_QUERY_STATUS_INVALID;
+        std::span<const std::uint32_t> nodes; // valid until ticket is released
+        std::uint32_t cost = 0;
+    };
+
+public:
+    PathQueryService() = default;
+    PathQueryService(const PathQueryService& rhs) = delete;
+    PathQueryService(PathQueryService&& rhs) = delete;
+    PathQueryService& operator=(const PathQueryService& rhs) = delete;
+    PathQueryService& operator=(PathQueryService&& rhs) = delete;
+    ~PathQueryService();
+
+    engine_path_query_ticket_t submit(engine_nav_mesh_t mesh, NavMeshNodeIdx start, NavMeshNodeIdx end);
+    result_t get_result(engine_path_query_ticket_t ticket) const;
+    void release(engine_path_query_ticket_t ticket);
+
+    void set_time_budget(std::chrono::microseconds budget) { time_budget_ = budget; }
+    void update(const Atlas<NavMesh>& meshes);
+    // blocks until searches of the current batch finish and publishes their results
+    void wait_for_searches();
+
+private:
+    struct query_key_t
+    {
+        engine_nav_mesh_t mesh = ENGINE_INVALID_OBJECT_HANDLE;
+        NavMeshNodeIdx start = invalid_node_idx;
+        NavMeshNodeIdx end = invalid_node_idx;
+
+        bool operator==(const query_key_t& rhs) const = default;
+    };
+
+    struct query_key_hash_t
+    {
+        std::size_t operator()(const query_key_t& key) const
+        {
+            const auto start_end = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.start)) << 32) | static_cast<std::uint32_t>(key.end);
+            return std::hash<std::uint64_t>()(start_end) ^ (std::hash<std::uint32_t>()(key.mesh) << 1);
+        }
+    };
+
+    struct query_t
+    {
+        query_key_t key;
+        engine_path_query_status_t status = ENGINE_PATH_QUERY_STATUS_INVALID;
+        std::vector<std::uint32_t> nodes;
+        std::uint32_t cost = 0;
+        std::uint32_t tickets_count = 0;
+        // batch state, search results are written by worker and published by the main thread when the batch finishes
+        bool in_batch = false;
+        const NavMesh* mesh = nullptr;
+        engine_path_query_status_t search_status = ENGINE_PATH_QUERY_STATUS_INVALID;
+    };
+
+    struct batch_entry_t
+    {
+        std::uint32_t query_idx = 0;
+        query_t* query = nullptr; // workers don't index queries_, it can grow during the batch
+    };
+
+    void run_batch(NavMeshPathFinder& finder);
+    void finish_batch();
+    void free_query(std::uint32_t query_idx);
+    void worker_loop();
+
+private:
+    // deque: address of the query doesn't change when new queries are submitted during the batch
+    std::deque<query_t> queries_;
+    std::vector<std::uint32_t> free_queries_;
+    // queries waiting for search in submission order, lookup is used to share search between the same requests
+    std::vector<std::uint32_t> pending_;
+    std::unordered_map<query_key_t, std::uint32_t, query_key_hash_t> pending_lookup_;
+    std::unordered_map<engine_path_query_ticket_t, std::uint32_t> tickets_;
+    engine_path_query_ticket_t next_ticket_ = 0;
+    std::chrono::microseconds time_budget_ = std::chrono::microseconds(1000);
+
+    // batch started by update(), shared with workers until all of them finish
+    std::vector<batch_entry_t> batch_;
+    bool batch_in_flight_ = false;
+    std::atomic<std::size_t> batch_next_ = 0;
+    std::chrono::steady_clock::time_point batch_deadline_;
+    std::uint32_t batch_generation_ = 0;
+    std::size_t busy_workers_ = 0;
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    // started with the first batch, so applications which don't use path queries don't pay for threads
+    std::vector<std::thread> workers_;
+};
+}  // namespace engine
@@ -18,8 +18,11 @@
 
 
 engine::PhysicsWorld::PhysicsWorld(RenderContext* renderer)
-    : debug_drawer_(std::make_unique<DebugDrawer>(renderer))
 {
+    if (renderer)
+    {
+        debug_drawer_ = std::make_unique<DebugDrawer>(renderer);
+    }
 
     collisions_info_buffer_.reserve(1024 * 2);
     collisions_contact_points_buffer_.reserve(1024 * 16);
@@ -45,6 +48,11 @@ void engine::PhysicsWorld::enable_debug_draw(bool enable)
     {
         return; // nothing to do
     }
+    if (enable && !debug_drawer_)
+    {
+        engine::log::log(engine::log::LogLevel::eError, fmt::format("Physics world has no renderer, debug draw can't be enabled!\n"));
+        return;
+    }
     if(enable)
     {
         dynamics_world_->setDebugDrawer(debug_drawer_.get());
@@ -317,12 +325,12 @@ void engine::PhysicsWorld::DebugDrawer::drawContactPoint(const btVector3& point_
 
 void engine::PhysicsWorld::DebugDrawer::reportErrorWarning(const char* warning_string)
 {
-    engine::log::log(engine::log::LogLevel::eTrace, fmt::format("[Bullet] physics warning: {}\n", warning_string));
+    ENGINE_LOG_TRACE(fmt::format("[Bullet] physics warning: {}\n", warning_string));
 }
 
 void engine::PhysicsWorld::DebugDrawer::draw3dText(const btVector3& /*location*/, const char* text_ttring)
 {
-    engine::log::log(engine::log::LogLevel::eTrace, fmt::format("[Bullet] draw 3d text {}\n", text_ttring));
+    ENGINE_LOG_TRACE(fmt::format("[Bullet] draw 3d text {}\n", text_ttring));
 }
 
 void engine::PhysicsWorld::DebugDrawer::begin_frame(const glm::mat4& view, const glm::mat4& projection)
@@ -19,6 +19,7 @@
 #include <glm/glm.hpp>
 
 #include "graphics.h"
+#include "entity_registry.h"
 
 namespace engine
 {
@@ -32,6 +33,7 @@ public:
 
     };
 public:
+    // renderer can be null (headless world, i.e. benchmarks), debug drawing is not available then
     PhysicsWorld(class RenderContext* renderer);
 
     /**
@@ -45,6 +47,7 @@ public:
      *
      * @note Debug drawing requires that you have a valid OpenGL context and that your
      *       OpenGL state is correctly set up for rendering lines and points.
+     *       Worlds created without a renderer ignore the request.
      */
     void enable_debug_draw(bool enable);
     bool is_debug_drawer_enabled() const;
@@ -67,7 +70,7 @@ public:
     physcic_internal_component_t create_rigid_body(const engine_collider_component_t& collider,
         const engine_rigid_body_component_t& rigid_body, const engine_tranform_component_t& transform, std::int32_t body_index);
 
-    void remove_rigid_body(entt::basic_registry<entt::entity>& reg, entt::entity entt)
+    void remove_rigid_body(registry_t& reg, entt::entity entt)
     {
         auto& comp = reg.get<physcic_internal_component_t>(entt);
         dynamics_world_->removeRigidBody(comp.rigid_body);
@@ -0,0 +1,253 @@
+#include "prefab_template.h"
+#include "logger.h"
+#include "profiler.h"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+// components are initialized with defaults on construction (see components_initializers),
+// so values are applied with patch - observers of updates (i.e. model matrix, parent-children) see them
+template<typename T, typename TGetValue>
+void insert_components(engine::registry_t& registry, std::span<const entt::entity> entities, std::uint32_t nodes_count, std::span<const std::uint32_t> nodes,
+    std::vector<entt::entity>& batch, TGetValue&& get_value)
+{
+    if (nodes.empty())
+    {
+        return;
+    }
+    const auto count = entities.size() / nodes_count;
+    batch.clear();
+    for (std::size_t instance = 0; instance < count; instance++)
+    {
+        for (const auto node : nodes)
+        {
+            batch.push_back(entities[instance * nodes_count + node]);
+        }
+    }
+    // storage is looked up once per component type, not per entity
+    auto& storage = registry.storage<T>();
+    storage.insert(batch.begin(), batch.end());
+    for (std::size_t i = 0; i < batch.size(); i++)
+    {
+        storage.patch(batch[i], [&](T& component) { component = get_value(i / nodes.size(), i % nodes.size()); });
+    }
+}
+}  // namespace anonymous
+
+engine::PrefabTemplate::PrefabTemplate(const engine_model_desc_t& model_desc, std::span<const engine_geometry_t> geometries, std::span<const engine_material_component_t> materials, bool add_animation_component)
+    : add_animation_component_(add_animation_component)
+{
+    const auto nodes_count = model_desc.nodes_count;
+    if (nodes_count == 0 || !model_desc.nodes_array)
+    {
+        log::log(log::LogLevel::eError, fmt::format("Prefab: model desc has no nodes.\n"));
+        return;
+    }
+
+    bool root_found = false;
+    transforms_.resize(nodes_count);
+    for (std::uint32_t i = 0; i < nodes_count; i++)
+    {
+        const auto& node = model_desc.nodes_array[i];
+
+        auto& tc = transforms_[i];
+        std::memset(&tc, 0, sizeof(tc));
+        std::memcpy(tc.position, node.translate, sizeof(tc.position));
+        std::memcpy(tc.rotation, node.rotation_quaternion, sizeof(tc.rotation));
+        std::memcpy(tc.scale, node.scale, sizeof(tc.scale));
+
+        if (node.name)
+        {
+            engine_name_component_t nc{};
+            std::strncpy(nc.name, node.name, std::size(nc.name) - 1);
+            names_.add(i, nc);
+        }
+
+        if (node.geometry_index != -1)
+        {
+            if (node.geometry_index < geometries.size())
+            {
+                engine_mesh_component_t mc{};
+                mc.geometry = geometries[node.geometry_index];
+                meshes_.add(i, mc);
+            }
+            else
+            {
+                log::log(log::LogLevel::eError, fmt::format("Prefab: node: {} has geometry index: {} out of range. Mesh is skipped.\n", i, node.geometry_index));
+            }
+        }
+
+        if (node.material_index != -1)
+        {
+            if (node.material_index < materials.size())
+            {
+                materials_.add(i, materials[node.material_index]);
+            }
+            else
+            {
+                log::log(log::LogLevel::eError, fmt::format("Prefab: node: {} has material index: {} out of range. Material is skipped.\n", i, node.material_index));
+            }
+        }
+
+        if (node.parent)
+        {
+            // parent is a pointer into the nodes array
+            const auto parent_idx = static_cast<std::size_t>(node.parent - model_desc.nodes_array);
+            assert(parent_idx < nodes_count);
+            parents_.add(i, static_cast<std::uint32_t>(parent_idx));
+        }
+        else if (!root_found)
+        {
+            root_ = i;
+            root_found = true;
+        }
+        else
+        {
+            log::log(log::LogLevel::eTrace, fmt::format("Prefab: model has more than one root node, node: {} is not attached to the root: {}.\n", i, root_));
+        }
+    }
+    assert(root_found && "Model has cycle in hierarchy");
+
+    // bones of all skins, node shared by skins gets single bone component (from the first skin)
+    std::vector<const engine_bone_create_desc_t*> node_bones(nodes_count, nullptr);
+    for (std::uint32_t skin_idx = 0; skin_idx < model_desc.skins_counts; skin_idx++)
+    {
+        const auto& skin = model_desc.skins_array[skin_idx];
+        for (std::uint32_t bone_idx = 0; bone_idx < skin.bones_count; bone_idx++)
+        {
+            const auto& bone = skin.bones_array[bone_idx];
+            if (bone.model_node_index < nodes_count && !node_bones[bone.model_node_index])
+            {
+                node_bones[bone.model_node_index] = &bone;
+            }
+        }
+    }
+    for (std::uint32_t i = 0; i < nodes_count; i++)
+    {
+        if (node_bones[i])
+        {
+            engine_bone_component_t bc{};
+            std::memcpy(bc.inverse_bind_matrix, node_bones[i]->inverse_bind_mat, sizeof(bc.inverse_bind_matrix));
+            bones_.add(i, bc);
+        }
+    }
+
+    for (std::uint32_t i = 0; i < nodes_count; i++)
+    {
+        const auto& node = model_desc.nodes_array[i];
+        if (node.skin_index == -1)
+        {
+            continue;
+        }
+        if (node.skin_index >= model_desc.skins_counts)
+        {
+            log::log(log::LogLevel::eError, fmt::format("Prefab: node: {} has skin index: {} out of range. Skin is skipped.\n", i, node.skin_index));
+            continue;
+        }
+        const auto& skin = model_desc.skins_array[node.skin_index];
+        skin_t sc{};
+        if (skin.bones_count > sc.bone_nodes.size())
+        {
+            log::log(log::LogLevel::eError, fmt::format("Prefab: skin: {} has {} bones, only first {} are used.\n", skin.name ? skin.name : "", skin.bones_count, sc.bone_nodes.size()));
+        }
+        for (std::uint32_t bone_idx = 0; bone_idx < skin.bones_count && sc.bones_count < sc.bone_nodes.size(); bone_idx++)
+        {
+            const auto bone_node = skin.bones_array[bone_idx].model_node_index;
+            if (bone_node < nodes_count)
+            {
+                sc.bone_nodes[sc.bones_count++] = bone_node;
+            }
+        }
+        skins_.add(i, sc);
+    }
+}
+
+void engine::PrefabTemplate::instantiate(registry_t& registry, std::uint32_t count, const engine_tranform_component_t* root_transforms, engine_game_object_t* out_roots) const
+{
+    ENGINE_PROFILE_SECTION_N("prefab_instantiate");
+    if (!is_valid() || count == 0)
+    {
+        return;
+    }
+    const auto nodes_count = get_nodes_count();
+    std::vector<entt::entity> entities(static_cast<std::size_t>(count) * nodes_count);
+    registry.create(entities.begin(), entities.end());
+    const auto entity_of = [&entities, nodes_count](std::size_t instance, std::uint32_t node)
+    {
+        return entities[instance * nodes_count + node];
+    };
+
+    std::vector<entt::entity> batch;
+    batch.reserve(entities.size());
+
+    // transforms of all nodes, in order of entities
+    {
+        auto& storage = registry.storage<engine_tranform_component_t>();
+        storage.insert(entities.begin(), entities.end());
+        for (std::size_t instance = 0; instance < count; instance++)
+        {
+            for (std::uint32_t node = 0; node < nodes_count; node++)
+            {
+                storage.patch(entity_of(instance, node), [&](engine_tranform_component_t& tc)
+                    {
+                        tc = transforms_[node];
+                        if (root_transforms && node == root_)
+                        {
+                            const auto& root_tc = root_transforms[instance];
+                            std::memcpy(tc.position, root_tc.position, sizeof(tc.position));
+                            std::memcpy(tc.rotation, root_tc.rotation, sizeof(tc.rotation));
+                            std::memcpy(tc.scale, root_tc.scale, sizeof(tc.scale));
+                        }
+                    }
+                );
+            }
+        }
+    }
+
+    insert_components<engine_name_component_t>(registry, entities, nodes_count, names_.nodes, batch,
+        [this](std::size_t, std::size_t i) -> const auto& { return names_.values[i]; });
+    insert_components<engine_mesh_component_t>(registry, entities, nodes_count, meshes_.nodes, batch,
+        [this](std::size_t, std::size_t i) -> const auto& { return meshes_.values[i]; });
+    insert_components<engine_material_component_t>(registry, entities, nodes_count, materials_.nodes, batch,
+        [this](std::size_t, std::size_t i) -> const auto& { return materials_.values[i]; });
+    insert_components<engine_bone_component_t>(registry, entities, nodes_count, bones_.nodes, batch,
+        [this](std::size_t, std::size_t i) -> const auto& { return bones_.values[i]; });
+    insert_components<engine_parent_component_t>(registry, entities, nodes_count, parents_.nodes, batch,
+        [this, &entity_of](std::size_t instance, std::size_t i)
+        {
+            engine_parent_component_t pc{};
+            pc.parent = static_cast<engine_game_object_t>(entity_of(instance, parents_.values[i]));
+            return pc;
+        }
+    );
+    insert_components<engine_skin_component_t>(registry, entities, nodes_count, skins_.nodes, batch,
+        [this, &entity_of](std::size_t instance, std::size_t i)
+        {
+            const auto& skin = skins_.values[i];
+            engine_skin_component_t sc{};
+            for (std::uint32_t bone_idx = 0; bone_idx < skin.bones_count; bone_idx++)
+            {
+                sc.bones[bone_idx] = static_cast<engine_game_object_t>(entity_of(instance, skin.bone_nodes[bone_idx]));
+            }
+            return sc;
+        }
+    );
+
+    batch.clear();
+    for (std::size_t instance = 0; instance < count; instance++)
+    {
+        batch.push_back(entity_of(instance, root_));
+        if (out_roots)
+        {
+            out_roots[instance] = static_cast<engine_game_object_t>(entity_of(instance, root_));
+        }
+    }
+    if (add_animation_component_)
+    {
+        registry.storage<engine_animation_component_t>().insert(batch.begin(), batch.end());
+    }
+}
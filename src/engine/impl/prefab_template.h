@@ -0,0 +1,68 @@
+#pragma once
+#include "engine.h"
+#include "memory_tracker.h"
+#include "entity_registry.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace engine
+{
+// Model desc compiled once into flat array of nodes: parents and bones are resolved to node indices
+// and components values are ready to copy, so instantiation doesn't touch the model desc.
+// All entities of all instances are created in one batch and components are added type by type,
+// entity of the node of the instance is: entities[instance * nodes_count + node].
+class PrefabTemplate
+{
+public:
+    PrefabTemplate() = default;
+    PrefabTemplate(const engine_model_desc_t& model_desc, std::span<const engine_geometry_t> geometries, std::span<const engine_material_component_t> materials, bool add_animation_component);
+    PrefabTemplate(const PrefabTemplate& rhs) = delete;
+    PrefabTemplate(PrefabTemplate&& rhs) noexcept = default;
+    PrefabTemplate& operator=(const PrefabTemplate& rhs) = delete;
+    PrefabTemplate& operator=(PrefabTemplate&& rhs) noexcept = default;
+    ~PrefabTemplate() = default;
+
+    // root_transforms and out_roots: nullptr or count elements
+    void instantiate(registry_t& registry, std::uint32_t count, const engine_tranform_component_t* root_transforms, engine_game_object_t* out_roots) const;
+
+    bool is_valid() const { return !transforms_.empty(); }
+    std::uint32_t get_nodes_count() const { return static_cast<std::uint32_t>(transforms_.size()); }
+
+private:
+    // nodes with the component and its values, in order of nodes
+    template<typename T>
+    struct component_table_t
+    {
+        memory::tracked_vector<std::uint32_t, ENGINE_MEMORY_TAG_ASSETS> nodes;
+        memory::tracked_vector<T, ENGINE_MEMORY_TAG_ASSETS> values;
+
+        void add(std::uint32_t node, const T& value)
+        {
+            nodes.push_back(node);
+            values.push_back(value);
+        }
+    };
+
+    struct skin_t
+    {
+        std::array<std::uint32_t, ENGINE_SKINNED_MESH_COMPONENT_MAX_SKELETON_BONES> bone_nodes{};
+        std::uint32_t bones_count = 0;
+    };
+
+private:
+    std::uint32_t root_ = 0;
+    bool add_animation_component_ = false;
+    memory::tracked_vector<engine_tranform_component_t, ENGINE_MEMORY_TAG_ASSETS> transforms_;  // every node has transform
+    component_table_t<engine_name_component_t> names_;
+    component_table_t<engine_mesh_component_t> meshes_;
+    component_table_t<engine_material_component_t> materials_;
+    component_table_t<std::uint32_t> parents_;  // parent node index
+    component_table_t<engine_bone_component_t> bones_;
+    component_table_t<skin_t> skins_;
+};
+}  // namespace engine
@@ -5,17 +5,86 @@
 #include "math_helpers.h"
 #include "components_utils/components_initializers.h"
 #include "profiler.h"
+#include "frame_stats.h"
 
 
 #include <fmt/format.h>
 
+#include <glm/gtc/constants.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <SDL3/SDL.h>
 
 #include <RmlUi/Core.h>
 
+namespace
+{
+// default 1x1 texture is the first texture created by application
+constexpr const engine_texture2d_t K_DEFAULT_TEXTURE = 0;
+constexpr const std::size_t K_DEFAULT_FRAME_ARENA_SIZE = 1024 * 1024;
+
+inline const engine::Texture2D& get_texture_or_default(const engine::Atlas<engine::Texture2D>& textures, engine_texture2d_t handle, std::string_view usage)
+{
+    const auto* texture = textures.get_object(handle == ENGINE_INVALID_OBJECT_HANDLE ? K_DEFAULT_TEXTURE : handle);
+    if (!texture)
+    {
+        engine::log::log(engine::log::LogLevel::eError, fmt::format("{} texture handle is not valid: {}. Are you sure you are doing valid thing?\n", usage, handle));
+        texture = textures.get_object(K_DEFAULT_TEXTURE);
+    }
+    assert(texture);
+    return *texture;
+}
 
-void update_parent_component(entt::registry& registry, entt::entity entity)
+// triangles of the collider shape in local space of the shape, winding is fixed later
+inline void append_box_triangles(const float half_size[3], const glm::mat4& transform, std::vector<glm::vec3>& out)
+{
+    constexpr std::uint32_t faces[6][4] = { { 2, 6, 7, 3 }, { 0, 1, 5, 4 }, { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+    glm::vec3 corners[8];
+    for (std::uint32_t i = 0; i < 8; i++)
+    {
+        const auto corner = glm::vec3(i & 1 ? half_size[0] : -half_size[0], i & 2 ? half_size[1] : -half_size[1], i & 4 ? half_size[2] : -half_size[2]);
+        corners[i] = glm::vec3(transform * glm::vec4(corner, 1.0f));
+    }
+    for (const auto& face : faces)
+    {
+        out.insert(out.end(), { corners[face[0]], corners[face[1]], corners[face[2]], corners[face[0]], corners[face[2]], corners[face[3]] });
+    }
+}
+
+inline void append_sphere_triangles(float radius, const glm::mat4& transform, std::vector<glm::vec3>& out)
+{
+    constexpr std::uint32_t rings = 6;
+    constexpr std::uint32_t segments = 8;
+    const auto point = [&](std::uint32_t ring, std::uint32_t segment)
+    {
+        const auto theta = glm::pi<float>() * ring / rings;
+        const auto phi = glm::two_pi<float>() * segment / segments;
+        const auto p = radius * glm::vec3(std::sin(theta) * std::cos(phi), -std::cos(theta), std::sin(theta) * std::sin(phi));
+        return glm::vec3(transform * glm::vec4(p, 1.0f));
+    };
+    for (std::uint32_t ring = 0; ring < rings; ring++)
+    {
+        for (std::uint32_t segment = 0; segment < segments; segment++)
+        {
+            out.insert(out.end(), { point(ring, segment), point(ring + 1, segment), point(ring + 1, segment + 1), point(ring, segment), point(ring + 1, segment + 1), point(ring, segment + 1) });
+        }
+    }
+}
+
+// nav mesh builder needs counter clockwise triangles (seen from the outside), shapes are convex so center of the shape is inside
+inline void fix_triangles_winding(std::span<glm::vec3> triangles, const glm::vec3& center)
+{
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3)
+    {
+        const auto normal = glm::cross(triangles[i + 1] - triangles[i], triangles[i + 2] - triangles[i]);
+        if (glm::dot(normal, triangles[i] - center) < 0.0f)
+        {
+            std::swap(triangles[i + 1], triangles[i + 2]);
+        }
+    }
+}
+}  // namespace anonymous
+
+void update_parent_component(engine::registry_t& registry, entt::entity entity)
 {
     auto& parent = registry.get<engine_parent_component_t>(entity);
     if (parent.parent == ENGINE_INVALID_GAME_OBJECT_ID)
@@ -41,7 +110,7 @@ void update_parent_component(entt::registry& registry, entt::entity entity)
     engine::log::log(engine::log::LogLevel::eCritical, fmt::format("Parent component has no more space for children. Are you sure you are doing valid thing?\n"));
 }
 
-void destroy_parent_component(entt::registry& registry, entt::entity entity)
+void destroy_parent_component(engine::registry_t& registry, entt::entity entity)
 {
     const auto parent_entt = static_cast<entt::entity>(registry.get<engine_parent_component_t>(entity).parent);
     auto& cc = registry.get<engine_children_component_t>(parent_entt);
@@ -99,6 +168,7 @@ struct engine_camera_internal_component_t
 engine::Scene::Scene(RenderContext& rdx, const engine_scene_create_desc_t& config, engine_result_code_t& out_code)
     : rdx_(rdx)
     , physics_world_(&rdx_)
+    , frame_arena_(config.frame_arena_size != 0 ? config.frame_arena_size : K_DEFAULT_FRAME_ARENA_SIZE)
     , fbo_(rdx.get_window_size_in_pixels().width, rdx.get_window_size_in_pixels().height, 1, true)
     , empty_vao_for_full_screen_quad_draw_(6)
     , collider_create_observer(entity_registry_, entt::collector.group<engine_tranform_component_t, engine_collider_component_t>(entt::exclude<engine_rigid_body_component_t>))
@@ -126,19 +196,23 @@ engine::Scene::Scene(RenderContext& rdx, const engine_scene_create_desc_t& confi
     entity_registry_.on_construct<engine_parent_component_t>().connect<&initialize_parent_component>();
     entity_registry_.on_construct<engine_name_component_t>().connect<&initialize_name_component>();
     entity_registry_.on_construct<engine_camera_component_t>().connect<&initialize_camera_component>();
-    entity_registry_.on_construct<engine_camera_component_t>().connect<&entt::registry::emplace<engine_camera_internal_component_t>>();
+    entity_registry_.on_construct<engine_camera_component_t>().connect<&registry_t::emplace<engine_camera_internal_component_t>>();
     entity_registry_.on_construct<engine_rigid_body_component_t>().connect<&initialize_rigidbody_component>();
     entity_registry_.on_construct<engine_collider_component_t>().connect<&initialize_collider_component>();
     entity_registry_.on_construct<engine_skin_component_t>().connect<&initialize_skin_component>();
     entity_registry_.on_construct<engine_light_component_t>().connect<&initialize_light_component>();
     entity_registry_.on_construct<engine_sprite_component_t>().connect<&initialize_sprite_component>();
+    entity_registry_.on_construct<engine_animation_component_t>().connect<&initialize_animation_component>();
+    entity_registry_.on_construct<engine_nav_agent_component_t>().connect<&initialize_nav_agent_component>();
     
     entity_registry_.on_update<engine_parent_component_t>().connect<&update_parent_component>();
     entity_registry_.on_destroy<engine_parent_component_t>().connect<&destroy_parent_component>();
 
-    entity_registry_.on_construct<engine_collider_component_t>().connect<&entt::registry::emplace<PhysicsWorld::physcic_internal_component_t>>();
-    entity_registry_.on_destroy<engine_collider_component_t>().connect<&entt::registry::remove<PhysicsWorld::physcic_internal_component_t>>();
+    entity_registry_.on_construct<engine_collider_component_t>().connect<&registry_t::emplace<PhysicsWorld::physcic_internal_component_t>>();
+    entity_registry_.on_destroy<engine_collider_component_t>().connect<&registry_t::remove<PhysicsWorld::physcic_internal_component_t>>();
     entity_registry_.on_destroy<PhysicsWorld::physcic_internal_component_t>().connect<&PhysicsWorld::remove_rigid_body>(&physics_world_);
+
+    entity_registry_.on_destroy<engine_animation_component_t>().connect<&registry_t::remove<AnimationSystem::animation_internal_component_t>>();
     out_code = ENGINE_RESULT_CODE_OK;
 
     
@@ -318,11 +392,28 @@ engine_result_code_t engine::Scene::physics_update(float dt)
     return ENGINE_RESULT_CODE_OK;
 }
 
-engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D> textures, 
-    std::span<const Geometry> geometries, std::span<class Shader> shaders)
+engine_result_code_t engine::Scene::update(float dt, const Atlas<Texture2D>& textures,
+    const Atlas<Geometry>& geometries, Atlas<Shader>& shaders, const Atlas<AnimationClip>& animation_clips)
 {
     ENGINE_PROFILE_SECTION_N("scene_update");
-    physics_update(dt);
+    {
+        // sync point: changes recorded by scripts and physics callbacks since the last update
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_COMMAND_BUFFER);
+        command_buffer_.apply(entity_registry_);
+    }
+    {
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_ANIMATION);
+        animation_system_.update(entity_registry_, dt, animation_clips);
+    }
+    {
+        // agents are separated before physics, so it doesn't have to resolve their contacts
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_CROWD);
+        crowd_system_.update(entity_registry_, dt);
+    }
+    {
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_PHYSICS);
+        physics_update(dt);
+    }
     class FBOFrameContext
     {
     public:
@@ -343,6 +434,7 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
 
         ~FBOFrameContext()
         {
+            frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_POST_PROCESS);
             fbo_.unbind();
             full_screen_quad_shader_.bind();
             full_screen_quad_shader_.set_texture("screen_texture", fbo_.get_color_attachment(0));
@@ -358,6 +450,7 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
     FBOFrameContext fbo_frame(fbo_, rdx_, shaders_[static_cast<std::uint32_t>(ShaderType::eFullScreenQuad)], empty_vao_for_full_screen_quad_draw_);
     {
         ENGINE_PROFILE_SECTION_N("transform_view");
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_TRANSFORMS);
 #if 1
         //auto transform_view = entity_registry_.view<engine_tranform_component_t>(entt::exclude<engine_rigid_body_component_t>);
         auto transform_view = entity_registry_.view<engine_tranform_component_t>();
@@ -390,10 +483,13 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
 
     {
         ENGINE_PROFILE_SECTION_N("parent_to_child_transform_view");
-        std::map<entt::entity, glm::mat4> ltw_map;
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_HIERARCHY);
         //ToDo: this coule be optimized if entityies are sorted, so parents are always computed first
         auto parent_to_child_transform_view = entity_registry_.view<engine_tranform_component_t, const engine_parent_component_t>();
-        parent_to_child_transform_view.each([this, &ltw_map](auto entity, engine_tranform_component_t& transform_comp, const engine_parent_component_t& parent_comp)
+        // every entity is visited once, so results don't need a map
+        std::pmr::vector<std::pair<entt::entity, glm::mat4>> ltws(frame_arena_.get_memory_resource());
+        ltws.reserve(parent_to_child_transform_view.size_hint());
+        parent_to_child_transform_view.each([this, &ltws](auto entity, engine_tranform_component_t& transform_comp, const engine_parent_component_t& parent_comp)
             {
                 //engine::log::log(engine::log::LogLevel::eTrace, fmt::format("updating ent: {}\n", static_cast<std::uint32_t>(entity)));
                 auto ltw_matrix = glm::make_mat4(transform_comp.local_to_world);
@@ -421,12 +517,15 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                         // break the recussion
                         parent = ENGINE_INVALID_GAME_OBJECT_ID;
                     }
-                    ltw_map[entity] = ltw_matrix;
+                }
+                if (parent_comp.parent != ENGINE_INVALID_GAME_OBJECT_ID)
+                {
+                    ltws.emplace_back(entity, ltw_matrix);
                 }
             });
         {
             ENGINE_PROFILE_SECTION_N("update_ltws_with_parents");
-            for (const auto& [entity, ltw_matrix] : ltw_map)
+            for (const auto& [entity, ltw_matrix] : ltws)
             {
                 auto transform_comp = *get_component<engine_tranform_component_t>(entity);
                 std::memcpy(transform_comp.local_to_world, &ltw_matrix, sizeof(ltw_matrix));
@@ -442,6 +541,7 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
     // copy lights data to the GPU
     {
         ENGINE_PROFILE_SECTION_N("lights update");
+        frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_LIGHTS);
         auto lights_view = entity_registry_.view<const engine_tranform_component_t, const engine_light_component_t>();
         {
             ENGINE_PROFILE_SECTION_N("lights counter");
@@ -582,6 +682,7 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
 
             {
                 ENGINE_PROFILE_SECTION_N("geometry_renderer");
+                frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_RENDER_GEOMETRY);
 
                 geometry_renderer.each([this, &camera_internal, &textures, &geometries](const engine_tranform_component_t& transform_component, const engine_mesh_component_t& mesh_component, const engine_material_component_t& material_component)
                     {
@@ -595,18 +696,11 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                             return;
                         }
 
-                        auto texture_diffuse_idx = material_component.data.pong.diffuse_texture == ENGINE_INVALID_OBJECT_HANDLE ? 0 : material_component.data.pong.diffuse_texture;
-                        if (texture_diffuse_idx > textures.size())
+                        const auto* geometry = geometries.get_object(mesh_component.geometry);
+                        if (!geometry)
                         {
-                            log::log(log::LogLevel::eError, fmt::format("Diffuse texture index out of bounds: {}. Are you sure you are doing valid thing?\n", texture_diffuse_idx));
-                            //assert(false);
-                        }
-
-                        auto texture_specular_idx = material_component.data.pong.specular_texture == ENGINE_INVALID_OBJECT_HANDLE ? 0 : material_component.data.pong.specular_texture;
-                        if (texture_specular_idx > textures.size())
-                        {
-                            log::log(log::LogLevel::eError, fmt::format("Specular exture index out of bounds: {}. Are you sure you are doing valid thing?\n", texture_specular_idx));
-                            //assert(false);
+                            log::log(log::LogLevel::eError, fmt::format("Mesh component has stale geometry handle: {}. Are you sure you are doing valid thing?\n", mesh_component.geometry));
+                            return;
                         }
 
                         const auto ctx = MaterialStaticGeometryLit::DrawContext{
@@ -615,17 +709,21 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                             .model_matrix = transform_component.local_to_world,
                             .color_diffuse = material_component.data.pong.diffuse_color,
                             .shininess = static_cast<float>(material_component.data.pong.shininess),     
-                            .texture_diffuse = textures[texture_diffuse_idx],
-                            .texture_specular = textures[texture_specular_idx]};
-                        material_static_geometry_lit_.draw(geometries[mesh_component.geometry], ctx);
+                            .texture_diffuse = get_texture_or_default(textures, material_component.data.pong.diffuse_texture, "Diffuse"),
+                            .texture_specular = get_texture_or_default(textures, material_component.data.pong.specular_texture, "Specular")};
+                        material_static_geometry_lit_.draw(*geometry, ctx);
                     }
                 );
             }
 
             {
                 ENGINE_PROFILE_SECTION_N("skinned_geometry_renderer");
+                frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_RENDER_SKINNED_GEOMETRY);
+                // reused by all skinned meshes of the camera
+                std::pmr::vector<glm::mat4> bone_transforms(frame_arena_.get_memory_resource());
+                bone_transforms.reserve(ENGINE_SKINNED_MESH_COMPONENT_MAX_SKELETON_BONES);
 
-                skinned_geometry_renderer.each([this, &camera_internal, &textures, &geometries](auto entity, const engine_tranform_component_t& transform_component, const engine_mesh_component_t& mesh_component,
+                skinned_geometry_renderer.each([this, &camera_internal, &textures, &geometries, &bone_transforms](auto entity, const engine_tranform_component_t& transform_component, const engine_mesh_component_t& mesh_component,
                     engine_skin_component_t& skin_component, const engine_material_component_t& material_component)
                     {
                         if (mesh_component.disable)
@@ -633,30 +731,14 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                             return;
                         }
 
-                        auto texture_diffuse_idx = material_component.data.pong.diffuse_texture == ENGINE_INVALID_OBJECT_HANDLE ? 0 : material_component.data.pong.diffuse_texture;
-                        if (texture_diffuse_idx > textures.size())
+                        const auto* geometry = geometries.get_object(mesh_component.geometry);
+                        if (!geometry)
                         {
-                            log::log(log::LogLevel::eError, fmt::format("Diffuse texture index out of bounds: {}. Are you sure you are doing valid thing?\n", texture_diffuse_idx));
-                            //assert(false);
-                        }
-
-                        auto texture_specular_idx = material_component.data.pong.specular_texture == ENGINE_INVALID_OBJECT_HANDLE ? 0 : material_component.data.pong.specular_texture;
-                        if (texture_specular_idx > textures.size())
-                        {
-                            log::log(log::LogLevel::eError, fmt::format("Specular exture index out of bounds: {}. Are you sure you are doing valid thing?\n", texture_specular_idx));
-                            //assert(false);
+                            log::log(log::LogLevel::eError, fmt::format("Mesh component has stale geometry handle: {}. Are you sure you are doing valid thing?\n", mesh_component.geometry));
+                            return;
                         }
 
-                        auto ctx = MaterialSkinnedGeometryLit::DrawContext{
-                            .camera = camera_internal.camera_ubo,
-                            .scene = scene_ubo_,
-                            .model_matrix = transform_component.local_to_world,
-                            .color_diffuse = material_component.data.pong.diffuse_color,
-                            .shininess = material_component.data.pong.shininess,
-                            .texture_diffuse = textures[texture_diffuse_idx],
-                            .texture_specular = textures[texture_specular_idx] };
-                        ctx.bone_transforms.reserve(ENGINE_SKINNED_MESH_COMPONENT_MAX_SKELETON_BONES); // reallocation this for each geometry each frame. ToDo: optimize it
-
+                        bone_transforms.clear();
                         const auto inverse_transform = glm::inverse(glm::make_mat4(transform_component.local_to_world));
                         for (std::size_t i = 0; i < ENGINE_SKINNED_MESH_COMPONENT_MAX_SKELETON_BONES; i++)
                         {
@@ -677,10 +759,19 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                             const auto inverse_bind_matrix = glm::make_mat4(bone_component->inverse_bind_matrix);
                             const auto bone_matrix = glm::make_mat4(bone_transform->local_to_world) * inverse_bind_matrix;
                             const auto per_bone_final_transform = inverse_transform * bone_matrix;
-                            ctx.bone_transforms.push_back(per_bone_final_transform);
+                            bone_transforms.push_back(per_bone_final_transform);
                         }
 
-                        material_skinned_geometry_lit_.draw(geometries[mesh_component.geometry], ctx);
+                        const auto ctx = MaterialSkinnedGeometryLit::DrawContext{
+                            .camera = camera_internal.camera_ubo,
+                            .scene = scene_ubo_,
+                            .model_matrix = transform_component.local_to_world,
+                            .bone_transforms = bone_transforms,
+                            .color_diffuse = material_component.data.pong.diffuse_color,
+                            .shininess = material_component.data.pong.shininess,
+                            .texture_diffuse = get_texture_or_default(textures, material_component.data.pong.diffuse_texture, "Diffuse"),
+                            .texture_specular = get_texture_or_default(textures, material_component.data.pong.specular_texture, "Specular") };
+                        material_skinned_geometry_lit_.draw(*geometry, ctx);
 
                     }
                 );
@@ -688,6 +779,7 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
 
             {
                 ENGINE_PROFILE_SECTION_N("sprite_renderer");
+                frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_RENDER_SPRITES);
 
                 sprite_renderer.each([this, &camera_internal, &shaders](const engine_tranform_component_t& transform_component, const engine_material_component_t& material_component, const engine_sprite_component_t& sprite_component)
                     {
@@ -712,10 +804,16 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
                         }
                         else if (material_component.type == ENGINE_MATERIAL_TYPE_USER)
                         {
+                            auto* shader = shaders.get_object(material_component.data.user.shader);
+                            if (!shader)
+                            {
+                                log::log(log::LogLevel::eError, fmt::format("User material has invalid shader handle: {}. Are you sure you are doing valid thing?\n", material_component.data.user.shader));
+                                return;
+                            }
                             auto ctx = MaterialSpriteUser::DrawContext{
                                 .camera = camera_internal.camera_ubo,
                                 .scene = scene_ubo_,
-                                .shader = shaders[material_component.data.user.shader],
+                                .shader = *shader,
                                 .world_position = translation,
                                 .scale = scale,
                                 .uniform_data = material_component.data.user.uniform_data_buffer
@@ -758,10 +856,15 @@ engine_result_code_t engine::Scene::update(float dt, std::span<const Texture2D>
 
             if (physics_world_.is_debug_drawer_enabled())
             {
+                frame_stats::ScopedStage frame_stage(ENGINE_FRAME_STAGE_RENDER_DEBUG);
                 physics_world_.debug_draw(view, projection);
             }
         }
         }
+
+    frame_stats::add_scene(get_entities_count());
+    frame_arena_.end_frame();
+    ENGINE_PROFILE_VALUE("frame_arena_used", static_cast<std::int64_t>(frame_arena_.get_stats().used));
     return ENGINE_RESULT_CODE_OK;
 }
 
@@ -775,14 +878,28 @@ void engine::Scene::destroy_entity(entt::entity entity)
     entity_registry_.destroy(entity);
 }
 
-entt::runtime_view engine::Scene::create_runtime_view()
+engine::runtime_view_t engine::Scene::create_runtime_view()
 {
-    return entt::runtime_view{};
+    return runtime_view_t{};
+}
+
+std::uint32_t engine::Scene::get_entities_count() const
+{
+    std::uint32_t count = 0;
+    for (const auto entity : entity_registry_.view<entt::entity>())
+    {
+        if (static_cast<std::uint32_t>(entity) != ENGINE_INVALID_GAME_OBJECT_ID)
+        {
+            count++;
+        }
+    }
+    return count;
 }
 
 std::vector<entt::entity> engine::Scene::get_all_entities() const
 {
     std::vector<entt::entity> entities;
+    entities.reserve(get_entities_count());
     for (const auto entity : entity_registry_.view<entt::entity>())
     {
         if (static_cast<std::uint32_t>(entity) != ENGINE_INVALID_GAME_OBJECT_ID)
@@ -811,3 +928,42 @@ engine_ray_hit_info_t engine::Scene::raycast_into_physics_world(const engine_ray
     return physics_world_.raycast(ray, ignore_list, max_distance);
 }
 
+void engine::Scene::get_static_collision_geometry(std::vector<glm::vec3>& out_triangles) const
+{
+    ENGINE_PROFILE_SECTION_N("get_static_collision_geometry");
+    const auto colliders_view = entity_registry_.view<const engine_collider_component_t, const engine_tranform_component_t>();
+    colliders_view.each([this, &out_triangles](auto entity, const engine_collider_component_t& collider, const engine_tranform_component_t& transform)
+        {
+            if (collider.is_trigger || (has_component<engine_rigid_body_component_t>(entity) && get_component<engine_rigid_body_component_t>(entity)->mass != 0.0f))
+            {
+                return;
+            }
+            const auto local_to_world = glm::make_mat4(transform.local_to_world);
+            const auto append_shape = [&out_triangles](engine_collider_type_t type, const auto& shape, const glm::mat4& shape_transform)
+            {
+                const auto first = out_triangles.size();
+                if (type == ENGINE_COLLIDER_TYPE_BOX)
+                {
+                    append_box_triangles(shape.box.size, shape_transform, out_triangles);
+                }
+                else if (type == ENGINE_COLLIDER_TYPE_SPHERE)
+                {
+                    append_sphere_triangles(shape.sphere.radius, shape_transform, out_triangles);
+                }
+                const auto center = glm::vec3(shape_transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+                fix_triangles_winding(std::span<glm::vec3>(out_triangles.data() + first, out_triangles.size() - first), center);
+            };
+
+            if (collider.type != ENGINE_COLLIDER_TYPE_COMPOUND)
+            {
+                append_shape(collider.type, collider.collider, local_to_world);
+                return;
+            }
+            for (const auto& child : collider.collider.compound.children)
+            {
+                const auto child_transform = glm::translate(glm::mat4(1.0f), glm::make_vec3(child.transform)) * glm::mat4_cast(glm::make_quat(child.rotation_quaternion));
+                append_shape(child.type, child.collider, local_to_world * child_transform);
+            }
+        });
+}
+
@@ -1,8 +1,15 @@
 #pragma once
 #include <engine.h>
 #include "graphics.h"
+#include "named_atlas.h"
 
 #include "physics_world.h"
+#include "animation.h"
+#include "crowd.h"
+#include "entity_command_buffer.h"
+#include "prefab_template.h"
+#include "frame_arena.h"
+#include "entity_registry.h"
 
 #include "material.h"
 
@@ -35,18 +42,28 @@ public:
     ~Scene();
 
     void enable_physics_debug_draw(bool enable);
-    engine_result_code_t update(float dt, std::span<const class Texture2D> textures, 
-        std::span<const Geometry> geometries, std::span<class Shader> shaders);
+    engine_result_code_t update(float dt, const Atlas<Texture2D>& textures,
+        const Atlas<Geometry>& geometries, Atlas<Shader>& shaders, const Atlas<AnimationClip>& animation_clips);
 
     entt::entity create_new_entity();
     void destroy_entity(entt::entity entity);
 
-    entt::runtime_view create_runtime_view();
+    // deferred changes, applied at the beginning of update()
+    entt::entity command_buffer_create_entity() { return command_buffer_.create(entity_registry_); }
+    EntityCommandBuffer& get_command_buffer() { return command_buffer_; }
+
+    void instantiate_prefab(const PrefabTemplate& prefab, std::uint32_t count, const engine_tranform_component_t* root_transforms, engine_game_object_t* out_roots)
+    {
+        prefab.instantiate(entity_registry_, count, root_transforms, out_roots);
+    }
+
+    runtime_view_t create_runtime_view();
 
     std::vector<entt::entity> get_all_entities() const;
+    std::uint32_t get_entities_count() const;
 
     template<typename T>
-    void attach_component_to_runtime_view(entt::runtime_view& rv)
+    void attach_component_to_runtime_view(runtime_view_t& rv)
     {
         rv.iterate(entity_registry_.storage<T>());
     }
@@ -98,22 +115,43 @@ public:
     void set_physcis_gravity(std::array<float, 3> g);
     void get_physcis_collisions_list(const engine_collision_info_t*& ptr_first, size_t* count);
     engine_ray_hit_info_t raycast_into_physics_world(const engine_ray_t& ray, std::span<const engine_game_object_t> ignore_list, float max_distance);
+    // triangles (3 vertices each, world space) of colliders of static objects (no rigid body or zero mass, not triggers)
+    void get_static_collision_geometry(std::vector<glm::vec3>& out_triangles) const;
+
+    void set_animation_lod_settings(const engine_animation_lod_settings_t& settings) { animation_system_.set_lod_settings(settings); }
+    engine_animation_lod_settings_t get_animation_lod_settings() const { return animation_system_.get_lod_settings(); }
+    engine_animation_lod_stats_t get_animation_lod_stats() const { return animation_system_.get_lod_stats(); }
+
+    void set_crowd_settings(const engine_crowd_settings_t& settings) { crowd_system_.set_settings(settings); }
+    engine_crowd_settings_t get_crowd_settings() const { return crowd_system_.get_settings(); }
+    engine_crowd_stats_t get_crowd_stats() const { return crowd_system_.get_stats(); }
+
+    engine_frame_arena_stats_t get_frame_arena_stats() const
+    {
+        const auto stats = frame_arena_.get_stats();
+        return engine_frame_arena_stats_t{ stats.capacity, stats.used, stats.peak_used, stats.overflow_count };
+    }
 
 private:
     engine_result_code_t physics_update(float dt);
 
 private:
     RenderContext& rdx_;
-    entt::registry entity_registry_;
-    entt::observer transform_model_matrix_update_observer;
-    entt::observer mesh_update_observer;
-    entt::observer collider_create_observer;
-    entt::observer collider_update_observer;
-    entt::observer transform_update_collider_observer;
-    entt::observer rigid_body_create_observer;
-    entt::observer rigid_body_update_observer;
+    registry_t entity_registry_;
+    observer_t transform_model_matrix_update_observer;
+    observer_t mesh_update_observer;
+    observer_t collider_create_observer;
+    observer_t collider_update_observer;
+    observer_t transform_update_collider_observer;
+    observer_t rigid_body_create_observer;
+    observer_t rigid_body_update_observer;
 
     PhysicsWorld physics_world_;
+    EntityCommandBuffer command_buffer_;
+    AnimationSystem animation_system_;
+    CrowdSystem crowd_system_;
+    // transient containers of update(), reset at its end
+    FrameArena frame_arena_;
 
     std::array<Shader, static_cast<std::size_t>(ShaderType::eCount)> shaders_;
 
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENGINE_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ENGINE_SIMD_NEON 1
+#endif
+
+// Minimal 4-wide float math used by hot loops (i.e. animation sampling and pose blending).
+// SSE2 on x86, NEON on ARM (android), scalar fallback otherwise.
+// Loads and stores are unaligned, so data can live in regular std::vector<glm::vec4/glm::quat>.
+// Quaternions are xyzw (same as GLM_FORCE_QUAT_DATA_XYZW).
+namespace engine::simd
+{
+#if ENGINE_SIMD_SSE
+using float4 = __m128;
+
+inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 set4(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline float4 splat(float v) { return _mm_set1_ps(v); }
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline float first(float4 v) { return _mm_cvtss_f32(v); }
+// flips sign of all lanes of v, where sign of the mask lane is negative
+inline float4 flip_sign(float4 v, float4 mask) { return _mm_xor_ps(v, _mm_and_ps(mask, _mm_set1_ps(-0.0f))); }
+
+template<int X, int Y, int Z, int W>
+inline float4 swizzle(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X)); }
+
+// dot product broadcasted to all lanes
+inline float4 dot4(float4 a, float4 b)
+{
+    const auto m = _mm_mul_ps(a, b);
+    const auto s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+inline float4 sqrt4(float4 v) { return _mm_sqrt_ps(v); }
+#elif ENGINE_SIMD_NEON
+using float4 = float32x4_t;
+
+inline float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+inline float4 set4(float x, float y, float z, float w) { const float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+inline float4 splat(float v) { return vdupq_n_f32(v); }
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+inline float first(float4 v) { return vgetq_lane_f32(v, 0); }
+inline float4 flip_sign(float4 v, float4 mask)
+{
+    const auto sign = vandq_u32(vreinterpretq_u32_f32(mask), vdupq_n_u32(0x80000000u));
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), sign));
+}
+
+template<int X, int Y, int Z, int W>
+inline float4 swizzle(float4 v)
+{
+    float in[4];
+    vst1q_f32(in, v);
+    const float out[4] = { in[X], in[Y], in[Z], in[W] };
+    return vld1q_f32(out);
+}
+
+inline float4 dot4(float4 a, float4 b)
+{
+    const auto m = vmulq_f32(a, b);
+    const auto s = vadd_f32(vget_low_f32(m), vget_high_f32(m));
+    return vdupq_lane_f32(vpadd_f32(s, s), 0);
+}
+
+#if defined(__aarch64__)
+inline float4 div(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 sqrt4(float4 v) { return vsqrtq_f32(v); }
+#else
+inline float4 div(float4 a, float4 b)
+{
+    // reciprocal estimate with two newton-raphson steps
+    auto r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+}
+inline float4 sqrt4(float4 v) { return splat(std::sqrt(first(v))); }
+#endif
+#else
+struct float4
+{
+    float v[4];
+};
+
+inline float4 load4(const float* p) { return { p[0], p[1], p[2], p[3] }; }
+inline void store4(float* p, float4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+inline float4 set4(float x, float y, float z, float w) { return { x, y, z, w }; }
+inline float4 splat(float v) { return { v, v, v, v }; }
+inline float4 add(float4 a, float4 b) { return { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] }; }
+inline float4 sub(float4 a, float4 b) { return { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] }; }
+inline float4 mul(float4 a, float4 b) { return { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] }; }
+inline float4 div(float4 a, float4 b) { return { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] }; }
+inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+inline float first(float4 a) { return a.v[0]; }
+inline float4 flip_sign(float4 a, float4 mask)
+{
+    return { std::signbit(mask.v[0]) ? -a.v[0] : a.v[0], std::signbit(mask.v[1]) ? -a.v[1] : a.v[1], std::signbit(mask.v[2]) ? -a.v[2] : a.v[2], std::signbit(mask.v[3]) ? -a.v[3] : a.v[3] };
+}
+
+template<int X, int Y, int Z, int W>
+inline float4 swizzle(float4 a) { return { a.v[X], a.v[Y], a.v[Z], a.v[W] }; }
+
+inline float4 dot4(float4 a, float4 b) { return splat(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]); }
+inline float4 sqrt4(float4 a) { return { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) }; }
+#endif
+
+// a + (b - a) * t
+inline float4 lerp(float4 a, float4 b, float4 t)
+{
+    return madd(sub(b, a), t, a);
+}
+
+inline float4 normalize4(float4 v)
+{
+    return div(v, sqrt4(dot4(v, v)));
+}
+
+// quaternion product a * b
+inline float4 quat_mul(float4 a, float4 b)
+{
+    const auto sign_w = set4(1.0f, 1.0f, 1.0f, -1.0f);
+    auto r = mul(swizzle<3, 3, 3, 3>(a), b);
+    r = madd(mul(swizzle<0, 1, 2, 0>(a), swizzle<3, 3, 3, 0>(b)), sign_w, r);
+    r = madd(mul(swizzle<1, 2, 0, 1>(a), swizzle<2, 0, 1, 1>(b)), sign_w, r);
+    return sub(r, mul(swizzle<2, 0, 1, 2>(a), swizzle<1, 2, 0, 2>(b)));
+}
+
+inline float4 quat_conjugate(float4 q)
+{
+    return mul(q, set4(-1.0f, -1.0f, -1.0f, 1.0f));
+}
+
+// normalized lerp along the shortest path, cheap and accurate enough for close rotations (i.e. neighbouring keys)
+inline float4 quat_nlerp(float4 a, float4 b, float t)
+{
+    b = flip_sign(b, dot4(a, b));
+    return normalize4(lerp(a, b, splat(t)));
+}
+
+// constant angular velocity interpolation, falls back to nlerp for nearly parallel quaternions
+inline float4 quat_slerp(float4 a, float4 b, float t)
+{
+    const auto d = dot4(a, b);
+    b = flip_sign(b, d);
+    const auto cos_theta = std::abs(first(d));
+    if (cos_theta > 0.9995f)
+    {
+        return normalize4(lerp(a, b, splat(t)));
+    }
+    const auto theta = std::acos(cos_theta);
+    const auto inv_sin_theta = 1.0f / std::sin(theta);
+    const auto wa = std::sin((1.0f - t) * theta) * inv_sin_theta;
+    const auto wb = std::sin(t * theta) * inv_sin_theta;
+    return madd(a, splat(wa), mul(b, splat(wb)));
+}
+} // namespace engine::simd
@@ -9,39 +9,115 @@
 #include <RmlUi/Core/ID.h>
 #include <RmlUi/Core/DataModelHandle.h>
 
-engine::UiDocument::UiDocument(Rml::Context* ctx, std::string_view file_name)
-    : doc_(ctx->LoadDocument((AssetStore::get_instance().get_ui_docs_base_path() / file_name).string()))
+#include <fmt/format.h>
+
+engine::UiDocument::UiDocument(UiManager& manager, Rml::Context* ctx, std::string_view file_name)
+    : manager_(&manager)
+    , doc_(ctx->LoadDocument((AssetStore::get_instance().get_ui_docs_base_path() / file_name).string()))
     , context_(ctx)
+    , file_name_(file_name)
 {   
+    manager_->register_document(this);
 }
 
 engine::UiDocument::UiDocument(UiDocument&& rhs)
 {
+    std::swap(manager_, rhs.manager_);
     std::swap(doc_, rhs.doc_);
+    std::swap(context_, rhs.context_);
+    std::swap(file_name_, rhs.file_name_);
+    std::swap(cached_ui_elements_, rhs.cached_ui_elements_);
+    if (manager_)
+    {
+        manager_->unregister_document(&rhs);
+        manager_->register_document(this);
+    }
 }
 
 engine::UiDocument& engine::UiDocument::operator=(UiDocument&& rhs)
 {
     if (this != &rhs)
     {
+        if (manager_)
+        {
+            manager_->unregister_document(this);
+        }
+        if (rhs.manager_)
+        {
+            rhs.manager_->unregister_document(&rhs);
+        }
+        std::swap(manager_, rhs.manager_);
         std::swap(doc_, rhs.doc_);
+        std::swap(context_, rhs.context_);
+        std::swap(file_name_, rhs.file_name_);
+        std::swap(cached_ui_elements_, rhs.cached_ui_elements_);
+        if (manager_)
+        {
+            manager_->register_document(this);
+        }
+        if (rhs.manager_)
+        {
+            rhs.manager_->register_document(&rhs);
+        }
     }
     return *this;
 }
 
 engine::UiDocument::~UiDocument()
 {
-    context_->UnloadDocument(doc_);
+    if (manager_)
+    {
+        manager_->unregister_document(this);
+    }
+    if (doc_)
+    {
+        context_->UnloadDocument(doc_);
+    }
 }
 
 void engine::UiDocument::show()
 {
-    doc_->Show();
+    if (doc_)
+    {
+        doc_->Show();
+    }
 }
 
 void engine::UiDocument::hide()
 {
-    doc_->Hide();
+    if (doc_)
+    {
+        doc_->Hide();
+    }
+}
+
+bool engine::UiDocument::reload(std::string_view rml_source)
+{
+    // relative paths (style sheets, templates, images) are resolved against the document file
+    const auto source_url = (AssetStore::get_instance().get_ui_docs_base_path() / file_name_).string();
+    auto* new_doc = context_->LoadDocumentFromMemory(Rml::String(rml_source), source_url);
+    if (!new_doc)
+    {
+        log::log(log::LogLevel::eError, fmt::format("[Hot reload] Failed to parse UI document: {}. Keeping the previous one.\n", file_name_));
+        return false;
+    }
+
+    const bool visible = doc_ && doc_->IsVisible();
+    if (doc_)
+    {
+        context_->UnloadDocument(doc_);
+    }
+    doc_ = new_doc;
+    if (visible)
+    {
+        doc_->Show();
+    }
+
+    for (auto& [id, element] : cached_ui_elements_)
+    {
+        element.rebind(doc_->GetElementById(id));
+    }
+    return true;
 }
 
 engine::UiElement* engine::UiDocument::get_element_by_id(std::string_view id, engine_result_code_t& err_out)
@@ -150,7 +226,7 @@ engine::UiElement::~UiElement()
     element_ = nullptr;
 }
 
-bool engine::UiElement::register_callback(engine_ui_event_type_t type, void* user_data, fnCallbackT&& callback)
+Rml::EventId engine::UiElement::to_rml_event_id(engine_ui_event_type_t type)
 {
     Rml::EventId rml_ev_id = Rml::EventId::Invalid;
     switch (type)
@@ -178,7 +254,12 @@ bool engine::UiElement::register_callback(engine_ui_event_type_t type, void* use
     default:
         engine::log::log(log::LogLevel::eCritical, "Unknown engine_ui_event_type_t. Cant creatre UI callback!");
     }
+    return rml_ev_id;
+}
 
+bool engine::UiElement::register_callback(engine_ui_event_type_t type, void* user_data, fnCallbackT&& callback)
+{
+    const auto rml_ev_id = to_rml_event_id(type);
     if (rml_ev_id == Rml::EventId::Invalid)
     {
         return false;
@@ -191,18 +272,39 @@ bool engine::UiElement::register_callback(engine_ui_event_type_t type, void* use
     }
 
     listeners_[type] = BasicEventListener(std::move(callback), user_data);
-    element_->AddEventListener(rml_ev_id, &listeners_[type]);
+    if (element_)
+    {
+        element_->AddEventListener(rml_ev_id, &listeners_[type]);
+    }
     return ret;
 }
 
 bool engine::UiElement::set_property(std::string_view name, std::string_view value)
 {
-    return element_->SetProperty(name.data(), value.data());
+    return element_ ? element_->SetProperty(name.data(), value.data()) : false;
 }
 
 void engine::UiElement::remove_property(std::string_view name)
 {
-    element_->RemoveProperty(name.data());
+    if (element_)
+    {
+        element_->RemoveProperty(name.data());
+    }
+}
+
+void engine::UiElement::rebind(Rml::Element* element)
+{
+    // listeners of the old element go away with the old document
+    element_ = element;
+    if (!element_)
+    {
+        log::log(log::LogLevel::eError, "[Hot reload] UI element is missing in the reloaded document. Its callbacks are kept until it comes back.\n");
+        return;
+    }
+    for (auto& [type, listener] : listeners_)
+    {
+        element_->AddEventListener(to_rml_event_id(type), &listener);
+    }
 }
 
 void engine::UiElement::BasicEventListener::ProcessEvent(Rml::Event& event)
@@ -86,6 +86,12 @@ public:
     bool set_property(std::string_view name, std::string_view value);
     void remove_property(std::string_view name);
 
+    // points the element to its counterpart in a reloaded document and moves registered callbacks to it
+    void rebind(Rml::Element* element);
+
+private:
+    static Rml::EventId to_rml_event_id(engine_ui_event_type_t type);
+
 private:
     Rml::Element* element_ = nullptr;
     const UiDocument* const parent_doc_ = nullptr;
@@ -95,7 +101,7 @@ private:
 class UiDocument
 {
 public:
-    UiDocument(Rml::Context* ctx, std::string_view file_name);
+    UiDocument(UiManager& manager, Rml::Context* ctx, std::string_view file_name);
     UiDocument(const UiDocument& rhs) = delete;
     UiDocument& operator=(const UiDocument& rhs) = delete;
     UiDocument(UiDocument&&);
@@ -107,9 +113,17 @@ public:
 
     UiElement* get_element_by_id(std::string_view id, engine_result_code_t& err_out);
 
+    const std::string& get_file_name() const { return file_name_; }
+
+    // Replaces the document with one parsed from rml_source (hot reload). Visibility is kept, false if parsing failed.
+    // Elements returned by get_element_by_id() stay valid and keep their callbacks, if the new document still has their ids.
+    bool reload(std::string_view rml_source);
+
 private:
+    UiManager* manager_ = nullptr;
     Rml::ElementDocument* doc_ = nullptr;
-    Rml::Context* context_;
+    Rml::Context* context_ = nullptr;
+    std::string file_name_{};
     std::map<std::string, UiElement> cached_ui_elements_;
 };
 }
\ No newline at end of file
@@ -11,15 +11,94 @@
 #include <RmlUi/Core.h>
 #include <RmlUi/Core/ID.h>
 #include <RmlUi/Core/DataModelHandle.h>
+#include <RmlUi/Core/FileInterface.h>
 #include <RmlUi/Debugger.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
+
+namespace
+{
+// Routes RmlUi file reads (documents, style sheets, fonts, images) through AssetStore, so they can be loaded from asset packs.
+class AssetStoreFileInterface : public Rml::FileInterface
+{
+public:
+    Rml::FileHandle Open(const Rml::String& path) override
+    {
+        auto file = std::make_unique<open_file_t>(engine::AssetStore::get_instance().get_file_data(path));
+        if (file->data.get_size() == 0)
+        {
+            return 0;
+        }
+        return reinterpret_cast<Rml::FileHandle>(file.release());
+    }
+
+    void Close(Rml::FileHandle file) override
+    {
+        delete reinterpret_cast<open_file_t*>(file);
+    }
+
+    size_t Read(void* buffer, size_t size, Rml::FileHandle file) override
+    {
+        auto* f = reinterpret_cast<open_file_t*>(file);
+        const auto bytes = std::min(size, f->data.get_size() - f->position);
+        std::memcpy(buffer, f->data.get_data_ptr() + f->position, bytes);
+        f->position += bytes;
+        return bytes;
+    }
+
+    bool Seek(Rml::FileHandle file, long offset, int origin) override
+    {
+        auto* f = reinterpret_cast<open_file_t*>(file);
+        long base = 0;
+        switch (origin)
+        {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = static_cast<long>(f->position); break;
+        case SEEK_END: base = static_cast<long>(f->data.get_size()); break;
+        default: return false;
+        }
+        const auto new_position = base + offset;
+        if (new_position < 0 || static_cast<std::size_t>(new_position) > f->data.get_size())
+        {
+            return false;
+        }
+        f->position = static_cast<std::size_t>(new_position);
+        return true;
+    }
+
+    size_t Tell(Rml::FileHandle file) override
+    {
+        return reinterpret_cast<open_file_t*>(file)->position;
+    }
+
+    size_t Length(Rml::FileHandle file) override
+    {
+        return reinterpret_cast<open_file_t*>(file)->data.get_size();
+    }
+
+private:
+    struct open_file_t
+    {
+        open_file_t(engine::RawDataFileContext&& d) : data(std::move(d)) {}
+        engine::RawDataFileContext data;
+        std::size_t position = 0;
+    };
+};
+
+// has to outlive Rml::Shutdown()
+AssetStoreFileInterface file_interface;
+}  // namespace anonymous
 
 
 engine::UiManager::UiManager(RenderContext& rdx)
     : rdx_(rdx)
 {
+    Rml::SetFileInterface(&file_interface);
     Rml::Initialise();
     // create context with some aribtrary name and dimension.  (dimensions wil lbe update in update(..))
     const auto window_size_pixels = rdx_.get_window_size_in_pixels();
@@ -37,6 +116,7 @@ engine::UiManager& engine::UiManager::operator=(UiManager&& rhs)
     if (this != &rhs)
     {
         std::swap(rdx_, rhs.rdx_);
+        std::swap(documents_, rhs.documents_);
     }
     return *this;
 }
@@ -57,7 +137,38 @@ engine::UiDataHandle engine::UiManager::create_data_handle(std::string_view name
 
 engine::UiDocument engine::UiManager::load_document_from_file(std::string_view file_name)
 {
-    return UiDocument(ui_rml_context_, file_name);
+    return UiDocument(*this, ui_rml_context_, file_name);
+}
+
+bool engine::UiManager::is_document_loaded(const std::filesystem::path& full_path) const
+{
+    const auto& base_path = AssetStore::get_instance().get_ui_docs_base_path();
+    return std::any_of(documents_.begin(), documents_.end(), [&](const UiDocument* doc)
+        {
+            return (base_path / doc->get_file_name()).lexically_normal() == full_path.lexically_normal();
+        });
+}
+
+void engine::UiManager::reload_documents(const std::filesystem::path& full_path, std::string_view rml_source)
+{
+    const auto& base_path = AssetStore::get_instance().get_ui_docs_base_path();
+    for (auto* doc : documents_)
+    {
+        if ((base_path / doc->get_file_name()).lexically_normal() == full_path.lexically_normal() && doc->reload(rml_source))
+        {
+            log::log(log::LogLevel::eTrace, fmt::format("[Hot reload] Reloaded UI document: {}\n", doc->get_file_name()));
+        }
+    }
+}
+
+void engine::UiManager::register_document(UiDocument* doc)
+{
+    documents_.push_back(doc);
+}
+
+void engine::UiManager::unregister_document(UiDocument* doc)
+{
+    std::erase(documents_, doc);
 }
 
 bool engine::UiManager::load_font_from_file(std::string_view file_name, std::string_view /*handle_name*/)
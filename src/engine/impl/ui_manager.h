@@ -4,6 +4,8 @@
 #include "ui_document.h"
 
 #include <array>
+#include <filesystem>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -28,6 +30,15 @@ public:
     engine::UiDataHandle create_data_handle(std::string_view name, std::span<const engine_ui_document_data_binding_t> bindings);
     UiDocument load_document_from_file(std::string_view file_name);
 
+    // hot reload: true if any live document was loaded from full_path
+    bool is_document_loaded(const std::filesystem::path& full_path) const;
+    // hot reload: reloads all live documents loaded from full_path, has to be called on the main thread
+    void reload_documents(const std::filesystem::path& full_path, std::string_view rml_source);
+
+    // live documents register themselves, so they can be found by hot reload
+    void register_document(UiDocument* doc);
+    void unregister_document(UiDocument* doc);
+
     bool load_font_from_file(std::string_view file_name, std::string_view handle_name);
 
     void parse_sdl_event(SDL_Event ev);
@@ -37,6 +48,7 @@ public:
 private:
     RenderContext& rdx_;
     Rml::Context* ui_rml_context_;
+    std::vector<UiDocument*> documents_;
 };
 
 
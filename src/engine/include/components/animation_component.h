@@ -0,0 +1,66 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // cpp
+
+#include <stdint.h>
+
+#define ENGINE_ANIMATION_MAX_ADDITIVE_LAYERS 4
+
+typedef uint32_t engine_animation_clip_t;
+
+// Additive layer is applied on top of the pose of the main clip (i.e. hit reactions, breathing, aim offsets).
+// Difference between the layer clip and its first frame is added, scaled by weight.
+typedef struct _engine_animation_layer_t
+{
+    engine_animation_clip_t clip; // ENGINE_INVALID_OBJECT_HANDLE if layer is not used
+    float time;
+    float speed;
+    float weight; // [0.0f, 1.0f]
+    bool loop;
+    bool playing;
+} engine_animation_layer_t;
+
+// Plays animation clip on the hierarchy of game objects, which starts at the owner of this component.
+// Clip channels are bound to game objects by name component (same names as nodes of the model the clip was created from).
+// Transform components of bound game objects are written by engine during scene update.
+typedef struct _engine_animation_component_t
+{
+    engine_animation_clip_t clip;
+    float time;  // current time of the clip in milliseconds (same units as delta time of the scene update)
+    float speed; // 1.0f is normal speed, negative values play clip backwards
+    bool loop;
+    bool playing; // set to false by engine when not looping clip reaches its end
+    // when clip is changed, pose of the previous clip fades out over this time (in milliseconds), 0.0f switches instantly
+    float crossfade_duration;
+    engine_animation_layer_t additive_layers[ENGINE_ANIMATION_MAX_ADDITIVE_LAYERS];
+} engine_animation_component_t;
+
+#define ENGINE_ANIMATION_LOD_COUNT 4
+
+// Animation level of detail of the scene, selected by distance of the game object (owner of animation component) to the enabled camera.
+// Lod 0 is used below distances[0], lod 1 below distances[1] etc. Objects out of camera view use offscreen settings.
+// Throttled objects accumulate delta time, so animations keep the same speed. Update phase depends on game object id, so work is spread between frames.
+typedef struct _engine_animation_lod_settings_t
+{
+    float distances[ENGINE_ANIMATION_LOD_COUNT - 1];
+    uint32_t update_intervals[ENGINE_ANIMATION_LOD_COUNT]; // pose is updated every N-th frame, 0 and 1 - every frame
+    uint32_t max_bone_depths[ENGINE_ANIMATION_LOD_COUNT];  // bones deeper in the hierarchy (i.e. fingers) keep their last pose, 0 - no limit
+    uint32_t offscreen_update_interval;
+    uint32_t offscreen_max_bone_depth;
+} engine_animation_lod_settings_t;
+
+// counters from the last scene update
+typedef struct _engine_animation_lod_stats_t
+{
+    uint32_t objects_per_lod[ENGINE_ANIMATION_LOD_COUNT];
+    uint32_t offscreen_objects;
+    uint32_t updated_objects;   // pose sampled in the last update
+    uint32_t throttled_objects; // skipped due to update interval
+} engine_animation_lod_stats_t;
+
+#ifdef __cplusplus
+}
+#endif // cpp
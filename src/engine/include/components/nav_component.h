@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // cpp
+#include <stdint.h>
+
+/**
+ * @struct _engine_nav_mesh_build_config_t
+ * @brief Parameters of the nav mesh generation from the level geometry.
+ *
+ * Geometry is voxelized into cells of cell_size x cell_height x cell_size.
+ * Smaller cells give more accurate nav mesh, but build time grows quadratically.
+ * Reasonable defaults for human sized agent (in meters): cell_size = 0.3, cell_height = 0.2,
+ * agent_radius = 0.5, agent_height = 2.0, agent_max_climb = 0.4, agent_max_slope = 45.0, tile_size = 32.
+ *
+ * @var agent_max_climb
+ * Max height of the step, which agent can walk on.
+ *
+ * @var agent_max_slope
+ * Max slope of the walkable surface, in degrees.
+ *
+ * @var tile_size
+ * Size of the tile in cells. Tiles are built independently, so changing the level
+ * rebuilds only tiles overlapping the changed area.
+ */
+typedef struct _engine_nav_mesh_build_config_t
+{
+    float cell_size;
+    float cell_height;
+    float agent_radius;
+    float agent_height;
+    float agent_max_climb;
+    float agent_max_slope;
+    uint32_t tile_size;
+} engine_nav_mesh_build_config_t;
+
+/**
+ * @struct _engine_nav_mesh_build_stats_t
+ * @brief Timings (in milliseconds) and results of the last nav mesh build or area rebuild.
+ */
+typedef struct _engine_nav_mesh_build_stats_t
+{
+    float voxelization_ms;  // rasterization of triangles, walkable spans and erosion
+    float regions_ms;  // regions and portals inside of tiles
+    float linking_ms;  // portals between tiles and nav mesh graph
+    float total_ms;
+    uint32_t tiles_count;
+    uint32_t tiles_built;
+    uint32_t nodes_count;
+    uint32_t edges_count;
+} engine_nav_mesh_build_stats_t;
+
+/**
+ * @struct _engine_nav_agent_component_t
+ * @brief Agent of the crowd, moved by the engine with local avoidance of other agents.
+ *
+ * Game sets preferred velocity (i.e. towards the next node of the path) and the engine computes
+ * the closest velocity, which doesn't collide with other agents (ORCA) within the crowd time horizon.
+ * Velocity is applied to the transform position (xz plane) before physics update, so agents should not have dynamic rigid bodies.
+ *
+ * @var velocity
+ * Output, velocity after avoidance used in the last update.
+ */
+typedef struct _engine_nav_agent_component_t
+{
+    float radius;
+    float max_speed;  // units per second
+    float preferred_velocity[3];  // units per second, y is ignored
+    float velocity[3];
+} engine_nav_agent_component_t;
+
+/**
+ * @struct _engine_crowd_settings_t
+ * @brief Local avoidance settings of all agents of the scene.
+ *
+ * @var neighbour_distance
+ * Only agents closer than this distance are avoided.
+ *
+ * @var time_horizon
+ * In seconds, agent avoids collisions which would happen within this time. Longer time gives smoother, but more cautious movement.
+ *
+ * @var max_neighbours
+ * Max number of the closest agents avoided by the agent.
+ */
+typedef struct _engine_crowd_settings_t
+{
+    float neighbour_distance;
+    float time_horizon;
+    uint32_t max_neighbours;
+} engine_crowd_settings_t;
+
+typedef struct _engine_crowd_stats_t
+{
+    uint32_t agents_count;
+    uint32_t neighbours_count;  // sum of avoided neighbours of all agents
+    float update_ms;
+} engine_crowd_stats_t;
+
+#ifdef __cplusplus
+}
+#endif // cpp
@@ -10,6 +10,8 @@
 #include "components/collider_component.h"
 #include "components/parent_component.h"
 #include "components/sprite_component.h"
+#include "components/animation_component.h"
+#include "components/nav_component.h"
 
 
 #ifdef _WIN32
@@ -45,11 +47,44 @@ typedef struct _engine_component_iterator_t* engine_component_iterator_t;
 typedef struct _engine_ui_document_t* engine_ui_document_t;
 typedef struct _engine_ui_data_handle_t* engine_ui_data_handle_t;
 typedef struct _engine_ui_element_t* engine_ui_element_t;
+typedef struct _engine_prefab_t* engine_prefab_t;
 typedef uint32_t engine_material_t;
 typedef uint32_t engine_texture2d_t;
 typedef uint32_t engine_geometry_t;
 typedef uint32_t engine_animation_controller_t;
 typedef uint32_t engine_shader_t;
+typedef uint32_t engine_nav_mesh_t;
+typedef uint32_t engine_nav_mesh_node_t; // ENGINE_INVALID_OBJECT_HANDLE if not valid
+typedef uint32_t engine_path_query_ticket_t;
+typedef uint32_t engine_nav_mesh_flow_field_t;
+
+typedef enum _engine_path_query_status_t
+{
+    ENGINE_PATH_QUERY_STATUS_INVALID = 0, // unknown or released ticket
+    ENGINE_PATH_QUERY_STATUS_PENDING,
+    ENGINE_PATH_QUERY_STATUS_COMPLETED,
+    ENGINE_PATH_QUERY_STATUS_NOT_FOUND, // end is not reachable from start, or query was invalid
+} engine_path_query_status_t;
+
+// components, which can be recorded in the scene command buffer
+typedef enum _engine_component_type_t
+{
+    ENGINE_COMPONENT_TYPE_TRANSFORM = 0,
+    ENGINE_COMPONENT_TYPE_NAME,
+    ENGINE_COMPONENT_TYPE_PARENT,
+    ENGINE_COMPONENT_TYPE_MESH,
+    ENGINE_COMPONENT_TYPE_MATERIAL,
+    ENGINE_COMPONENT_TYPE_CAMERA,
+    ENGINE_COMPONENT_TYPE_LIGHT,
+    ENGINE_COMPONENT_TYPE_RIGID_BODY,
+    ENGINE_COMPONENT_TYPE_COLLIDER,
+    ENGINE_COMPONENT_TYPE_SKIN,
+    ENGINE_COMPONENT_TYPE_BONE,
+    ENGINE_COMPONENT_TYPE_SPRITE,
+    ENGINE_COMPONENT_TYPE_ANIMATION,
+    ENGINE_COMPONENT_TYPE_NAV_AGENT,
+    ENGINE_COMPONENT_TYPE_COUNT
+} engine_component_type_t;
 
 
 
@@ -119,12 +154,87 @@ typedef struct _engine_application_create_desc_t
     uint32_t height;
     bool fullscreen;
     bool enable_editor;
+    bool optimize_meshes; // reorder vertex and index data of loaded models for vertex cache, overdraw and vertex fetch
+    bool compress_animations; // remove redundant keys and quantize rotations and translations of animations of loaded models
+    bool enable_assets_hot_reload; // watch assets folders and rebuild textures, shaders and models geometries when their files change
 } engine_application_create_desc_t;
 
 typedef struct _engine_scene_create_desc_t
 {
+    // bytes of each of two buffers of the frame arena (transient data of the scene update), 0 - default (1 MiB)
+    // arena grows when update doesn't fit, so it's only a hint to skip warm up frames
+    uint32_t frame_arena_size;
 } engine_scene_create_desc_t;
 
+typedef struct _engine_frame_arena_stats_t
+{
+    uint64_t capacity;        // bytes of each of two buffers
+    uint64_t used;            // bytes used by the last scene update
+    uint64_t peak_used;       // max of used, since scene creation
+    uint32_t overflow_count;  // heap allocations of the last scene update (non zero until arena grows to fit the update)
+} engine_frame_arena_stats_t;
+
+// subsystems, which memory is tracked
+typedef enum _engine_memory_tag_t
+{
+    ENGINE_MEMORY_TAG_ECS = 0,      // entt registry storage, scene command buffer and frame arena
+    ENGINE_MEMORY_TAG_PHYSICS,      // all Bullet allocations
+    ENGINE_MEMORY_TAG_ASSETS,       // animation clips, prefabs
+    ENGINE_MEMORY_TAG_UI,           // GPU buffers and textures of the UI renderer
+    ENGINE_MEMORY_TAG_GPU_BUFFERS,  // vertex, index, uniform and storage buffers
+    ENGINE_MEMORY_TAG_GPU_TEXTURES, // textures, including framebuffer attachments (mip chain estimated as 1/3 of base level)
+
+    ENGINE_MEMORY_TAG_COUNT
+} engine_memory_tag_t;
+
+typedef struct _engine_memory_stats_t
+{
+    uint64_t live_bytes;
+    uint64_t peak_bytes;
+    uint64_t live_allocations;
+    uint64_t frame_allocations;      // allocations made during the last frame
+    uint64_t frame_allocated_bytes;  // bytes allocated during the last frame
+    uint64_t budget_bytes;           // 0 - no budget
+} engine_memory_stats_t;
+
+// CPU time of frame parts; times of a stage repeated in the frame (i.e. for every scene or camera) are summed
+typedef enum _engine_frame_stage_t
+{
+    ENGINE_FRAME_STAGE_EVENTS = 0,               // frame begin: events polling, hot reload and path queries
+    ENGINE_FRAME_STAGE_SCENE_UPDATE,             // whole updates of scenes, including stages below
+    ENGINE_FRAME_STAGE_COMMAND_BUFFER,
+    ENGINE_FRAME_STAGE_ANIMATION,
+    ENGINE_FRAME_STAGE_CROWD,
+    ENGINE_FRAME_STAGE_PHYSICS,                  // rigid bodies sync and simulation step
+    ENGINE_FRAME_STAGE_TRANSFORMS,
+    ENGINE_FRAME_STAGE_HIERARCHY,
+    ENGINE_FRAME_STAGE_LIGHTS,
+    ENGINE_FRAME_STAGE_RENDER_GEOMETRY,
+    ENGINE_FRAME_STAGE_RENDER_SKINNED_GEOMETRY,
+    ENGINE_FRAME_STAGE_RENDER_SPRITES,
+    ENGINE_FRAME_STAGE_RENDER_DEBUG,             // physics debug draw
+    ENGINE_FRAME_STAGE_POST_PROCESS,             // scene framebuffer blit
+    ENGINE_FRAME_STAGE_UI,                       // UI documents update and rendering (and editor, if enabled)
+    ENGINE_FRAME_STAGE_PRESENT,                  // buffers swap, includes waiting for vsync
+
+    ENGINE_FRAME_STAGE_COUNT
+} engine_frame_stage_t;
+
+#define ENGINE_FRAME_STATS_HISTORY_SIZE 128
+
+typedef struct _engine_frame_stats_t
+{
+    uint64_t frame_index;
+    float delta_time_ms;  // time between beginnings of this and the previous frame
+    float cpu_time_ms;    // from the frame begin to the frame end
+    float stages_ms[ENGINE_FRAME_STAGE_COUNT];  // indexed with engine_frame_stage_t
+    uint32_t draw_calls;
+    uint32_t state_changes;  // shader, texture and vertex array binds
+    uint64_t triangles;
+    uint32_t entities_count;  // game objects of updated scenes
+    uint32_t scenes_updated;
+} engine_frame_stats_t;
+
 typedef enum _engine_begin_frame_event_flags_t
 {
     ENGINE_EVENT_NONE = 0x0,
@@ -310,13 +420,28 @@ typedef enum _engine_vertex_attribute_data_type_t
     ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT8,
     ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_INT8,
 
+    // half precision float, read by shader as float
+    ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT16,
+
+    // normalized integers, read by shader as float in range [0, 1] (unorm) or [-1, 1] (snorm)
+    ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM16,
+    ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16,
+    ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8,
+    ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM8,
+
 } engine_vertex_attribute_data_type_t;
 
+typedef enum _engine_index_data_type_t
+{
+    ENGINE_INDEX_DATA_TYPE_UINT32 = 0,
+    ENGINE_INDEX_DATA_TYPE_UINT16,
+} engine_index_data_type_t;
+
 typedef struct _engine_vertex_attribute_desc_t
 {
     uint32_t elements_count;  // set to 0 to disable given attribute
     engine_vertex_attribute_data_type_t elements_data_type;
-    engine_vertex_attribute_type_t type;
+    engine_vertex_attribute_type_t type; // defines shader input location
 
     float range_min[4];
     float range_max[4];
@@ -367,8 +492,9 @@ typedef struct _engine_geometry_create_desc_t
     size_t verts_data_size;
     int32_t verts_count;
     engine_vertex_attributes_layout_t verts_layout;
-    const uint32_t* inds;
+    const void* inds;
     size_t inds_count;
+    engine_index_data_type_t inds_data_type; // default (zero) is uint32_t
 } engine_geometry_create_desc_t;
 
 typedef struct _engine_animation_channel_data_t
@@ -450,6 +576,14 @@ typedef struct _engine_model_desc_t
     uint32_t skins_counts;
 } engine_model_desc_t;
 
+typedef struct _engine_prefab_create_desc_t
+{
+    const engine_model_desc_t* model_desc;
+    const engine_geometry_t* geometries;  // model_desc->geometries_count, created from the model desc geometries; nullptr if model has no meshes
+    const engine_material_component_t* materials;  // model_desc->materials_count; nullptr if model has no materials
+    bool add_animation_component;  // added to the root game object of every instance
+} engine_prefab_create_desc_t;
+
 /**
  * @struct engine_geometry_attribute_limit_t
  * @brief A structure representing the limits of a geometry attribute in the engine.
@@ -472,7 +606,20 @@ typedef struct _engine_geometry_attribute_limit_t
 
 
 // cross platform log
+// asynchronous: message is queued and written by background thread, safe to call from any thread
 ENGINE_API void engineLog(const char* str);
+// blocks until all queued messages are written
+ENGINE_API void engineLogFlush();
+// messages dropped, because log queue was full
+ENGINE_API uint64_t engineLogGetDroppedCount();
+
+// memory tracking (thread safe), counters are shared by all applications; frame counters are updated at the frame end
+ENGINE_API engine_memory_stats_t engineMemoryGetStats(engine_memory_tag_t tag);
+// budget_bytes: 0 - no budget; budgets are checked at the frame end
+ENGINE_API void engineMemorySetBudget(engine_memory_tag_t tag, uint64_t budget_bytes);
+// called at the frame end, once when live bytes of the subsystem exceed its budget (again after they drop below it)
+// without callback, error is logged
+ENGINE_API void engineMemorySetBudgetExceededCallback(void* user_data, void (*callback)(engine_memory_tag_t tag, uint64_t live_bytes, uint64_t budget_bytes, void* user_data));
 
 // app
 ENGINE_API engine_result_code_t engineApplicationCreate(engine_application_t* handle, engine_application_create_desc_t create_desc);
@@ -487,6 +634,26 @@ ENGINE_API void engineApplicationSceneDestroy(engine_application_t handle, engin
 ENGINE_API engine_game_object_t engineSceneCreateGameObject(engine_scene_t scene);
 ENGINE_API void                 engineSceneDestroyGameObject(engine_scene_t scene, engine_game_object_t game_object);
 
+// scene command buffer: operations are recorded (thread safe) and applied in one batch at the beginning of the next scene update,
+// so game objects can be safely created/destroyed and components added/changed during iteration, collisions callbacks etc.
+// Batch is sorted by component type, so each component storage is modified once, and all destroys are applied last.
+// Game object id is valid immediately, but recorded components are visible only after the batch is applied.
+ENGINE_API engine_game_object_t engineSceneCommandBufferCreateGameObject(engine_scene_t scene);
+ENGINE_API void engineSceneCommandBufferDestroyGameObject(engine_scene_t scene, engine_game_object_t game_object);
+// adds component with default values, ignored if game object already has the component
+ENGINE_API void engineSceneCommandBufferAddComponent(engine_scene_t scene, engine_game_object_t game_object, engine_component_type_t type);
+// component: pointer to the component struct of given type, copied. Component is added if game object doesn't have it.
+// Only the last recorded value of the component is applied.
+ENGINE_API void engineSceneCommandBufferSetComponent(engine_scene_t scene, engine_game_object_t game_object, engine_component_type_t type, const void* component);
+
+// prefab instances: all game objects of all instances are created in one batch, components are added type by type
+// root_transforms: count elements (local_to_world is ignored), or nullptr to keep root transform from the model
+// out_roots: count elements, root game object of every instance; can be nullptr
+ENGINE_API engine_result_code_t engineScenePrefabInstantiate(engine_scene_t scene, engine_prefab_t prefab, uint32_t count, const engine_tranform_component_t* root_transforms, engine_game_object_t* out_roots);
+
+// transient data of the scene update is allocated from double buffered frame arena, instead of the heap
+ENGINE_API engine_frame_arena_stats_t engineSceneGetFrameArenaStats(engine_scene_t scene);
+
 // user input hangling
 ENGINE_API bool engineApplicationIsKeyboardButtonDown(engine_application_t handle, engine_keyboard_keys_t key);
 ENGINE_API bool engineApplicationIsKeyboardButtonUp(engine_application_t handle, engine_keyboard_keys_t key);
@@ -501,16 +668,23 @@ ENGINE_API bool engineApplicationGetFingerInfo(engine_application_t handle, engi
 ENGINE_API engine_application_frame_begine_info_t engineApplicationFrameBegine(engine_application_t handle);
 ENGINE_API engine_result_code_t                   engineApplicationFrameSceneUpdate(engine_application_t handle, engine_scene_t scene, float delta_time);
 ENGINE_API engine_application_frame_end_info_t    engineApplicationFrameEnd(engine_application_t handle);
+// statistics of the last finished frames, newest first; returns number of frames written to out (up to ENGINE_FRAME_STATS_HISTORY_SIZE)
+ENGINE_API uint32_t engineApplicationGetFrameStats(engine_application_t handle, engine_frame_stats_t* out, uint32_t max_count);
 
 // pipeline state objects and GPU buffers
 ENGINE_API engine_result_code_t engineApplicationCreateShader(engine_application_t handle, const engine_shader_create_desc_t* desc, const char* name, engine_shader_t* out);
 ENGINE_API engine_shader_t engineApplicationGetShaderByName(engine_application_t handle, const char* name);
 ENGINE_API void engineApplicationDestroyShader(engine_application_t handle, engine_shader_t pso);
 
+// asset packs (*.epak created with asset_packer tool), searched before loose files
+// file_name is relative to asset_store_path, pack mounted last has the highest priority
+ENGINE_API engine_result_code_t engineApplicationMountAssetPack(engine_application_t handle, const char* file_name);
+
 // fonts
 ENGINE_API engine_result_code_t engineApplicationCreateFontFromFile(engine_application_t handle, const char* file_name, const char* handle_name);
 
 // model loading
+// thread safe: file I/O and parsing only, so models can be loaded on background threads (i.e. scene streaming)
 ENGINE_API engine_result_code_t engineApplicationAllocateModelDescAndLoadDataFromFile(engine_application_t handle, engine_model_specification_t spec, const char* file_name, const char* base_dir, engine_model_desc_t* out);
 ENGINE_API void engineApplicationReleaseModelDesc(engine_application_t handle, engine_model_desc_t* model_info);
 
@@ -526,6 +700,62 @@ ENGINE_API engine_result_code_t engineApplicationCreateTexture2DFromFile(engine_
 ENGINE_API engine_texture2d_t   engineApplicationGetTextured2DByName(engine_application_t handle, const char* name);
 ENGINE_API void engineApplicationDestroyTexture2D(engine_application_t handle, engine_texture2d_t tex2d);
 
+// animation clips
+// clip is created from animation of the model desc, channels are bound to game objects by names of the model nodes
+ENGINE_API engine_result_code_t engineApplicationCreateAnimationClipFromModelDesc(engine_application_t handle, const engine_model_desc_t* model_desc, uint32_t animation_index, const char* name, engine_animation_clip_t* out);
+ENGINE_API engine_animation_clip_t engineApplicationGetAnimationClipByName(engine_application_t handle, const char* name);
+ENGINE_API float engineApplicationGetAnimationClipDuration(engine_application_t handle, engine_animation_clip_t clip);
+ENGINE_API void engineApplicationDestroyAnimationClip(engine_application_t handle, engine_animation_clip_t clip);
+
+// prefabs
+// model desc compiled once into spawn template: flat array of nodes with resolved parents and bones, and ready components values.
+// Prefab doesn't own geometries and materials, they have to outlive its instances. Model desc can be released after creation.
+ENGINE_API engine_result_code_t engineApplicationCreatePrefabFromModelDesc(engine_application_t handle, const engine_prefab_create_desc_t* desc, engine_prefab_t* out);
+// prefab isn't stored in the application, so it's used and destroyed without the application handle
+ENGINE_API uint32_t enginePrefabGetNodesCount(engine_prefab_t prefab);
+ENGINE_API void enginePrefabDestroy(engine_prefab_t prefab);
+
+// nav mesh
+// graph of walkable nodes (boxes), has to be built after nodes and edges are added and before it's used
+ENGINE_API engine_result_code_t engineApplicationCreateNavMesh(engine_application_t handle, const char* name, engine_nav_mesh_t* out);
+ENGINE_API engine_nav_mesh_node_t engineApplicationNavMeshAddNode(engine_application_t handle, engine_nav_mesh_t nav_mesh, const float center[3], const float half_size[3]);
+ENGINE_API void engineApplicationNavMeshAddEdge(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t from, engine_nav_mesh_node_t to, uint32_t cost);
+ENGINE_API void engineApplicationNavMeshBuild(engine_application_t handle, engine_nav_mesh_t nav_mesh);
+// node containing position or the closest one
+ENGINE_API engine_nav_mesh_node_t engineApplicationNavMeshGetNearestNode(engine_application_t handle, engine_nav_mesh_t nav_mesh, const float position[3]);
+ENGINE_API void engineApplicationNavMeshGetNodeCenter(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t node, float out_center[3]);
+ENGINE_API void engineApplicationDestroyNavMesh(engine_application_t handle, engine_nav_mesh_t nav_mesh);
+// replaces nodes of the nav mesh with regions generated from colliders of static objects of the scene (no rigid body or zero mass)
+// node indices change with every (re)build, so flow fields of the nav mesh have to be reset
+ENGINE_API engine_result_code_t engineApplicationNavMeshBuildFromScene(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_scene_t scene, const engine_nav_mesh_build_config_t* config);
+// rebuilds only tiles affected by changed static objects in the area, nav mesh has to be built from scene before
+ENGINE_API engine_result_code_t engineApplicationNavMeshRebuildArea(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_scene_t scene, const float bounds_min[3], const float bounds_max[3]);
+ENGINE_API engine_result_code_t engineApplicationNavMeshGetBuildStats(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_build_stats_t* out);
+
+// flow fields
+// direction towards one goal for every node of the nav mesh, for many agents chasing the same goal
+ENGINE_API engine_result_code_t engineApplicationCreateNavMeshFlowField(engine_application_t handle, const char* name, engine_nav_mesh_flow_field_t* out);
+// goal moved to a different node restarts the field computation, at most max_nodes nodes are processed per call (0 - no limit), so it can be spread over frames
+// returns true when field of the current goal is complete, until then sampling uses the previous field
+ENGINE_API bool engineApplicationNavMeshFlowFieldUpdate(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_flow_field_t field, const float goal_position[3], uint32_t max_nodes);
+// returns false if position is outside of the nav mesh or goal is not reachable from it
+ENGINE_API bool engineApplicationNavMeshFlowFieldSample(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_flow_field_t field, const float position[3], float out_direction[3]);
+// has to be called when nav mesh is rebuilt
+ENGINE_API void engineApplicationNavMeshFlowFieldReset(engine_application_t handle, engine_nav_mesh_flow_field_t field);
+ENGINE_API void engineApplicationDestroyNavMeshFlowField(engine_application_t handle, engine_nav_mesh_flow_field_t field);
+
+// path queries
+// queries are executed in batches on worker threads, frame doesn't wait for them: batch is started at the beginning of the frame,
+// workers start searches within the time budget (1 ms by default), results are available from the first frame after the batch finished
+// modifying or destroying nav mesh waits for the running batch
+// same queries (nav mesh, start and end) submitted before they are executed share the search
+ENGINE_API engine_path_query_ticket_t engineApplicationSubmitPathQuery(engine_application_t handle, engine_nav_mesh_t nav_mesh, engine_nav_mesh_node_t start, engine_nav_mesh_node_t end);
+// path doesn't include start node, nodes pointer is valid until ticket is released
+ENGINE_API engine_path_query_status_t engineApplicationGetPathQueryResult(engine_application_t handle, engine_path_query_ticket_t ticket, const engine_nav_mesh_node_t** nodes, uint32_t* nodes_count);
+// every submitted ticket has to be released
+ENGINE_API void engineApplicationReleasePathQuery(engine_application_t handle, engine_path_query_ticket_t ticket);
+ENGINE_API void engineApplicationSetPathQueriesTimeBudget(engine_application_t handle, float budget_ms);
+
 // physics 
 ENGINE_API void engineScenePhysicsSetGravityVector(engine_scene_t scene, const float gravity[3]);
 ENGINE_API void engineScenePhysicsGetCollisions(engine_scene_t scene, size_t* num_collision, const engine_collision_info_t** collisions);
@@ -604,6 +834,26 @@ ENGINE_API void engineSceneUpdateBoneComponent(engine_scene_t scene, engine_game
 ENGINE_API void engineSceneRemoveBoneComponent(engine_scene_t scene, engine_game_object_t game_object);
 ENGINE_API bool engineSceneHasBoneComponent(engine_scene_t scene, engine_game_object_t game_object);
 
+// animation component
+ENGINE_API engine_animation_component_t engineSceneAddAnimationComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API engine_animation_component_t engineSceneGetAnimationComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API void engineSceneUpdateAnimationComponent(engine_scene_t scene, engine_game_object_t game_object, const engine_animation_component_t* comp);
+ENGINE_API void engineSceneRemoveAnimationComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API bool engineSceneHasAnimationComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API void engineSceneSetAnimationLodSettings(engine_scene_t scene, const engine_animation_lod_settings_t* settings);
+ENGINE_API engine_animation_lod_settings_t engineSceneGetAnimationLodSettings(engine_scene_t scene);
+ENGINE_API engine_animation_lod_stats_t engineSceneGetAnimationLodStats(engine_scene_t scene);
+
+// nav agent component
+ENGINE_API engine_nav_agent_component_t engineSceneAddNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API engine_nav_agent_component_t engineSceneGetNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API void engineSceneUpdateNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object, const engine_nav_agent_component_t* comp);
+ENGINE_API void engineSceneRemoveNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API bool engineSceneHasNavAgentComponent(engine_scene_t scene, engine_game_object_t game_object);
+ENGINE_API void engineSceneSetCrowdSettings(engine_scene_t scene, const engine_crowd_settings_t* settings);
+ENGINE_API engine_crowd_settings_t engineSceneGetCrowdSettings(engine_scene_t scene);
+ENGINE_API engine_crowd_stats_t engineSceneGetCrowdStats(engine_scene_t scene);
+
 // material component
 ENGINE_API engine_material_component_t engineSceneAddMaterialComponent(engine_scene_t scene, engine_game_object_t game_object);
 ENGINE_API engine_material_component_t engineSceneGetMaterialComponent(engine_scene_t scene, engine_game_object_t game_object);
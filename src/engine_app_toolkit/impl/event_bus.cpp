@@ -0,0 +1,61 @@
+#include "event_bus.h"
+
+void engine::EventBus::unsubscribe(event_listener_handle_t& handle)
+{
+    if (!handle.is_valid() || handle.queue >= queues_.size())
+    {
+        return;
+    }
+    queues_[handle.queue]->unsubscribe(handle.slot, handle.generation);
+    handle = {};
+}
+
+void engine::EventBus::dispatch(EventDispatchPoint point)
+{
+    // queues created by listeners during dispatch are dispatched at the next point
+    const auto queues_count = queues_.size();
+    for (std::size_t i = 0; i < queues_count; i++)
+    {
+        auto* queue = queues_[i].get();
+        if (queue->dispatch_point == point)
+        {
+            queue->dispatch();
+        }
+    }
+}
+
+void engine::EventBus::end_frame()
+{
+    stats_ = {};
+    stats_.queues_count = static_cast<std::uint32_t>(queues_.size());
+    for (auto& queue : queues_)
+    {
+        stats_.listeners_count += queue->get_listeners_count();
+        stats_.events_sent += queue->events_sent;
+        stats_.events_dispatched += queue->events_dispatched;
+        stats_.memory_bytes += queue->get_memory_bytes();
+        queue->events_sent = 0;
+        queue->events_dispatched = 0;
+    }
+}
+
+void engine::EventBus::clear()
+{
+    for (auto& queue : queues_)
+    {
+        queue->clear();
+    }
+}
+
+std::uint32_t engine::EventBus::get_queue_index(std::type_index type)
+{
+    const auto it = queues_lookup_.find(type);
+    if (it != queues_lookup_.end())
+    {
+        return it->second;
+    }
+    const auto idx = static_cast<std::uint32_t>(queues_.size());
+    queues_.emplace_back();
+    queues_lookup_[type] = idx;
+    return idx;
+}
@@ -71,15 +71,6 @@ engine_result_code_t propagate_collisions_events(engine_application_t app, engin
     return ENGINE_RESULT_CODE_OK;
 }
 
-engine_result_code_t update_scripts(std::unordered_map<engine_game_object_t, std::unique_ptr<engine::IScript>>& scripts, float dt)
-{
-    for (auto& [go, script] : scripts)
-    {
-        script->update(dt);
-    }
-    return ENGINE_RESULT_CODE_OK;
-}
-
 inline engine_scene_t create_scene(engine_application_t app_handle)
 {
     engine_scene_t scene = nullptr;
@@ -112,6 +103,8 @@ engine::IScene::IScene(IApplication* app)
 engine::IScene::~IScene()
 {
     // delete all scripts immediately before deallocating scene
+    event_bus_.clear();
+    script_scheduler_.clear();
     scripts_.clear();
     // delete scene
     if (scene_)
@@ -149,7 +142,13 @@ engine_result_code_t engine::IScene::update(float dt)
 
     for (auto& srq : scripts_register_queue_)
     {
-        scripts_[srq->get_game_object()] = std::unique_ptr<IScript>(srq);
+        auto& script = scripts_[srq.script->get_game_object()];
+        if (script)
+        {
+            script_scheduler_.remove(script.get());
+        }
+        script = std::unique_ptr<IScript>(srq.script);
+        script_scheduler_.add(srq);
     }
     scripts_register_queue_.clear();
 
@@ -157,13 +156,19 @@ engine_result_code_t engine::IScene::update(float dt)
 
     propagate_collisions_events(get_app_handle(), scene_, scripts_);
 
-    update_scripts(scripts_, dt);
+    script_scheduler_.update(ScriptUpdatePhase::ePrePhysics, dt);
+    event_bus_.dispatch(EventDispatchPoint::eBeforeSceneUpdate);
     update_scene(get_app_handle(), scene_, dt);
+    script_scheduler_.update(ScriptUpdatePhase::ePostPhysics, dt);
+    script_scheduler_.update(ScriptUpdatePhase::eLate, dt);
+    event_bus_.dispatch(EventDispatchPoint::eEndOfFrame);
+    event_bus_.end_frame();
 
     update_hook_end();
 
     for (auto& srq : scripts_unregister_queue_)
     {
+        script_scheduler_.remove(srq);
         scripts_.erase(srq->get_game_object());
     }
     scripts_unregister_queue_.clear();
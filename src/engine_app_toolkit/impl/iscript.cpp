@@ -12,5 +12,6 @@ engine::IScript::IScript(engine::IScene *my_scene)
 
 engine::IScript::~IScript()
 {
-    engineSceneDestroyGameObject(my_scene_->get_handle(), go_);
+    // deferred, scripts are destroyed while scene (and other scripts) may still use the game object in this frame
+    engineSceneCommandBufferDestroyGameObject(my_scene_->get_handle(), go_);
 }
\ No newline at end of file
@@ -1,13 +1,33 @@
 #include "scene_manager.h"
 #include "iscene.h"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace
+{
+inline float elapsed_ms(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now())
+{
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+}  // namespace anonymous
+
 engine::SceneManager::SceneManager(IApplication* app)
     : app_(app)
 {
 }
 
+engine::SceneManager::~SceneManager()
+{
+    // futures wait for background loads, before scenes are destroyed
+    loading_scenes_.clear();
+    scenes_.clear();
+}
+
 void engine::SceneManager::update(float dt)
 {
+    update_loading();
     for (auto& [_, scene] : scenes_)
     {
         scene->update(dt);
@@ -25,10 +45,134 @@ engine::IScene* engine::SceneManager::get_scene(std::string_view name)
 
 void engine::SceneManager::unregister_scene(std::string_view name)
 {
+    if (loading_scenes_.contains(name.data()))
+    {
+        loading_scenes_.erase(name.data());
+        load_stats_[name.data()].state = SceneLoadState::eFailed;
+        return;
+    }
     if (!scenes_.contains(name.data()))
     {
         assert(false && "Scene not found - cant unregister!");
         return;
     }
     scenes_.erase(name.data());
-}
\ No newline at end of file
+}
+
+bool engine::SceneManager::is_scene_loading(std::string_view name) const
+{
+    return loading_scenes_.contains(name.data());
+}
+
+const engine::scene_load_stats_t* engine::SceneManager::get_scene_load_stats(std::string_view name) const
+{
+    const auto it = load_stats_.find(name.data());
+    if (it == load_stats_.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void engine::SceneManager::load_scene_sync(std::string_view name, std::shared_ptr<IScene> scene)
+{
+    const auto start = std::chrono::steady_clock::now();
+    scene_load_stats_t stats{};
+    scene->load_background();
+    const auto main_thread_start = std::chrono::steady_clock::now();
+    stats.background_ms = elapsed_ms(start, main_thread_start);
+    while (!scene->load_step(std::chrono::steady_clock::time_point::max()))
+    {
+    }
+    stats.main_thread_ms = elapsed_ms(main_thread_start);
+    stats.max_step_ms = stats.main_thread_ms;
+    stats.main_thread_frames = 1;
+    stats.total_ms = elapsed_ms(start);
+    stats.progress = 1.0f;
+    stats.state = SceneLoadState::eReady;
+    load_stats_[name.data()] = stats;
+    scenes_[name.data()] = std::move(scene);
+}
+
+void engine::SceneManager::start_async_load(std::string_view name, std::shared_ptr<IScene> scene, bool activate_when_ready, std::chrono::steady_clock::time_point start)
+{
+    // not updated until loaded, scene can be activated by the user before it's ready
+    scene->deactivate();
+
+    loading_scene_t loading{};
+    loading.start = start;
+    loading.activate_when_ready = activate_when_ready;
+    loading.scene = scene;
+    // raw pointer, so scene is always destroyed on main thread (future is destroyed, and waits, before the scene)
+    loading.background = std::async(std::launch::async, [scene = scene.get()]()
+        {
+            scene->load_background();
+        }
+    );
+    loading_scenes_[name.data()] = std::move(loading);
+    load_stats_[name.data()] = {};
+}
+
+void engine::SceneManager::update_loading()
+{
+    if (loading_scenes_.empty())
+    {
+        return;
+    }
+    const auto frame_start = std::chrono::steady_clock::now();
+    const auto deadline = frame_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(loading_time_budget_);
+    for (auto it = loading_scenes_.begin(); it != loading_scenes_.end();)
+    {
+        auto& [name, loading] = *it;
+        auto& stats = load_stats_[name];
+        if (stats.state == SceneLoadState::eBackground)
+        {
+            if (loading.background.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                stats.total_ms = elapsed_ms(loading.start);
+                ++it;
+                continue;
+            }
+            try
+            {
+                loading.background.get();
+            }
+            catch (const std::exception& e)
+            {
+                log(fmt::format("Background loading of scene: {} failed: {}\n", name, e.what()));
+                stats.state = SceneLoadState::eFailed;
+                it = loading_scenes_.erase(it);
+                continue;
+            }
+            loading.main_thread_start = std::chrono::steady_clock::now();
+            stats.background_ms = elapsed_ms(loading.start, loading.main_thread_start);
+            stats.state = SceneLoadState::eMainThread;
+        }
+
+        // every loading scene makes at least one step per frame, budget is shared by all of them
+        const auto step_start = std::chrono::steady_clock::now();
+        const auto finished = loading.scene->load_step(deadline);
+        const auto step_ms = elapsed_ms(step_start);
+        stats.main_thread_ms += step_ms;
+        stats.max_step_ms = std::max(stats.max_step_ms, step_ms);
+        stats.main_thread_frames++;
+        stats.progress = 0.5f + 0.5f * std::clamp(loading.scene->get_load_progress(), 0.0f, 1.0f);
+        stats.total_ms = elapsed_ms(loading.start);
+        if (!finished)
+        {
+            ++it;
+            continue;
+        }
+
+        stats.progress = 1.0f;
+        stats.state = SceneLoadState::eReady;
+        log(fmt::format("Scene: {} loaded in {:.2f} ms (background: {:.2f} ms, main thread: {:.2f} ms in {} frames, longest step: {:.2f} ms)\n",
+            name, stats.total_ms, stats.background_ms, stats.main_thread_ms, stats.main_thread_frames, stats.max_step_ms));
+        if (loading.activate_when_ready)
+        {
+            loading.scene->activate();
+        }
+        scenes_[name] = std::move(loading.scene);
+        it = loading_scenes_.erase(it);
+    }
+}
@@ -0,0 +1,152 @@
+#include "script_scheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+void engine::ScriptScheduler::add(const registration_t& registration)
+{
+    assert(registration.script);
+    assert(!locations_.contains(registration.script));
+    const auto bucket_idx = get_bucket(registration.type);
+    auto& bucket = buckets_[bucket_idx];
+    // scripts registered with pointer to base class are assumed to have update, so the whole type is updated
+    if (registration.has_update && !bucket.has_update)
+    {
+        bucket.has_update = true;
+        update_phases();
+    }
+    locations_[registration.script] = { bucket_idx, static_cast<std::uint32_t>(bucket.scripts.size()) };
+    bucket.scripts.push_back(registration.script);
+    bucket.pending_dt.push_back(0.0f);
+}
+
+void engine::ScriptScheduler::remove(IScript* script)
+{
+    const auto it = locations_.find(script);
+    if (it == locations_.end())
+    {
+        return;
+    }
+    const auto location = it->second;
+    locations_.erase(it);
+
+    auto& bucket = buckets_[location.bucket];
+    const auto last = static_cast<std::uint32_t>(bucket.scripts.size() - 1);
+    if (location.index != last)
+    {
+        bucket.scripts[location.index] = bucket.scripts[last];
+        bucket.pending_dt[location.index] = bucket.pending_dt[last];
+        locations_[bucket.scripts[location.index]].index = location.index;
+    }
+    bucket.scripts.pop_back();
+    bucket.pending_dt.pop_back();
+}
+
+void engine::ScriptScheduler::clear()
+{
+    for (auto& bucket : buckets_)
+    {
+        bucket.scripts.clear();
+        bucket.pending_dt.clear();
+    }
+    locations_.clear();
+}
+
+void engine::ScriptScheduler::update(ScriptUpdatePhase phase, float dt)
+{
+    for (const auto bucket_idx : phases_[static_cast<std::size_t>(phase)])
+    {
+        auto& bucket = buckets_[bucket_idx];
+        const auto start = std::chrono::steady_clock::now();
+        bucket.updated_count = 0;
+
+        const auto count = bucket.scripts.size();
+        const auto interval = std::max(bucket.settings.update_interval, 1u);
+        if (interval == 1)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                bucket.scripts[i]->update(dt);
+            }
+            bucket.updated_count = static_cast<std::uint32_t>(count);
+        }
+        else
+        {
+            const auto group = bucket.frame % interval;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                bucket.pending_dt[i] += dt;
+                if (i % interval == group)
+                {
+                    const auto script_dt = bucket.pending_dt[i];
+                    bucket.pending_dt[i] = 0.0f;
+                    bucket.scripts[i]->update(script_dt);
+                    bucket.updated_count++;
+                }
+            }
+        }
+        bucket.frame++;
+        bucket.update_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void engine::ScriptScheduler::set_type_settings(std::type_index type, const script_type_settings_t& settings)
+{
+    assert(settings.phase < ScriptUpdatePhase::eCount);
+    auto& bucket = buckets_[get_bucket(type)];
+    const auto phase_changed = bucket.settings.phase != settings.phase;
+    bucket.settings = settings;
+    if (phase_changed)
+    {
+        update_phases();
+    }
+}
+
+void engine::ScriptScheduler::get_stats(std::vector<script_type_stats_t>& out_stats) const
+{
+    out_stats.clear();
+    out_stats.reserve(buckets_.size());
+    for (const auto& bucket : buckets_)
+    {
+        script_type_stats_t stats{};
+        stats.name = bucket.type.name();
+        stats.phase = bucket.settings.phase;
+        stats.has_update = bucket.has_update;
+        stats.scripts_count = static_cast<std::uint32_t>(bucket.scripts.size());
+        stats.updated_count = bucket.has_update ? bucket.updated_count : 0;
+        stats.update_ms = bucket.has_update ? bucket.update_ms : 0.0f;
+        out_stats.push_back(stats);
+    }
+}
+
+std::uint32_t engine::ScriptScheduler::get_bucket(std::type_index type)
+{
+    const auto it = buckets_lookup_.find(type);
+    if (it != buckets_lookup_.end())
+    {
+        return it->second;
+    }
+    const auto bucket_idx = static_cast<std::uint32_t>(buckets_.size());
+    type_bucket_t bucket{};
+    bucket.type = type;
+    buckets_.push_back(std::move(bucket));
+    buckets_lookup_[type] = bucket_idx;
+    update_phases();
+    return bucket_idx;
+}
+
+void engine::ScriptScheduler::update_phases()
+{
+    for (auto& phase : phases_)
+    {
+        phase.clear();
+    }
+    for (std::uint32_t i = 0; i < buckets_.size(); i++)
+    {
+        if (buckets_[i].has_update)
+        {
+            phases_[static_cast<std::size_t>(buckets_[i].settings.phase)].push_back(i);
+        }
+    }
+}
@@ -0,0 +1,280 @@
+#pragma once
+#include "utils.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace engine
+{
+// frame points, at which IScene dispatches events
+enum class EventDispatchPoint : std::uint8_t
+{
+    eBeforeSceneUpdate = 0,  // after pre physics scripts
+    eEndOfFrame,             // after late scripts
+    eCount
+};
+
+struct event_listener_handle_t
+{
+    std::uint32_t queue = UINT32_MAX;
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+
+    bool is_valid() const { return queue != UINT32_MAX; }
+};
+
+struct event_bus_stats_t
+{
+    std::uint32_t queues_count = 0;
+    std::uint32_t listeners_count = 0;
+    std::uint32_t events_sent = 0;        // in the last frame
+    std::uint32_t events_dispatched = 0;  // in the last frame, deliveries to listeners (events without listeners are counted once)
+    std::size_t memory_bytes = 0;         // reserved for events and listeners
+};
+
+namespace detail
+{
+class IEventQueue
+{
+public:
+    virtual ~IEventQueue() = default;
+    virtual void dispatch() = 0;
+    virtual void unsubscribe(std::uint32_t slot, std::uint32_t generation) = 0;
+    virtual void clear() = 0;
+    virtual std::uint32_t get_listeners_count() const = 0;
+    virtual std::size_t get_memory_bytes() const = 0;
+
+    EventDispatchPoint dispatch_point = EventDispatchPoint::eEndOfFrame;
+    std::uint32_t events_sent = 0;
+    std::uint32_t events_dispatched = 0;
+};
+
+template<typename T>
+class EventQueue final : public IEventQueue
+{
+public:
+    using callback_t = void(*)(void* context, const T& event);
+
+    void send(const T& event)
+    {
+        // no allocation, once capacity grows to the peak number of events per frame
+        pending_.push_back(event);
+        events_sent++;
+    }
+
+    void reserve(std::size_t count)
+    {
+        pending_.reserve(count);
+        dispatching_.reserve(count);
+    }
+
+    std::uint32_t subscribe(callback_t callback, void* context, std::uint32_t& out_generation)
+    {
+        assert(callback);
+        std::uint32_t slot = 0;
+        // slots aren't reused during dispatch, so new listener doesn't get events of the current dispatch
+        if (!free_slots_.empty() && !is_dispatching_)
+        {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(listeners_.size());
+            listeners_.push_back({});
+        }
+        auto& listener = listeners_[slot];
+        listener.callback = callback;
+        listener.context = context;
+        out_generation = listener.generation;
+        listeners_count_++;
+        return slot;
+    }
+
+    void unsubscribe(std::uint32_t slot, std::uint32_t generation) override
+    {
+        if (slot >= listeners_.size() || listeners_[slot].generation != generation || !listeners_[slot].callback)
+        {
+            return;
+        }
+        // slot is reused only with the new generation, so stale handles are ignored
+        auto& listener = listeners_[slot];
+        listener.callback = nullptr;
+        listener.context = nullptr;
+        listener.generation++;
+        free_slots_.push_back(slot);
+        listeners_count_--;
+    }
+
+    void dispatch() override
+    {
+        // events sent by listeners during dispatch are delivered in the next dispatch
+        dispatching_.swap(pending_);
+        if (pending_.capacity() < dispatching_.capacity())
+        {
+            pending_.reserve(dispatching_.capacity());
+        }
+        if (dispatching_.empty())
+        {
+            return;
+        }
+        // listener by listener, so each callback walks the contiguous array of events
+        // listeners added during dispatch get events from the next dispatch
+        is_dispatching_ = true;
+        const auto listeners_count = listeners_.size();
+        for (std::size_t i = 0; i < listeners_count; i++)
+        {
+            for (const auto& event : dispatching_)
+            {
+                // listener can be removed by itself or by other listener
+                const auto& listener = listeners_[i];
+                if (!listener.callback)
+                {
+                    break;
+                }
+                listener.callback(listener.context, event);
+                events_dispatched++;
+            }
+        }
+        is_dispatching_ = false;
+        if (listeners_count_ == 0)
+        {
+            events_dispatched += static_cast<std::uint32_t>(dispatching_.size());
+        }
+        dispatching_.clear();
+    }
+
+    void clear() override
+    {
+        pending_.clear();
+        dispatching_.clear();
+    }
+
+    std::uint32_t get_listeners_count() const override { return listeners_count_; }
+    std::size_t get_memory_bytes() const override
+    {
+        return (pending_.capacity() + dispatching_.capacity()) * sizeof(T) + listeners_.capacity() * sizeof(listener_t) + free_slots_.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    struct listener_t
+    {
+        callback_t callback = nullptr;
+        void* context = nullptr;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<T> pending_;
+    std::vector<T> dispatching_;
+    std::vector<listener_t> listeners_;
+    std::vector<std::uint32_t> free_slots_;
+    std::uint32_t listeners_count_ = 0;
+    bool is_dispatching_ = false;
+};
+
+template<typename>
+struct listener_method_traits;
+
+template<typename C, typename E>
+struct listener_method_traits<void (C::*)(const E&)>
+{
+    using class_t = C;
+    using event_t = E;
+};
+} // namespace detail
+
+// Events are plain structs (trivially copyable), queued per type in contiguous arrays and delivered later
+// with dispatch(), so sending is just a copy into the array of the event type.
+// Each listener gets all events of the type in order of sending, listeners get them in order of subscription.
+// Listeners are plain function pointers with context (no std::function), removed in O(1) with the handle.
+// Queues are created on the first use of the event type; queue can be obtained once with get_queue() and used directly,
+// to avoid type lookup on every send.
+class ENGINE_APP_TOOLKIT_API EventBus
+{
+public:
+    EventBus() = default;
+    EventBus(const EventBus& rhs) = delete;
+    EventBus(EventBus&& rhs) noexcept = default;
+    EventBus& operator=(const EventBus& rhs) = delete;
+    EventBus& operator=(EventBus&& rhs) noexcept = default;
+    ~EventBus() = default;
+
+    template<typename T>
+    detail::EventQueue<T>& get_queue()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Events have to be trivially copyable.");
+        const auto idx = get_queue_index(typeid(T));
+        if (!queues_[idx])
+        {
+            queues_[idx] = std::make_unique<detail::EventQueue<T>>();
+        }
+        return static_cast<detail::EventQueue<T>&>(*queues_[idx]);
+    }
+
+    template<typename T>
+    void send(const T& event)
+    {
+        get_queue<T>().send(event);
+    }
+
+    // expected peak number of events of the type per frame
+    template<typename T>
+    void reserve(std::size_t count)
+    {
+        get_queue<T>().reserve(count);
+    }
+
+    template<typename T>
+    void set_dispatch_point(EventDispatchPoint point)
+    {
+        get_queue<T>().dispatch_point = point;
+    }
+
+    template<typename T>
+    event_listener_handle_t subscribe(void(*callback)(void* context, const T& event), void* context = nullptr)
+    {
+        auto& queue = get_queue<T>();
+        event_listener_handle_t handle{};
+        handle.queue = get_queue_index(typeid(T));
+        handle.slot = queue.subscribe(callback, context, handle.generation);
+        return handle;
+    }
+
+    // i.e. subscribe<&Enemy::on_hit>(this)
+    template<auto Method>
+    event_listener_handle_t subscribe(typename detail::listener_method_traits<decltype(Method)>::class_t* object)
+    {
+        using traits_t = detail::listener_method_traits<decltype(Method)>;
+        using event_t = typename traits_t::event_t;
+        return subscribe<event_t>([](void* context, const event_t& event)
+            {
+                (static_cast<typename traits_t::class_t*>(context)->*Method)(event);
+            }, object);
+    }
+
+    // handle is reset, unsubscribing again is no-op
+    void unsubscribe(event_listener_handle_t& handle);
+
+    // delivers events of queues of the given dispatch point
+    void dispatch(EventDispatchPoint point);
+    // stores statistics of the frame and resets counters
+    void end_frame();
+    void clear();
+
+    const event_bus_stats_t& get_stats() const { return stats_; }
+
+private:
+    std::uint32_t get_queue_index(std::type_index type);
+
+private:
+    std::vector<std::unique_ptr<detail::IEventQueue>> queues_;
+    std::unordered_map<std::type_index, std::uint32_t> queues_lookup_;
+    event_bus_stats_t stats_{};
+};
+
+} // namespace engine
@@ -25,6 +25,22 @@ public:
         return scene_manager_.register_scene<T>();
     }
 
+    template<typename T>
+    void load_scene_async(bool activate_when_ready)
+    {
+        scene_manager_.load_scene_async<T>(activate_when_ready);
+    }
+
+    bool is_scene_loading(std::string_view name) const
+    {
+        return scene_manager_.is_scene_loading(name);
+    }
+
+    const scene_load_stats_t* get_scene_load_stats(std::string_view name) const
+    {
+        return scene_manager_.get_scene_load_stats(name);
+    }
+
     IScene* get_scene(std::string_view name)
     {
         return scene_manager_.get_scene(name);
@@ -1,44 +1,26 @@
 #pragma once
 #include "engine.h"
+#include "event_bus.h"
 #include "iscript.h"
+#include "script_scheduler.h"
 #include "utils.h"
 
 #include <unordered_map>
+#include <chrono>
 #include <deque>
-#include <functional>
 #include <memory>
 
 namespace engine
 {
 class SceneManager;
 
-class ENGINE_APP_TOOLKIT_API UserEventSystem
-{
-public:
-    void register_event_callback(std::uint32_t ev_id, std::function<void()>&& callback)
-    {
-        callbacks_[ev_id].push_back(std::move(callback));
-    }
-
-    void activate_event(std::uint32_t ev_id)
-    {
-        for (const auto& listener : callbacks_[ev_id])
-        {
-            listener();
-        }
-    }
-
-
-private:
-    std::unordered_map<std::uint32_t, std::vector<std::function<void()>>> callbacks_;
-};
-
 class IApplication;
 class ENGINE_APP_TOOLKIT_API IScene
 {
 public:
     using ScriptsMap = std::unordered_map<engine_game_object_t, std::unique_ptr<IScript>>;
     using ScriptsQueue = std::deque<IScript*>;
+    using ScriptsRegisterQueue = std::deque<ScriptScheduler::registration_t>;
 
 public:
     IScene(IApplication* app);
@@ -51,15 +33,16 @@ public:
     template<typename T,typename... TArgs>
     T* register_script(TArgs&&... args)
     {
-        scripts_register_queue_.push_back(new T(this, args...));
-        return (T*)scripts_register_queue_.back();
+        auto* t = new T(this, args...);
+        scripts_register_queue_.push_back(ScriptScheduler::make_registration(t));
+        return t;
     }
 
     template<typename T>
     T* register_script(T* t)
     {
-        scripts_register_queue_.push_back(t);
-        return (T*)scripts_register_queue_.back();
+        scripts_register_queue_.push_back(ScriptScheduler::make_registration(t));
+        return t;
     }
 
     template<typename T>
@@ -81,21 +64,39 @@ public:
         return dynamic_cast<const T*>(scripts_.at(go).get());
     }
 
+    // update phase and update rate of all scripts of type T
+    template<typename T>
+    void set_script_type_settings(const script_type_settings_t& settings)
+    {
+        script_scheduler_.set_type_settings<T>(settings);
+    }
+
+    void get_scripts_stats(std::vector<script_type_stats_t>& out_stats) const
+    {
+        script_scheduler_.get_stats(out_stats);
+    }
+
     IApplication* get_app() { return app_; }
     engine_scene_t& get_handle() { return scene_; }
     engine_application_t get_app_handle();
 
+    // Streaming (SceneManager::load_scene_async()), called after construction, before the first update:
+    // background thread: file I/O and parsing (i.e. engineApplicationAllocateModelDescAndLoadDataFromFile()),
+    // must not touch the scene or call engine functions, which aren't thread safe
+    virtual void load_background() {}
+    // main thread: GL uploads and game objects creation, called every frame until it returns true,
+    // should return as soon as deadline is reached
+    virtual bool load_step(std::chrono::steady_clock::time_point deadline) { return true; }
+    // progress of the load_step() work, 0 - 1
+    virtual float get_load_progress() const { return 1.0f; }
+
     virtual void activate();
     virtual void deactivate();
     virtual bool is_active() const;
     virtual engine_result_code_t update(float dt);
     
-    UserEventSystem* get_user_event_sysmte() { return &user_event_system_; }
-
-    virtual void register_event_callback(std::uint32_t event_id, std::function<void()>&& callback)
-    {
-        user_event_system_.register_event_callback(event_id, std::move(callback));
-    }
+    // events are dispatched after pre physics scripts and at the end of the frame (see EventDispatchPoint)
+    EventBus& get_event_bus() { return event_bus_; }
 
 protected:
     virtual void update_hook_begin() {}
@@ -106,9 +107,10 @@ protected:
     engine_scene_t scene_{};
 
     ScriptsMap scripts_{};
-    ScriptsQueue scripts_register_queue_{};
+    ScriptsRegisterQueue scripts_register_queue_{};
     ScriptsQueue scripts_unregister_queue_{};
-    UserEventSystem user_event_system_;
+    ScriptScheduler script_scheduler_;
+    EventBus event_bus_;
     bool is_activate_ = true;
 };
 }
\ No newline at end of file
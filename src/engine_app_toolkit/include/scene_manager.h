@@ -2,6 +2,9 @@
 #include "engine.h"
 #include "utils.h"
 
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <unordered_map>
 #include <string>
 #include <memory>
@@ -12,32 +15,97 @@ namespace engine
 {
 class IScene;
 class IApplication;
+
+enum class SceneLoadState : std::uint8_t
+{
+    eBackground = 0,  // IScene::load_background() running on background thread
+    eMainThread,      // IScene::load_step() called every frame within time budget
+    eReady,
+    eFailed
+};
+
+struct scene_load_stats_t
+{
+    SceneLoadState state = SceneLoadState::eBackground;
+    float progress = 0.0f;  // 0 - 1, first half is background load, second half main thread steps
+    float background_ms = 0.0f;
+    float main_thread_ms = 0.0f;  // sum of all load steps
+    float max_step_ms = 0.0f;  // the longest single frame of load steps
+    std::uint32_t main_thread_frames = 0;
+    float total_ms = 0.0f;  // from request to ready, including construction on main thread
+};
+
 class ENGINE_APP_TOOLKIT_API SceneManager
 {
 public:
     SceneManager(IApplication* app);
-    ~SceneManager() = default;
+    SceneManager(const SceneManager& rhs) = delete;
+    SceneManager(SceneManager&& rhs) noexcept = default;
+    SceneManager& operator=(const SceneManager& rhs) = delete;
+    SceneManager& operator=(SceneManager&& rhs) noexcept = default;
+    ~SceneManager();
+    // advances streamed scenes within time budget and updates all ready scenes
     void update(float dt);
     
+    // constructs and fully loads the scene in this frame
     template<typename T, typename ...TUserArgs>
     T* register_scene(TUserArgs&&... args)
     {
-        if (get_scene(T::get_name()) != nullptr)
+        if (get_scene(T::get_name()) != nullptr || is_scene_loading(T::get_name()))
         {
             throw std::runtime_error("Scene already exists");
         }
         auto ret = std::make_shared<T>(app_, args...);
-        scenes_[T::get_name()] = ret;
+        load_scene_sync(T::get_name(), ret);
         return ret.get();
     }
 
+    // Constructs the scene (on main thread, no updates until loaded), runs IScene::load_background() on background thread
+    // and then IScene::load_step() on main thread within the loading time budget per frame.
+    // Scene becomes visible through get_scene() when loaded; it's activated if activate_when_ready.
+    template<typename T, typename ...TUserArgs>
+    void load_scene_async(bool activate_when_ready, TUserArgs&&... args)
+    {
+        if (get_scene(T::get_name()) != nullptr || is_scene_loading(T::get_name()))
+        {
+            throw std::runtime_error("Scene already exists");
+        }
+        const auto start = std::chrono::steady_clock::now();
+        auto scene = std::make_shared<T>(app_, args...);
+        start_async_load(T::get_name(), scene, activate_when_ready, start);
+    }
+
     IScene* get_scene(std::string_view name);
+    // blocks until background part of loading is finished, if scene is still loading
     void unregister_scene(std::string_view name);
 
+    bool is_scene_loading(std::string_view name) const;
+    // stats of loading (in progress or the last finished) of the scene, nullptr if scene was never loaded
+    const scene_load_stats_t* get_scene_load_stats(std::string_view name) const;
+    // main thread time per frame for load steps of all loading scenes
+    void set_loading_time_budget(float ms) { loading_time_budget_ = std::chrono::duration<float, std::milli>(ms); }
+
+private:
+    struct loading_scene_t
+    {
+        std::shared_ptr<IScene> scene;
+        std::future<void> background;  // declared after scene, so it's destroyed (waits for the load) first
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point main_thread_start;
+        bool activate_when_ready = false;
+    };
+
+    void load_scene_sync(std::string_view name, std::shared_ptr<IScene> scene);
+    void start_async_load(std::string_view name, std::shared_ptr<IScene> scene, bool activate_when_ready, std::chrono::steady_clock::time_point start);
+    void update_loading();
+
 private:
     IApplication* app_ = nullptr;
     std::unordered_map<std::string,std::shared_ptr<IScene>> scenes_;  //ToDo: should use unique_ptr
+    std::unordered_map<std::string, loading_scene_t> loading_scenes_;
+    std::unordered_map<std::string, scene_load_stats_t> load_stats_;
+    std::chrono::duration<float, std::milli> loading_time_budget_{ 4.0f };
 };
 
 
-} // namespace engine
\ No newline at end of file
+} // namespace engine
@@ -0,0 +1,124 @@
+#pragma once
+#include "engine.h"
+#include "iscript.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace engine
+{
+enum class ScriptUpdatePhase : std::uint8_t
+{
+    ePrePhysics = 0,  // before scene update (physics, animations, rendering)
+    ePostPhysics,     // after scene update
+    eLate,            // after all post physics scripts
+    eCount
+};
+
+struct script_type_settings_t
+{
+    ScriptUpdatePhase phase = ScriptUpdatePhase::ePrePhysics;
+    // scripts of the type are split into update_interval groups and one group is updated per frame,
+    // with dt accumulated since its last update
+    std::uint32_t update_interval = 1;
+};
+
+struct script_type_stats_t
+{
+    std::string_view name;
+    ScriptUpdatePhase phase = ScriptUpdatePhase::ePrePhysics;
+    bool has_update = true;
+    std::uint32_t scripts_count = 0;
+    std::uint32_t updated_count = 0;  // in the last frame
+    float update_ms = 0.0f;  // in the last frame
+};
+
+// Updates scripts grouped by concrete type: scripts of the same type are stored in contiguous array
+// and updated one after another, so the same update() code and vtable stay hot in cache.
+// Types are updated in order of their first registration, scripts of the type in order of registration
+// (until some script of the type is removed, removal moves the last script of the type in its place).
+// Types which don't override IScript::update() are never iterated.
+class ENGINE_APP_TOOLKIT_API ScriptScheduler
+{
+public:
+    struct registration_t
+    {
+        IScript* script = nullptr;
+        std::type_index type = typeid(IScript);
+        bool has_update = true;
+    };
+
+    template<typename T>
+    static registration_t make_registration(T* script)
+    {
+        registration_t ret{ script, typeid(*script), true };
+        // override can be checked only if static type is the concrete type of the script
+        if (ret.type == std::type_index(typeid(T)))
+        {
+            ret.has_update = !std::is_same_v<decltype(&T::update), void (IScript::*)(float)>;
+        }
+        return ret;
+    }
+
+public:
+    ScriptScheduler() = default;
+    ScriptScheduler(const ScriptScheduler& rhs) = delete;
+    ScriptScheduler(ScriptScheduler&& rhs) noexcept = default;
+    ScriptScheduler& operator=(const ScriptScheduler& rhs) = delete;
+    ScriptScheduler& operator=(ScriptScheduler&& rhs) noexcept = default;
+    ~ScriptScheduler() = default;
+
+    void add(const registration_t& registration);
+    void remove(IScript* script);
+    void clear();
+
+    // dt in milliseconds
+    void update(ScriptUpdatePhase phase, float dt);
+
+    // shouldn't be called from update() of scripts
+    template<typename T>
+    void set_type_settings(const script_type_settings_t& settings)
+    {
+        set_type_settings(typeid(T), settings);
+    }
+    void set_type_settings(std::type_index type, const script_type_settings_t& settings);
+
+    void get_stats(std::vector<script_type_stats_t>& out_stats) const;
+
+private:
+    struct type_bucket_t
+    {
+        std::type_index type = typeid(IScript);
+        script_type_settings_t settings{};
+        bool has_update = false;
+        std::vector<IScript*> scripts;
+        std::vector<float> pending_dt;  // accumulated dt of the throttled scripts
+        std::uint32_t frame = 0;
+        std::uint32_t updated_count = 0;
+        float update_ms = 0.0f;
+    };
+
+    struct location_t
+    {
+        std::uint32_t bucket = 0;
+        std::uint32_t index = 0;
+    };
+
+    std::uint32_t get_bucket(std::type_index type);
+    void update_phases();
+
+private:
+    std::vector<type_bucket_t> buckets_;
+    std::unordered_map<std::type_index, std::uint32_t> buckets_lookup_;
+    std::unordered_map<IScript*, location_t> locations_;
+    // buckets with update, per phase
+    std::vector<std::uint32_t> phases_[static_cast<std::size_t>(ScriptUpdatePhase::eCount)];
+};
+
+} // namespace engine
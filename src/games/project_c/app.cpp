@@ -8,6 +8,8 @@
 
 #include <chrono>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <fmt/format.h>
 
 //ToDo: find a way to remove this
@@ -24,8 +26,30 @@ inline engine_application_create_desc_t app_cd()
     app_cd.height = K_IS_ANDROID ? 0 : 1080 / 2;
     app_cd.fullscreen = K_IS_ANDROID;
     app_cd.enable_editor = true;
+    app_cd.optimize_meshes = true;
+    app_cd.compress_animations = true;
     return app_cd;
 }
+
+struct prefab_file_t
+{
+    std::string model_file_name;
+    std::string base_dir;
+    bool streamed = false;  // used only by the test scene, loaded when the scene is loaded
+};
+
+const std::unordered_map<project_c::PrefabType, prefab_file_t> K_PREFAB_FILES =
+{
+    { project_c::PREFAB_TYPE_DAGGER,       { "dagger_01.glb", "" }},
+    { project_c::PREFAB_TYPE_SWORD,        { "weapon-sword.glb", "Textures_mini_arena" }},
+    { project_c::PREFAB_TYPE_SOLIDER,      { "character-soldier.glb", "Textures_mini_arena" }},
+    { project_c::PREFAB_TYPE_ORC,          { "character-orc.glb", "Textures_mini_dungeon", true }},
+    { project_c::PREFAB_TYPE_BARREL,       { "barrel.glb", "Textures_mini_dungeon" }},
+    { project_c::PREFAB_TYPE_FLOOR,        { "floor.glb", "Textures_mini_dungeon" }},
+    { project_c::PREFAB_TYPE_FLOOR_DETAIL, { "floor-detail.glb", "Textures_mini_dungeon", true }},
+    { project_c::PREFAB_TYPE_WALL,         { "wall.glb", "Textures_mini_dungeon", true }},
+    { project_c::PREFAB_TYPE_CUBE,         { "cube.glb", "" }},
+};
 }  // namespace anonymous
 
 project_c::AppProjectC::AppProjectC()
@@ -33,33 +57,20 @@ project_c::AppProjectC::AppProjectC()
 {
     const auto load_start = std::chrono::high_resolution_clock::now();
 
+    // optional, loose files are used when the pack is not deployed
+    engineApplicationMountAssetPack(get_handle(), "assets.epak");
+
     if (engineApplicationCreateFontFromFile(get_handle(), "tahoma.ttf", "tahoma_font") != ENGINE_RESULT_CODE_OK)
     {
         log(fmt::format("Couldnt load font!\n"));
         return;
     }
 
-    const std::unordered_map<PrefabType, std::pair<std::string, std::string>> prefabs_data =
-    {
-        { PREFAB_TYPE_DAGGER,       { "dagger_01.glb", ""}},
-        { PREFAB_TYPE_SWORD,        { "weapon-sword.glb", "Textures_mini_arena" }},
-        { PREFAB_TYPE_SOLIDER,      { "character-soldier.glb", "Textures_mini_arena" }},
-        { PREFAB_TYPE_ORC,          { "character-orc.glb", "Textures_mini_dungeon" }},
-        { PREFAB_TYPE_BARREL,       { "barrel.glb", "Textures_mini_dungeon" }},
-        { PREFAB_TYPE_FLOOR,        { "floor.glb", "Textures_mini_dungeon" }},
-        { PREFAB_TYPE_FLOOR_DETAIL, { "floor-detail.glb", "Textures_mini_dungeon" }},
-        { PREFAB_TYPE_WALL,         { "wall.glb", "Textures_mini_dungeon" }},
-        { PREFAB_TYPE_CUBE,         { "cube.glb", ""}},
-    };
-
-    for (const auto& [type, file_and_basedir] : prefabs_data)
+    for (const auto& [type, prefab_file] : K_PREFAB_FILES)
     {
-        const auto& [model_file_name, base_dir] = file_and_basedir;
-        engine_result_code_t engine_error_code = ENGINE_RESULT_CODE_FAIL;
-        prefabs_[type] = std::move(Prefab(engine_error_code, get_handle(), model_file_name, base_dir));
-        if (engine_error_code != ENGINE_RESULT_CODE_OK)
+        if (!prefab_file.streamed && load_prefab_model(type))
         {
-            log(fmt::format("Failed loading prefab: {}\n", type));
+            create_prefab(type);
         }
     }
 
@@ -115,6 +126,52 @@ project_c::PrefabResult project_c::AppProjectC::instantiate_prefab(PrefabType ty
     return prefab.instantiate(scene);
 }
 
+bool project_c::AppProjectC::load_prefab_model(PrefabType type)
+{
+    auto& prefab = prefabs_[type];
+    if (prefab.is_model_loaded())
+    {
+        return true;
+    }
+    const auto& prefab_file = K_PREFAB_FILES.at(type);
+    if (prefab.load_model(get_handle(), prefab_file.model_file_name, prefab_file.base_dir) != ENGINE_RESULT_CODE_OK)
+    {
+        log(fmt::format("Failed loading prefab: {}\n", type));
+        return false;
+    }
+    return true;
+}
+
+void project_c::AppProjectC::create_prefab(PrefabType type)
+{
+    auto& prefab = prefabs_[type];
+    if (prefab.is_valid() || !prefab.is_model_loaded())
+    {
+        return;
+    }
+    if (prefab.create() != ENGINE_RESULT_CODE_OK)
+    {
+        log(fmt::format("Failed creating prefab: {}\n", type));
+    }
+}
+
+std::vector<engine_game_object_t> project_c::AppProjectC::instantiate_prefabs(PrefabType type, std::uint32_t count, engine::IScene* scene)
+{
+    if (type >= PREFAB_TYPE_COUNT)
+    {
+        log(fmt::format("Invalid prefab type: {}\n", type));
+        return std::vector<engine_game_object_t>(count, ENGINE_INVALID_GAME_OBJECT_ID);
+    }
+
+    const auto& prefab = prefabs_[type];
+    if (!prefab.is_valid())
+    {
+        log(fmt::format("Prefab: {} is not valid\n", type));
+        return std::vector<engine_game_object_t>(count, ENGINE_INVALID_GAME_OBJECT_ID);
+    }
+    return prefab.instantiate(scene, count);
+}
+
 void project_c::AppProjectC::run()
 {
     struct fps_counter_t
@@ -123,6 +180,8 @@ void project_c::AppProjectC::run()
         std::uint32_t frames_count = 0;
     };
     fps_counter_t fps_counter{};
+    // test scene is streamed in, while city scene is still active
+    bool switch_to_streamed_scene = false;
 
     while (true)
     {
@@ -153,24 +212,42 @@ void project_c::AppProjectC::run()
         auto scene_city = get_scene(CityScene::get_name());
         if (engineApplicationIsKeyboardButtonDown(get_handle(), ENGINE_KEYBOARD_KEY_5))
         {
-            if (scene)
+            if (scene || is_scene_loading(TestScene::get_name()))
             {
+                // cancels loading, blocks until background part of the load is finished
                 unregister_scene(TestScene::get_name());
             }
+            switch_to_streamed_scene = false;
             scene_city->activate();
         }
         else if (engineApplicationIsKeyboardButtonDown(get_handle(), ENGINE_KEYBOARD_KEY_6))
         {
-            if (!scene)
+            if (scene)
+            {
+                scene->activate();
+                scene_city->deactivate();
+            }
+            else if (!is_scene_loading(TestScene::get_name()))
             {
-                register_scene<project_c::TestScene>();
-                scene = get_scene(TestScene::get_name());
+                // city stays active until test scene is streamed in
+                load_scene_async<project_c::TestScene>(false);
+                switch_to_streamed_scene = true;
             }
-            scene->activate();
-            scene_city->deactivate();
         }
         update_scenes(frame_begin.delta_time);
 
+        // switched after the update, so both scenes are never updated in the same frame
+        if (switch_to_streamed_scene && !is_scene_loading(TestScene::get_name()))
+        {
+            switch_to_streamed_scene = false;
+            const auto* load_stats = get_scene_load_stats(TestScene::get_name());
+            if (load_stats && load_stats->state == engine::SceneLoadState::eReady)
+            {
+                get_scene(TestScene::get_name())->activate();
+                scene_city->deactivate();
+            }
+        }
+
         const auto frame_end = engineApplicationFrameEnd(get_handle());
         if (!frame_end.success)
         {
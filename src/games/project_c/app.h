@@ -12,6 +12,7 @@
 #include <fmt/chrono.h>
 
 #include <array>
+#include <vector>
 
 
 namespace project_c
@@ -23,7 +24,14 @@ public:
     AppProjectC();
     ~AppProjectC();
 
+    // Prefabs used only by the test scene are loaded by the scene (see TestScene::load_background()).
+    // load_prefab_model() does only file I/O and can be called from background thread, when no other thread uses the same prefab type.
+    bool load_prefab_model(PrefabType type);
+    // main thread, after load_prefab_model()
+    void create_prefab(PrefabType type);
+
     PrefabResult instantiate_prefab(PrefabType type, engine::IScene* scene);
+    std::vector<engine_game_object_t> instantiate_prefabs(PrefabType type, std::uint32_t count, engine::IScene* scene);
     void run();
 
 private:
@@ -3,7 +3,9 @@
 
 #include <engine.h>
 
+#include <cstdint>
 #include <vector>
+#include <string>
 #include <string_view>
 
 namespace engine
@@ -22,6 +24,7 @@ struct PrefabResult
 
 struct Prefab
 {
+    // loads the model and creates the prefab, same as load_model() followed by create()
     Prefab(engine_result_code_t& engine_error_code, engine_application_t& app, std::string_view model_file_name, std::string_view base_dir = "");
     Prefab() = default;
     // delete copy constructor and default move constructor
@@ -31,14 +34,25 @@ struct Prefab
     Prefab& operator=(Prefab&& rhs) noexcept;
     ~Prefab();
 
+    // file I/O and parsing of the model only, can be called from background thread (see IScene::load_background())
+    engine_result_code_t load_model(engine_application_t app, std::string_view model_file_name, std::string_view base_dir = "");
+    // geometries, textures, materials and animation clips of the loaded model, main thread
+    engine_result_code_t create();
+
     PrefabResult instantiate(engine::IScene* scene) const;
+    // all instances are created in one batch, only root game objects are returned (without animation controllers)
+    std::vector<engine_game_object_t> instantiate(engine::IScene* scene, std::uint32_t count) const;
+    bool is_model_loaded() const;
     bool is_valid() const;
 
 private:
     engine_application_t app_ = nullptr;
+    std::string model_file_name_;
     engine_model_desc_t model_info_ = {};
     std::vector<engine_geometry_t> geometries_ = {};
     std::vector<engine_material_component_t> materials_;
     std::vector<engine_texture2d_t> textures_ = {};
+    std::vector<engine_animation_clip_t> animation_clips_ = {};
+    engine_prefab_t prefab_ = nullptr;
 };
 }
\ No newline at end of file
@@ -15,11 +15,14 @@ project_c::CityScene::CityScene(engine::IApplication* app)
     auto typed_app = dynamic_cast<AppProjectC*>(app);
     register_script<project_c::Solider>(typed_app->instantiate_prefab(project_c::PREFAB_TYPE_SOLIDER, this));
 
+    // floors don't have animations, so all of them are created in one batch
+    const auto floors = typed_app->instantiate_prefabs(project_c::PREFAB_TYPE_FLOOR, 10 * 6, this);
+    auto floor = floors.begin();
     for (std::int32_t i = -5; i < 5; i++)
     {
         for (std::int32_t j = -3; j < 3; j++)
         {
-            register_script<project_c::Floor>(typed_app->instantiate_prefab(project_c::PREFAB_TYPE_FLOOR, this).go, i, j);
+            register_script<project_c::Floor>(*floor++, i, j);
         }
     }
     register_script<MainLight>();
@@ -8,8 +8,10 @@
 
 #include "../nav_mesh.h"
 
+#include <array>
 #include <random>
 #include <chrono>
+#include <string_view>
 
 namespace
 {
@@ -62,11 +64,41 @@ private:
 };
 
 
-inline void generate_scene(std::string_view scene_str, project_c::NavMesh& nav_mesh, project_c::AppProjectC& app, engine::IScene& scene)
+// level layout: walls (x), floors with spawn points of the solider (s), enemy packs (e) and point lights (p)
+constexpr std::string_view K_LEVEL =
+    //"xxxxxxxxxxx\n"
+    //"x         x\n"
+    //"x         x\n"
+    //"x         x\n"
+    //"x         x\n"
+    //"x     x   x\n"
+    //"xxxxxxxxxxx\n"
+    //"x    p    x\n"
+    "x         x\n"
+    "x     ee  x\n"
+    "xs    ee  x\n"
+    "x     ee  x\n"
+    "x         x\n";
+    //"xxxxxxxxxxx\n";
+
+// models of the level, prefabs used only by this scene are loaded when the scene is loaded
+constexpr std::array<project_c::PrefabType, 5> K_LEVEL_PREFABS =
 {
+    project_c::PREFAB_TYPE_WALL,
+    project_c::PREFAB_TYPE_FLOOR,
+    project_c::PREFAB_TYPE_FLOOR_DETAIL,
+    project_c::PREFAB_TYPE_SOLIDER,
+    project_c::PREFAB_TYPE_ORC,
+};
+
+// doesn't call engine, so it's used on background thread
+inline std::vector<project_c::TestScene::level_object_t> parse_level(std::string_view scene_str, project_c::NavMesh& nav_mesh)
+{
+    using LevelObjectType = project_c::TestScene::LevelObjectType;
     std::mt19937 rng(42);
     std::uniform_int_distribution<std::mt19937::result_type> dist6(0, 1);
 
+    std::vector<project_c::TestScene::level_object_t> objects;
     struct SceneSpawnPoints
     {
         std::vector<engine_coords_2d_t> solider;
@@ -92,12 +124,12 @@ inline void generate_scene(std::string_view scene_str, project_c::NavMesh& nav_m
             const auto z_offset = (float)std::int32_t(z - scene_height / 2);
             if (c == 'x')
             {
-                scene.register_script<project_c::Wall>(app.instantiate_prefab(project_c::PREFAB_TYPE_WALL, &scene).go, x_offset, z_offset);
+                objects.push_back({ LevelObjectType::eWall, project_c::PREFAB_TYPE_WALL, x_offset, z_offset });
             }
             else
             {
                 auto flor_moodel = dist6(rng) ? project_c::PREFAB_TYPE_FLOOR_DETAIL : project_c::PREFAB_TYPE_FLOOR;
-                scene.register_script<project_c::Floor>(app.instantiate_prefab(flor_moodel, &scene).go, x_offset, z_offset);
+                objects.push_back({ LevelObjectType::eFloor, flor_moodel, x_offset, z_offset });
                 const auto id = nav_mesh.add_node({ x_offset, 0.0f, z_offset }, { 0.5f, 0.0f, 0.5f });
                 nodes_id[x][z] = id;
             }
@@ -207,24 +239,58 @@ inline void generate_scene(std::string_view scene_str, project_c::NavMesh& nav_m
 
     for (const auto& point : scene_spawn_points.solider)
     {
-        auto s = scene.register_script<project_c::Solider>(app.instantiate_prefab(project_c::PREFAB_TYPE_SOLIDER, &scene));
-        s->set_world_position(point.x, 0.0f, point.y);
+        objects.push_back({ LevelObjectType::eSolider, project_c::PREFAB_TYPE_SOLIDER, point.x, point.y });
     }
 
     for (const auto& point : scene_spawn_points.enemy_packs)
     {
-        EnemyPack pack{ {project_c::PrefabType::PREFAB_TYPE_ORC} };
+        objects.push_back({ LevelObjectType::eEnemyPack, project_c::PREFAB_TYPE_ORC, point.x, point.y });
+    }
+
+    for (const auto& point : scene_spawn_points.point_lights)
+    {
+        objects.push_back({ LevelObjectType::ePointLight, project_c::PREFAB_TYPE_COUNT, point.x, point.y });
+    }
+    return objects;
+}
+
+inline void spawn_level_object(const project_c::TestScene::level_object_t& object, const project_c::NavMesh& nav_mesh, project_c::AppProjectC& app, engine::IScene& scene)
+{
+    using LevelObjectType = project_c::TestScene::LevelObjectType;
+    switch (object.type)
+    {
+    case LevelObjectType::eWall:
+    {
+        scene.register_script<project_c::Wall>(app.instantiate_prefab(object.prefab, &scene).go, object.x, object.z);
+        break;
+    }
+    case LevelObjectType::eFloor:
+    {
+        scene.register_script<project_c::Floor>(app.instantiate_prefab(object.prefab, &scene).go, object.x, object.z);
+        break;
+    }
+    case LevelObjectType::eSolider:
+    {
+        auto s = scene.register_script<project_c::Solider>(app.instantiate_prefab(object.prefab, &scene));
+        s->set_world_position(object.x, 0.0f, object.z);
+        break;
+    }
+    case LevelObjectType::eEnemyPack:
+    {
+        EnemyPack pack{ { object.prefab } };
         MobPackSpawner spawner;
         const auto spawn_area = MobPackSpawner::SpawnAreaRect{ -1.0f, 1.0f, -1.0f, 1.0f };
         //const auto spawn_area = MobPackSpawner::SpawnAreaRect{ 0.0f, 0.0f, 0.0f, 0.0f };
-        const auto spawn_world_pos = MobPackSpawner::Point{ point.x, point.y };
+        const auto spawn_world_pos = MobPackSpawner::Point{ object.x, object.z };
         spawner.spawn(pack, 1, spawn_world_pos, spawn_area, nav_mesh, app, scene);
+        break;
     }
-
-    for (const auto& point : scene_spawn_points.point_lights)
+    case LevelObjectType::ePointLight:
     {
         auto l = scene.register_script<project_c::PointLight>();
-        l->set_world_position(point.x, 1.0f, point.y);
+        l->set_world_position(object.x, 1.0f, object.z);
+        break;
+    }
     }
 }
 
@@ -255,25 +321,46 @@ project_c::TestScene::TestScene(engine::IApplication* app)
         engineUiDocumentShow(ui_data_.doc);
     }
 
-    const std::string scene_str =
-        //"xxxxxxxxxxx\n"
-        //"x         x\n"
-        //"x         x\n"
-        //"x         x\n"
-        //"x         x\n"
-        //"x     x   x\n"
-        //"xxxxxxxxxxx\n"
-        //"x    p    x\n"
-        "x         x\n"
-        "x     ee  x\n"
-        "xs    ee  x\n"
-        "x     ee  x\n"
-        "x         x\n";
-        //"xxxxxxxxxxx\n";
     register_script<MainLight>();
-    auto typed_app = static_cast<AppProjectC*>(app);
-    generate_scene(scene_str, nav_mesh_, *typed_app, *this);
+}
+
+void project_c::TestScene::load_background()
+{
+    auto typed_app = static_cast<AppProjectC*>(get_app());
+    for (const auto type : K_LEVEL_PREFABS)
+    {
+        typed_app->load_prefab_model(type);
+    }
+    level_objects_ = parse_level(K_LEVEL, nav_mesh_);
+}
+
+bool project_c::TestScene::load_step(std::chrono::steady_clock::time_point deadline)
+{
+    auto typed_app = static_cast<AppProjectC*>(get_app());
+    // deadline is checked after every prefab and object, so every step makes progress
+    while (prefabs_created_ < K_LEVEL_PREFABS.size())
+    {
+        typed_app->create_prefab(K_LEVEL_PREFABS[prefabs_created_++]);
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+    }
+    while (objects_spawned_ < level_objects_.size())
+    {
+        spawn_level_object(level_objects_[objects_spawned_++], nav_mesh_, *typed_app, *this);
+        if (objects_spawned_ < level_objects_.size() && std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
+float project_c::TestScene::get_load_progress() const
+{
+    const auto total = K_LEVEL_PREFABS.size() + level_objects_.size();
+    return static_cast<float>(prefabs_created_ + objects_spawned_) / static_cast<float>(total);
 }
 
 project_c::TestScene::~TestScene()
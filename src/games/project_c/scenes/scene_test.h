@@ -4,8 +4,10 @@
 #include "engine.h"
 #include "iscene.h"
 #include "../nav_mesh.h"
+#include "../prefab_types.h"
 
 #include <cstdint>
+#include <vector>
 
 namespace project_c
 {
@@ -41,6 +43,29 @@ public:
         }
     }
 
+    enum class LevelObjectType
+    {
+        eWall,
+        eFloor,
+        eSolider,
+        eEnemyPack,
+        ePointLight
+    };
+
+    struct level_object_t
+    {
+        LevelObjectType type;
+        PrefabType prefab;
+        float x;
+        float z;
+    };
+
+    // parses the level into objects and nav mesh, and loads models of level prefabs
+    void load_background() override;
+    // creates level prefabs and then spawns level objects, until the deadline
+    bool load_step(std::chrono::steady_clock::time_point deadline) override;
+    float get_load_progress() const override;
+
     void update_hook_begin() override
     {
         engineUiDataHandleDirtyVariable(ui_data_.handle, "character_health");
@@ -53,6 +78,9 @@ public:
 private:
     UI_data ui_data_;
     NavMesh nav_mesh_;
+    std::vector<level_object_t> level_objects_;
+    std::size_t prefabs_created_ = 0;
+    std::size_t objects_spawned_ = 0;
 };
 
 }// namespace project_c
\ No newline at end of file
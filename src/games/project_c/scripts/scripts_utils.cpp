@@ -16,7 +16,7 @@ void project_c::utils::delete_game_objects_hierarchy(engine_scene_t scene, engin
             if (cc.child[i] != ENGINE_INVALID_GAME_OBJECT_ID)
             {
                 delete_game_objects_hierarchy(scene, cc.child[i]);
-                engineSceneDestroyGameObject(scene, cc.child[i]);
+                engineSceneCommandBufferDestroyGameObject(scene, cc.child[i]);
             }
         }
     }
@@ -0,0 +1,198 @@
+#include "animation.h"
+#include "gltf_parser.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Builds clips of growing length and samples them through AnimationClip::sample, checks, that:
+// - playback with cursors kept between frames gives the same pose as sampling with reset cursors (binary search),
+// - cost of the playback sample stays flat as clip gets longer (cursor finds next key without search).
+// Prints cost of the playback and of random seeks per track.
+// Returns non zero when any of the checks fails.
+namespace
+{
+constexpr std::uint32_t K_BONES_COUNT = 16;
+constexpr float K_KEYS_PER_SECOND = 30.0f;
+constexpr float K_PLAYBACK_DT = 1.0f / 60.0f;
+constexpr std::uint32_t K_SEEKS_COUNT = 20000;
+// short clips are played repeatedly, so all measurements have similar number of samples
+constexpr std::uint32_t K_MIN_PLAYBACK_SAMPLES = 32768;
+// playback of the longest clip can be this many times slower than of the shortest one (cache misses),
+// binary search grows with keys count
+constexpr double K_MAX_PLAYBACK_GROWTH = 2.0;
+
+// translation, rotation and scale track for each bone, values change every key
+std::pair<engine::AnimationClipInfo, engine::ModelInfo> build_clip(std::uint32_t keys_count)
+{
+    engine::ModelInfo model{};
+    engine::AnimationClipInfo clip{};
+    clip.name = "clip_" + std::to_string(keys_count);
+    for (std::uint32_t bone = 0; bone < K_BONES_COUNT; bone++)
+    {
+        auto node = std::make_shared<engine::ModelNode>();
+        node->name = "bone_" + std::to_string(bone);
+        node->index = static_cast<std::int32_t>(bone);
+        model.nodes.push_back(node);
+
+        for (const auto type : { engine::AnimationChannelType::eTranslation, engine::AnimationChannelType::eRotation, engine::AnimationChannelType::eScale })
+        {
+            engine::AnimationChannelInfo channel{};
+            channel.type = type;
+            channel.target_node_idx = node->index;
+            for (std::uint32_t key = 0; key < keys_count; key++)
+            {
+                const auto time = static_cast<float>(key) / K_KEYS_PER_SECOND;
+                const auto phase = time * 3.0f + static_cast<float>(bone);
+                channel.timestamps.push_back(time);
+                if (type == engine::AnimationChannelType::eRotation)
+                {
+                    // unit quaternion (x, y, z, w) around y axis
+                    channel.data.insert(channel.data.end(), { 0.0f, std::sin(0.5f * phase), 0.0f, std::cos(0.5f * phase) });
+                }
+                else
+                {
+                    const auto base = type == engine::AnimationChannelType::eScale ? 1.0f : 0.0f;
+                    channel.data.insert(channel.data.end(), { base + 0.1f * std::sin(phase), base + 0.1f * std::cos(phase), base });
+                }
+            }
+            clip.channels.push_back(std::move(channel));
+        }
+    }
+    return { std::move(clip), std::move(model) };
+}
+
+engine::Pose make_pose()
+{
+    engine::Pose ret{};
+    ret.translations.resize(K_BONES_COUNT, glm::vec4(0.0f));
+    ret.rotations.resize(K_BONES_COUNT, glm::identity<glm::quat>());
+    ret.scales.resize(K_BONES_COUNT, glm::vec4(1.0f));
+    return ret;
+}
+
+bool equal_poses(const engine::Pose& a, const engine::Pose& b)
+{
+    constexpr float K_EPSILON = 1e-6f;
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        for (glm::length_t c = 0; c < 4; c++)
+        {
+            if (std::abs(a.translations[i][c] - b.translations[i][c]) > K_EPSILON
+                || std::abs(a.rotations[i][c] - b.rotations[i][c]) > K_EPSILON
+                || std::abs(a.scales[i][c] - b.scales[i][c]) > K_EPSILON)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct result_t
+{
+    std::uint32_t mismatches = 0;
+    double playback_ns = 0.0;  // per track
+    double seek_ns = 0.0;  // per track
+};
+
+result_t run(std::mt19937& rng, std::uint32_t keys_count)
+{
+    const auto [clip_info, model] = build_clip(keys_count);
+    const engine::AnimationClip clip(clip_info, model);
+
+    std::vector<std::uint32_t> bones(K_BONES_COUNT);
+    for (std::uint32_t i = 0; i < K_BONES_COUNT; i++)
+    {
+        bones[i] = i;
+    }
+    std::vector<std::uint32_t> cursors(clip.get_tracks_count(), 0);
+    std::vector<std::uint32_t> reset_cursors(clip.get_tracks_count(), 0);
+    auto pose = make_pose();
+    auto reference_pose = make_pose();
+
+    result_t ret{};
+    // correctness of the playback, on the slice of the clip, so the check doesn't grow with the clip
+    const auto checked_duration = std::min(clip.get_duration(), 2.0f);
+    for (float time = 0.0f; time < checked_duration; time += K_PLAYBACK_DT)
+    {
+        clip.sample(time, bones, cursors, pose);
+        std::fill(reset_cursors.begin(), reset_cursors.end(), 0u);
+        clip.sample(time, bones, reset_cursors, reference_pose);
+        ret.mismatches += !equal_poses(pose, reference_pose);
+    }
+
+    // playback of the whole clip, cursors move at most one key per frame
+    std::fill(cursors.begin(), cursors.end(), 0u);
+    std::uint32_t samples_count = 0;
+    const auto playback_start = std::chrono::steady_clock::now();
+    while (samples_count < K_MIN_PLAYBACK_SAMPLES)
+    {
+        for (float time = 0.0f; time < clip.get_duration(); time += K_PLAYBACK_DT)
+        {
+            clip.sample(time, bones, cursors, pose);
+            samples_count++;
+        }
+    }
+    const auto playback_end = std::chrono::steady_clock::now();
+
+    std::uniform_real_distribution<float> distribution(0.0f, clip.get_duration());
+    std::vector<float> seeks(K_SEEKS_COUNT);
+    for (auto& seek : seeks)
+    {
+        seek = distribution(rng);
+    }
+    const auto seek_start = std::chrono::steady_clock::now();
+    for (const auto time : seeks)
+    {
+        clip.sample(time, bones, cursors, pose);
+    }
+    const auto seek_end = std::chrono::steady_clock::now();
+
+    const auto tracks_count = static_cast<double>(clip.get_tracks_count());
+    ret.playback_ns = std::chrono::duration<double, std::nano>(playback_end - playback_start).count() / (samples_count * tracks_count);
+    ret.seek_ns = std::chrono::duration<double, std::nano>(seek_end - seek_start).count() / (K_SEEKS_COUNT * tracks_count);
+    return ret;
+}
+
+}  // namespace anonymous
+
+int main()
+{
+    std::mt19937 rng(7);
+    bool ok = true;
+    std::vector<result_t> results;
+    constexpr std::uint32_t keys_counts[] = { 32, 256, 2048, 16384 };
+    for (const auto keys_count : keys_counts)
+    {
+        const auto result = run(rng, keys_count);
+        std::cout << "keys per track " << keys_count << ": playback " << result.playback_ns << " ns, seek " << result.seek_ns << " ns per track\n";
+        if (result.mismatches)
+        {
+            std::cout << "[FAILED] " << keys_count << " keys: " << result.mismatches << " playback poses differ from sampling with reset cursors\n";
+            ok = false;
+        }
+        results.push_back(result);
+    }
+
+    const auto growth = results.back().playback_ns / results.front().playback_ns;
+    const auto name = "playback of " + std::to_string(keys_counts[0]) + " to " + std::to_string(keys_counts[std::size(keys_counts) - 1]) + " keys";
+    if (growth > K_MAX_PLAYBACK_GROWTH)
+    {
+        std::cout << "[FAILED] " << name << " is " << growth << " times slower\n";
+        ok = false;
+    }
+    else
+    {
+        std::cout << "[OK] " << name << " (" << growth << " times)\n";
+    }
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "crowd.h"
+#include "physics_world.h"
+#include "logger.h"
+
+#include <btBulletDynamicsCommon.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Runs CrowdSystem::update of two opposing streams of agents with the same per frame order as the scene
+// (crowd update, transforms pushed to rigid bodies, physics step, rigid bodies synced back to transforms)
+// and counts contacts reported by PhysicsWorld::get_collisions(). Prints cost of the crowd update and
+// contacts with and without avoidance, for 100 and 1000 agents, and checks, that:
+// - avoidance reduces the number of agent pairs in contact,
+// - crowd stats count all agents.
+// Returns non zero when any of the checks fails.
+namespace
+{
+constexpr float K_AGENT_RADIUS = 0.5f;
+constexpr float K_AGENT_MAX_SPEED = 2.0f;
+constexpr float K_AGENT_SPACING = 1.5f;
+// streams start this far apart and pass through each other within the simulated time
+constexpr float K_STREAMS_GAP = 4.0f;
+constexpr float K_DT_MS = 1000.0f / 60.0f;
+constexpr std::uint32_t K_FRAMES_COUNT = 900;
+
+struct result_t
+{
+    double crowd_update_ms = 0.0;
+    double physics_update_ms = 0.0;
+    double contact_pairs_avg = 0.0;
+    std::size_t contact_pairs_max = 0;
+    double contact_points_avg = 0.0;
+    std::uint32_t agents_count = 0;
+};
+
+// two blocks of agents, the left one walks to +x and the right one to -x, enemies of the game have the same mass 1 rigid bodies
+std::vector<entt::entity> create_agents(engine::registry_t& registry, engine::PhysicsWorld& physics_world, std::uint32_t agents_count)
+{
+    const auto per_stream = agents_count / 2;
+    const auto rows = std::max(1u, static_cast<std::uint32_t>(std::sqrt(static_cast<float>(per_stream)) * 1.25f));
+    const auto columns = (per_stream + rows - 1) / rows;
+    const auto block_width = static_cast<float>(columns - 1) * K_AGENT_SPACING;
+
+    std::vector<entt::entity> entities;
+    entities.reserve(agents_count);
+    for (std::uint32_t i = 0; i < agents_count; i++)
+    {
+        const auto stream = i / per_stream;
+        const auto index = i % per_stream;
+        const auto direction = stream == 0 ? 1.0f : -1.0f;
+        const auto column = static_cast<float>(index / rows);
+        const auto row = static_cast<float>(index % rows);
+
+        engine_tranform_component_t transform{};
+        transform.position[0] = -direction * (0.5f * K_STREAMS_GAP + block_width - column * K_AGENT_SPACING);
+        // rows of the second stream are shifted by half of the spacing, so agents don't meet exactly head on
+        transform.position[2] = row * K_AGENT_SPACING + (stream == 0 ? 0.0f : 0.5f * K_AGENT_SPACING);
+        std::fill(std::begin(transform.scale), std::end(transform.scale), 1.0f);
+        transform.rotation[3] = 1.0f;
+
+        engine_nav_agent_component_t agent{};
+        agent.radius = K_AGENT_RADIUS;
+        agent.max_speed = K_AGENT_MAX_SPEED;
+        agent.preferred_velocity[0] = direction * K_AGENT_MAX_SPEED;
+
+        engine_collider_component_t collider{};
+        collider.type = ENGINE_COLLIDER_TYPE_SPHERE;
+        collider.collider.sphere.radius = K_AGENT_RADIUS;
+
+        engine_rigid_body_component_t rigid_body{};
+        rigid_body.mass = 1.0f;
+
+        const auto entity = registry.create();
+        registry.emplace<engine_tranform_component_t>(entity, transform);
+        registry.emplace<engine_nav_agent_component_t>(entity, agent);
+        registry.emplace<engine::PhysicsWorld::physcic_internal_component_t>(entity,
+            physics_world.create_rigid_body(collider, rigid_body, transform, static_cast<std::int32_t>(entity)));
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+result_t run(std::uint32_t agents_count, bool avoidance)
+{
+    engine::registry_t registry;
+    engine::PhysicsWorld physics_world(nullptr);
+    physics_world.set_gravity(std::array<float, 3>{ 0.0f, 0.0f, 0.0f });
+
+    engine::CrowdSystem crowd_system;
+    auto settings = crowd_system.get_settings();
+    if (!avoidance)
+    {
+        settings.max_neighbours = 0;
+    }
+    crowd_system.set_settings(settings);
+
+    const auto entities = create_agents(registry, physics_world, agents_count);
+
+    result_t ret{};
+    for (std::uint32_t frame = 0; frame < K_FRAMES_COUNT; frame++)
+    {
+        crowd_system.update(registry, K_DT_MS);
+        ret.crowd_update_ms += crowd_system.get_stats().update_ms;
+        ret.agents_count = crowd_system.get_stats().agents_count;
+
+        const auto start = std::chrono::steady_clock::now();
+        // same as transform update observer of the scene
+        for (const auto entity : entities)
+        {
+            const auto& transform = registry.get<engine_tranform_component_t>(entity);
+            auto* rigid_body = registry.get<engine::PhysicsWorld::physcic_internal_component_t>(entity).rigid_body;
+            auto world_transform = rigid_body->getWorldTransform();
+            world_transform.setOrigin(btVector3(transform.position[0], transform.position[1], transform.position[2]));
+            rigid_body->activate(true);
+            rigid_body->setWorldTransform(world_transform);
+        }
+
+        physics_world.update(K_DT_MS / 1000.0f);
+
+        std::size_t contact_pairs = 0;
+        std::size_t contact_points = 0;
+        for (const auto& collision : physics_world.get_collisions())
+        {
+            contact_pairs++;
+            contact_points += collision.contact_points_count;
+        }
+        ret.contact_pairs_avg += static_cast<double>(contact_pairs);
+        ret.contact_pairs_max = std::max(ret.contact_pairs_max, contact_pairs);
+        ret.contact_points_avg += static_cast<double>(contact_points);
+
+        // same as the sync of dynamic rigid bodies after the physics step of the scene
+        for (const auto entity : entities)
+        {
+            const auto origin = registry.get<engine::PhysicsWorld::physcic_internal_component_t>(entity).rigid_body->getWorldTransform().getOrigin();
+            registry.patch<engine_tranform_component_t>(entity, [&](auto& transform)
+                {
+                    transform.position[0] = origin.getX();
+                    transform.position[1] = origin.getY();
+                    transform.position[2] = origin.getZ();
+                });
+        }
+        ret.physics_update_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    for (const auto entity : entities)
+    {
+        auto* collision_shape = registry.get<engine::PhysicsWorld::physcic_internal_component_t>(entity).collision_shape;
+        physics_world.remove_rigid_body(registry, entity);
+        delete collision_shape;
+    }
+
+    ret.crowd_update_ms /= K_FRAMES_COUNT;
+    ret.physics_update_ms /= K_FRAMES_COUNT;
+    ret.contact_pairs_avg /= K_FRAMES_COUNT;
+    ret.contact_points_avg /= K_FRAMES_COUNT;
+    return ret;
+}
+
+void print(std::uint32_t agents_count, bool avoidance, const result_t& result)
+{
+    std::cout << "agents " << agents_count << (avoidance ? ", avoidance on: " : ", avoidance off: ")
+        << result.crowd_update_ms << " ms crowd update, " << result.physics_update_ms << " ms physics, "
+        << "contact pairs per frame avg " << result.contact_pairs_avg << " max " << result.contact_pairs_max
+        << ", contact points per frame avg " << result.contact_points_avg << "\n";
+}
+
+}  // namespace anonymous
+
+int main()
+{
+    bool ok = true;
+    for (const std::uint32_t agents_count : { 100u, 1000u })
+    {
+        const auto without_avoidance = run(agents_count, false);
+        const auto with_avoidance = run(agents_count, true);
+        print(agents_count, false, without_avoidance);
+        print(agents_count, true, with_avoidance);
+
+        const auto name = std::to_string(agents_count) + " agents";
+        if (with_avoidance.agents_count != agents_count)
+        {
+            std::cout << "[FAILED] " << name << ": crowd stats count " << with_avoidance.agents_count << " agents\n";
+            ok = false;
+        }
+        else if (with_avoidance.contact_pairs_avg >= without_avoidance.contact_pairs_avg)
+        {
+            std::cout << "[FAILED] " << name << ": avoidance doesn't reduce contacts\n";
+            ok = false;
+        }
+        else
+        {
+            std::cout << "[OK] " << name << "\n";
+        }
+    }
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
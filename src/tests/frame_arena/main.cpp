@@ -0,0 +1,155 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Checks FrameArena on its own: frames of container work shaped like the scene update (hierarchy and skinning
+// scratch arrays), not Scene::update itself, which needs a render context. Checks, that:
+// - after warm up, the arena doesn't allocate from the heap (counted by the global operator new),
+// - data allocated in the frame stays valid until the end of the next frame,
+// - arena which starts too small grows and stops overflowing.
+// Returns non zero when any of the checks fails.
+namespace
+{
+std::atomic<std::uint64_t> g_heap_allocations{ 0 };
+
+constexpr std::uint32_t K_FRAMES_COUNT = 16;
+// each of the two buffers can overflow once and grows when it's reused, the second one at the end of frame 2
+constexpr std::uint32_t K_WARM_UP_FRAMES_COUNT = 3;
+constexpr std::uint32_t K_CHILDREN_COUNT = 5000;
+constexpr std::uint32_t K_SKINNED_MESHES_COUNT = 100;
+constexpr std::uint32_t K_BONES_COUNT = 64;
+constexpr std::uint32_t K_ENTITIES_COUNT = 5400;
+
+// same size as glm::mat4
+using matrix_t = std::array<float, 16>;
+
+// returns data, which has to stay valid until the end of the next frame
+std::pmr::vector<std::uint32_t> run_frame(engine::FrameArena& arena, std::uint32_t frame)
+{
+    // hierarchy pass: local to world matrices of children, reserved up front
+    std::pmr::vector<std::pair<std::uint32_t, matrix_t>> ltws(arena.get_memory_resource());
+    ltws.reserve(K_CHILDREN_COUNT);
+    for (std::uint32_t i = 0; i < K_CHILDREN_COUNT; i++)
+    {
+        ltws.emplace_back(i, matrix_t{ static_cast<float>(i) });
+    }
+
+    // skinned meshes: one bone matrices scratch reused by all meshes
+    std::pmr::vector<matrix_t> bone_transforms(arena.get_memory_resource());
+    bone_transforms.reserve(K_BONES_COUNT);
+    for (std::uint32_t i = 0; i < K_SKINNED_MESHES_COUNT; i++)
+    {
+        bone_transforms.assign(K_BONES_COUNT, matrix_t{ 1.0f });
+    }
+
+    // container growing without reserve
+    std::pmr::vector<std::uint32_t> entities(arena.get_memory_resource());
+    for (std::uint32_t i = 0; i < K_ENTITIES_COUNT; i++)
+    {
+        entities.push_back(frame * K_ENTITIES_COUNT + i);
+    }
+    return entities;
+}
+
+bool is_frame_data_valid(const std::pmr::vector<std::uint32_t>& entities, std::uint32_t frame)
+{
+    for (std::uint32_t i = 0; i < entities.size(); i++)
+    {
+        if (entities[i] != frame * K_ENTITIES_COUNT + i)
+        {
+            return false;
+        }
+    }
+    return entities.size() == K_ENTITIES_COUNT;
+}
+
+bool run(const char* name, std::size_t capacity)
+{
+    bool ok = true;
+    engine::FrameArena arena(capacity);
+    // previous frame data outlives arena frame, but not the arena
+    std::vector<std::pmr::vector<std::uint32_t>> frames_data;
+    frames_data.reserve(K_FRAMES_COUNT);
+    std::uint64_t max_allocations = 0;
+    std::int32_t last_overflow_frame = -1;
+    for (std::uint32_t frame = 0; frame < K_FRAMES_COUNT; frame++)
+    {
+        const auto allocations_before = g_heap_allocations.load();
+        frames_data.push_back(run_frame(arena, frame));
+        // frame before the current one was allocated from the other buffer, which was not reset yet
+        if (frame > 0 && !is_frame_data_valid(frames_data[frame - 1], frame - 1))
+        {
+            std::cout << "[FAILED] " << name << ": data of frame " << frame - 1 << " overwritten in frame " << frame << "\n";
+            ok = false;
+        }
+        arena.end_frame();
+        const auto allocations = g_heap_allocations.load() - allocations_before;
+        if (arena.get_stats().overflow_count > 0)
+        {
+            last_overflow_frame = static_cast<std::int32_t>(frame);
+        }
+        if (frame >= K_WARM_UP_FRAMES_COUNT)
+        {
+            max_allocations = std::max(max_allocations, allocations);
+        }
+    }
+    const auto stats = arena.get_stats();
+    ok &= max_allocations == 0 && stats.overflow_count == 0;
+    std::cout << (ok ? "[OK] " : "[FAILED] ") << name << ": FrameArena heap allocations per frame after warm up " << max_allocations
+        << ", last overflow in frame " << last_overflow_frame << ", used " << stats.used << " B, capacity " << stats.capacity << " B\n";
+    return ok;
+}
+}  // namespace anonymous
+
+void* operator new(std::size_t size)
+{
+    g_heap_allocations++;
+    if (auto* ptr = std::malloc(size != 0 ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    g_heap_allocations++;
+    const auto align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+    auto* ptr = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    auto* ptr = std::aligned_alloc(align, (size + align) / align * align);
+#endif
+    if (ptr)
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#ifdef _MSC_VER
+void operator delete(void* ptr, std::align_val_t) noexcept { _aligned_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(ptr); }
+#else
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+#endif
+
+int main()
+{
+    bool ok = true;
+    ok &= run("default capacity", 1024 * 1024);
+    ok &= run("growing from 4 KiB", 4 * 1024);
+    return ok ? 0 : 1;
+}
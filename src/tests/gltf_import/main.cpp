@@ -0,0 +1,208 @@
+#include "gltf_parser.h"
+#include "logger.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Imports glTF mesh made of two primitives, which don't share accessor ranges, uv range (in and out of [0, 1]),
+// joints data type (below and above 255) and attributes (normals only in the first one), and checks, that:
+// - both primitives are imported into single geometry, vertices and indices of the second follow the first one,
+// - vertex format is common for both primitives and value ranges are union of ranges of both primitives,
+// - attribute missing in the second primitive is zero filled.
+// Returns non zero when any of the checks fails.
+namespace
+{
+constexpr std::int32_t K_FLOAT = 5126;
+constexpr std::int32_t K_UNSIGNED_BYTE = 5121;
+constexpr std::int32_t K_UNSIGNED_SHORT = 5123;
+
+std::string encode_base64(std::span<const std::uint8_t> data)
+{
+    constexpr std::string_view K_ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string ret;
+    for (std::size_t i = 0; i < data.size(); i += 3)
+    {
+        const auto left = data.size() - i;
+        const std::uint32_t triple = (data[i] << 16) | ((left > 1 ? data[i + 1] : 0) << 8) | (left > 2 ? data[i + 2] : 0);
+        ret += K_ALPHABET[(triple >> 18) & 0x3f];
+        ret += K_ALPHABET[(triple >> 12) & 0x3f];
+        ret += left > 1 ? K_ALPHABET[(triple >> 6) & 0x3f] : '=';
+        ret += left > 2 ? K_ALPHABET[triple & 0x3f] : '=';
+    }
+    return ret;
+}
+
+// single buffer, every accessor has its own tightly packed buffer view
+class GltfBuilder
+{
+public:
+    template<typename T>
+    std::uint32_t add_accessor(const std::vector<T>& values, std::string_view type, std::uint32_t components, std::int32_t component_type, bool with_range = false)
+    {
+        while (data_.size() % 4 != 0)
+        {
+            data_.push_back(0);
+        }
+        const auto offset = data_.size();
+        data_.resize(offset + values.size() * sizeof(T));
+        std::memcpy(data_.data() + offset, values.data(), values.size() * sizeof(T));
+
+        std::string range;
+        if (with_range)
+        {
+            std::vector<T> min(values.begin(), values.begin() + components);
+            std::vector<T> max = min;
+            for (std::size_t i = 0; i < values.size(); i++)
+            {
+                min[i % components] = std::min(min[i % components], values[i]);
+                max[i % components] = std::max(max[i % components], values[i]);
+            }
+            const auto to_list = [](const std::vector<T>& v)
+            {
+                std::string ret;
+                for (std::size_t i = 0; i < v.size(); i++)
+                {
+                    ret += fmt::format("{}{}", i ? ", " : "", static_cast<double>(v[i]));
+                }
+                return ret;
+            };
+            range = fmt::format(R"(, "min": [{}], "max": [{}])", to_list(min), to_list(max));
+        }
+        const auto idx = views_count_++;
+        buffer_views_ += fmt::format(R"({}{{ "buffer": 0, "byteOffset": {}, "byteLength": {} }})", idx ? ", " : "", offset, values.size() * sizeof(T));
+        accessors_ += fmt::format(R"({}{{ "bufferView": {}, "componentType": {}, "count": {}, "type": "{}"{} }})",
+            idx ? ", " : "", idx, component_type, values.size() / components, type, range);
+        return idx;
+    }
+
+    std::string build(std::string_view primitives) const
+    {
+        return fmt::format(R"({{ "asset": {{ "version": "2.0" }}, "scene": 0, "scenes": [{{ "nodes": [0] }}], "nodes": [{{ "mesh": 0 }}],
+            "meshes": [{{ "primitives": [{}] }}],
+            "buffers": [{{ "byteLength": {}, "uri": "data:application/octet-stream;base64,{}" }}],
+            "bufferViews": [{}], "accessors": [{}] }})",
+            primitives, data_.size(), encode_base64(data_), buffer_views_, accessors_);
+    }
+
+private:
+    std::vector<std::uint8_t> data_;
+    std::string buffer_views_;
+    std::string accessors_;
+    std::uint32_t views_count_ = 0;
+};
+
+template<typename T, std::size_t N>
+std::array<T, N> read_attribute(const engine::GeometryInfo& geometry, std::uint32_t vertex_size, std::uint32_t attribute_offset, std::uint32_t vertex_idx)
+{
+    std::array<T, N> ret{};
+    std::memcpy(ret.data(), geometry.vertex_data.data() + vertex_idx * vertex_size + attribute_offset, sizeof(ret));
+    return ret;
+}
+
+bool check(bool condition, std::string_view name)
+{
+    std::cout << (condition ? "[OK] " : "[FAILED] ") << name << "\n";
+    return condition;
+}
+}  // namespace anonymous
+
+int main()
+{
+    GltfBuilder builder;
+    // first primitive: positions in [0, 1], uvs in [0, 1], normals, uint8 joints
+    const auto positions_0 = builder.add_accessor(std::vector<float>{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f }, "VEC3", 3, K_FLOAT, true);
+    const auto uvs_0 = builder.add_accessor(std::vector<float>{ 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f }, "VEC2", 2, K_FLOAT);
+    const auto normals_0 = builder.add_accessor(std::vector<float>{ 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f }, "VEC3", 3, K_FLOAT);
+    const auto joints_0 = builder.add_accessor(std::vector<std::uint8_t>{ 0, 1, 2, 3, 3, 2, 1, 0, 1, 1, 1, 1 }, "VEC4", 4, K_UNSIGNED_BYTE);
+    const auto weights_0 = builder.add_accessor(std::vector<float>{ 1.0f, 0.0f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f, 0.0f, 0.25f, 0.25f, 0.25f, 0.25f }, "VEC4", 4, K_FLOAT);
+    const auto indices_0 = builder.add_accessor(std::vector<std::uint16_t>{ 0, 1, 2 }, "SCALAR", 1, K_UNSIGNED_SHORT);
+    // second primitive: positions in [2, 3], tiled uvs, no normals, uint16 joints above 255
+    const auto positions_1 = builder.add_accessor(std::vector<float>{ 2.0f, 2.0f, 2.0f, 3.0f, 2.0f, 2.0f, 2.0f, 3.0f, 3.0f }, "VEC3", 3, K_FLOAT, true);
+    const auto uvs_1 = builder.add_accessor(std::vector<float>{ 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 2.0f }, "VEC2", 2, K_FLOAT);
+    const auto joints_1 = builder.add_accessor(std::vector<std::uint16_t>{ 300, 0, 0, 0, 301, 0, 0, 0, 302, 0, 0, 0 }, "VEC4", 4, K_UNSIGNED_SHORT);
+    const auto weights_1 = builder.add_accessor(std::vector<float>{ 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f }, "VEC4", 4, K_FLOAT);
+    const auto indices_1 = builder.add_accessor(std::vector<std::uint16_t>{ 0, 2, 1 }, "SCALAR", 1, K_UNSIGNED_SHORT);
+
+    const auto gltf = builder.build(fmt::format(
+        R"({{ "attributes": {{ "POSITION": {}, "TEXCOORD_0": {}, "NORMAL": {}, "JOINTS_0": {}, "WEIGHTS_0": {} }}, "indices": {} }},
+           {{ "attributes": {{ "POSITION": {}, "TEXCOORD_0": {}, "JOINTS_0": {}, "WEIGHTS_0": {} }}, "indices": {} }})",
+        positions_0, uvs_0, normals_0, joints_0, weights_0, indices_0, positions_1, uvs_1, joints_1, weights_1, indices_1));
+
+    const auto model = engine::parse_gltf_data_from_memory({ reinterpret_cast<const std::uint8_t*>(gltf.data()), gltf.size() }, "");
+    if (model.geometries.size() != 1)
+    {
+        std::cerr << "Expected single geometry, got: " << model.geometries.size() << "\n";
+        engine::log::flush();
+        return 1;
+    }
+    const auto& geometry = model.geometries.front();
+
+    bool ok = true;
+    ok &= check(geometry.vertex_count == 6, "vertices of both primitives");
+
+    // format only, ranges are checked separately
+    struct expected_attribute_t
+    {
+        engine_vertex_attribute_type_t type;
+        std::uint32_t elements_count;
+        engine_vertex_attribute_data_type_t elements_data_type;
+    };
+    constexpr std::array<expected_attribute_t, 5> K_EXPECTED_LAYOUT =
+    {{
+        { ENGINE_VERTEX_ATTRIBUTE_TYPE_POSITION, 3, ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32 },
+        { ENGINE_VERTEX_ATTRIBUTE_TYPE_UV_0, 2, ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_FLOAT32 },
+        { ENGINE_VERTEX_ATTRIBUTE_TYPE_NORMALS, 4, ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_SNORM16 },
+        { ENGINE_VERTEX_ATTRIBUTE_TYPE_JOINTS_0, 4, ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UINT16 },
+        { ENGINE_VERTEX_ATTRIBUTE_TYPE_WEIGHTS_0, 4, ENGINE_VERTEX_ATTRIBUTE_DATA_TYPE_UNORM8 },
+    }};
+    bool same_layout = true;
+    for (std::size_t i = 0; i < K_EXPECTED_LAYOUT.size(); i++)
+    {
+        const auto& attribute = geometry.vertex_laytout.attributes[i];
+        same_layout &= attribute.type == K_EXPECTED_LAYOUT[i].type && attribute.elements_count == K_EXPECTED_LAYOUT[i].elements_count
+            && attribute.elements_data_type == K_EXPECTED_LAYOUT[i].elements_data_type;
+    }
+    ok &= check(same_layout, "common vertex format: float uvs, uint16 joints, normals kept");
+
+    const auto& position_layout = geometry.vertex_laytout.attributes[0];
+    ok &= check(position_layout.range_min[0] == 0.0f && position_layout.range_min[2] == 0.0f
+        && position_layout.range_max[0] == 3.0f && position_layout.range_max[2] == 3.0f, "position range is union of primitive ranges");
+
+    // float3 position, float2 uv, snorm16x4 normal, uint16x4 joints, unorm8x4 weights
+    constexpr std::uint32_t K_VERTEX_SIZE = 12 + 8 + 8 + 8 + 4;
+    ok &= check(geometry.vertex_data.size() == 6 * K_VERTEX_SIZE, "vertex size");
+    if (geometry.vertex_data.size() == 6 * K_VERTEX_SIZE)
+    {
+        ok &= check(read_attribute<float, 3>(geometry, K_VERTEX_SIZE, 0, 4) == std::array{ 3.0f, 2.0f, 2.0f }, "position of the second primitive");
+        ok &= check(read_attribute<float, 2>(geometry, K_VERTEX_SIZE, 12, 5) == std::array{ 0.0f, 2.0f }, "tiled uv of the second primitive");
+        ok &= check(read_attribute<std::int16_t, 4>(geometry, K_VERTEX_SIZE, 20, 0)[1] == 32767
+            && read_attribute<std::int16_t, 4>(geometry, K_VERTEX_SIZE, 20, 3) == std::array<std::int16_t, 4>{}, "normals of the first primitive, zeros in the second one");
+        ok &= check(read_attribute<std::uint16_t, 4>(geometry, K_VERTEX_SIZE, 28, 1) == std::array<std::uint16_t, 4>{ 3, 2, 1, 0 }
+            && read_attribute<std::uint16_t, 4>(geometry, K_VERTEX_SIZE, 28, 5)[0] == 302, "joints of both primitives");
+        ok &= check(read_attribute<std::uint8_t, 4>(geometry, K_VERTEX_SIZE, 36, 3) == std::array<std::uint8_t, 4>{ 255, 0, 0, 0 }, "weights of the second primitive");
+    }
+
+    std::vector<std::uint32_t> indices(geometry.index_count);
+    if (geometry.index_data_type == ENGINE_INDEX_DATA_TYPE_UINT16)
+    {
+        for (std::uint32_t i = 0; i < geometry.index_count; i++)
+        {
+            std::uint16_t index = 0;
+            std::memcpy(&index, geometry.index_data.data() + i * sizeof(index), sizeof(index));
+            indices[i] = index;
+        }
+    }
+    ok &= check(geometry.index_data_type == ENGINE_INDEX_DATA_TYPE_UINT16 && indices == std::vector<std::uint32_t>{ 0, 1, 2, 3, 5, 4 }, "indices of the second primitive are offset");
+
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
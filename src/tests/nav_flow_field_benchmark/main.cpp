@@ -0,0 +1,229 @@
+#include "nav_mesh.h"
+#include "logger.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Builds grid nav mesh with random holes and compares flow field with per-agent A* search, checks, that:
+// - flow field cost of every sampled node equals cost of the A* path to the goal,
+// - following next nodes of the flow field reaches the goal with the same cost,
+// - for 1000 agents, one flow field per goal change is cheaper than A* search of every agent.
+// Prints cost of both per goal change for 10, 100 and 1000 agents.
+// Returns non zero when any of the checks fails.
+namespace
+{
+constexpr std::int32_t K_GRID_SIZE = 100;
+constexpr engine::NavMeshEdgeCost K_STRAIGHT_COST = 10;
+constexpr engine::NavMeshEdgeCost K_CROSS_COST = 14;
+constexpr std::uint32_t K_GOALS_COUNT = 20;
+constexpr std::uint32_t K_STARTS_PER_GOAL = 200;
+constexpr std::uint32_t K_FRAMES_COUNT = 20;
+
+struct level_t
+{
+    engine::NavMesh mesh;
+    std::vector<engine::NavMeshPosition3D> positions;  // indexed with node idx
+};
+
+// every 5th cell is a hole, but every 10th column is kept, so most of the grid stays connected
+level_t build_level(std::mt19937& rng)
+{
+    level_t ret{};
+    std::vector<engine::NavMeshNodeIdx> cells(K_GRID_SIZE * K_GRID_SIZE, engine::invalid_node_idx);
+    for (std::int32_t z = 0; z < K_GRID_SIZE; z++)
+    {
+        for (std::int32_t x = 0; x < K_GRID_SIZE; x++)
+        {
+            if (rng() % 5 == 0 && x % 10 != 0)
+            {
+                continue;
+            }
+            const auto position = engine::NavMeshPosition3D(static_cast<float>(x), 0.0f, static_cast<float>(z));
+            cells[z * K_GRID_SIZE + x] = ret.mesh.add_node(glm::vec3(position), glm::vec3(0.5f, 0.5f, 0.5f));
+            ret.positions.push_back(position);
+        }
+    }
+    for (std::int32_t z = 0; z < K_GRID_SIZE; z++)
+    {
+        for (std::int32_t x = 0; x < K_GRID_SIZE; x++)
+        {
+            const auto node = cells[z * K_GRID_SIZE + x];
+            if (node == engine::invalid_node_idx)
+            {
+                continue;
+            }
+            if (x + 1 < K_GRID_SIZE && cells[z * K_GRID_SIZE + x + 1] != engine::invalid_node_idx)
+            {
+                ret.mesh.add_edge(node, cells[z * K_GRID_SIZE + x + 1], K_STRAIGHT_COST);
+                ret.mesh.add_edge(cells[z * K_GRID_SIZE + x + 1], node, K_STRAIGHT_COST);
+            }
+            if (z + 1 < K_GRID_SIZE && cells[(z + 1) * K_GRID_SIZE + x] != engine::invalid_node_idx)
+            {
+                ret.mesh.add_edge(node, cells[(z + 1) * K_GRID_SIZE + x], K_CROSS_COST);
+                ret.mesh.add_edge(cells[(z + 1) * K_GRID_SIZE + x], node, K_CROSS_COST);
+            }
+        }
+    }
+    ret.mesh.build();
+    return ret;
+}
+
+engine::NavMeshNodeIdx random_node(std::mt19937& rng, const level_t& level)
+{
+    return static_cast<engine::NavMeshNodeIdx>(rng() % level.mesh.get_nodes_count());
+}
+
+// returns number of nodes, which cost differs from A*
+std::uint32_t compare_with_path_finder(std::mt19937& rng, const level_t& level)
+{
+    engine::NavMeshFlowField flow_field;
+    engine::NavMeshPathFinder path_finder;
+    std::uint32_t mismatches = 0;
+    for (std::uint32_t i = 0; i < K_GOALS_COUNT; i++)
+    {
+        const auto goal = random_node(rng, level);
+        flow_field.set_goal(level.mesh, level.positions[goal]);
+        // spread over frames, as the scene does
+        while (!flow_field.update(level.mesh, 50))
+        {
+        }
+
+        for (std::uint32_t j = 0; j < K_STARTS_PER_GOAL; j++)
+        {
+            const auto start = random_node(rng, level);
+            const auto path = path_finder.find_path(level.mesh, start, goal);
+            const auto cost = flow_field.get_cost(start);
+            const auto reachable = !path.nodes.empty() || start == goal;
+            if (reachable ? cost != path.cost : cost != engine::NavMeshFlowField::K_UNREACHABLE)
+            {
+                mismatches++;
+                continue;
+            }
+            if (!reachable)
+            {
+                continue;
+            }
+
+            engine::NavMeshEdgeCost followed_cost = 0;
+            auto node = start;
+            while (node != goal)
+            {
+                const auto next = flow_field.get_next_node(node);
+                for (const auto& edge : level.mesh.get_edges(node))
+                {
+                    if (edge.target == next)
+                    {
+                        followed_cost += edge.cost;
+                        break;
+                    }
+                }
+                node = next;
+            }
+            mismatches += followed_cost != cost;
+        }
+    }
+    return mismatches;
+}
+
+struct timings_t
+{
+    double flow_field_ms = 0.0;
+    double path_finder_ms = 0.0;
+};
+
+// goal moves to a different node every frame and every agent needs a direction or path to it
+timings_t measure(std::mt19937& rng, const level_t& level, std::uint32_t agents_count)
+{
+    std::vector<engine::NavMeshNodeIdx> agents(agents_count);
+    for (auto& agent : agents)
+    {
+        agent = random_node(rng, level);
+    }
+    std::vector<engine::NavMeshNodeIdx> goals(K_FRAMES_COUNT);
+    for (auto& goal : goals)
+    {
+        goal = random_node(rng, level);
+    }
+
+    engine::NavMeshFlowField flow_field;
+    engine::NavMeshPathFinder path_finder;
+    float sink = 0.0f;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto goal : goals)
+    {
+        flow_field.set_goal(level.mesh, level.positions[goal]);
+        flow_field.update(level.mesh);
+        for (const auto agent : agents)
+        {
+            glm::vec3 direction{};
+            flow_field.sample(level.mesh, level.positions[agent], direction);
+            sink += direction.x;
+        }
+    }
+    const auto flow_field_end = std::chrono::steady_clock::now();
+    for (const auto goal : goals)
+    {
+        for (const auto agent : agents)
+        {
+            sink += static_cast<float>(path_finder.find_path(level.mesh, agent, goal).cost);
+        }
+    }
+    const auto path_finder_end = std::chrono::steady_clock::now();
+
+    timings_t ret{};
+    ret.flow_field_ms = std::chrono::duration<double, std::milli>(flow_field_end - start).count() / K_FRAMES_COUNT;
+    ret.path_finder_ms = std::chrono::duration<double, std::milli>(path_finder_end - flow_field_end).count() / K_FRAMES_COUNT;
+    // keeps the queries from being optimized out
+    if (sink == -1.0f)
+    {
+        std::cout << sink;
+    }
+    return ret;
+}
+
+}  // namespace anonymous
+
+int main()
+{
+    std::mt19937 rng(42);
+    const auto level = build_level(rng);
+    bool ok = true;
+
+    const auto mismatches = compare_with_path_finder(rng, level);
+    if (mismatches)
+    {
+        std::cout << "[FAILED] flow field differs from A* in " << mismatches << " of " << K_GOALS_COUNT * K_STARTS_PER_GOAL << " nodes\n";
+        ok = false;
+    }
+    else
+    {
+        std::cout << "[OK] flow field matches A* (" << level.mesh.get_nodes_count() << " nodes)\n";
+    }
+
+    for (const std::uint32_t agents_count : { 10u, 100u, 1000u })
+    {
+        const auto timings = measure(rng, level, agents_count);
+        std::cout << "agents " << agents_count << ": flow field " << timings.flow_field_ms << " ms, A* " << timings.path_finder_ms
+            << " ms per goal change\n";
+        if (agents_count == 1000)
+        {
+            const auto name = "flow field for " + std::to_string(agents_count) + " agents";
+            if (timings.flow_field_ms >= timings.path_finder_ms)
+            {
+                std::cout << "[FAILED] " << name << " is not cheaper than A*\n";
+                ok = false;
+            }
+            else
+            {
+                std::cout << "[OK] " << name << "\n";
+            }
+        }
+    }
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "nav_mesh_builder.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Builds nav mesh from synthetic level and checks, that the result doesn't depend on how it was built:
+// - two builds of the same geometry,
+// - build of the geometry with shuffled triangles,
+// - rebuild_area() of changed part of the level and full build of the changed level.
+// Returns non zero when any of the nav meshes differ.
+namespace
+{
+const engine_nav_mesh_build_config_t K_CONFIG =
+{
+    .cell_size = 0.3f,
+    .cell_height = 0.2f,
+    .agent_radius = 0.5f,
+    .agent_height = 2.0f,
+    .agent_max_climb = 0.4f,
+    .agent_max_slope = 45.0f,
+    .tile_size = 32,
+};
+
+struct nav_mesh_snapshot_t
+{
+    std::vector<glm::vec3> centers;
+    std::vector<glm::vec3> sizes;
+    std::vector<engine::NavMeshEdge> edges;
+    std::vector<engine::NavMeshBuilder::portal_t> portals;
+};
+
+// quad p0, p1, p2, p3 (in order around the quad), triangles are flipped to face the outward direction
+void add_quad(std::vector<glm::vec3>& triangles, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& outward)
+{
+    const auto flip = glm::dot(glm::cross(p1 - p0, p2 - p0), outward) < 0.0f;
+    for (const auto& tri : { std::array{ p0, p1, p2 }, std::array{ p0, p2, p3 } })
+    {
+        triangles.push_back(tri[0]);
+        triangles.push_back(flip ? tri[2] : tri[1]);
+        triangles.push_back(flip ? tri[1] : tri[2]);
+    }
+}
+
+void add_box(std::vector<glm::vec3>& triangles, const glm::vec3& min, const glm::vec3& max)
+{
+    const auto c = [&](std::uint32_t x, std::uint32_t y, std::uint32_t z) { return glm::vec3(x ? max.x : min.x, y ? max.y : min.y, z ? max.z : min.z); };
+    add_quad(triangles, c(0, 1, 0), c(1, 1, 0), c(1, 1, 1), c(0, 1, 1), glm::vec3(0.0f, 1.0f, 0.0f));
+    add_quad(triangles, c(0, 0, 0), c(1, 0, 0), c(1, 0, 1), c(0, 0, 1), glm::vec3(0.0f, -1.0f, 0.0f));
+    add_quad(triangles, c(0, 0, 0), c(0, 1, 0), c(0, 1, 1), c(0, 0, 1), glm::vec3(-1.0f, 0.0f, 0.0f));
+    add_quad(triangles, c(1, 0, 0), c(1, 1, 0), c(1, 1, 1), c(1, 0, 1), glm::vec3(1.0f, 0.0f, 0.0f));
+    add_quad(triangles, c(0, 0, 0), c(1, 0, 0), c(1, 1, 0), c(0, 1, 0), glm::vec3(0.0f, 0.0f, -1.0f));
+    add_quad(triangles, c(0, 0, 1), c(1, 0, 1), c(1, 1, 1), c(0, 1, 1), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+// ground with walls, pillars, raised platform with ramp and low steps, spans a few tiles in both directions
+std::vector<glm::vec3> create_level()
+{
+    std::vector<glm::vec3> triangles;
+    add_box(triangles, glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(40.0f, 0.0f, 30.0f));
+    add_box(triangles, glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(10.5f, 3.0f, 20.0f));
+    add_box(triangles, glm::vec3(20.0f, 0.0f, 10.0f), glm::vec3(20.5f, 3.0f, 30.0f));
+    for (std::uint32_t i = 0; i < 5; i++)
+    {
+        const auto x = 2.0f + 1.5f * static_cast<float>(i);
+        add_box(triangles, glm::vec3(x, 0.0f, 24.0f), glm::vec3(x + 0.6f, 4.0f, 24.6f));
+    }
+    add_box(triangles, glm::vec3(28.0f, 0.0f, 4.0f), glm::vec3(36.0f, 2.0f, 12.0f));
+    // ramp up to the platform along -x side
+    add_quad(triangles, glm::vec3(22.0f, 0.0f, 6.0f), glm::vec3(28.0f, 2.0f, 6.0f), glm::vec3(28.0f, 2.0f, 10.0f), glm::vec3(22.0f, 0.0f, 10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    for (std::uint32_t i = 0; i < 4; i++)
+    {
+        const auto z = 16.0f + 1.0f * static_cast<float>(i);
+        add_box(triangles, glm::vec3(30.0f, 0.0f, z), glm::vec3(38.0f, 0.2f * static_cast<float>(i + 1), 30.0f));
+    }
+    return triangles;
+}
+
+nav_mesh_snapshot_t create_snapshot(engine::NavMeshBuilder& builder)
+{
+    auto nav_mesh = builder.create_nav_mesh();
+    nav_mesh_snapshot_t ret;
+    for (std::size_t i = 0; i < nav_mesh.get_nodes_count(); i++)
+    {
+        const auto& node = nav_mesh.get_node(static_cast<engine::NavMeshNodeIdx>(i));
+        ret.centers.push_back(node.get_center());
+        ret.sizes.push_back(node.get_size());
+        const auto edges = nav_mesh.get_edges(static_cast<engine::NavMeshNodeIdx>(i));
+        ret.edges.insert(ret.edges.end(), edges.begin(), edges.end());
+    }
+    const auto portals = builder.get_portals();
+    ret.portals.assign(portals.begin(), portals.end());
+    return ret;
+}
+
+// bitwise equality, build has to give exactly the same floats
+bool compare(const std::string& name, const nav_mesh_snapshot_t& expected, const nav_mesh_snapshot_t& actual)
+{
+    const auto same_portal = [](const auto& a, const auto& b) { return a.node_a == b.node_a && a.node_b == b.node_b && a.start == b.start && a.end == b.end; };
+    const auto same_edge = [](const auto& a, const auto& b) { return a.target == b.target && a.cost == b.cost; };
+    const auto ok = expected.centers == actual.centers && expected.sizes == actual.sizes
+        && std::equal(expected.edges.begin(), expected.edges.end(), actual.edges.begin(), actual.edges.end(), same_edge)
+        && std::equal(expected.portals.begin(), expected.portals.end(), actual.portals.begin(), actual.portals.end(), same_portal);
+    std::cout << (ok ? "[OK] " : "[FAILED] ") << name << ": nodes " << actual.centers.size() << " (expected " << expected.centers.size()
+        << "), edges " << actual.edges.size() << " (expected " << expected.edges.size() << ")\n";
+    return ok;
+}
+}  // namespace anonymous
+
+int main()
+{
+    auto level = create_level();
+
+    engine::NavMeshBuilder builder;
+    builder.build(K_CONFIG, level);
+    const auto reference = create_snapshot(builder);
+    if (reference.centers.empty() || reference.edges.empty() || builder.get_stats().tiles_count < 4)
+    {
+        std::cerr << "Synthetic level gave empty nav mesh or single tile.\n";
+        engine::log::flush();
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        engine::NavMeshBuilder other;
+        other.build(K_CONFIG, level);
+        ok &= compare("same geometry", reference, create_snapshot(other));
+    }
+    {
+        // order of triangles depends i.e. on order of entities in the scene
+        auto shuffled = level;
+        std::mt19937 rng(1234);
+        for (std::size_t i = shuffled.size() / 3 - 1; i > 0; i--)
+        {
+            const auto j = std::uniform_int_distribution<std::size_t>(0, i)(rng);
+            std::swap_ranges(shuffled.begin() + i * 3, shuffled.begin() + i * 3 + 3, shuffled.begin() + j * 3);
+        }
+        engine::NavMeshBuilder other;
+        other.build(K_CONFIG, shuffled);
+        ok &= compare("shuffled triangles", reference, create_snapshot(other));
+    }
+    {
+        // nothing changed in the area, cached tiles are rebuilt with the same result
+        builder.rebuild_area(level, glm::vec3(8.0f, 0.0f, 8.0f), glm::vec3(22.0f, 3.0f, 22.0f));
+        ok &= compare("rebuild of unchanged area", reference, create_snapshot(builder));
+    }
+    {
+        // obstacle added on the border of tiles, lower than the rest of the level so bounds of the level don't change
+        const auto box_min = glm::vec3(8.5f, 0.0f, 8.5f);
+        const auto box_max = glm::vec3(11.5f, 1.5f, 11.5f);
+        add_box(level, box_min, box_max);
+        builder.rebuild_area(level, box_min, box_max);
+        const auto rebuilt = create_snapshot(builder);
+
+        engine::NavMeshBuilder other;
+        other.build(K_CONFIG, level);
+        const auto full = create_snapshot(other);
+        ok &= compare("rebuild of changed area", full, rebuilt);
+        if (full.centers == reference.centers)
+        {
+            std::cerr << "Added obstacle didn't change the nav mesh.\n";
+            ok = false;
+        }
+    }
+
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include "nav_mesh.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Builds grid nav meshes of growing size and checks, that:
+// - get_node_idx() finds the same containing node as the linear scan of all nodes,
+// - get_nearest_node_idx() finds a node as close as the closest one of the linear scan,
+// - cost of the lookup stays flat, while number of nodes grows by three orders of magnitude.
+// Prints cost of the grid lookup, nearest node lookup and linear scan per query.
+// Returns non zero when any of the checks fails.
+namespace
+{
+constexpr std::uint32_t K_QUERIES_COUNT = 20000;
+constexpr std::uint32_t K_CHECKED_QUERIES_COUNT = 2000;
+// lookup of the largest mesh can be this many times slower than of the smallest one (cache misses), linear scan grows with nodes count
+constexpr double K_MAX_LOOKUP_GROWTH = 8.0;
+
+// squared distance on xz plane from pos to the node, 0 if node contains pos
+float distance_sq(const engine::NavMesh& mesh, engine::NavMeshNodeIdx idx, const engine::NavMeshPosition3D& pos)
+{
+    const auto& node = mesh.get_node(idx);
+    const auto center = node.get_center();
+    const auto size = node.get_size();
+    const auto dx = std::max(std::abs(pos.x - center.x) - size.x, 0.0f);
+    const auto dz = std::max(std::abs(pos.z - center.z) - size.z, 0.0f);
+    return dx * dx + dz * dz;
+}
+
+engine::NavMeshNodeIdx linear_node_idx(const engine::NavMesh& mesh, const engine::NavMeshPosition3D& pos)
+{
+    for (engine::NavMeshNodeIdx i = 0; i < static_cast<engine::NavMeshNodeIdx>(mesh.get_nodes_count()); i++)
+    {
+        if (distance_sq(mesh, i, pos) == 0.0f)
+        {
+            return i;
+        }
+    }
+    return engine::invalid_node_idx;
+}
+
+float linear_nearest_distance_sq(const engine::NavMesh& mesh, const engine::NavMeshPosition3D& pos)
+{
+    auto ret = std::numeric_limits<float>::max();
+    for (engine::NavMeshNodeIdx i = 0; i < static_cast<engine::NavMeshNodeIdx>(mesh.get_nodes_count()); i++)
+    {
+        ret = std::min(ret, distance_sq(mesh, i, pos));
+    }
+    return ret;
+}
+
+// cells of width x width grid, a quarter of them are holes
+engine::NavMesh build_mesh(std::mt19937& rng, std::int32_t width)
+{
+    engine::NavMesh ret;
+    for (std::int32_t x = 0; x < width; x++)
+    {
+        for (std::int32_t z = 0; z < width; z++)
+        {
+            if (rng() % 4 != 0)
+            {
+                ret.add_node(glm::vec3(static_cast<float>(x - width / 2), 0.0f, static_cast<float>(z - width / 2)), glm::vec3(0.5f, 0.0f, 0.5f));
+            }
+        }
+    }
+    ret.build();
+    return ret;
+}
+
+struct result_t
+{
+    std::size_t nodes_count = 0;
+    std::uint32_t mismatches = 0;
+    double lookup_ns = 0.0;
+    double nearest_ns = 0.0;
+    double linear_ns = 0.0;
+};
+
+result_t run(std::mt19937& rng, std::int32_t width)
+{
+    const auto mesh = build_mesh(rng, width);
+    // queries cover the mesh and a margin around it, so some of them are outside of all nodes
+    const auto half_extent = static_cast<float>(width / 2) + 4.0f;
+    std::uniform_real_distribution<float> distribution(-half_extent, half_extent);
+    std::vector<engine::NavMeshPosition3D> queries(K_QUERIES_COUNT);
+    for (auto& query : queries)
+    {
+        query = engine::NavMeshPosition3D(distribution(rng), 0.0f, distribution(rng));
+    }
+
+    result_t ret{};
+    ret.nodes_count = mesh.get_nodes_count();
+    for (std::uint32_t i = 0; i < K_CHECKED_QUERIES_COUNT; i++)
+    {
+        const auto& query = queries[i];
+        const auto idx = mesh.get_node_idx(query);
+        const auto expected_idx = linear_node_idx(mesh, query);
+        // neighbour nodes share edges, so any containing node is valid
+        const auto contains_ok = idx == engine::invalid_node_idx ? expected_idx == engine::invalid_node_idx : distance_sq(mesh, idx, query) == 0.0f;
+        const auto nearest_ok = std::abs(distance_sq(mesh, mesh.get_nearest_node_idx(query), query) - linear_nearest_distance_sq(mesh, query)) <= 1e-5f;
+        ret.mismatches += !contains_ok || !nearest_ok;
+    }
+
+    engine::NavMeshNodeIdx sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& query : queries)
+    {
+        sink += mesh.get_node_idx(query);
+    }
+    const auto lookup_end = std::chrono::steady_clock::now();
+    for (const auto& query : queries)
+    {
+        sink += mesh.get_nearest_node_idx(query);
+    }
+    const auto nearest_end = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < K_CHECKED_QUERIES_COUNT / 10; i++)
+    {
+        sink += linear_node_idx(mesh, queries[i]);
+    }
+    const auto linear_end = std::chrono::steady_clock::now();
+
+    ret.lookup_ns = std::chrono::duration<double, std::nano>(lookup_end - start).count() / K_QUERIES_COUNT;
+    ret.nearest_ns = std::chrono::duration<double, std::nano>(nearest_end - lookup_end).count() / K_QUERIES_COUNT;
+    ret.linear_ns = std::chrono::duration<double, std::nano>(linear_end - nearest_end).count() / (K_CHECKED_QUERIES_COUNT / 10);
+    // keeps the queries from being optimized out
+    if (sink == engine::invalid_node_idx)
+    {
+        std::cout << sink;
+    }
+    return ret;
+}
+
+}  // namespace anonymous
+
+int main()
+{
+    std::mt19937 rng(3);
+    bool ok = true;
+    std::vector<result_t> results;
+    for (const std::int32_t width : { 16, 64, 256, 512 })
+    {
+        const auto result = run(rng, width);
+        std::cout << "nodes " << result.nodes_count << ": grid lookup " << result.lookup_ns << " ns, nearest " << result.nearest_ns
+            << " ns, linear scan " << result.linear_ns << " ns\n";
+        if (result.mismatches)
+        {
+            std::cout << "[FAILED] " << result.nodes_count << " nodes: " << result.mismatches << " of " << K_CHECKED_QUERIES_COUNT
+                << " lookups differ from the linear scan\n";
+            ok = false;
+        }
+        results.push_back(result);
+    }
+
+    const auto growth = results.back().lookup_ns / results.front().lookup_ns;
+    const auto name = "lookup of " + std::to_string(results.front().nodes_count) + " to " + std::to_string(results.back().nodes_count) + " nodes";
+    if (growth > K_MAX_LOOKUP_GROWTH)
+    {
+        std::cout << "[FAILED] " << name << " is " << growth << " times slower\n";
+        ok = false;
+    }
+    else
+    {
+        std::cout << "[OK] " << name << " (" << growth << " times)\n";
+    }
+    engine::log::flush();
+    return ok ? 0 : 1;
+}
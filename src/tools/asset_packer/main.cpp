@@ -0,0 +1,246 @@
+#include "asset_pack_format.h"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Builds asset pack (*.epak) from assets folder, so engine can load all assets from single memory mapped file.
+// Usage:
+//   asset_packer <assets_dir> <output_file> [--level <1-22>] [--store-only]
+//   asset_packer --list <pack_file>
+namespace
+{
+// compressed data is kept only when it saves at least 10%, otherwise entry is stored and can be used without copy
+constexpr float K_MIN_COMPRESSION_RATIO = 0.9f;
+constexpr int K_DEFAULT_COMPRESSION_LEVEL = 19;
+
+struct pack_input_file_t
+{
+    std::string name;
+    std::vector<std::uint8_t> data;
+    engine::AssetPackCompression compression = engine::AssetPackCompression::eNone;
+    std::uint64_t original_size = 0;
+};
+
+bool read_file(const std::filesystem::path& path, std::vector<std::uint8_t>& out)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    out.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), out.size()));
+}
+
+void compress_entry(pack_input_file_t& file, int level)
+{
+    std::vector<std::uint8_t> compressed(ZSTD_compressBound(file.data.size()));
+    const auto result = ZSTD_compress(compressed.data(), compressed.size(), file.data.data(), file.data.size(), level);
+    if (ZSTD_isError(result))
+    {
+        std::cerr << "Failed to compress: " << file.name << ". Error msg: " << ZSTD_getErrorName(result) << "\n";
+        return;
+    }
+    if (static_cast<float>(result) > static_cast<float>(file.data.size()) * K_MIN_COMPRESSION_RATIO)
+    {
+        // i.e. png or jpg files
+        return;
+    }
+    compressed.resize(result);
+    file.data = std::move(compressed);
+    file.compression = engine::AssetPackCompression::eZstd;
+}
+
+int build_pack(const std::filesystem::path& assets_dir, const std::filesystem::path& output_file, int level, bool store_only)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<pack_input_file_t> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(assets_dir))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() == engine::K_ASSET_PACK_EXTENSION)
+        {
+            continue;
+        }
+        pack_input_file_t file{};
+        file.name = entry.path().lexically_relative(assets_dir).generic_string();
+        if (!read_file(entry.path(), file.data))
+        {
+            std::cerr << "Couldnt read file: " << entry.path().string() << "\n";
+            return 1;
+        }
+        file.original_size = file.data.size();
+        files.push_back(std::move(file));
+    }
+    // deterministic output, files from the same folder are close to each other in the pack
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+    std::uint64_t total_original_size = 0;
+    std::uint64_t total_stored_size = 0;
+    std::uint32_t compressed_count = 0;
+    for (auto& file : files)
+    {
+        if (!store_only && !file.data.empty())
+        {
+            compress_entry(file, level);
+        }
+        total_original_size += file.original_size;
+        total_stored_size += file.data.size();
+        compressed_count += file.compression == engine::AssetPackCompression::eZstd ? 1 : 0;
+    }
+
+    // layout: header, toc, names, data
+    engine::asset_pack_header_t header{};
+    header.magic = engine::K_ASSET_PACK_MAGIC;
+    header.version = engine::K_ASSET_PACK_VERSION;
+    header.entry_count = static_cast<std::uint32_t>(files.size());
+    header.toc_offset = sizeof(engine::asset_pack_header_t);
+    header.names_offset = header.toc_offset + files.size() * sizeof(engine::asset_pack_toc_entry_t);
+
+    std::string names;
+    std::vector<engine::asset_pack_toc_entry_t> toc;
+    toc.reserve(files.size());
+    for (const auto& file : files)
+    {
+        engine::asset_pack_toc_entry_t entry{};
+        entry.name_hash = engine::asset_pack_hash_name(file.name);
+        entry.name_offset = static_cast<std::uint32_t>(names.size());
+        entry.name_size = static_cast<std::uint32_t>(file.name.size());
+        entry.stored_size = file.data.size();
+        entry.original_size = file.original_size;
+        entry.compression = file.compression;
+        names += file.name;
+        toc.push_back(entry);
+    }
+    header.names_size = names.size();
+
+    std::uint64_t offset = header.names_offset + header.names_size;
+    for (auto& entry : toc)
+    {
+        // stored entries are page aligned, so they can be used straight from the mapped file
+        const auto alignment = entry.compression == engine::AssetPackCompression::eNone ? engine::K_ASSET_PACK_PAGE_ALIGNMENT : engine::K_ASSET_PACK_COMPRESSED_ALIGNMENT;
+        offset = engine::asset_pack_align(offset, alignment);
+        entry.data_offset = offset;
+        offset += entry.stored_size;
+    }
+    header.file_size = offset;
+
+    // data is written in name order, toc is sorted by hash for binary search
+    auto sorted_toc = toc;
+    std::stable_sort(sorted_toc.begin(), sorted_toc.end(), [](const auto& a, const auto& b) { return a.name_hash < b.name_hash; });
+
+    std::ofstream out(output_file, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Couldnt create file: " << output_file.string() << "\n";
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sorted_toc.data()), sorted_toc.size() * sizeof(engine::asset_pack_toc_entry_t));
+    out.write(names.data(), names.size());
+    std::uint64_t written = header.names_offset + header.names_size;
+    const std::vector<char> padding(engine::K_ASSET_PACK_PAGE_ALIGNMENT, 0);
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        out.write(padding.data(), toc[i].data_offset - written);
+        out.write(reinterpret_cast<const char*>(files[i].data.data()), files[i].data.size());
+        written = toc[i].data_offset + toc[i].stored_size;
+    }
+    if (!out)
+    {
+        std::cerr << "Failed writing to file: " << output_file.string() << "\n";
+        return 1;
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    std::cout << "Packed " << files.size() << " files (" << compressed_count << " compressed) into " << output_file.string() << "\n"
+        << "\tdata: " << total_original_size << " bytes -> " << total_stored_size << " bytes, pack size: " << header.file_size << " bytes\n"
+        << "\ttook: " << duration.count() << " ms\n";
+    return 0;
+}
+
+int list_pack(const std::filesystem::path& pack_file)
+{
+    std::vector<std::uint8_t> data;
+    if (!read_file(pack_file, data) || data.size() < sizeof(engine::asset_pack_header_t))
+    {
+        std::cerr << "Couldnt read pack: " << pack_file.string() << "\n";
+        return 1;
+    }
+    engine::asset_pack_header_t header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != engine::K_ASSET_PACK_MAGIC || header.version != engine::K_ASSET_PACK_VERSION || header.file_size != data.size())
+    {
+        std::cerr << "Invalid pack: " << pack_file.string() << "\n";
+        return 1;
+    }
+    for (std::uint32_t i = 0; i < header.entry_count; i++)
+    {
+        engine::asset_pack_toc_entry_t entry{};
+        std::memcpy(&entry, data.data() + header.toc_offset + i * sizeof(entry), sizeof(entry));
+        const std::string_view name(reinterpret_cast<const char*>(data.data() + header.names_offset + entry.name_offset), entry.name_size);
+        std::cout << name << "\t" << entry.original_size << " -> " << entry.stored_size
+            << (entry.compression == engine::AssetPackCompression::eZstd ? " (zstd)" : "") << "\t@" << entry.data_offset << "\n";
+    }
+    return 0;
+}
+
+void print_usage()
+{
+    std::cout << "Usage:\n"
+        << "\tasset_packer <assets_dir> <output_file> [--level <1-22>] [--store-only]\n"
+        << "\tasset_packer --list <pack_file>\n";
+}
+
+}  // namespace anonymous
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() == 2 && args[0] == "--list")
+    {
+        return list_pack(args[1]);
+    }
+    if (args.size() < 2)
+    {
+        print_usage();
+        return 1;
+    }
+
+    int level = K_DEFAULT_COMPRESSION_LEVEL;
+    bool store_only = false;
+    for (std::size_t i = 2; i < args.size(); i++)
+    {
+        if (args[i] == "--level" && i + 1 < args.size())
+        {
+            level = std::clamp(std::stoi(args[++i]), 1, ZSTD_maxCLevel());
+        }
+        else if (args[i] == "--store-only")
+        {
+            store_only = true;
+        }
+        else
+        {
+            print_usage();
+            return 1;
+        }
+    }
+
+    const std::filesystem::path assets_dir = args[0];
+    if (!std::filesystem::is_directory(assets_dir))
+    {
+        std::cerr << "Not a directory: " << assets_dir.string() << "\n";
+        return 1;
+    }
+    return build_pack(assets_dir, args[1], level, store_only);
+}